@@ -0,0 +1,517 @@
+/*****************************************************************
+|
+|   BlueTune - Codec Throughput Benchmark
+|
+|   (c) 2002-2013 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+/** @file
+ * Main code for BtBench
+ */
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "BlueTune.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+#define BTBENCH_MAX_MODULES     32
+#define BTBENCH_MAX_NAME_LENGTH 128
+
+/*----------------------------------------------------------------------
+|    types
++---------------------------------------------------------------------*/
+typedef struct {
+    const char*  input;
+    unsigned int run;
+    BLT_Result   result;
+    char         decoder[BTBENCH_MAX_NAME_LENGTH];
+    double       media_time;    /* seconds of decoded audio       */
+    double       wall_time;     /* seconds                        */
+    double       cpu_time;      /* seconds, all threads           */
+    double       decoder_time;  /* seconds spent in the decoder   */
+    BLT_UInt64   packet_count;  /* packets decoded, from the      */
+                                /* decoder node's statistics      */
+    BLT_UInt64   peak_rss;      /* kilobytes, process-wide        */
+} BenchResult;
+
+typedef struct {
+    char         name[BTBENCH_MAX_NAME_LENGTH];
+    unsigned int run_count;
+    double       media_time;
+    double       wall_time;
+    double       cpu_time;
+    BLT_UInt64   packet_count;
+} ModuleSummary;
+
+/*----------------------------------------------------------------------
+|    globals
++---------------------------------------------------------------------*/
+static struct {
+    char**       inputs;
+    unsigned int input_count;
+    unsigned int repeat;
+    int          cpu;
+    bool         json;
+    bool         threaded;
+    const char*  output;
+} Options;
+
+static ModuleSummary Summaries[BTBENCH_MAX_MODULES];
+static unsigned int  SummaryCount = 0;
+
+/*----------------------------------------------------------------------
+|    PrintUsageAndExit
++---------------------------------------------------------------------*/
+static void
+PrintUsageAndExit()
+{
+    printf("btbench [options] <input> [<input> ...]\n"
+           "  options:\n"
+           "  --repeat=<n>:    decode each input <n> times [def=1]\n"
+           "  --cpu=<n>:       pin the process to CPU core <n>\n"
+           "  --threads:       run the stream nodes on worker threads\n"
+           "  --output=<name>: output to decode to [def=null]\n"
+           "  --json:          print the results as JSON\n"
+        );
+    exit(1);
+}
+
+/*----------------------------------------------------------------------
+|    ParseCommandLine
++---------------------------------------------------------------------*/
+static void
+ParseCommandLine(int argc, char** argv)
+{
+    // default options
+    Options.inputs      = new char*[argc];
+    Options.input_count = 0;
+    Options.repeat      = 1;
+    Options.cpu         = -1;
+    Options.json        = false;
+    Options.threaded    = false;
+    Options.output      = "null";
+
+    for (int i=1; i<argc; i++) {
+        char* arg = argv[i];
+        if (!strncmp(arg, "--repeat=", 9)) {
+            Options.repeat = strtoul(arg+9, NULL, 10);
+        } else if (!strncmp(arg, "--cpu=", 6)) {
+            Options.cpu = (int)strtoul(arg+6, NULL, 10);
+        } else if (!strncmp(arg, "--output=", 9)) {
+            Options.output = arg+9;
+        } else if (!strcmp(arg, "--threads")) {
+            Options.threaded = true;
+        } else if (!strcmp(arg, "--json")) {
+            Options.json = true;
+        } else if (!strncmp(arg, "--", 2)) {
+            fprintf(stderr, "invalid option '%s'\n", arg);
+            PrintUsageAndExit();
+        } else {
+            Options.inputs[Options.input_count++] = arg;
+        }
+    }
+
+    // check args
+    if (Options.input_count == 0) {
+        fprintf(stderr, "missing input\n");
+        PrintUsageAndExit();
+    }
+    if (Options.repeat == 0) Options.repeat = 1;
+}
+
+/*----------------------------------------------------------------------
+|    PinToCpu
++---------------------------------------------------------------------*/
+static bool
+PinToCpu(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return SetProcessAffinityMask(GetCurrentProcess(), ((DWORD_PTR)1)<<cpu) != 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+/*----------------------------------------------------------------------
+|    GetCpuTime
++---------------------------------------------------------------------*/
+static double
+GetCpuTime()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;   u.HighPart = user.dwHighDateTime;
+    return (double)(k.QuadPart+u.QuadPart)/10000000.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0.0;
+    return (double)usage.ru_utime.tv_sec+(double)usage.ru_utime.tv_usec/1000000.0+
+           (double)usage.ru_stime.tv_sec+(double)usage.ru_stime.tv_usec/1000000.0;
+#endif
+}
+
+/*----------------------------------------------------------------------
+|    GetPeakRss
++---------------------------------------------------------------------*/
+static BLT_UInt64
+GetPeakRss()
+{
+#if defined(_WIN32)
+    return 0; /* not available without psapi */
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#if defined(__APPLE__)
+    return (BLT_UInt64)usage.ru_maxrss/1024; /* bytes on Darwin */
+#else
+    return (BLT_UInt64)usage.ru_maxrss;
+#endif
+#endif
+}
+
+/*----------------------------------------------------------------------
+|    GetNodeStatistic
++---------------------------------------------------------------------*/
+static const ATX_PropertyValue*
+GetNodeStatistic(ATX_Properties*    properties,
+                 unsigned int       index,
+                 const char*        counter,
+                 ATX_PropertyValue* value)
+{
+    char name[64];
+    ATX_FormatStringN(name, sizeof(name),
+                      BLT_STREAM_PROFILING_NODE_PROPERTY_PREFIX "%d.%s",
+                      index, counter);
+    if (ATX_FAILED(ATX_Properties_GetProperty(properties, name, value))) {
+        return NULL;
+    }
+    return value;
+}
+
+/*----------------------------------------------------------------------
+|    FindDecoderNode
+|
+|   look for the decoder in the node statistics published by the stream
++---------------------------------------------------------------------*/
+static void
+FindDecoderNode(BLT_Decoder* decoder, BenchResult* result)
+{
+    ATX_Properties*   properties = NULL;
+    ATX_PropertyValue value;
+
+    if (BLT_FAILED(BLT_Decoder_GetStreamProperties(decoder, &properties))) return;
+
+    for (unsigned int i=0;
+         GetNodeStatistic(properties, i, BLT_STREAM_PROFILING_NODE_GET_PACKET_COUNT, &value);
+         i++) {
+        if (GetNodeStatistic(properties, i, BLT_STREAM_PROFILING_NODE_NAME, &value) == NULL ||
+            value.type != ATX_PROPERTY_VALUE_TYPE_STRING ||
+            strstr(value.data.string, "Decoder") == NULL) {
+            continue;
+        }
+        strncpy(result->decoder, value.data.string, sizeof(result->decoder)-1);
+
+        /* the packets it was given, or produced if it reads a byte stream */
+        if (GetNodeStatistic(properties, i, BLT_STREAM_PROFILING_NODE_PUT_PACKET_COUNT, &value)) {
+            result->packet_count = (BLT_UInt64)value.data.large_integer;
+        }
+        if (result->packet_count == 0 &&
+            GetNodeStatistic(properties, i, BLT_STREAM_PROFILING_NODE_GET_PACKET_COUNT, &value)) {
+            result->packet_count = (BLT_UInt64)value.data.large_integer;
+        }
+
+        BLT_UInt64 nanos = 0;
+        if (GetNodeStatistic(properties, i, BLT_STREAM_PROFILING_NODE_PUT_PACKET_TIME, &value)) {
+            nanos += value.data.large_integer;
+        }
+        if (GetNodeStatistic(properties, i, BLT_STREAM_PROFILING_NODE_GET_PACKET_TIME, &value)) {
+            nanos += value.data.large_integer;
+        }
+        result->decoder_time = (double)nanos/1000000000.0;
+        break;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    RunBenchmark
++---------------------------------------------------------------------*/
+static BLT_Result
+RunBenchmark(const char* input, BenchResult* result)
+{
+    BLT_Decoder*      decoder = NULL;
+    ATX_Properties*   properties = NULL;
+    ATX_PropertyValue value;
+    BLT_Result        status;
+
+    /* create a decoder */
+    status = BLT_Decoder_Create(&decoder);
+    if (BLT_FAILED(status)) return status;
+    BLT_Decoder_RegisterBuiltins(decoder);
+
+    /* the stream profiling counters tell us which decoder is used */
+    BLT_Decoder_GetProperties(decoder, &properties);
+    value.type         = ATX_PROPERTY_VALUE_TYPE_BOOLEAN;
+    value.data.boolean = ATX_TRUE;
+    ATX_Properties_SetProperty(properties, BLT_STREAM_PROFILING_ENABLED_PROPERTY, &value);
+    if (Options.threaded) {
+        ATX_Properties_SetProperty(properties, BLT_STREAM_THREADING_ENABLED_PROPERTY, &value);
+    }
+
+    /* open the input */
+    status = BLT_Decoder_SetInput(decoder, input, NULL);
+    if (BLT_FAILED(status)) {
+        fprintf(stderr, "ERROR: SetInput failed for %s (%d)\n", input, status);
+        BLT_Decoder_Destroy(decoder);
+        return status;
+    }
+
+    /* set the output */
+    status = BLT_Decoder_SetOutput(decoder, Options.output, "audio/pcm");
+    if (BLT_FAILED(status)) {
+        fprintf(stderr, "ERROR: SetOutput failed (%d)\n", status);
+        BLT_Decoder_Destroy(decoder);
+        return status;
+    }
+
+    /* pump packets until there are no more */
+    double     cpu_start  = GetCpuTime();
+    ATX_UInt64 wall_start = BLT_Time_GetMonotonicNanos();
+    for (;;) {
+        status = BLT_Decoder_PumpPacket(decoder);
+        if (status == BLT_ERROR_WOULD_BLOCK || status == BLT_ERROR_PORT_HAS_NO_DATA) {
+            /* the worker threads have nothing for us yet */
+            ATX_TimeInterval sleep_duration = {0, 1000000}; /* 1ms */
+            ATX_System_Sleep(&sleep_duration);
+            continue;
+        }
+        if (BLT_FAILED(status)) break;
+    }
+    result->wall_time = (double)(BLT_Time_GetMonotonicNanos()-wall_start)/1000000000.0;
+    result->cpu_time  = GetCpuTime()-cpu_start;
+    result->peak_rss  = GetPeakRss();
+    result->result    = status == BLT_ERROR_EOS ? BLT_SUCCESS : status;
+
+    /* the stream time stamp is the end of the last decoded packet */
+    BLT_DecoderStatus decoder_status;
+    if (BLT_SUCCEEDED(BLT_Decoder_GetStatus(decoder, &decoder_status))) {
+        result->media_time = BLT_TimeStamp_ToSeconds(decoder_status.time_stamp);
+    }
+    FindDecoderNode(decoder, result);
+
+    /* cleanup */
+    BLT_Decoder_Destroy(decoder);
+
+    return result->result;
+}
+
+/*----------------------------------------------------------------------
+|    UpdateSummary
++---------------------------------------------------------------------*/
+static void
+UpdateSummary(const BenchResult* result)
+{
+    ModuleSummary* summary = NULL;
+    for (unsigned int i=0; i<SummaryCount; i++) {
+        if (!strcmp(Summaries[i].name, result->decoder)) {
+            summary = &Summaries[i];
+            break;
+        }
+    }
+    if (summary == NULL) {
+        if (SummaryCount == BTBENCH_MAX_MODULES) return;
+        summary = &Summaries[SummaryCount++];
+        memset(summary, 0, sizeof(*summary));
+        strcpy(summary->name, result->decoder);
+    }
+    summary->run_count++;
+    summary->media_time   += result->media_time;
+    summary->wall_time    += result->wall_time;
+    summary->cpu_time     += result->cpu_time;
+    summary->packet_count += result->packet_count;
+}
+
+/*----------------------------------------------------------------------
+|    RealTimeFactor
++---------------------------------------------------------------------*/
+static double
+RealTimeFactor(double media_time, double wall_time)
+{
+    return wall_time > 0.0 ? media_time/wall_time : 0.0;
+}
+
+/*----------------------------------------------------------------------
+|    PrintJsonString
++---------------------------------------------------------------------*/
+static void
+PrintJsonString(const char* string)
+{
+    putchar('"');
+    for (; *string; string++) {
+        unsigned char c = (unsigned char)*string;
+        if (c == '"' || c == '\\') {
+            printf("\\%c", c);
+        } else if (c < 0x20) {
+            printf("\\u%04x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+/*----------------------------------------------------------------------
+|    PrintResult
++---------------------------------------------------------------------*/
+static void
+PrintResult(const BenchResult* result, bool first)
+{
+    double packet_rate = result->wall_time > 0.0 ?
+                         (double)result->packet_count/result->wall_time : 0.0;
+    if (Options.json) {
+        printf("%s\n    {\"input\": ", first?"":",");
+        PrintJsonString(result->input);
+        printf(", \"run\": %u, \"result\": %d, \"decoder\": ", result->run, result->result);
+        PrintJsonString(result->decoder);
+        printf(", \"media_time\": %.6f, \"wall_time\": %.6f, \"cpu_time\": %.6f, "
+               "\"decoder_time\": %.6f, \"real_time_factor\": %.2f, \"packets\": %llu, "
+               "\"packets_per_second\": %.1f, \"peak_rss_kb\": %llu}",
+               result->media_time,
+               result->wall_time,
+               result->cpu_time,
+               result->decoder_time,
+               RealTimeFactor(result->media_time, result->wall_time),
+               (unsigned long long)result->packet_count,
+               packet_rate,
+               (unsigned long long)result->peak_rss);
+    } else {
+        printf("%s [run %u] %s: %s\n",
+               result->input,
+               result->run,
+               result->decoder,
+               BLT_SUCCEEDED(result->result)?"ok":"FAILED");
+        printf("  media=%.3fs wall=%.3fs cpu=%.3fs decoder=%.3fs rtf=%.2fx "
+               "packets=%llu (%.1f/s) peak_rss=%llukB\n",
+               result->media_time,
+               result->wall_time,
+               result->cpu_time,
+               result->decoder_time,
+               RealTimeFactor(result->media_time, result->wall_time),
+               (unsigned long long)result->packet_count,
+               packet_rate,
+               (unsigned long long)result->peak_rss);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    PrintSummaries
++---------------------------------------------------------------------*/
+static void
+PrintSummaries()
+{
+    if (Options.json) {
+        printf("\n  ],\n  \"modules\": [");
+    } else {
+        printf("\nper decoder module:\n");
+    }
+    for (unsigned int i=0; i<SummaryCount; i++) {
+        const ModuleSummary* summary = &Summaries[i];
+        if (Options.json) {
+            printf("%s\n    {\"decoder\": ", i?",":"");
+            PrintJsonString(summary->name);
+            printf(", \"runs\": %u, \"media_time\": %.6f, \"wall_time\": %.6f, "
+                   "\"cpu_time\": %.6f, \"real_time_factor\": %.2f, \"packets\": %llu}",
+                   summary->run_count,
+                   summary->media_time,
+                   summary->wall_time,
+                   summary->cpu_time,
+                   RealTimeFactor(summary->media_time, summary->wall_time),
+                   (unsigned long long)summary->packet_count);
+        } else {
+            printf("  %s: runs=%u media=%.3fs wall=%.3fs cpu=%.3fs rtf=%.2fx packets=%llu\n",
+                   summary->name,
+                   summary->run_count,
+                   summary->media_time,
+                   summary->wall_time,
+                   summary->cpu_time,
+                   RealTimeFactor(summary->media_time, summary->wall_time),
+                   (unsigned long long)summary->packet_count);
+        }
+    }
+    if (Options.json) printf("\n  ]\n}\n");
+}
+
+/*----------------------------------------------------------------------
+|    main
++---------------------------------------------------------------------*/
+int
+main(int argc, char** argv)
+{
+    int exit_code = 0;
+
+    // parse command line
+    ParseCommandLine(argc, argv);
+
+    // pin to a core if requested
+    if (Options.cpu >= 0 && !PinToCpu(Options.cpu)) {
+        fprintf(stderr, "WARNING: cannot pin to CPU %d\n", Options.cpu);
+    }
+
+    if (Options.json) printf("{\n  \"runs\": [");
+    bool first = true;
+    for (unsigned int i=0; i<Options.input_count; i++) {
+        for (unsigned int run=0; run<Options.repeat; run++) {
+            BenchResult result;
+            memset(&result, 0, sizeof(result));
+            result.input = Options.inputs[i];
+            result.run   = run;
+            strcpy(result.decoder, "unknown");
+            BLT_Result status = RunBenchmark(Options.inputs[i], &result);
+            PrintResult(&result, first);
+            first = false;
+            if (BLT_FAILED(status)) {
+                // no point in repeating a run that can't even start
+                exit_code = 1;
+                if (result.packet_count == 0) break;
+            } else {
+                UpdateSummary(&result);
+            }
+        }
+    }
+    PrintSummaries();
+
+    delete[] Options.inputs;
+    return exit_code;
+}
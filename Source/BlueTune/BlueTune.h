@@ -113,6 +113,7 @@ See the BLT_Player class for details.
 #include "BltRegistry.h"
 #include "BltCore.h"
 #include "BltStream.h"
+#include "BltThreads.h"
 #include "BltTime.h"
 #include "BltMedia.h"
 #include "BltMediaNode.h"
@@ -32,18 +32,58 @@
 +---------------------------------------------------------------------*/
 ATX_SET_LOCAL_LOGGER("bluetune.core")
 
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* number of entries in the cache of resolved node constructors */
+#if !defined(BLT_CONFIG_CORE_NODE_CACHE_SIZE)
+#define BLT_CONFIG_CORE_NODE_CACHE_SIZE 32
+#endif
+
+/* number of buckets in the tables of declared module inputs */
+#define BLT_CORE_MODULE_INPUTS_BUCKET_COUNT 32
+
 /*----------------------------------------------------------------------
 |    types
 +---------------------------------------------------------------------*/
+typedef struct {
+    BLT_MediaPortProtocol input_protocol;
+    BLT_MediaType*        input_type;  /* copy, with the extension */
+    BLT_MediaPortProtocol output_protocol;
+    BLT_MediaType*        output_type; /* copy, with the extension */
+    BLT_Module*           module; /* NULL when the entry is free */
+} CoreNodeCacheEntry;
+
+typedef struct CoreModuleInput {
+    BLT_Module*             module;
+    BLT_MediaPortProtocol   protocol;
+    BLT_MediaTypeId         type_id;
+    struct CoreModuleInput* next_for_type;   /* same bucket in by_type   */
+    struct CoreModuleInput* next_for_module; /* same bucket in by_module */
+} CoreModuleInput;
+
 typedef struct {
     /* interfaces */
     ATX_IMPLEMENTS(BLT_Core);
     ATX_IMPLEMENTS(ATX_Destroyable);
+    ATX_IMPLEMENTS(ATX_PropertyListener);
 
     /* members */
-    BLT_Registry*   registry;
-    ATX_Properties* properties;
-    ATX_List*       modules;
+    BLT_Registry*              registry;
+    ATX_Properties*            properties;
+    ATX_List*                  modules;
+    BLT_MediaPacketPool*       packet_pool;
+    ATX_PropertyListenerHandle packet_pool_listener_handle;
+    struct {
+        CoreNodeCacheEntry entries[BLT_CONFIG_CORE_NODE_CACHE_SIZE];
+        BLT_Ordinal        next; /* next entry to replace */
+    }                          node_cache;
+    struct {
+        /* each input is in both tables, hashed on its type id */
+        /* and on its module                                   */
+        CoreModuleInput* by_type[BLT_CORE_MODULE_INPUTS_BUCKET_COUNT];
+        CoreModuleInput* by_module[BLT_CORE_MODULE_INPUTS_BUCKET_COUNT];
+    }                          module_inputs;
 } Core;
 
 /*----------------------------------------------------------------------
@@ -51,6 +91,9 @@ typedef struct {
 +---------------------------------------------------------------------*/
 ATX_DECLARE_INTERFACE_MAP(Core, BLT_Core)
 ATX_DECLARE_INTERFACE_MAP(Core, ATX_Destroyable)
+ATX_DECLARE_INTERFACE_MAP(Core, ATX_PropertyListener)
+static void Core_InvalidateNodeCache(Core* self);
+static void Core_ForgetModuleInputs(Core* self, BLT_Module* module);
 
 /*----------------------------------------------------------------------
 |    Core_Create
@@ -90,11 +133,28 @@ Core_Create(BLT_Core** object)
         return result;
     }
 
+    /* create the packet pool */
+    result = BLT_MediaPacketPool_Create(&core->packet_pool);
+    if (BLT_FAILED(result)) {
+        ATX_List_Destroy(core->modules);
+        ATX_DESTROY_OBJECT(core->registry);
+        *object = NULL;
+        ATX_FreeMemory(core);
+        return result;
+    }
+
     /* setup interfaces */
     ATX_SET_INTERFACE(core, Core, BLT_Core);
     ATX_SET_INTERFACE(core, Core, ATX_Destroyable);
+    ATX_SET_INTERFACE(core, Core, ATX_PropertyListener);
     *object = &ATX_BASE(core, BLT_Core);
 
+    /* listen for changes to the packet pool switch */
+    ATX_Properties_AddListener(core->properties,
+                               BLT_CORE_PACKET_POOL_ENABLED_PROPERTY,
+                               &ATX_BASE(core, ATX_PropertyListener),
+                               &core->packet_pool_listener_handle);
+
     return BLT_SUCCESS;
 }
 
@@ -119,9 +179,20 @@ Core_Destroy(ATX_Destroyable* _self)
     /* delete the module list */
     ATX_List_Destroy(core->modules);
 
+    /* free the cached node constructors */
+    Core_InvalidateNodeCache(core);
+
+    /* free the declared module inputs */
+    Core_ForgetModuleInputs(core, NULL);
+
     /* destroy the properties */
+    ATX_Properties_RemoveListener(core->properties, 
+                                  core->packet_pool_listener_handle);
     ATX_DESTROY_OBJECT(core->properties);
 
+    /* destroy the packet pool (packets still in use will keep it alive) */
+    BLT_MediaPacketPool_Destroy(core->packet_pool);
+
     /* destroy the registry */
     BLT_Registry_Destroy(core->registry);
 
@@ -157,6 +228,9 @@ Core_RegisterModule(BLT_Core* _self, BLT_Module* module)
     /* keep a reference to the object */
     ATX_REFERENCE_OBJECT(module);
     
+    /* a new module may be a better match for previously resolved types */
+    Core_InvalidateNodeCache(self);
+
     /* attach the module to the core */
     result = BLT_Module_Attach(module, _self);
     if (BLT_FAILED(result)) return result;
@@ -172,6 +246,12 @@ Core_UnRegisterModule(BLT_Core* _self, BLT_Module* module)
 {
     Core* self = ATX_SELF(Core, BLT_Core);
 
+    /* the cache may point to this module */
+    Core_InvalidateNodeCache(self);
+
+    /* forget the inputs declared by this module */
+    Core_ForgetModuleInputs(self, module);
+
     /* release the reference */
     ATX_RELEASE_OBJECT(module);
     
@@ -223,10 +303,251 @@ BLT_METHOD
 Core_GetProperties(BLT_Core* _self, ATX_Properties** properties)
 {
     Core* self = ATX_SELF(Core, BLT_Core);
+
     *properties = self->properties;
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    BLT_Core_PublishPacketPoolStats
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_Core_PublishPacketPoolStats(BLT_Core* _self)
+{
+    Core*                    self = ATX_SELF(Core, BLT_Core);
+    BLT_MediaPacketPoolStats stats;
+    ATX_PropertyValue        value;
+    
+    BLT_MediaPacketPool_GetStats(self->packet_pool, &stats);
+    value.type = ATX_PROPERTY_VALUE_TYPE_LARGE_INTEGER;
+    value.data.large_integer = (ATX_Int64)stats.hits;
+    ATX_Properties_SetProperty(self->properties, 
+                               BLT_CORE_PACKET_POOL_HITS_PROPERTY, 
+                               &value);
+    value.data.large_integer = (ATX_Int64)stats.misses;
+    ATX_Properties_SetProperty(self->properties, 
+                               BLT_CORE_PACKET_POOL_MISSES_PROPERTY, 
+                               &value);
+    value.type = ATX_PROPERTY_VALUE_TYPE_INTEGER;
+    value.data.integer = (ATX_Int32)stats.bytes_held;
+    ATX_Properties_SetProperty(self->properties, 
+                               BLT_CORE_PACKET_POOL_BYTES_HELD_PROPERTY, 
+                               &value);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Core_GetTypeBucket
++---------------------------------------------------------------------*/
+static unsigned int
+Core_GetTypeBucket(BLT_MediaTypeId type_id)
+{
+    return type_id%BLT_CORE_MODULE_INPUTS_BUCKET_COUNT;
+}
+
+/*----------------------------------------------------------------------
+|    Core_GetModuleBucket
++---------------------------------------------------------------------*/
+static unsigned int
+Core_GetModuleBucket(const BLT_Module* module)
+{
+    /* the low bits of an object address are always the same */
+    return ((unsigned int)((ATX_IntPtr)module>>4))%BLT_CORE_MODULE_INPUTS_BUCKET_COUNT;
+}
+
+/*----------------------------------------------------------------------
+|    Core_DeclareModuleInput
++---------------------------------------------------------------------*/
+BLT_METHOD
+Core_DeclareModuleInput(BLT_Core*             _self,
+                        BLT_Module*           module,
+                        BLT_MediaPortProtocol protocol,
+                        BLT_MediaTypeId       type_id)
+{
+    Core*            self = ATX_SELF(Core, BLT_Core);
+    CoreModuleInput* input;
+    unsigned int     type_bucket   = Core_GetTypeBucket(type_id);
+    unsigned int     module_bucket = Core_GetModuleBucket(module);
+
+    input = (CoreModuleInput*)ATX_AllocateMemory(sizeof(CoreModuleInput));
+    if (input == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    input->module   = module;
+    input->protocol = protocol;
+    input->type_id  = type_id;
+
+    /* add it to both tables */
+    input->next_for_type   = self->module_inputs.by_type[type_bucket];
+    input->next_for_module = self->module_inputs.by_module[module_bucket];
+    self->module_inputs.by_type[type_bucket]     = input;
+    self->module_inputs.by_module[module_bucket] = input;
+
+    /* the set of candidates for previously resolved types may change */
+    Core_InvalidateNodeCache(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Core_ForgetModuleInputs
+|
+|   frees the inputs declared by a module, or by all modules if NULL
++---------------------------------------------------------------------*/
+static void
+Core_ForgetModuleInputs(Core* self, BLT_Module* module)
+{
+    unsigned int b;
+
+    /* unlink them from the type table */
+    for (b=0; b<BLT_CORE_MODULE_INPUTS_BUCKET_COUNT; b++) {
+        CoreModuleInput** link = &self->module_inputs.by_type[b];
+        while (*link) {
+            if (module == NULL || (*link)->module == module) {
+                *link = (*link)->next_for_type;
+            } else {
+                link = &(*link)->next_for_type;
+            }
+        }
+    }
+
+    /* unlink them from the module table, and free them */
+    for (b=0; b<BLT_CORE_MODULE_INPUTS_BUCKET_COUNT; b++) {
+        CoreModuleInput** link = &self->module_inputs.by_module[b];
+        while (*link) {
+            CoreModuleInput* input = *link;
+            if (module == NULL || input->module == module) {
+                *link = input->next_for_module;
+                ATX_FreeMemory(input);
+            } else {
+                link = &input->next_for_module;
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Core_IsModuleCandidate
+|
+|   a module that has declared its inputs is only a candidate for 
+|   constructors with a matching input, other modules always are
++---------------------------------------------------------------------*/
+static BLT_Boolean
+Core_IsModuleCandidate(Core*                           self, 
+                       BLT_Module*                     module,
+                       const BLT_MediaNodeConstructor* constructor)
+{
+    const BLT_MediaPortInterfaceSpec* input = &constructor->spec.input;
+    const CoreModuleInput*            entry;
+
+    if (input->media_type == NULL) return BLT_TRUE;
+
+    /* look for a matching input among the ones declared for this type */
+    for (entry = self->module_inputs.by_type[Core_GetTypeBucket(input->media_type->id)];
+         entry;
+         entry = entry->next_for_type) {
+        if (entry->module  != module || 
+            entry->type_id != input->media_type->id) {
+            continue;
+        }
+        if (entry->protocol == BLT_MEDIA_PORT_PROTOCOL_ANY ||
+            input->protocol == BLT_MEDIA_PORT_PROTOCOL_ANY ||
+            entry->protocol == input->protocol) {
+            return BLT_TRUE;
+        }
+    }
+
+    /* no match, the module is only a candidate if it declared nothing */
+    for (entry = self->module_inputs.by_module[Core_GetModuleBucket(module)];
+         entry;
+         entry = entry->next_for_module) {
+        if (entry->module == module) return BLT_FALSE;
+    }
+
+    return BLT_TRUE;
+}
+
+/*----------------------------------------------------------------------
+|    Core_InvalidateNodeCache
++---------------------------------------------------------------------*/
+static void
+Core_InvalidateNodeCache(Core* self)
+{
+    unsigned int i;
+
+    for (i=0; i<BLT_CONFIG_CORE_NODE_CACHE_SIZE; i++) {
+        CoreNodeCacheEntry* entry = &self->node_cache.entries[i];
+        BLT_MediaType_Free(entry->input_type);
+        BLT_MediaType_Free(entry->output_type);
+    }
+    ATX_SetMemory(&self->node_cache, 0, sizeof(self->node_cache));
+}
+
+/*----------------------------------------------------------------------
+|    Core_IsNodeCacheable
++---------------------------------------------------------------------*/
+static BLT_Boolean
+Core_IsNodeCacheable(const BLT_MediaNodeConstructor* constructor)
+{
+    /* only anonymous constructors with typed ends can be cached */
+    return constructor->name                    == NULL &&
+           constructor->spec.input.media_type  != NULL &&
+           constructor->spec.output.media_type != NULL;
+}
+
+/*----------------------------------------------------------------------
+|    Core_FindNodeCacheEntry
++---------------------------------------------------------------------*/
+static CoreNodeCacheEntry*
+Core_FindNodeCacheEntry(Core* self, const BLT_MediaNodeConstructor* constructor)
+{
+    const BLT_MediaNodeSpec* spec = &constructor->spec;
+    CoreNodeCacheEntry*      entry;
+    unsigned int             i;
+
+    if (!Core_IsNodeCacheable(constructor)) return NULL;
+
+    /* look for a match on the complete spec, since the probe scores */
+    /* may depend on the type extensions                             */
+    for (i=0; i<BLT_CONFIG_CORE_NODE_CACHE_SIZE; i++) {
+        entry = &self->node_cache.entries[i];
+        if (entry->module                                                 &&
+            entry->input_protocol  == spec->input.protocol                &&
+            entry->output_protocol == spec->output.protocol               &&
+            BLT_MediaType_Equals(entry->input_type, spec->input.media_type) &&
+            BLT_MediaType_Equals(entry->output_type, spec->output.media_type)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------
+|    Core_AddNodeCacheEntry
++---------------------------------------------------------------------*/
+static void
+Core_AddNodeCacheEntry(Core*                           self, 
+                       const BLT_MediaNodeConstructor* constructor,
+                       BLT_Module*                     module)
+{
+    const BLT_MediaNodeSpec* spec = &constructor->spec;
+    CoreNodeCacheEntry*      entry;
+
+    if (!Core_IsNodeCacheable(constructor)) return;
+
+    /* replace the oldest entry */
+    entry = &self->node_cache.entries[self->node_cache.next];
+    self->node_cache.next = (self->node_cache.next+1)%BLT_CONFIG_CORE_NODE_CACHE_SIZE;
+    BLT_MediaType_Free(entry->input_type);
+    BLT_MediaType_Free(entry->output_type);
+    entry->module          = NULL;
+    entry->input_protocol  = spec->input.protocol;
+    entry->output_protocol = spec->output.protocol;
+    BLT_MediaType_Clone(spec->input.media_type,  &entry->input_type);
+    BLT_MediaType_Clone(spec->output.media_type, &entry->output_type);
+    if (entry->input_type && entry->output_type) entry->module = module;
+}
+
 /*----------------------------------------------------------------------
 |    Core_CreateCompatibleNode
 +---------------------------------------------------------------------*/
@@ -235,11 +556,35 @@ Core_CreateCompatibleNode(BLT_Core*                 _self,
                           BLT_MediaNodeConstructor* constructor,
                           BLT_MediaNode**           node)
 {
-    Core*         core        = ATX_SELF(Core, BLT_Core);
-    ATX_ListItem* item        = ATX_List_GetFirstItem(core->modules);
-    int           best_match  = -1;
-    BLT_Module*   best_module = NULL;
-            
+    Core*               core        = ATX_SELF(Core, BLT_Core);
+    ATX_ListItem*       item        = ATX_List_GetFirstItem(core->modules);
+    int                 best_match  = -1;
+    BLT_Module*         best_module = NULL;
+    CoreNodeCacheEntry* cache_entry = Core_FindNodeCacheEntry(core, constructor);
+    
+    /* if this exact spec was resolved before with the same modules, the */
+    /* best match can't have changed, just check that it still accepts it */
+    if (cache_entry && cache_entry->module) {
+        BLT_Cardinal match;
+        if (BLT_SUCCEEDED(BLT_Module_Probe(cache_entry->module,
+                                           _self,
+                                           BLT_MODULE_PARAMETERS_TYPE_MEDIA_NODE_CONSTRUCTOR,
+                                           constructor,
+                                           &match))) {
+            ATX_LOG_FINER("Core::CreateCompatibleNode - cache hit");
+            return BLT_Module_CreateInstance(
+                cache_entry->module, 
+                _self, 
+                BLT_MODULE_PARAMETERS_TYPE_MEDIA_NODE_CONSTRUCTOR, 
+                constructor,
+                &ATX_INTERFACE_ID__BLT_MediaNode,
+                (ATX_Object**)node);
+        }
+
+        /* the module doesn't want it anymore, forget about it */
+        cache_entry->module = NULL;
+    }
+
     /* find a module that responds to the probe */
     while (item) {
         BLT_Result   result;
@@ -248,6 +593,10 @@ Core_CreateCompatibleNode(BLT_Core*                 _self,
 
         /* get the module object from the list */
         module = (BLT_Module*)ATX_ListItem_GetData(item);
+        item   = ATX_ListItem_GetNext(item);
+
+        /* skip modules that have declared other inputs */
+        if (!Core_IsModuleCandidate(core, module, constructor)) continue;
 
         /* probe the module */
         result = BLT_Module_Probe(
@@ -264,9 +613,6 @@ Core_CreateCompatibleNode(BLT_Core*                 _self,
                 best_module = module;
             }
         }
-
-        /* move on to the next module */
-        item = ATX_ListItem_GetNext(item);
     }
 
     if (best_match == -1) {
@@ -274,6 +620,9 @@ Core_CreateCompatibleNode(BLT_Core*                 _self,
         return BLT_ERROR_NO_MATCHING_MODULE;
     }
 
+    /* remember the module for the next time */
+    Core_AddNodeCacheEntry(core, constructor, best_module);
+
     /* create a node instance */
     return BLT_Module_CreateInstance(
         best_module, 
@@ -288,13 +637,38 @@ Core_CreateCompatibleNode(BLT_Core*                 _self,
 |    Core_CreateMediaPacket
 +---------------------------------------------------------------------*/
 BLT_METHOD
-Core_CreateMediaPacket(BLT_Core*            self,
+Core_CreateMediaPacket(BLT_Core*            _self,
                        BLT_Size             size,
                        const BLT_MediaType* type,
                        BLT_MediaPacket**    packet)
 {       
-    BLT_COMPILER_UNUSED(self);
-    return BLT_MediaPacket_Create(size, type, packet);
+    Core* self = ATX_SELF(Core, BLT_Core);
+    return BLT_MediaPacketPool_CreatePacket(self->packet_pool, size, type, packet);
+}
+
+/*----------------------------------------------------------------------
+|    Core_OnPropertyChanged
++---------------------------------------------------------------------*/
+BLT_VOID_METHOD
+Core_OnPropertyChanged(ATX_PropertyListener*    _self,
+                       ATX_CString              name,
+                       const ATX_PropertyValue* value)
+{
+    Core* self = ATX_SELF(Core, ATX_PropertyListener);
+
+    if (name && ATX_StringsEqual(name, BLT_CORE_PACKET_POOL_ENABLED_PROPERTY)) {
+        BLT_Boolean enabled = BLT_TRUE;
+        if (value) {
+            if (value->type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN) {
+                enabled = value->data.boolean?BLT_TRUE:BLT_FALSE;
+            } else if (value->type == ATX_PROPERTY_VALUE_TYPE_INTEGER) {
+                enabled = value->data.integer?BLT_TRUE:BLT_FALSE;
+            }
+        }
+        ATX_LOG_FINE_1("Core::OnPropertyChanged - packet pool %s", 
+                       enabled?"enabled":"disabled");
+        BLT_MediaPacketPool_SetEnabled(self->packet_pool, enabled);
+    }
 }
 
 /*----------------------------------------------------------------------
@@ -357,6 +731,7 @@ Core_ParseMimeType(BLT_Core*       _self,
 ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(Core)
     ATX_GET_INTERFACE_ACCEPT(Core, BLT_Core)
     ATX_GET_INTERFACE_ACCEPT(Core, ATX_Destroyable)
+    ATX_GET_INTERFACE_ACCEPT(Core, ATX_PropertyListener)
 ATX_END_GET_INTERFACE_IMPLEMENTATION
 
 /*----------------------------------------------------------------------
@@ -371,7 +746,15 @@ ATX_BEGIN_INTERFACE_MAP(Core, BLT_Core)
     Core_GetProperties,
     Core_CreateCompatibleNode,
     Core_CreateMediaPacket,
-    Core_ParseMimeType
+    Core_ParseMimeType,
+    Core_DeclareModuleInput
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    ATX_PropertyListener interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(Core, ATX_PropertyListener)
+    Core_OnPropertyChanged
 ATX_END_INTERFACE_MAP
 
 /*----------------------------------------------------------------------
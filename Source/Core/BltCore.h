@@ -22,6 +22,7 @@
 #include "BltErrors.h"
 #include "BltRegistry.h"
 #include "BltMediaPacket.h"
+#include "BltMediaPort.h"
 
 /*----------------------------------------------------------------------
 |   constants
@@ -34,6 +35,19 @@
 #define BLT_MODULE_CATEGORY_FILTER    0x20
 #define BLT_MODULE_CATEGORY_OUTPUT    0x40
 
+/**
+ * Core property used to enable (default) or disable the media packet pool.
+ * Disabling the pool makes every packet a separate allocation, which can be
+ * useful when tracking memory errors.
+ */
+#define BLT_CORE_PACKET_POOL_ENABLED_PROPERTY    "Core.PacketPool.Enabled"
+
+/* read-only packet pool statistics, refreshed by the streams every few
+ * seconds while they pump packets, and when they stop */
+#define BLT_CORE_PACKET_POOL_HITS_PROPERTY       "Core.PacketPool.Hits"
+#define BLT_CORE_PACKET_POOL_MISSES_PROPERTY     "Core.PacketPool.Misses"
+#define BLT_CORE_PACKET_POOL_BYTES_HELD_PROPERTY "Core.PacketPool.BytesHeld"
+
 /*----------------------------------------------------------------------
 |   references
 +---------------------------------------------------------------------*/
@@ -67,6 +81,18 @@ ATX_BEGIN_INTERFACE_DEFINITION(BLT_Core)
     BLT_Result (*ParseMimeType)(BLT_Core*       self, 
                                 const char*     mime_type, 
                                 BLT_MediaType** media_type);
+    /**
+     * Declare an input protocol and media type that a module accepts when
+     * probed with a media node constructor. Modules call this from their
+     * Attach method. Once a module has declared at least one input, the
+     * core only probes it for constructors with a matching input, so a
+     * module must declare every input its Probe method can accept.
+     * Modules that don't declare anything are probed for all constructors.
+     */
+    BLT_Result (*DeclareModuleInput)(BLT_Core*             self,
+                                     BLT_Module*           module,
+                                     BLT_MediaPortProtocol protocol,
+                                     BLT_MediaTypeId       type_id);
 ATX_END_INTERFACE_DEFINITION
 
 /*----------------------------------------------------------------------
@@ -99,6 +125,9 @@ ATX_INTERFACE(object)->CreateMediaPacket(object, size, type, packet)
 #define BLT_Core_ParseMimeType(object, mime_type, media_type)\
 ATX_INTERFACE(object)->ParseMimeType(object, mime_type, media_type)
 
+#define BLT_Core_DeclareModuleInput(object, module, protocol, type_id)\
+ATX_INTERFACE(object)->DeclareModuleInput(object, module, protocol, type_id)
+
 #define BLT_Core_Destroy(object) ATX_DESTROY_OBJECT(object)
 
 #endif /* _BLT_CORE_H_ */
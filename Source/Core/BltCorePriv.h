@@ -19,6 +19,7 @@
 |   functions
 +---------------------------------------------------------------------*/
 BLT_Result BLT_Core_Create(BLT_Core** core);
+BLT_Result BLT_Core_PublishPacketPoolStats(BLT_Core* core);
 
 /*----------------------------------------------------------------------
 |   prototypes
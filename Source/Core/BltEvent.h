@@ -32,7 +32,8 @@ typedef enum {
     BLT_EVENT_TYPE_DEBUG,
     BLT_EVENT_TYPE_STREAM_TOPOLOGY,
     BLT_EVENT_TYPE_STREAM_INFO,
-    BLT_EVENT_TYPE_DECODING_ERROR
+    BLT_EVENT_TYPE_DECODING_ERROR,
+    BLT_EVENT_TYPE_NODE_READY
 } BLT_EventType;
 
 typedef struct BLT_Event BLT_Event;
@@ -75,4 +76,15 @@ typedef struct {
     BLT_CString message;
 } BLT_DecodingErrorEvent;
 
+/**
+ * Sent by a node, possibly from another thread, when an operation that
+ * previously returned BLT_ERROR_WOULD_BLOCK or BLT_ERROR_PORT_HAS_NO_DATA
+ * may now succeed (the output has buffer space, the network has data, ...).
+ * Listeners must not call back into the stream from this event, and nodes
+ * must not hold any lock that the decoding thread may need when sending it.
+ */
+typedef struct {
+    BLT_MediaNode* node;
+} BLT_NodeReadyEvent;
+
 #endif /* _BLT_EVENT_H_ */
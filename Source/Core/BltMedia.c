@@ -90,6 +90,7 @@ BLT_MediaType_Clone(const BLT_MediaType* from, BLT_MediaType** to)
 BLT_Boolean
 BLT_MediaType_Equals(const BLT_MediaType* self, const BLT_MediaType* other)
 {
+    if (self == other) return self ? BLT_TRUE : BLT_FALSE;
     if (self == NULL || other == NULL) return BLT_FALSE;
     if (self->extension_size != other->extension_size) return BLT_FALSE;
     if (ATX_CompareMemory(self, other, sizeof(BLT_MediaType)+self->extension_size)) return BLT_FALSE;
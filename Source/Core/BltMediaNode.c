@@ -20,6 +20,8 @@
 #include "BltErrors.h"
 #include "BltCore.h"
 #include "BltMediaNode.h"
+#include "BltEvent.h"
+#include "BltEventListener.h"
 
 /*----------------------------------------------------------------------
 |    BLT_BaseMediaNode_Construct
@@ -158,3 +160,26 @@ BLT_BaseMediaNode_Seek(BLT_MediaNode* self,
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    BLT_BaseMediaNode_SignalReady
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_BaseMediaNode_SignalReady(BLT_BaseMediaNode* self)
+{
+    BLT_EventListener* listener;
+    BLT_NodeReadyEvent event;
+
+    /* the stream forwards the event to its own listener */
+    if (self->context == NULL) return BLT_ERROR_INVALID_STATE;
+    listener = ATX_CAST(self->context, BLT_EventListener);
+    if (listener == NULL) return BLT_ERROR_NOT_SUPPORTED;
+
+    event.node = &ATX_BASE(self, BLT_MediaNode);
+    BLT_EventListener_OnEvent(listener, 
+                              (ATX_Object*)self, 
+                              BLT_EVENT_TYPE_NODE_READY, 
+                              (const BLT_Event*)(const void*)&event);
+
+    return BLT_SUCCESS;
+}
+
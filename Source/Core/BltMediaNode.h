@@ -182,6 +182,7 @@ BLT_Result BLT_BaseMediaNode_Resume(BLT_MediaNode* self);
 BLT_Result BLT_BaseMediaNode_Seek(BLT_MediaNode* self, 
                                   BLT_SeekMode*  mode,
                                   BLT_SeekPoint* point);
+BLT_Result BLT_BaseMediaNode_SignalReady(BLT_BaseMediaNode* self);
 
 #if defined(__cplusplus)
 }
@@ -13,6 +13,8 @@
 /*----------------------------------------------------------------------
 |    includes
 +---------------------------------------------------------------------*/
+#include <stddef.h>
+
 #include "Atomix.h"
 #include "BltTypes.h"
 #include "BltDefs.h"
@@ -20,29 +22,233 @@
 #include "BltCore.h"
 #include "BltMedia.h"
 #include "BltMediaPacketPriv.h"
+#include "BltThreadsPriv.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* size classes are powers of two, from 2^MIN to 2^MAX bytes */
+#define BLT_MEDIA_PACKET_POOL_MIN_CLASS_SHIFT   8
+#define BLT_MEDIA_PACKET_POOL_MAX_CLASS_SHIFT   18
+#define BLT_MEDIA_PACKET_POOL_CLASS_COUNT       \
+    (BLT_MEDIA_PACKET_POOL_MAX_CLASS_SHIFT-BLT_MEDIA_PACKET_POOL_MIN_CLASS_SHIFT+1)
+
+/* max number of free packets kept in each size class */
+#if !defined(BLT_CONFIG_MEDIA_PACKET_POOL_MAX_PACKETS_PER_CLASS)
+#define BLT_CONFIG_MEDIA_PACKET_POOL_MAX_PACKETS_PER_CLASS 32
+#endif
+
+/* number of hash buckets for the interned media types */
+#define BLT_MEDIA_PACKET_POOL_TYPE_BUCKET_COUNT 32
 
 /*----------------------------------------------------------------------
 |    types
 +---------------------------------------------------------------------*/
+/* immutable media type shared by all the packets of a pool that have */
+/* the same type. Each one keeps a reference to the pool.              */
+typedef struct BLT_InternedMediaType {
+    BLT_Cardinal                  reference_count;
+    BLT_UInt32                    hash;
+    struct BLT_InternedMediaType* next; /* next in the hash bucket */
+    BLT_MediaPacketPool*          pool;
+    union {
+        BLT_MediaType base;
+        ATX_UInt64    alignment; /* for the extension that follows */
+        double        alignment_double;
+    }                             type;
+} BLT_InternedMediaType;
+
+struct BLT_MediaPacketPool {
+    BLT_Mutex*               lock; /* packets may be released on any thread */
+    BLT_Cardinal             reference_count;
+    BLT_Boolean              enabled;
+    BLT_MediaPacket*         free_packets[BLT_MEDIA_PACKET_POOL_CLASS_COUNT];
+    BLT_Cardinal             free_packet_count[BLT_MEDIA_PACKET_POOL_CLASS_COUNT];
+    BLT_InternedMediaType*   types[BLT_MEDIA_PACKET_POOL_TYPE_BUCKET_COUNT];
+    BLT_MediaPacketPoolStats stats;
+};
+
 struct BLT_MediaPacket {
-    BLT_Cardinal   reference_count;
-    BLT_MediaType* type;
-    BLT_Size       allocated_size;
-    BLT_Size       payload_size;
-    BLT_Offset     payload_offset;
-    BLT_Any        payload;
-    BLT_Flags      flags;
-    BLT_TimeStamp  time_stamp;
-    BLT_Time       duration;
+    BLT_AtomicCounter    reference_count; /* views share packets across threads */
+    BLT_MediaPacketPool* pool;      /* pool to return to, or NULL */
+    BLT_MediaPacket*     next_free; /* link in the pool free list */
+    BLT_MediaPacket*     parent;    /* packet whose buffer we view */
+    struct {
+        BLT_MediaPacket_ReleaseBufferCallback callback;
+        BLT_Any                               instance;
+    }                    external;  /* owner of an external buffer */
+    BLT_MediaType*       type;
+    BLT_Boolean          type_interned; /* type is shared, don't modify it */
+    BLT_Size             allocated_size;
+    BLT_Size             payload_size;
+    BLT_Offset           payload_offset;
+    BLT_Any              payload;
+    BLT_Flags            flags;
+    BLT_TimeStamp        time_stamp;
+    BLT_Time             duration;
 };
 
 /*----------------------------------------------------------------------
-|    BLT_MediaPacket_Create
+|    forward declarations
 +---------------------------------------------------------------------*/
-BLT_Result
-BLT_MediaPacket_Create(BLT_Size             size,
-                       const BLT_MediaType* type,
-                       BLT_MediaPacket**    packet)
+static void BLT_MediaPacketPool_Release(BLT_MediaPacketPool* self);
+
+/*----------------------------------------------------------------------
+|    BLT_InternedMediaType_FromType
++---------------------------------------------------------------------*/
+static BLT_InternedMediaType*
+BLT_InternedMediaType_FromType(BLT_MediaType* type)
+{
+    return (BLT_InternedMediaType*)((char*)type-offsetof(BLT_InternedMediaType, type));
+}
+
+/*----------------------------------------------------------------------
+|    BLT_InternedMediaType_AddReference
++---------------------------------------------------------------------*/
+static void
+BLT_InternedMediaType_AddReference(BLT_InternedMediaType* self)
+{
+    BLT_Mutex_Lock(self->pool->lock);
+    ++self->reference_count;
+    BLT_Mutex_Unlock(self->pool->lock);
+}
+
+/*----------------------------------------------------------------------
+|    BLT_InternedMediaType_Release
++---------------------------------------------------------------------*/
+static void
+BLT_InternedMediaType_Release(BLT_InternedMediaType* self)
+{
+    BLT_MediaPacketPool* pool = self->pool;
+    BLT_Boolean          last;
+
+    BLT_Mutex_Lock(pool->lock);
+    last = (--self->reference_count == 0);
+    if (last) {
+        /* remove the type from its bucket */
+        BLT_InternedMediaType** link = &pool->types[self->hash%BLT_MEDIA_PACKET_POOL_TYPE_BUCKET_COUNT];
+        while (*link != self) link = &(*link)->next;
+        *link = self->next;
+    }
+    BLT_Mutex_Unlock(pool->lock);
+
+    if (last) {
+        ATX_FreeMemory(self);
+        BLT_MediaPacketPool_Release(pool);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_ReleaseType
++---------------------------------------------------------------------*/
+static void
+BLT_MediaPacket_ReleaseType(BLT_MediaPacket* packet)
+{
+    if (packet->type_interned) {
+        BLT_InternedMediaType_Release(BLT_InternedMediaType_FromType(packet->type));
+    } else {
+        BLT_MediaType_Free(packet->type);
+    }
+    packet->type          = NULL;
+    packet->type_interned = BLT_FALSE;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaType_Hash
++---------------------------------------------------------------------*/
+static BLT_UInt32
+BLT_MediaType_Hash(const BLT_MediaType* type)
+{
+    /* FNV-1a over the base type and its extension */
+    const unsigned char* bytes = (const unsigned char*)type;
+    BLT_Size             size  = sizeof(BLT_MediaType)+type->extension_size;
+    BLT_UInt32           hash  = 2166136261U;
+
+    while (size--) {
+        hash ^= *bytes++;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_InternType
++---------------------------------------------------------------------*/
+static BLT_Result
+BLT_MediaPacketPool_InternType(BLT_MediaPacketPool*  self,
+                               const BLT_MediaType*  type,
+                               BLT_MediaType**       interned)
+{
+    BLT_UInt32             hash = BLT_MediaType_Hash(type);
+    BLT_InternedMediaType* entry;
+
+    BLT_Mutex_Lock(self->lock);
+
+    /* look for an existing instance */
+    for (entry = self->types[hash%BLT_MEDIA_PACKET_POOL_TYPE_BUCKET_COUNT]; 
+         entry; 
+         entry = entry->next) {
+        if (entry->hash == hash && BLT_MediaType_Equals(&entry->type.base, type)) {
+            ++entry->reference_count;
+            BLT_Mutex_Unlock(self->lock);
+            *interned = &entry->type.base;
+            return BLT_SUCCESS;
+        }
+    }
+
+    /* create a new instance */
+    entry = (BLT_InternedMediaType*)ATX_AllocateMemory(sizeof(BLT_InternedMediaType)+type->extension_size);
+    if (entry == NULL) {
+        BLT_Mutex_Unlock(self->lock);
+        *interned = NULL;
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+    entry->reference_count = 1;
+    entry->hash            = hash;
+    entry->pool            = self;
+    ATX_CopyMemory(&entry->type.base, type, sizeof(BLT_MediaType)+type->extension_size);
+    entry->next = self->types[hash%BLT_MEDIA_PACKET_POOL_TYPE_BUCKET_COUNT];
+    self->types[hash%BLT_MEDIA_PACKET_POOL_TYPE_BUCKET_COUNT] = entry;
+
+    /* the instance keeps the pool (and its lock) alive */
+    ++self->reference_count;
+    BLT_Mutex_Unlock(self->lock);
+
+    *interned = &entry->type.base;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_ShareType
++---------------------------------------------------------------------*/
+static BLT_Result
+BLT_MediaPacket_ShareType(BLT_MediaPacket*     packet,
+                          BLT_MediaPacketPool* pool,
+                          const BLT_MediaType* type)
+{
+    BLT_MediaType* interned;
+    BLT_Result     result;
+
+    /* nothing to do if the packet already shares an equal type */
+    if (packet->type_interned && BLT_MediaType_Equals(packet->type, type)) {
+        return BLT_SUCCESS;
+    }
+
+    result = BLT_MediaPacketPool_InternType(pool, type, &interned);
+    if (BLT_FAILED(result)) return result;
+    BLT_MediaPacket_ReleaseType(packet);
+    packet->type          = interned;
+    packet->type_interned = BLT_TRUE;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_Allocate
++---------------------------------------------------------------------*/
+static BLT_Result
+BLT_MediaPacket_Allocate(BLT_Size size, BLT_MediaPacket** packet)
 {
     /* allocate memory for the packet object */
     *packet = (BLT_MediaPacket*)ATX_AllocateZeroMemory(sizeof(BLT_MediaPacket));
@@ -66,6 +272,23 @@ BLT_MediaPacket_Create(BLT_Size             size,
     (*packet)->reference_count = 1;
     (*packet)->allocated_size  = size;
 
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_Create
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacket_Create(BLT_Size             size,
+                       const BLT_MediaType* type,
+                       BLT_MediaPacket**    packet)
+{
+    BLT_Result result;
+
+    /* allocate the packet */
+    result = BLT_MediaPacket_Allocate(size, packet);
+    if (BLT_FAILED(result)) return result;
+
     /* set the media type */
     if (type) {
         BLT_MediaType_Clone(type, &(*packet)->type);
@@ -76,6 +299,95 @@ BLT_MediaPacket_Create(BLT_Size             size,
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_CreateWithExternalBuffer
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacket_CreateWithExternalBuffer(
+    BLT_Any                               buffer,
+    BLT_Size                              size,
+    const BLT_MediaType*                  type,
+    BLT_MediaPacket_ReleaseBufferCallback callback,
+    BLT_Any                               instance,
+    BLT_MediaPacket**                     packet)
+{
+    BLT_Result result;
+    
+    /* create a packet without a buffer */
+    result = BLT_MediaPacket_Create(0, type, packet);
+    if (BLT_FAILED(result)) return result;
+    
+    /* use the external buffer */
+    (*packet)->payload            = buffer;
+    (*packet)->allocated_size     = size;
+    (*packet)->payload_size       = size;
+    (*packet)->external.callback  = callback;
+    (*packet)->external.instance  = instance;
+    
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_CreateView
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacket_CreateView(BLT_MediaPacket*     packet,
+                           BLT_Offset           offset,
+                           BLT_Size             size,
+                           const BLT_MediaType* type,
+                           BLT_MediaPacket**    view)
+{
+    BLT_Result result;
+    
+    /* check that the view is within the payload */
+    if (offset < 0 || (BLT_Size)offset+size > packet->payload_size) {
+        *view = NULL;
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+    
+    /* create a packet without a buffer, sharing the type if we can */
+    if (packet->type_interned && (type == NULL || type == packet->type)) {
+        result = BLT_MediaPacket_Allocate(0, view);
+        if (BLT_FAILED(result)) return result;
+        BLT_InternedMediaType_AddReference(BLT_InternedMediaType_FromType(packet->type));
+        (*view)->type          = packet->type;
+        (*view)->type_interned = BLT_TRUE;
+    } else {
+        result = BLT_MediaPacket_Create(0, type?type:packet->type, view);
+        if (BLT_FAILED(result)) return result;
+    }
+    
+    /* point to the buffer of the other packet, and keep it alive */
+    (*view)->payload        = (char*)packet->payload+packet->payload_offset+offset;
+    (*view)->allocated_size = size;
+    (*view)->payload_size   = size;
+    (*view)->parent         = packet;
+    BLT_AtomicCounter_Increment(&packet->reference_count);
+    
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_FreeBuffer
++---------------------------------------------------------------------*/
+static void
+BLT_MediaPacket_FreeBuffer(BLT_MediaPacket* packet)
+{
+    if (packet->parent) {
+        /* the buffer belongs to another packet */
+        BLT_MediaPacket_Release(packet->parent);
+        packet->parent = NULL;
+    } else if (packet->external.callback) {
+        /* the buffer belongs to someone else */
+        packet->external.callback(packet->payload, packet->external.instance);
+        packet->external.callback = NULL;
+        packet->external.instance = NULL;
+    } else if (packet->payload) {
+        ATX_FreeMemory(packet->payload);
+    }
+    packet->payload = NULL;
+}
+
 /*----------------------------------------------------------------------
 |    BLT_MediaPacket_Destroy
 +---------------------------------------------------------------------*/
@@ -83,18 +395,120 @@ static BLT_Result
 BLT_MediaPacket_Destroy(BLT_MediaPacket* packet)
 {
     /* free the packet payload */
-    if (packet->payload) {
-        ATX_FreeMemory(packet->payload);
-    }
+    BLT_MediaPacket_FreeBuffer(packet);
 
-    /* free the media type extensions if any */
-    BLT_MediaType_Free(packet->type);
+    /* release the media type */
+    BLT_MediaPacket_ReleaseType(packet);
 
     ATX_FreeMemory((void*)packet);
 
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_GetClassForSize
+|
+|    returns the index of the smallest size class that can hold 'size'
+|    bytes, or -1 if the size is too large to be pooled
++---------------------------------------------------------------------*/
+static int
+BLT_MediaPacketPool_GetClassForSize(BLT_Size size)
+{
+    int class_index = 0;
+    while (class_index < BLT_MEDIA_PACKET_POOL_CLASS_COUNT) {
+        if (size <= ((BLT_Size)1<<(class_index+BLT_MEDIA_PACKET_POOL_MIN_CLASS_SHIFT))) {
+            return class_index;
+        }
+        ++class_index;
+    }
+    
+    return -1;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_Flush
++---------------------------------------------------------------------*/
+static void
+BLT_MediaPacketPool_Flush(BLT_MediaPacketPool* self)
+{
+    BLT_MediaPacket* free_packets[BLT_MEDIA_PACKET_POOL_CLASS_COUNT];
+    unsigned int     i;
+
+    /* detach the free lists */
+    BLT_Mutex_Lock(self->lock);
+    for (i=0; i<BLT_MEDIA_PACKET_POOL_CLASS_COUNT; i++) {
+        free_packets[i]            = self->free_packets[i];
+        self->free_packets[i]      = NULL;
+        self->free_packet_count[i] = 0;
+    }
+    self->stats.bytes_held   = 0;
+    self->stats.packets_held = 0;
+    BLT_Mutex_Unlock(self->lock);
+
+    /* destroy the packets outside of the lock */
+    for (i=0; i<BLT_MEDIA_PACKET_POOL_CLASS_COUNT; i++) {
+        BLT_MediaPacket* packet = free_packets[i];
+        while (packet) {
+            BLT_MediaPacket* next = packet->next_free;
+            BLT_MediaPacket_Destroy(packet);
+            packet = next;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_Release
++---------------------------------------------------------------------*/
+static void
+BLT_MediaPacketPool_Release(BLT_MediaPacketPool* self)
+{
+    BLT_Cardinal reference_count;
+
+    BLT_Mutex_Lock(self->lock);
+    reference_count = --self->reference_count;
+    BLT_Mutex_Unlock(self->lock);
+
+    if (reference_count == 0) {
+        BLT_MediaPacketPool_Flush(self);
+        BLT_Mutex_Destroy(self->lock);
+        ATX_FreeMemory(self);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_Recycle
++---------------------------------------------------------------------*/
+static BLT_Result
+BLT_MediaPacketPool_Recycle(BLT_MediaPacketPool* self, 
+                            BLT_MediaPacket*     packet)
+{
+    int         class_index = BLT_MediaPacketPool_GetClassForSize(packet->allocated_size);
+    BLT_Boolean kept = BLT_FALSE;
+
+    /* only keep packets whose buffer is exactly one of the class sizes */
+    /* (the buffer may have been reallocated since it was created)      */
+    BLT_Mutex_Lock(self->lock);
+    if (self->enabled && 
+        class_index >= 0 && 
+        packet->allocated_size == ((BLT_Size)1<<(class_index+BLT_MEDIA_PACKET_POOL_MIN_CLASS_SHIFT)) &&
+        self->free_packet_count[class_index] < BLT_CONFIG_MEDIA_PACKET_POOL_MAX_PACKETS_PER_CLASS) {
+        packet->pool      = NULL;
+        packet->next_free = self->free_packets[class_index];
+        self->free_packets[class_index] = packet;
+        self->free_packet_count[class_index]++;
+        self->stats.bytes_held += packet->allocated_size;
+        self->stats.packets_held++;
+        kept = BLT_TRUE;
+    }
+    BLT_Mutex_Unlock(self->lock);
+    if (!kept) BLT_MediaPacket_Destroy(packet);
+
+    /* the packet no longer keeps the pool alive */
+    BLT_MediaPacketPool_Release(self);
+    
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |    BLT_MediaPacket_Release
 +---------------------------------------------------------------------*/
@@ -103,13 +517,154 @@ BLT_MediaPacket_Release(BLT_MediaPacket* packet)
 {
     /*BLT_Debug("MediaPacket [%x] - release (ref = %d)\n", 
       (int)packet, packet->reference_count);*/
-    if (--packet->reference_count == 0) {
+    if (BLT_AtomicCounter_Decrement(&packet->reference_count) == 0) {
+        if (packet->pool) {
+            return BLT_MediaPacketPool_Recycle(packet->pool, packet);
+        }
         return BLT_MediaPacket_Destroy(packet);
     } else {
         return BLT_SUCCESS;
     }
 }
 
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_Create
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacketPool_Create(BLT_MediaPacketPool** pool)
+{
+    /* allocate memory for the object */
+    *pool = (BLT_MediaPacketPool*)ATX_AllocateZeroMemory(sizeof(BLT_MediaPacketPool));
+    if (*pool == NULL) {
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* create the lock */
+    if (BLT_FAILED(BLT_Mutex_Create(&(*pool)->lock))) {
+        ATX_FreeMemory(*pool);
+        *pool = NULL;
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* initialize the non-zero fields */
+    (*pool)->reference_count = 1;
+    (*pool)->enabled         = BLT_TRUE;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacketPool_Destroy(BLT_MediaPacketPool* self)
+{
+    /* packets still in use keep a reference to the pool, so we can */
+    /* only free what we hold and let the last packet finish the job */
+    BLT_Mutex_Lock(self->lock);
+    self->enabled = BLT_FALSE;
+    BLT_Mutex_Unlock(self->lock);
+    BLT_MediaPacketPool_Flush(self);
+    BLT_MediaPacketPool_Release(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_SetEnabled
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacketPool_SetEnabled(BLT_MediaPacketPool* self, BLT_Boolean enabled)
+{
+    BLT_Mutex_Lock(self->lock);
+    self->enabled = enabled;
+    BLT_Mutex_Unlock(self->lock);
+    if (!enabled) BLT_MediaPacketPool_Flush(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_GetStats
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacketPool_GetStats(BLT_MediaPacketPool*      self, 
+                             BLT_MediaPacketPoolStats* stats)
+{
+    BLT_Mutex_Lock(self->lock);
+    *stats = self->stats;
+    BLT_Mutex_Unlock(self->lock);
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPacketPool_CreatePacket
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_MediaPacketPool_CreatePacket(BLT_MediaPacketPool* self,
+                                 BLT_Size             size,
+                                 const BLT_MediaType* type,
+                                 BLT_MediaPacket**    packet)
+{
+    int        class_index;
+    BLT_Result result;
+    
+    /* bypass the pool if it is disabled or the size is too large */
+    BLT_Mutex_Lock(self->lock);
+    class_index = self->enabled?BLT_MediaPacketPool_GetClassForSize(size):-1;
+    if (class_index < 0) {
+        BLT_Mutex_Unlock(self->lock);
+        return BLT_MediaPacket_Create(size, type, packet);
+    }
+    
+    /* take a free packet from this class, if any */
+    *packet = self->free_packets[class_index];
+    if (*packet) {
+        self->free_packets[class_index] = (*packet)->next_free;
+        self->free_packet_count[class_index]--;
+        self->stats.bytes_held -= (*packet)->allocated_size;
+        self->stats.packets_held--;
+        self->stats.hits++;
+    } else {
+        self->stats.misses++;
+    }
+
+    /* the packet keeps a reference to the pool until it is recycled */
+    ++self->reference_count;
+    BLT_Mutex_Unlock(self->lock);
+    
+    if (*packet) {
+        /* reset the fields to their initial state */
+        (*packet)->next_free       = NULL;
+        (*packet)->reference_count = 1;
+        (*packet)->payload_size    = 0;
+        (*packet)->payload_offset  = 0;
+        (*packet)->flags           = 0;
+        BLT_TimeStamp_Set((*packet)->duration, 0, 0);
+        BLT_TimeStamp_Set((*packet)->time_stamp, 0, 0);
+    } else {
+        /* allocate a new packet with a buffer the size of the class */
+        result = BLT_MediaPacket_Allocate((BLT_Size)1<<(class_index+BLT_MEDIA_PACKET_POOL_MIN_CLASS_SHIFT),
+                                          packet);
+        if (BLT_FAILED(result)) {
+            BLT_MediaPacketPool_Release(self);
+            return result;
+        }
+    }
+
+    /* share the type with the other packets of the pool */
+    result = BLT_MediaPacket_ShareType(*packet, self, type?type:&BLT_MediaType_None);
+    if (BLT_FAILED(result)) {
+        BLT_MediaPacket_Destroy(*packet);
+        *packet = NULL;
+        BLT_MediaPacketPool_Release(self);
+        return result;
+    }
+    (*packet)->pool = self;
+    
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |    BLT_MediaPacket_AddReference
 +---------------------------------------------------------------------*/
@@ -118,11 +673,24 @@ BLT_MediaPacket_AddReference(BLT_MediaPacket* packet)
 {
     /*BLT_Debug("MediaPacket [%x] - reference (ref = %d)\n", 
       (int)packet, packet->reference_count);*/
-    packet->reference_count++;
+    BLT_AtomicCounter_Increment(&packet->reference_count);
 
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    BLT_MediaPacket_IsWritable
++---------------------------------------------------------------------*/
+BLT_Boolean
+BLT_MediaPacket_IsWritable(BLT_MediaPacket* packet)
+{
+    /* views share their buffer with another packet, and external */
+    /* buffers with a release callback still belong to their owner */
+    return BLT_AtomicCounter_Get(&packet->reference_count) == 1 &&
+           packet->parent            == NULL                     &&
+           packet->external.callback == NULL;
+}
+
 /*----------------------------------------------------------------------
 |    BLT_MediaPacket_GetPayloadBuffer
 +---------------------------------------------------------------------*/
@@ -218,9 +786,7 @@ BLT_MediaPacket_SetAllocatedSize(BLT_MediaPacket* packet, BLT_Size size)
         }
 
         /* free the previous buffer, if any */
-        if (packet->payload) {
-            ATX_FreeMemory(packet->payload);
-        }
+        BLT_MediaPacket_FreeBuffer(packet);
         
         /* use the new buffer */
         packet->payload        = new_buffer;
@@ -281,7 +847,15 @@ BLT_Result
 BLT_MediaPacket_SetMediaType(BLT_MediaPacket*     packet, 
                              const BLT_MediaType* type)
 {
+    if (type == packet->type) return BLT_SUCCESS;
+
+    /* packets from a pool share their type with the other packets */
+    if (packet->pool && type != NULL) {
+        return BLT_MediaPacket_ShareType(packet, packet->pool, type);
+    }
+
 	if (packet->type != NULL && 
+	    !packet->type_interned &&
 	    type != NULL &&
 	    packet->type->extension_size >= type->extension_size) { 
 		/* we have enough space for the type, just copy it */
@@ -289,7 +863,7 @@ BLT_MediaPacket_SetMediaType(BLT_MediaPacket*     packet,
 		return BLT_SUCCESS;
 	} else {
 		/* replace the type with this new one */
-	    BLT_MediaType_Free(packet->type);
+	    BLT_MediaPacket_ReleaseType(packet);
     	return BLT_MediaType_Clone(type, &packet->type);
 	}
 }
@@ -38,6 +38,17 @@
  */
 typedef struct BLT_MediaPacket BLT_MediaPacket;
 
+/**
+ * Function called when a packet that wraps an external buffer no 
+ * longer needs that buffer.
+ * @param buffer The buffer that was passed to 
+ * BLT_MediaPacket_CreateWithExternalBuffer
+ * @param instance The instance pointer that was passed to 
+ * BLT_MediaPacket_CreateWithExternalBuffer
+ */
+typedef void (*BLT_MediaPacket_ReleaseBufferCallback)(BLT_Any buffer, 
+                                                      BLT_Any instance);
+
 /** @} */
 
 /*----------------------------------------------------------------------
@@ -95,6 +106,47 @@ typedef struct BLT_MediaPacket BLT_MediaPacket;
 extern "C" {
 #endif
 
+/**
+ * Create a packet whose payload is an externally-owned buffer. No copy
+ * of the data is made. The packet does not own the buffer: when the 
+ * packet no longer needs it, it calls the release callback (if not NULL).
+ * If the packet needs to grow its buffer, the data is copied to a new 
+ * internal buffer and the external buffer is released right away.
+ * @param buffer Pointer to the external buffer.
+ * @param size Size of the external buffer. The payload size is 
+ * initially set to that value.
+ * @param type Media type of the packet (may be NULL).
+ * @param callback Function called to release the buffer.
+ * @param instance Pointer passed back to the callback.
+ */
+BLT_Result BLT_MediaPacket_CreateWithExternalBuffer(
+    BLT_Any                               buffer,
+    BLT_Size                              size,
+    const BLT_MediaType*                  type,
+    BLT_MediaPacket_ReleaseBufferCallback callback,
+    BLT_Any                               instance,
+    BLT_MediaPacket**                     packet);
+
+/**
+ * Create a packet that is a view of a portion of the payload of another
+ * packet. No copy of the data is made: the new packet keeps a reference
+ * to the other packet for as long as it uses its buffer. The time stamp
+ * and flags are not inherited.
+ * Since the buffer is shared, neither packet should modify the payload 
+ * data or resize its buffer while the other one is in use.
+ * @param packet The packet whose payload is viewed.
+ * @param offset Offset of the view, relative to the start of the payload.
+ * @param size Size of the view.
+ * @param type Media type of the new packet, or NULL to use the same 
+ * type as the other packet.
+ * @param view Pointer to the new packet.
+ */
+BLT_Result BLT_MediaPacket_CreateView(BLT_MediaPacket*     packet,
+                                      BLT_Offset           offset,
+                                      BLT_Size             size,
+                                      const BLT_MediaType* type,
+                                      BLT_MediaPacket**    view);
+
 /**
  * Increase the reference counter of a packet.
  */
@@ -105,6 +157,13 @@ BLT_Result BLT_MediaPacket_AddReference(BLT_MediaPacket* packet);
  */
 BLT_Result BLT_MediaPacket_Release(BLT_MediaPacket* packet);
 
+/**
+ * Returns BLT_TRUE if the caller holds the only reference to the packet
+ * and the packet owns its buffer, so that the payload can be modified
+ * in place without affecting anyone else.
+ */
+BLT_Boolean BLT_MediaPacket_IsWritable(BLT_MediaPacket* packet);
+
 /**
  * Returns a pointer to the packet's payload buffer.
  */
@@ -164,6 +223,8 @@ BLT_Result BLT_MediaPacket_SetPayloadOffset(BLT_MediaPacket* packet,
  * Returns the type of the media data in this packet.
  * @param type Pointer to a pointer that will, upon return, point
  * to a BLT_MediaType structure representing the type information.
+ * The returned structure may be shared with other packets and must not
+ * be modified.
  */
 BLT_Result BLT_MediaPacket_GetMediaType(BLT_MediaPacket* packet,
                                         const BLT_MediaType** type);
@@ -171,6 +232,8 @@ BLT_Result BLT_MediaPacket_GetMediaType(BLT_MediaPacket* packet,
 /**
  * Sets the type of the media data in this packet.
  * This method makes an internal copy of the media type structure.
+ * Packets created by the core share a single immutable copy of each
+ * distinct type, so packets with equal types have equal type pointers.
  * @param type Pointer to a BLT_MediaType structure representing the
  * type information.
  */
@@ -15,6 +15,23 @@
 +---------------------------------------------------------------------*/
 #include "BltMediaPacket.h"
 
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Pool of recycled media packets, grouped by payload size class.
+ * Packets created from a pool go back to it when their last reference
+ * is released.
+ */
+typedef struct BLT_MediaPacketPool BLT_MediaPacketPool;
+
+typedef struct {
+    BLT_UInt64   hits;         /**< packets served from a free list        */
+    BLT_UInt64   misses;       /**< packets that had to be allocated       */
+    BLT_Size     bytes_held;   /**< payload bytes held in the free lists   */
+    BLT_Cardinal packets_held; /**< number of packets in the free lists    */
+} BLT_MediaPacketPoolStats;
+
 /*----------------------------------------------------------------------
 |   prototypes
 +---------------------------------------------------------------------*/
@@ -22,4 +39,15 @@ BLT_Result BLT_MediaPacket_Create(BLT_Size             size,
                                   const BLT_MediaType* type,
                                   BLT_MediaPacket**    packet);
 
+BLT_Result BLT_MediaPacketPool_Create(BLT_MediaPacketPool** pool);
+BLT_Result BLT_MediaPacketPool_Destroy(BLT_MediaPacketPool* pool);
+BLT_Result BLT_MediaPacketPool_CreatePacket(BLT_MediaPacketPool* pool,
+                                            BLT_Size             size,
+                                            const BLT_MediaType* type,
+                                            BLT_MediaPacket**    packet);
+BLT_Result BLT_MediaPacketPool_SetEnabled(BLT_MediaPacketPool* pool, 
+                                          BLT_Boolean          enabled);
+BLT_Result BLT_MediaPacketPool_GetStats(BLT_MediaPacketPool*      pool,
+                                        BLT_MediaPacketPoolStats* stats);
+
 #endif /* _BLT_MEDIA_PACKET_PRIV_H_ */
@@ -14,6 +14,7 @@
 |   includes
 +---------------------------------------------------------------------*/
 #include "BltPcm.h"
+#include "BltPcmKernelsPriv.h"
 
 /*----------------------------------------------------------------------
 |   global constants
@@ -41,6 +42,12 @@ BLT_PcmMediaType_Init(BLT_PcmMediaType* media_type)
 }
 
 
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef BLT_Int32 (*BLT_PcmReadFunction)(const void* buffer, unsigned int width);
+typedef void      (*BLT_PcmWriteFunction)(void* buffer, BLT_Int32 sample, unsigned int width);
+
 #if BLT_CONFIG_CPU_BYTE_ORDER == BLT_CPU_LITTLE_ENDIAN
 /*----------------------------------------------------------------------
 |   BLT_Pcm_ReadSignedIntBE
@@ -114,15 +121,8 @@ BLT_Pcm_ReadFloatBE(const void* buffer, unsigned int width)
     y[2] = x[1];
     y[1] = x[2];
     y[0] = x[3];
-    {
-        float f = 2147483648.0f*v;
-        if (f > 2147483647.0f) {
-            f = 2147483647.0f;
-        } else if (f < -2147483648.0f) {
-            f = -2147483648.0f;
-        }
-        return (BLT_Int32)f;
-    }
+    
+    return BLT_Pcm_FloatToInt32(v);
 }
 
 /*----------------------------------------------------------------------
@@ -133,15 +133,7 @@ BLT_Pcm_ReadFloatLE(const void* buffer, unsigned int width)
 {
 	BLT_COMPILER_UNUSED(width);
 	
-    {
-        float f = 2147483648.0f* (*(float*)buffer);
-        if (f > 2147483647.0f) {
-            f = 2147483647.0f;
-        } else if (f < -2147483648.0f) {
-            f = -2147483648.0f;
-        }
-        return (BLT_Int32)f;
-    }
+    return BLT_Pcm_FloatToInt32(*(float*)buffer);
 }
 
 /*----------------------------------------------------------------------
@@ -151,7 +143,7 @@ static void
 BLT_Pcm_WriteFloatBE(void* buffer, BLT_Int32 sample, unsigned int width)
 {
     unsigned char* x = (unsigned char*)buffer;
-    float f = ((float)sample)/32768.0f;
+    float f = BLT_Pcm_Int32ToFloat(sample);
     unsigned char* y = (unsigned char*)&f;
 	BLT_COMPILER_UNUSED(width);
 	
@@ -169,7 +161,7 @@ BLT_Pcm_WriteFloatLE(void* buffer, BLT_Int32 sample, unsigned int width)
 {
 	BLT_COMPILER_UNUSED(width);
 	
-    *((float*)buffer) = ((float)sample)/32768.0f;
+    *((float*)buffer) = BLT_Pcm_Int32ToFloat(sample);
 }
 
 #else 
@@ -231,6 +223,124 @@ BLT_Pcm_CanConvert(const BLT_MediaType* from, const BLT_MediaType* to)
     return BLT_TRUE;
 }
 
+/*----------------------------------------------------------------------
+|   BLT_Pcm_GetSampleFunctions
++---------------------------------------------------------------------*/
+static BLT_Result
+BLT_Pcm_GetSampleFunctions(const BLT_PcmMediaType* in_type,
+                           const BLT_PcmMediaType* out_type,
+                           BLT_PcmReadFunction*    in_function,
+                           BLT_PcmWriteFunction*   out_function)
+{
+    /* select the approprite conversion routines */
+    switch (in_type->sample_format) {
+        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE:
+            *in_function = BLT_Pcm_ReadSignedIntBE;
+            break;
+
+        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE:
+            *in_function = BLT_Pcm_ReadSignedIntLE;
+            break;
+
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_BE:
+            *in_function = BLT_Pcm_ReadFloatBE;
+            if (in_type->bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
+            break;
+
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_LE:
+            *in_function = BLT_Pcm_ReadFloatLE;
+            if (in_type->bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
+            break;
+
+        default:
+            return BLT_ERROR_INVALID_MEDIA_TYPE;
+    }
+    switch (out_type->sample_format) {
+        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE:
+            *out_function = BLT_Pcm_WriteSignedIntBE;
+            break;
+
+        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE:
+            *out_function = BLT_Pcm_WriteSignedIntLE;
+            break;
+
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_BE:
+            *out_function = BLT_Pcm_WriteFloatBE;
+            if (out_type->bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
+            break;
+
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_LE:
+            *out_function = BLT_Pcm_WriteFloatLE;
+            if (out_type->bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
+            break;
+
+        default:
+            return BLT_ERROR_INVALID_MEDIA_TYPE;
+    }
+
+    /* the generic functions work on 1 to 4 bytes per sample */
+    if (in_type->bits_per_sample  < 8 || in_type->bits_per_sample  > 32 ||
+        out_type->bits_per_sample < 8 || out_type->bits_per_sample > 32) {
+        return BLT_ERROR_INVALID_MEDIA_TYPE;
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Pcm_GetAvailableKernels
++---------------------------------------------------------------------*/
+BLT_Flags
+BLT_Pcm_GetAvailableKernels(void)
+{
+    return BLT_PcmKernels_GetAvailable();
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Pcm_ConvertSamples
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_Pcm_ConvertSamples(const BLT_PcmMediaType* in_type,
+                       const void*             in_samples,
+                       const BLT_PcmMediaType* out_type,
+                       void*                   out_samples,
+                       BLT_Cardinal            sample_count,
+                       BLT_Flags               kernels)
+{
+    unsigned int         in_width  = in_type->bits_per_sample/8;
+    unsigned int         out_width = out_type->bits_per_sample/8;
+    BLT_PcmReadFunction  in_function;
+    BLT_PcmWriteFunction out_function;
+    BLT_PcmKernel        kernel;
+    BLT_Result           result;
+
+    result = BLT_Pcm_GetSampleFunctions(in_type, out_type, &in_function, &out_function);
+    if (BLT_FAILED(result)) return result;
+
+    /* use a specialized kernel if there is one for this conversion */
+    kernel = BLT_PcmKernels_Find(in_type->sample_format,  in_width,
+                                 out_type->sample_format, out_width,
+                                 kernels);
+    if (kernel) {
+        kernel(in_samples, out_samples, sample_count);
+        return BLT_SUCCESS;
+    }
+
+    /* generic conversion */
+    {
+        const char* in_buffer  = (const char*)in_samples;
+        char*       out_buffer = (char*)out_samples;
+        while (sample_count--) {
+            BLT_Int32 sample = in_function(in_buffer, in_width);
+            out_function(out_buffer, sample, out_width);
+            in_buffer  += in_width;
+            out_buffer += out_width;
+        }
+    }
+
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |   BLT_Pcm_ConvertMediaPacket
 +---------------------------------------------------------------------*/
@@ -244,8 +354,8 @@ BLT_Pcm_ConvertMediaPacket(BLT_Core*         core,
     BLT_PcmMediaType        out_type;
     unsigned int            sample_count;
     unsigned int            packet_size;
-    BLT_Int32               (*in_function)(const void* buffer, unsigned int width);
-    void                    (*out_function)(void* buffer, BLT_Int32 sample, unsigned int width);
+    BLT_PcmReadFunction     in_function;
+    BLT_PcmWriteFunction    out_function;
     BLT_Result              result;
 
     /* default */
@@ -273,79 +383,77 @@ BLT_Pcm_ConvertMediaPacket(BLT_Core*         core,
         out_type.sample_rate = in_type->sample_rate;
     }
 
-    /* select the approprite conversion routines */
-    switch (in_type->sample_format) {
-        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE:
-            in_function = BLT_Pcm_ReadSignedIntBE;
-            break;
-
-        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE:
-            in_function = BLT_Pcm_ReadSignedIntLE;
-            break;
-
-        case BLT_PCM_SAMPLE_FORMAT_FLOAT_BE:
-            in_function = BLT_Pcm_ReadFloatBE;
-            if (in_type->bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
-            break;
-
-        case BLT_PCM_SAMPLE_FORMAT_FLOAT_LE:
-            in_function = BLT_Pcm_ReadFloatLE;
-            if (in_type->bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
-            break;
-
-        default:
-            return BLT_ERROR_INVALID_MEDIA_TYPE;
-    }
-    switch (out_type.sample_format) {
-        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE:
-            out_function = BLT_Pcm_WriteSignedIntBE;
-            break;
-
-        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE:
-            out_function = BLT_Pcm_WriteSignedIntLE;
-            break;
-
-        case BLT_PCM_SAMPLE_FORMAT_FLOAT_BE:
-            out_function = BLT_Pcm_WriteFloatBE;
-            if (out_type.bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
-            break;
+    /* check that we can convert before allocating anything */
+    result = BLT_Pcm_GetSampleFunctions(in_type, &out_type, &in_function, &out_function);
+    if (BLT_FAILED(result)) return result;
 
-        case BLT_PCM_SAMPLE_FORMAT_FLOAT_LE:
-            out_function = BLT_Pcm_WriteFloatLE;
-            if (out_type.bits_per_sample != 32) return BLT_ERROR_INVALID_MEDIA_TYPE;
-            break;
+    sample_count = BLT_MediaPacket_GetPayloadSize(in)/(in_type->bits_per_sample/8);
+    packet_size = sample_count*(out_type.bits_per_sample/8);
 
-        default:
-            return BLT_ERROR_INVALID_MEDIA_TYPE;
+    /* convert in place when nobody else can see the input packet and */
+    /* the samples don't get wider                                    */
+    if (out_type.bits_per_sample <= in_type->bits_per_sample &&
+        BLT_MediaPacket_IsWritable(in)) {
+        void* samples = BLT_MediaPacket_GetPayloadBuffer(in);
+        result = BLT_Pcm_ConvertSamples(in_type,
+                                        samples,
+                                        &out_type,
+                                        samples,
+                                        sample_count,
+                                        BLT_PCM_KERNEL_ANY);
+        if (BLT_FAILED(result)) return result;
+        BLT_MediaPacket_SetPayloadSize(in, packet_size);
+        result = BLT_MediaPacket_SetMediaType(in, (const BLT_MediaType*)&out_type);
+        if (BLT_FAILED(result)) return result;
+        BLT_MediaPacket_AddReference(in);
+        *out = in;
+        return BLT_SUCCESS;
     }
 
     /* allocate the output packet */
-    sample_count = BLT_MediaPacket_GetPayloadSize(in)/(in_type->bits_per_sample/8);
-    packet_size = sample_count*(out_type.bits_per_sample/8);
     result = BLT_Core_CreateMediaPacket(core,
                                         packet_size,
                                         (const BLT_MediaType*)&out_type,
                                         out);
     if (BLT_FAILED(result)) return result;
 
-    /* set the payload size */
+    /* set the payload size, and keep the same timing as the input */
     BLT_MediaPacket_SetPayloadSize(*out, packet_size);
+    BLT_MediaPacket_SetFlags(*out, BLT_MediaPacket_GetFlags(in));
+    BLT_MediaPacket_SetTimeStamp(*out, BLT_MediaPacket_GetTimeStamp(in));
+    BLT_MediaPacket_SetDuration(*out, BLT_MediaPacket_GetDuration(in));
 
     /* convert the samples */
-    {
-        const char*  in_buffer = (const char*)BLT_MediaPacket_GetPayloadBuffer(in);
-        unsigned int in_width  = in_type->bits_per_sample/8;
-        char*  out_buffer      = (char*)BLT_MediaPacket_GetPayloadBuffer(*out);
-        unsigned int out_width  = out_type.bits_per_sample/8;
-        while (sample_count--) {
-            BLT_Int32 sample = in_function(in_buffer, in_width);
-            out_function(out_buffer, sample, out_width);
-            in_buffer += in_width;
-            out_buffer += out_width;
-        }
+    return BLT_Pcm_ConvertSamples(in_type,
+                                  BLT_MediaPacket_GetPayloadBuffer(in),
+                                  &out_type,
+                                  BLT_MediaPacket_GetPayloadBuffer(*out),
+                                  sample_count,
+                                  BLT_PCM_KERNEL_ANY);
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Pcm_IsFloatPipelineEnabled
++---------------------------------------------------------------------*/
+BLT_Boolean
+BLT_Pcm_IsFloatPipelineEnabled(BLT_Core* core)
+{
+    ATX_Properties*   properties = NULL;
+    ATX_PropertyValue property;
+
+    if (core == NULL ||
+        BLT_FAILED(BLT_Core_GetProperties(core, &properties)) ||
+        properties == NULL) {
+        return BLT_FALSE;
+    }
+    if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties,
+                                                 BLT_PCM_FLOAT_PIPELINE_ENABLED_PROPERTY,
+                                                 &property)) &&
+        property.type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN) {
+        return property.data.boolean?BLT_TRUE:BLT_FALSE;
     }
 
-    return BLT_SUCCESS;
+    return BLT_FALSE;
 }
 
 /*----------------------------------------------------------------------
@@ -139,6 +139,22 @@ do {                                            \
                                            BLT_PCM_SPEAKER_BACK_LEFT    | BLT_PCM_SPEAKER_BACK_RIGHT    | \
                                            BLT_PCM_SPEAKER_SIDE_LEFT    | BLT_PCM_SPEAKER_SIDE_RIGHT)
 
+/* sample conversion kernels, for BLT_Pcm_ConvertSamples     */
+/* (with none of these, the generic per-sample loop is used) */
+#define BLT_PCM_KERNEL_PORTABLE 0x01 /* loops specialized for each (format, width) pair */
+#define BLT_PCM_KERNEL_SSE2     0x02
+#define BLT_PCM_KERNEL_AVX2     0x04
+#define BLT_PCM_KERNEL_NEON     0x08
+#define BLT_PCM_KERNEL_ANY      0xFF
+
+/* Float pipeline, read from the core properties when a node is set up.
+ * When enabled, decoders that can produce floating point samples emit
+ * 32-bit BLT_PCM_SAMPLE_FORMAT_FLOAT_NE samples instead of 16-bit
+ * integers, and filters process them as they are, so that the samples
+ * are only converted once, in front of the output.
+ */
+#define BLT_PCM_FLOAT_PIPELINE_ENABLED_PROPERTY "Pcm.FloatPipeline.Enabled"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -156,12 +172,50 @@ BLT_PcmMediaType_Init(BLT_PcmMediaType* media_type);
 extern BLT_Boolean
 BLT_Pcm_CanConvert(const BLT_MediaType* from, const BLT_MediaType* to);
 
+/**
+ * Converts the samples of a packet to another PCM type. When the caller
+ * holds the only reference to the input packet (see 
+ * BLT_MediaPacket_IsWritable) and the samples don't get wider, the
+ * conversion is done in place and out_packet is a new reference to the
+ * input packet, with its media type changed. Otherwise, out_packet is
+ * a new packet with the same flags and timing as the input packet.
+ */
 extern BLT_Result
 BLT_Pcm_ConvertMediaPacket(BLT_Core*         core,
                            BLT_MediaPacket*  in_packet, 
                            BLT_PcmMediaType* out_type, 
                            BLT_MediaPacket** out_packet);
 
+/**
+ * Converts samples between two fully specified PCM types (sample
+ * format and bits per sample). The kernels argument is a combination
+ * of BLT_PCM_KERNEL_XXX flags that restricts which specialized kernels
+ * may be used; all of them produce the same output as the generic loop.
+ * The input and output may be the same buffer if the output samples
+ * are not wider than the input samples, but may not overlap otherwise.
+ */
+extern BLT_Result
+BLT_Pcm_ConvertSamples(const BLT_PcmMediaType* in_type,
+                       const void*             in_samples,
+                       const BLT_PcmMediaType* out_type,
+                       void*                   out_samples,
+                       BLT_Cardinal            sample_count,
+                       BLT_Flags               kernels);
+
+/**
+ * Returns the BLT_PCM_KERNEL_XXX flags of the kernels that can be
+ * used on this CPU.
+ */
+extern BLT_Flags
+BLT_Pcm_GetAvailableKernels(void);
+
+/**
+ * Returns BLT_TRUE if the BLT_PCM_FLOAT_PIPELINE_ENABLED_PROPERTY core
+ * property is set to true.
+ */
+extern BLT_Boolean
+BLT_Pcm_IsFloatPipelineEnabled(BLT_Core* core);
+
 extern BLT_Result
 BLT_Pcm_ParseMimeType(const char* mime_type, BLT_PcmMediaType** media_type);
 
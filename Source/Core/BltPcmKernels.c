@@ -0,0 +1,688 @@
+/*****************************************************************
+|
+|   BlueTune - PCM Conversion Kernels
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+/** @file
+ * Sample format conversion loops specialized for the common
+ * (format, width) pairs, with SIMD variants selected at runtime.
+ */
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltPcm.h"
+#include "BltPcmKernelsPriv.h"
+
+/*----------------------------------------------------------------------
+|   SIMD support
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD) && \
+    BLT_CONFIG_CPU_BYTE_ORDER == BLT_CPU_LITTLE_ENDIAN
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_PCM_KERNELS_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* AVX2 kernels are compiled for the target even when the rest of the */
+/* code isn't, and only used when the CPU supports them               */
+#if defined(BLT_PCM_KERNELS_HAVE_SSE2)
+#if defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define BLT_PCM_KERNELS_HAVE_AVX2
+#define BLT_PCM_KERNELS_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && _MSC_VER >= 1700
+#define BLT_PCM_KERNELS_HAVE_AVX2
+#define BLT_PCM_KERNELS_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLT_PCM_KERNELS_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef union {
+    float      f;
+    BLT_UInt32 i;
+} BLT_PcmFloatBits;
+
+typedef struct {
+    unsigned char in_format;
+    unsigned char in_width;
+    unsigned char out_format;
+    unsigned char out_width;
+    BLT_PcmKernel portable;
+    BLT_PcmKernel sse2;
+    BLT_PcmKernel avx2;
+    BLT_PcmKernel neon;
+} BLT_PcmKernelEntry;
+
+/*----------------------------------------------------------------------
+|   sample readers
+|
+|   all the readers return the sample left-justified in 32 bits, like
+|   the generic conversion loop
++---------------------------------------------------------------------*/
+static inline BLT_Int32
+BLT_PcmKernels_ReadS16LE(const unsigned char* x)
+{
+    return (BLT_Int32)(((BLT_UInt32)x[1]<<24) | ((BLT_UInt32)x[0]<<16));
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadS16BE(const unsigned char* x)
+{
+    return (BLT_Int32)(((BLT_UInt32)x[0]<<24) | ((BLT_UInt32)x[1]<<16));
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadS24LE(const unsigned char* x)
+{
+    return (BLT_Int32)(((BLT_UInt32)x[2]<<24) |
+                       ((BLT_UInt32)x[1]<<16) |
+                       ((BLT_UInt32)x[0]<< 8));
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadS24BE(const unsigned char* x)
+{
+    return (BLT_Int32)(((BLT_UInt32)x[0]<<24) |
+                       ((BLT_UInt32)x[1]<<16) |
+                       ((BLT_UInt32)x[2]<< 8));
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadS32LE(const unsigned char* x)
+{
+    return (BLT_Int32)(((BLT_UInt32)x[3]<<24) |
+                       ((BLT_UInt32)x[2]<<16) |
+                       ((BLT_UInt32)x[1]<< 8) |
+                       ((BLT_UInt32)x[0]    ));
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadS32BE(const unsigned char* x)
+{
+    return (BLT_Int32)(((BLT_UInt32)x[0]<<24) |
+                       ((BLT_UInt32)x[1]<<16) |
+                       ((BLT_UInt32)x[2]<< 8) |
+                       ((BLT_UInt32)x[3]    ));
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadFloatLE(const unsigned char* x)
+{
+    BLT_PcmFloatBits v;
+    v.i = (BLT_UInt32)BLT_PcmKernels_ReadS32LE(x);
+    return BLT_Pcm_FloatToInt32(v.f);
+}
+
+static inline BLT_Int32
+BLT_PcmKernels_ReadFloatBE(const unsigned char* x)
+{
+    BLT_PcmFloatBits v;
+    v.i = (BLT_UInt32)BLT_PcmKernels_ReadS32BE(x);
+    return BLT_Pcm_FloatToInt32(v.f);
+}
+
+/*----------------------------------------------------------------------
+|   sample writers
+|
+|   all the writers take a left-justified sample and keep its most
+|   significant bytes, like the generic conversion loop
++---------------------------------------------------------------------*/
+static inline void
+BLT_PcmKernels_WriteS16LE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_UInt32 s = (BLT_UInt32)sample;
+    x[0] = (unsigned char)(s>>16);
+    x[1] = (unsigned char)(s>>24);
+}
+
+static inline void
+BLT_PcmKernels_WriteS16BE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_UInt32 s = (BLT_UInt32)sample;
+    x[0] = (unsigned char)(s>>24);
+    x[1] = (unsigned char)(s>>16);
+}
+
+static inline void
+BLT_PcmKernels_WriteS24LE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_UInt32 s = (BLT_UInt32)sample;
+    x[0] = (unsigned char)(s>> 8);
+    x[1] = (unsigned char)(s>>16);
+    x[2] = (unsigned char)(s>>24);
+}
+
+static inline void
+BLT_PcmKernels_WriteS24BE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_UInt32 s = (BLT_UInt32)sample;
+    x[0] = (unsigned char)(s>>24);
+    x[1] = (unsigned char)(s>>16);
+    x[2] = (unsigned char)(s>> 8);
+}
+
+static inline void
+BLT_PcmKernels_WriteS32LE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_UInt32 s = (BLT_UInt32)sample;
+    x[0] = (unsigned char)(s    );
+    x[1] = (unsigned char)(s>> 8);
+    x[2] = (unsigned char)(s>>16);
+    x[3] = (unsigned char)(s>>24);
+}
+
+static inline void
+BLT_PcmKernels_WriteS32BE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_UInt32 s = (BLT_UInt32)sample;
+    x[0] = (unsigned char)(s>>24);
+    x[1] = (unsigned char)(s>>16);
+    x[2] = (unsigned char)(s>> 8);
+    x[3] = (unsigned char)(s    );
+}
+
+static inline void
+BLT_PcmKernels_WriteFloatLE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_PcmFloatBits v;
+    v.f = BLT_Pcm_Int32ToFloat(sample);
+    BLT_PcmKernels_WriteS32LE(x, (BLT_Int32)v.i);
+}
+
+static inline void
+BLT_PcmKernels_WriteFloatBE(unsigned char* x, BLT_Int32 sample)
+{
+    BLT_PcmFloatBits v;
+    v.f = BLT_Pcm_Int32ToFloat(sample);
+    BLT_PcmKernels_WriteS32BE(x, (BLT_Int32)v.i);
+}
+
+/*----------------------------------------------------------------------
+|   portable kernels
+|
+|   with the widths known at compile time, the compiler can inline the
+|   readers and writers and, for the simple cases, vectorize the loop
++---------------------------------------------------------------------*/
+#define BLT_PCM_KERNELS_DEFINE(_in, _in_width, _out, _out_width)           \
+static void                                                                 \
+BLT_PcmKernels_##_in##To##_out(const void*  in,                             \
+                               void*        out,                            \
+                               BLT_Cardinal sample_count)                   \
+{                                                                           \
+    const unsigned char* src = (const unsigned char*)in;                    \
+    unsigned char*       dst = (unsigned char*)out;                         \
+    while (sample_count--) {                                                \
+        BLT_PcmKernels_Write##_out(dst, BLT_PcmKernels_Read##_in(src));     \
+        src += _in_width;                                                   \
+        dst += _out_width;                                                  \
+    }                                                                       \
+}
+
+/* integers to floats */
+BLT_PCM_KERNELS_DEFINE(S16LE, 2, FloatLE, 4)
+BLT_PCM_KERNELS_DEFINE(S16LE, 2, FloatBE, 4)
+BLT_PCM_KERNELS_DEFINE(S16BE, 2, FloatLE, 4)
+BLT_PCM_KERNELS_DEFINE(S16BE, 2, FloatBE, 4)
+BLT_PCM_KERNELS_DEFINE(S24LE, 3, FloatLE, 4)
+BLT_PCM_KERNELS_DEFINE(S24LE, 3, FloatBE, 4)
+BLT_PCM_KERNELS_DEFINE(S24BE, 3, FloatLE, 4)
+BLT_PCM_KERNELS_DEFINE(S24BE, 3, FloatBE, 4)
+BLT_PCM_KERNELS_DEFINE(S32LE, 4, FloatLE, 4)
+BLT_PCM_KERNELS_DEFINE(S32LE, 4, FloatBE, 4)
+BLT_PCM_KERNELS_DEFINE(S32BE, 4, FloatLE, 4)
+BLT_PCM_KERNELS_DEFINE(S32BE, 4, FloatBE, 4)
+
+/* floats to integers */
+BLT_PCM_KERNELS_DEFINE(FloatLE, 4, S16LE, 2)
+BLT_PCM_KERNELS_DEFINE(FloatLE, 4, S16BE, 2)
+BLT_PCM_KERNELS_DEFINE(FloatBE, 4, S16LE, 2)
+BLT_PCM_KERNELS_DEFINE(FloatBE, 4, S16BE, 2)
+BLT_PCM_KERNELS_DEFINE(FloatLE, 4, S24LE, 3)
+BLT_PCM_KERNELS_DEFINE(FloatLE, 4, S24BE, 3)
+BLT_PCM_KERNELS_DEFINE(FloatBE, 4, S24LE, 3)
+BLT_PCM_KERNELS_DEFINE(FloatBE, 4, S24BE, 3)
+BLT_PCM_KERNELS_DEFINE(FloatLE, 4, S32LE, 4)
+BLT_PCM_KERNELS_DEFINE(FloatLE, 4, S32BE, 4)
+BLT_PCM_KERNELS_DEFINE(FloatBE, 4, S32LE, 4)
+BLT_PCM_KERNELS_DEFINE(FloatBE, 4, S32BE, 4)
+
+/* byte swaps */
+BLT_PCM_KERNELS_DEFINE(S16LE, 2, S16BE, 2)
+BLT_PCM_KERNELS_DEFINE(S16BE, 2, S16LE, 2)
+BLT_PCM_KERNELS_DEFINE(S24LE, 3, S24BE, 3)
+BLT_PCM_KERNELS_DEFINE(S24BE, 3, S24LE, 3)
+BLT_PCM_KERNELS_DEFINE(S32LE, 4, S32BE, 4)
+BLT_PCM_KERNELS_DEFINE(S32BE, 4, S32LE, 4)
+
+/*----------------------------------------------------------------------
+|   SSE2 kernels
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_KERNELS_HAVE_SSE2)
+static void
+BLT_PcmKernels_S16LEToFloatLE_SSE2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_Int16* src   = (const BLT_Int16*)in;
+    float*           dst   = (float*)out;
+    const __m128i    zero  = _mm_setzero_si128();
+    const __m128     scale = _mm_set1_ps(1.0f/2147483648.0f);
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)src);
+
+        /* interleaving with zeros left-justifies the samples */
+        __m128i lo = _mm_unpacklo_epi16(zero, x);
+        __m128i hi = _mm_unpackhi_epi16(zero, x);
+        _mm_storeu_ps(dst,   _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst+4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    BLT_PcmKernels_S16LEToFloatLE(src, dst, sample_count);
+}
+
+static void
+BLT_PcmKernels_S32LEToFloatLE_SSE2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_Int32* src   = (const BLT_Int32*)in;
+    float*           dst   = (float*)out;
+    const __m128     scale = _mm_set1_ps(1.0f/2147483648.0f);
+
+    for (; sample_count >= 4; sample_count -= 4, src += 4, dst += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)src);
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(x), scale));
+    }
+    BLT_PcmKernels_S32LEToFloatLE(src, dst, sample_count);
+}
+
+/* same clamping as BLT_Pcm_FloatToInt32 (max returns 'lo' for NaNs, */
+/* which converts to the same value as the scalar code on x86)       */
+#define BLT_PCM_KERNELS_SSE2_FLOAT_TO_INT32(_x)                        \
+    _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps((_x), scale), lo), hi))
+
+static void
+BLT_PcmKernels_FloatLEToS16LE_SSE2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const float* src   = (const float*)in;
+    BLT_Int16*   dst   = (BLT_Int16*)out;
+    const __m128 scale = _mm_set1_ps(2147483648.0f);
+    const __m128 lo    = _mm_set1_ps(BLT_PCM_FLOAT_TO_INT32_MIN);
+    const __m128 hi    = _mm_set1_ps(BLT_PCM_FLOAT_TO_INT32_MAX);
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        __m128i a = BLT_PCM_KERNELS_SSE2_FLOAT_TO_INT32(_mm_loadu_ps(src));
+        __m128i b = BLT_PCM_KERNELS_SSE2_FLOAT_TO_INT32(_mm_loadu_ps(src+4));
+
+        /* keep the top 16 bits, which the saturating pack won't change */
+        a = _mm_srai_epi32(a, 16);
+        b = _mm_srai_epi32(b, 16);
+        _mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(a, b));
+    }
+    BLT_PcmKernels_FloatLEToS16LE(src, dst, sample_count);
+}
+
+static void
+BLT_PcmKernels_FloatLEToS32LE_SSE2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const float* src   = (const float*)in;
+    BLT_Int32*   dst   = (BLT_Int32*)out;
+    const __m128 scale = _mm_set1_ps(2147483648.0f);
+    const __m128 lo    = _mm_set1_ps(BLT_PCM_FLOAT_TO_INT32_MIN);
+    const __m128 hi    = _mm_set1_ps(BLT_PCM_FLOAT_TO_INT32_MAX);
+
+    for (; sample_count >= 4; sample_count -= 4, src += 4, dst += 4) {
+        _mm_storeu_si128((__m128i*)dst,
+                         BLT_PCM_KERNELS_SSE2_FLOAT_TO_INT32(_mm_loadu_ps(src)));
+    }
+    BLT_PcmKernels_FloatLEToS32LE(src, dst, sample_count);
+}
+
+static void
+BLT_PcmKernels_SwapS16_SSE2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_UInt16* src = (const BLT_UInt16*)in;
+    BLT_UInt16*       dst = (BLT_UInt16*)out;
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)src);
+        _mm_storeu_si128((__m128i*)dst,
+                         _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8)));
+    }
+    BLT_PcmKernels_S16LEToS16BE(src, dst, sample_count);
+}
+#define BLT_PCM_KERNELS_SSE2(_kernel) BLT_PcmKernels_##_kernel##_SSE2
+#else
+#define BLT_PCM_KERNELS_SSE2(_kernel) NULL
+#endif /* BLT_PCM_KERNELS_HAVE_SSE2 */
+
+/*----------------------------------------------------------------------
+|   AVX2 kernels
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_KERNELS_HAVE_AVX2)
+BLT_PCM_KERNELS_AVX2_TARGET static void
+BLT_PcmKernels_S16LEToFloatLE_AVX2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_Int16* src   = (const BLT_Int16*)in;
+    float*           dst   = (float*)out;
+    const __m256     scale = _mm256_set1_ps(1.0f/2147483648.0f);
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)src));
+        x = _mm256_slli_epi32(x, 16);
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+    }
+    BLT_PcmKernels_S16LEToFloatLE(src, dst, sample_count);
+}
+
+BLT_PCM_KERNELS_AVX2_TARGET static void
+BLT_PcmKernels_S32LEToFloatLE_AVX2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_Int32* src   = (const BLT_Int32*)in;
+    float*           dst   = (float*)out;
+    const __m256     scale = _mm256_set1_ps(1.0f/2147483648.0f);
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)src);
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+    }
+    BLT_PcmKernels_S32LEToFloatLE(src, dst, sample_count);
+}
+
+#define BLT_PCM_KERNELS_AVX2_FLOAT_TO_INT32(_x)                        \
+    _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps((_x), scale), lo), hi))
+
+BLT_PCM_KERNELS_AVX2_TARGET static void
+BLT_PcmKernels_FloatLEToS16LE_AVX2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const float* src   = (const float*)in;
+    BLT_Int16*   dst   = (BLT_Int16*)out;
+    const __m256 scale = _mm256_set1_ps(2147483648.0f);
+    const __m256 lo    = _mm256_set1_ps(BLT_PCM_FLOAT_TO_INT32_MIN);
+    const __m256 hi    = _mm256_set1_ps(BLT_PCM_FLOAT_TO_INT32_MAX);
+
+    for (; sample_count >= 16; sample_count -= 16, src += 16, dst += 16) {
+        __m256i a = BLT_PCM_KERNELS_AVX2_FLOAT_TO_INT32(_mm256_loadu_ps(src));
+        __m256i b = BLT_PCM_KERNELS_AVX2_FLOAT_TO_INT32(_mm256_loadu_ps(src+8));
+        __m256i x;
+
+        a = _mm256_srai_epi32(a, 16);
+        b = _mm256_srai_epi32(b, 16);
+
+        /* the pack works on each 128-bit lane, so put the lanes back in order */
+        x = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)dst, x);
+    }
+    BLT_PcmKernels_FloatLEToS16LE(src, dst, sample_count);
+}
+
+BLT_PCM_KERNELS_AVX2_TARGET static void
+BLT_PcmKernels_FloatLEToS32LE_AVX2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const float* src   = (const float*)in;
+    BLT_Int32*   dst   = (BLT_Int32*)out;
+    const __m256 scale = _mm256_set1_ps(2147483648.0f);
+    const __m256 lo    = _mm256_set1_ps(BLT_PCM_FLOAT_TO_INT32_MIN);
+    const __m256 hi    = _mm256_set1_ps(BLT_PCM_FLOAT_TO_INT32_MAX);
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        _mm256_storeu_si256((__m256i*)dst,
+                            BLT_PCM_KERNELS_AVX2_FLOAT_TO_INT32(_mm256_loadu_ps(src)));
+    }
+    BLT_PcmKernels_FloatLEToS32LE(src, dst, sample_count);
+}
+
+BLT_PCM_KERNELS_AVX2_TARGET static void
+BLT_PcmKernels_SwapS16_AVX2(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_UInt16* src = (const BLT_UInt16*)in;
+    BLT_UInt16*       dst = (BLT_UInt16*)out;
+
+    for (; sample_count >= 16; sample_count -= 16, src += 16, dst += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)src);
+        _mm256_storeu_si256((__m256i*)dst,
+                            _mm256_or_si256(_mm256_slli_epi16(x, 8), _mm256_srli_epi16(x, 8)));
+    }
+    BLT_PcmKernels_S16LEToS16BE(src, dst, sample_count);
+}
+#define BLT_PCM_KERNELS_AVX2(_kernel) BLT_PcmKernels_##_kernel##_AVX2
+#else
+#define BLT_PCM_KERNELS_AVX2(_kernel) NULL
+#endif /* BLT_PCM_KERNELS_HAVE_AVX2 */
+
+/*----------------------------------------------------------------------
+|   NEON kernels
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_KERNELS_HAVE_NEON)
+static void
+BLT_PcmKernels_S16LEToFloatLE_NEON(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_Int16* src = (const BLT_Int16*)in;
+    float*           dst = (float*)out;
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        int16x8_t x  = vld1q_s16(src);
+        int32x4_t lo = vshll_n_s16(vget_low_s16(x),  16);
+        int32x4_t hi = vshll_n_s16(vget_high_s16(x), 16);
+        vst1q_f32(dst,   vmulq_n_f32(vcvtq_f32_s32(lo), 1.0f/2147483648.0f));
+        vst1q_f32(dst+4, vmulq_n_f32(vcvtq_f32_s32(hi), 1.0f/2147483648.0f));
+    }
+    BLT_PcmKernels_S16LEToFloatLE(src, dst, sample_count);
+}
+
+static void
+BLT_PcmKernels_S32LEToFloatLE_NEON(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_Int32* src = (const BLT_Int32*)in;
+    float*           dst = (float*)out;
+
+    for (; sample_count >= 4; sample_count -= 4, src += 4, dst += 4) {
+        vst1q_f32(dst, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src)), 1.0f/2147483648.0f));
+    }
+    BLT_PcmKernels_S32LEToFloatLE(src, dst, sample_count);
+}
+
+/* NaNs propagate through min/max and convert to 0, like the scalar code */
+#define BLT_PCM_KERNELS_NEON_FLOAT_TO_INT32(_x)                        \
+    vcvtq_s32_f32(vminq_f32(vmaxq_f32(vmulq_n_f32((_x), 2147483648.0f), lo), hi))
+
+static void
+BLT_PcmKernels_FloatLEToS16LE_NEON(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const float*      src = (const float*)in;
+    BLT_Int16*        dst = (BLT_Int16*)out;
+    const float32x4_t lo  = vdupq_n_f32(BLT_PCM_FLOAT_TO_INT32_MIN);
+    const float32x4_t hi  = vdupq_n_f32(BLT_PCM_FLOAT_TO_INT32_MAX);
+
+    for (; sample_count >= 8; sample_count -= 8, src += 8, dst += 8) {
+        int32x4_t a = BLT_PCM_KERNELS_NEON_FLOAT_TO_INT32(vld1q_f32(src));
+        int32x4_t b = BLT_PCM_KERNELS_NEON_FLOAT_TO_INT32(vld1q_f32(src+4));
+        vst1q_s16(dst, vcombine_s16(vshrn_n_s32(a, 16), vshrn_n_s32(b, 16)));
+    }
+    BLT_PcmKernels_FloatLEToS16LE(src, dst, sample_count);
+}
+
+static void
+BLT_PcmKernels_FloatLEToS32LE_NEON(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const float*      src = (const float*)in;
+    BLT_Int32*        dst = (BLT_Int32*)out;
+    const float32x4_t lo  = vdupq_n_f32(BLT_PCM_FLOAT_TO_INT32_MIN);
+    const float32x4_t hi  = vdupq_n_f32(BLT_PCM_FLOAT_TO_INT32_MAX);
+
+    for (; sample_count >= 4; sample_count -= 4, src += 4, dst += 4) {
+        vst1q_s32(dst, BLT_PCM_KERNELS_NEON_FLOAT_TO_INT32(vld1q_f32(src)));
+    }
+    BLT_PcmKernels_FloatLEToS32LE(src, dst, sample_count);
+}
+
+static void
+BLT_PcmKernels_SwapS16_NEON(const void* in, void* out, BLT_Cardinal sample_count)
+{
+    const BLT_UInt8* src = (const BLT_UInt8*)in;
+    BLT_UInt8*       dst = (BLT_UInt8*)out;
+
+    for (; sample_count >= 8; sample_count -= 8, src += 16, dst += 16) {
+        vst1q_u8(dst, vrev16q_u8(vld1q_u8(src)));
+    }
+    BLT_PcmKernels_S16LEToS16BE(src, dst, sample_count);
+}
+#define BLT_PCM_KERNELS_NEON(_kernel) BLT_PcmKernels_##_kernel##_NEON
+#else
+#define BLT_PCM_KERNELS_NEON(_kernel) NULL
+#endif /* BLT_PCM_KERNELS_HAVE_NEON */
+
+/*----------------------------------------------------------------------
+|   kernel table
++---------------------------------------------------------------------*/
+#define BLT_PCM_KERNELS_S16LE   BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE, 2
+#define BLT_PCM_KERNELS_S16BE   BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE, 2
+#define BLT_PCM_KERNELS_S24LE   BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE, 3
+#define BLT_PCM_KERNELS_S24BE   BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE, 3
+#define BLT_PCM_KERNELS_S32LE   BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE, 4
+#define BLT_PCM_KERNELS_S32BE   BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE, 4
+#define BLT_PCM_KERNELS_FloatLE BLT_PCM_SAMPLE_FORMAT_FLOAT_LE,      4
+#define BLT_PCM_KERNELS_FloatBE BLT_PCM_SAMPLE_FORMAT_FLOAT_BE,      4
+
+#define BLT_PCM_KERNELS_ENTRY(_in, _out)                                \
+    { BLT_PCM_KERNELS_##_in, BLT_PCM_KERNELS_##_out,                    \
+      BLT_PcmKernels_##_in##To##_out, NULL, NULL, NULL }
+#define BLT_PCM_KERNELS_SIMD_ENTRY(_in, _out, _simd)                    \
+    { BLT_PCM_KERNELS_##_in, BLT_PCM_KERNELS_##_out,                    \
+      BLT_PcmKernels_##_in##To##_out,                                   \
+      BLT_PCM_KERNELS_SSE2(_simd),                                      \
+      BLT_PCM_KERNELS_AVX2(_simd),                                      \
+      BLT_PCM_KERNELS_NEON(_simd) }
+
+static const BLT_PcmKernelEntry BLT_PcmKernels_Table[] = {
+    BLT_PCM_KERNELS_SIMD_ENTRY(S16LE, FloatLE, S16LEToFloatLE),
+    BLT_PCM_KERNELS_ENTRY     (S16LE, FloatBE),
+    BLT_PCM_KERNELS_ENTRY     (S16BE, FloatLE),
+    BLT_PCM_KERNELS_ENTRY     (S16BE, FloatBE),
+    BLT_PCM_KERNELS_ENTRY     (S24LE, FloatLE),
+    BLT_PCM_KERNELS_ENTRY     (S24LE, FloatBE),
+    BLT_PCM_KERNELS_ENTRY     (S24BE, FloatLE),
+    BLT_PCM_KERNELS_ENTRY     (S24BE, FloatBE),
+    BLT_PCM_KERNELS_SIMD_ENTRY(S32LE, FloatLE, S32LEToFloatLE),
+    BLT_PCM_KERNELS_ENTRY     (S32LE, FloatBE),
+    BLT_PCM_KERNELS_ENTRY     (S32BE, FloatLE),
+    BLT_PCM_KERNELS_ENTRY     (S32BE, FloatBE),
+
+    BLT_PCM_KERNELS_SIMD_ENTRY(FloatLE, S16LE, FloatLEToS16LE),
+    BLT_PCM_KERNELS_ENTRY     (FloatLE, S16BE),
+    BLT_PCM_KERNELS_ENTRY     (FloatBE, S16LE),
+    BLT_PCM_KERNELS_ENTRY     (FloatBE, S16BE),
+    BLT_PCM_KERNELS_ENTRY     (FloatLE, S24LE),
+    BLT_PCM_KERNELS_ENTRY     (FloatLE, S24BE),
+    BLT_PCM_KERNELS_ENTRY     (FloatBE, S24LE),
+    BLT_PCM_KERNELS_ENTRY     (FloatBE, S24BE),
+    BLT_PCM_KERNELS_SIMD_ENTRY(FloatLE, S32LE, FloatLEToS32LE),
+    BLT_PCM_KERNELS_ENTRY     (FloatLE, S32BE),
+    BLT_PCM_KERNELS_ENTRY     (FloatBE, S32LE),
+    BLT_PCM_KERNELS_ENTRY     (FloatBE, S32BE),
+
+    BLT_PCM_KERNELS_SIMD_ENTRY(S16LE, S16BE, SwapS16),
+    BLT_PCM_KERNELS_SIMD_ENTRY(S16BE, S16LE, SwapS16),
+    BLT_PCM_KERNELS_ENTRY     (S24LE, S24BE),
+    BLT_PCM_KERNELS_ENTRY     (S24BE, S24LE),
+    BLT_PCM_KERNELS_ENTRY     (S32LE, S32BE),
+    BLT_PCM_KERNELS_ENTRY     (S32BE, S32LE)
+};
+
+/*----------------------------------------------------------------------
+|   BLT_PcmKernels_DetectAvailable
++---------------------------------------------------------------------*/
+static BLT_Flags
+BLT_PcmKernels_DetectAvailable(void)
+{
+    BLT_Flags available = BLT_PCM_KERNEL_PORTABLE;
+
+#if defined(BLT_PCM_KERNELS_HAVE_SSE2)
+    available |= BLT_PCM_KERNEL_SSE2;
+#endif
+
+#if defined(BLT_PCM_KERNELS_HAVE_AVX2)
+#if defined(_MSC_VER) && !defined(__clang__)
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7) {
+            /* the OS must also save the YMM registers */
+            __cpuid(info, 1);
+            if ((info[2] & (1<<27)) && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                if (info[1] & (1<<5)) available |= BLT_PCM_KERNEL_AVX2;
+            }
+        }
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) available |= BLT_PCM_KERNEL_AVX2;
+#endif
+#endif
+
+#if defined(BLT_PCM_KERNELS_HAVE_NEON)
+    available |= BLT_PCM_KERNEL_NEON;
+#endif
+
+    return available;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PcmKernels_GetAvailable
++---------------------------------------------------------------------*/
+BLT_Flags
+BLT_PcmKernels_GetAvailable(void)
+{
+    /* detecting twice in a race is harmless */
+    static BLT_Flags available = 0;
+    if (available == 0) available = BLT_PcmKernels_DetectAvailable();
+    return available;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PcmKernels_Find
++---------------------------------------------------------------------*/
+BLT_PcmKernel
+BLT_PcmKernels_Find(unsigned int in_format,
+                    unsigned int in_width,
+                    unsigned int out_format,
+                    unsigned int out_width,
+                    BLT_Flags    kernels)
+{
+    unsigned int i;
+
+    kernels &= BLT_PcmKernels_GetAvailable();
+    if (kernels == 0) return NULL;
+
+    for (i=0; i<sizeof(BLT_PcmKernels_Table)/sizeof(BLT_PcmKernels_Table[0]); i++) {
+        const BLT_PcmKernelEntry* entry = &BLT_PcmKernels_Table[i];
+        if (entry->in_format  != in_format  || entry->in_width  != in_width ||
+            entry->out_format != out_format || entry->out_width != out_width) {
+            continue;
+        }
+
+        /* pick the widest variant we are allowed to use */
+        if ((kernels & BLT_PCM_KERNEL_AVX2) && entry->avx2) return entry->avx2;
+        if ((kernels & BLT_PCM_KERNEL_SSE2) && entry->sse2) return entry->sse2;
+        if ((kernels & BLT_PCM_KERNEL_NEON) && entry->neon) return entry->neon;
+        if (kernels & BLT_PCM_KERNEL_PORTABLE) return entry->portable;
+        return NULL;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,91 @@
+/*****************************************************************
+|
+|   BlueTune - PCM Conversion Kernels Private Interface
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_PCM_KERNELS_PRIV_H_
+#define _BLT_PCM_KERNELS_PRIV_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltPcm.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/* largest float below 2^31, so that +1.0 doesn't wrap around */
+#define BLT_PCM_FLOAT_TO_INT32_MAX  2147483520.0f
+#define BLT_PCM_FLOAT_TO_INT32_MIN (-2147483648.0f)
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Converts sample_count samples from 'in' to 'out'. The buffers don't
+ * need to be aligned. They may be the same buffer when the output width
+ * isn't larger than the input width (each block of samples is read
+ * before it is written), but must not overlap otherwise.
+ */
+typedef void (*BLT_PcmKernel)(const void*  in,
+                              void*        out,
+                              BLT_Cardinal sample_count);
+
+/*----------------------------------------------------------------------
+|   inline functions
+|
+|   these are shared by the generic conversion loop and the kernels,
+|   so that both produce exactly the same samples
++---------------------------------------------------------------------*/
+static inline BLT_Int32
+BLT_Pcm_FloatToInt32(float value)
+{
+    float f = 2147483648.0f*value;
+    if (f > BLT_PCM_FLOAT_TO_INT32_MAX) {
+        f = BLT_PCM_FLOAT_TO_INT32_MAX;
+    } else if (f < BLT_PCM_FLOAT_TO_INT32_MIN) {
+        f = BLT_PCM_FLOAT_TO_INT32_MIN;
+    }
+    return (BLT_Int32)f;
+}
+
+static inline float
+BLT_Pcm_Int32ToFloat(BLT_Int32 sample)
+{
+    return ((float)sample)*(1.0f/2147483648.0f);
+}
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Returns the BLT_PCM_KERNEL_XXX flags of the kernels that can run
+ * on this CPU.
+ */
+BLT_Flags BLT_PcmKernels_GetAvailable(void);
+
+/**
+ * Returns the best kernel for a conversion, among the kernel types
+ * in 'kernels' that are available, or NULL if there is none.
+ */
+BLT_PcmKernel BLT_PcmKernels_Find(unsigned int in_format,
+                                  unsigned int in_width,
+                                  unsigned int out_format,
+                                  unsigned int out_width,
+                                  BLT_Flags    kernels);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_PCM_KERNELS_PRIV_H_ */
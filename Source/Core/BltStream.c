@@ -19,6 +19,7 @@
 #include "BltDefs.h"
 #include "BltErrors.h"
 #include "BltCore.h"
+#include "BltCorePriv.h"
 #include "BltStream.h"
 #include "BltStreamPriv.h"
 #include "BltMediaNode.h"
@@ -31,12 +32,38 @@
 #include "BltEventListener.h"
 #include "BltOutputNode.h"
 #include "BltPcm.h"
+#include "BltThreadsPriv.h"
 
 /*----------------------------------------------------------------------
 |   logging
 +---------------------------------------------------------------------*/
 ATX_SET_LOCAL_LOGGER("bluetune.core.stream")
 
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* max number of node groups when the stream is threaded */
+#define BLT_STREAM_MAX_THREAD_GROUPS 3
+
+/* max number of packets queued between two node groups */
+#if !defined(BLT_CONFIG_STREAM_THREADING_DEFAULT_QUEUE_SIZE)
+#define BLT_CONFIG_STREAM_THREADING_DEFAULT_QUEUE_SIZE 8
+#endif
+
+/* upper bound for a worker thread wait, for inputs that never signal */
+/* that they are ready                                                */
+#define BLT_STREAM_THREADING_WAIT_TIMEOUT 50 /* ms */
+
+/* min interval between two updates of the node statistics properties (ms) */
+#if !defined(BLT_CONFIG_STREAM_PROFILING_PUBLISH_INTERVAL)
+#define BLT_CONFIG_STREAM_PROFILING_PUBLISH_INTERVAL 1000
+#endif
+
+/* min interval between two updates of the packet pool statistics (ms) */
+#if !defined(BLT_CONFIG_STREAM_POOL_STATS_PUBLISH_INTERVAL)
+#define BLT_CONFIG_STREAM_POOL_STATS_PUBLISH_INTERVAL 5000
+#endif
+
 /*----------------------------------------------------------------------
 |    types
 +---------------------------------------------------------------------*/
@@ -67,14 +94,41 @@ typedef struct StreamNode {
             BLT_PacketProducer*      packet_producer;
         }                     iface;
     }                  output;
-    struct StreamNode* next;
-    struct StreamNode* prev;
+    BLT_StreamNodeStatistics statistics;
+    struct StreamNode*       next;
+    struct StreamNode*       prev;
 } StreamNode;
 
 typedef struct {
+    struct Stream*    stream;
+    StreamNode*       head;
+    StreamNode*       tail;
+    BLT_PacketQueue*  inbound;  /* outbound queue of the previous group */
+    BLT_PacketQueue*  outbound; /* NULL for the last group              */
+    BLT_WorkerThread* thread;   /* NULL for the last group              */
+} StreamThreadGroup;
+
+typedef struct {
+    ATX_Property property;
+    ATX_Boolean  removed;
+} StreamPendingProperty;
+
+typedef struct {
+    ATX_Object*   source;
+    BLT_EventType type;
+    BLT_Event*    event; /* a copy, which owns its strings */
+} StreamPendingEvent;
+
+typedef struct {
+    char*                 name; /* NULL for all the properties */
+    ATX_PropertyListener* listener;
+} StreamPropertyListener;
+
+typedef struct Stream {
     /* interfaces */
     ATX_IMPLEMENTS(BLT_Stream);
     ATX_IMPLEMENTS(BLT_EventListener);
+    ATX_IMPLEMENTS(ATX_Properties);
     ATX_IMPLEMENTS(ATX_Referenceable);
 
     /* members */
@@ -95,10 +149,33 @@ typedef struct {
         BLT_TimeStamp   last_time_stamp;
         BLT_TimeStamp   next_time_stamp;
     }                  output;
-    ATX_Properties*    properties;
+    ATX_Properties*    properties; /* only accessed under the lock */
+    ATX_List*          property_listeners; /* StreamPropertyListener*    */
+    struct {
+        StreamPendingProperty* items;
+        BLT_Cardinal           count;
+        BLT_Cardinal           allocated;
+    }                  pending_properties; /* set from worker threads */
+    ATX_List*          worker_values;  /* ATX_Property*, kept until the workers stop */
+    ATX_List*          pending_events; /* StreamPendingEvent*, sent by the workers    */
     BLT_StreamInfo     info;
     BLT_EventListener* event_listener;
     ATX_Boolean        at_start;
+    BLT_Mutex*         lock; /* protects the info and serializes events */
+    struct {
+        BLT_Boolean       enabled;
+        BLT_Cardinal      queue_size;
+        BLT_Boolean       running;
+        BLT_ThreadId      owner; /* the thread that pumps the last group */
+        BLT_Cardinal      group_count;
+        StreamThreadGroup groups[BLT_STREAM_MAX_THREAD_GROUPS];
+    }                  threading;
+    struct {
+        BLT_Boolean  enabled;
+        BLT_Cardinal published_node_count;
+        ATX_UInt64   published_time; /* monotonic, in nanoseconds */
+    }                  profiling;
+    ATX_UInt64         pool_stats_time; /* monotonic, in nanoseconds */
 } Stream;
 
 /*----------------------------------------------------------------------
@@ -106,6 +183,7 @@ typedef struct {
 +---------------------------------------------------------------------*/
 ATX_DECLARE_INTERFACE_MAP(Stream, BLT_Stream)
 ATX_DECLARE_INTERFACE_MAP(Stream, BLT_EventListener)
+ATX_DECLARE_INTERFACE_MAP(Stream, ATX_Properties)
 ATX_DECLARE_INTERFACE_MAP(Stream, ATX_Referenceable)
 static BLT_Result Stream_ResetInfo(Stream* self);
 static BLT_Result Stream_RemoveNode(Stream* self, StreamNode* stream_node);
@@ -113,6 +191,17 @@ static BLT_Result StreamNode_Activate(StreamNode* self);
 static BLT_Result StreamNode_Deactivate(StreamNode* self);
 static BLT_Result StreamNode_Start(StreamNode* self);
 static BLT_Result StreamNode_Stop(StreamNode* self);
+static void       Stream_ReadConfig(Stream* self);
+static BLT_Result Stream_StopThreads(Stream* self);
+static BLT_Result Stream_ResetThreads(Stream* self);
+static void       Stream_ApplyPendingProperties(Stream* self);
+static void       Stream_ClearPendingProperties(Stream* self);
+static void       Stream_ReleaseWorkerValues(Stream* self);
+static BLT_Boolean Stream_IsWorkerThread(Stream* self);
+static void       Stream_DeliverPendingEvents(Stream* self);
+static void       Stream_ClearPendingEvents(Stream* self);
+static void       Stream_UpdateNodeStatistics(Stream* self, BLT_Result result);
+static void       Stream_UpdatePacketPoolStats(Stream* self, BLT_Result result);
 
 /*----------------------------------------------------------------------
 |    StreamNode_Create
@@ -332,6 +421,197 @@ Stream_TopologyChanged(Stream*                     self,
                               (const BLT_Event*)(const void*)&event);
 }
 
+/*----------------------------------------------------------------------
+|    Stream_NodeReady
++---------------------------------------------------------------------*/
+static void
+Stream_NodeReady(Stream* self, StreamNode* node)
+{
+    BLT_NodeReadyEvent event;
+
+    /* this is called from worker threads, and is meant to wake up the */
+    /* owner, so unlike other events it is sent right away             */
+    if (self->event_listener) {
+        event.node = node->media_node;
+        BLT_EventListener_OnEvent(self->event_listener,
+                                  (ATX_Object*)self, 
+                                  BLT_EVENT_TYPE_NODE_READY,
+                                  (const BLT_Event*)(const void*)&event);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Stream_WakeWorkers
+|
+|    may be called from any thread
++---------------------------------------------------------------------*/
+static void
+Stream_WakeWorkers(Stream* self)
+{
+    BLT_Cardinal i;
+
+    BLT_Mutex_Lock(self->lock);
+    for (i=0; i<self->threading.group_count; i++) {
+        StreamThreadGroup* group = &self->threading.groups[i];
+        if (group->thread) BLT_WorkerThread_Wake(group->thread);
+    }
+    BLT_Mutex_Unlock(self->lock);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_CopyEvent
+|
+|    returns a copy of an event that can be sent later, or NULL if the
+|    event type is unknown or there isn't enough memory
++---------------------------------------------------------------------*/
+static StreamPendingEvent*
+Stream_CopyEvent(ATX_Object* source, BLT_EventType type, const BLT_Event* event)
+{
+    StreamPendingEvent* pending;
+    BLT_Size            size;
+    BLT_CString         string = NULL;
+    BLT_Size            string_size = 0;
+
+    /* the size of the event, and the string that it points to, if any */
+    switch (type) {
+      case BLT_EVENT_TYPE_USER:
+        size = sizeof(BLT_UserEvent)+((const BLT_UserEvent*)(const void*)event)->size;
+        break;
+
+      case BLT_EVENT_TYPE_INFO:
+        size   = sizeof(BLT_InfoEvent);
+        string = ((const BLT_InfoEvent*)(const void*)event)->message;
+        break;
+
+      case BLT_EVENT_TYPE_DEBUG:
+        size   = sizeof(BLT_DebugEvent);
+        string = ((const BLT_DebugEvent*)(const void*)event)->message;
+        break;
+
+      case BLT_EVENT_TYPE_STREAM_TOPOLOGY:
+        size = sizeof(BLT_StreamTopologyEvent);
+        break;
+
+      case BLT_EVENT_TYPE_STREAM_INFO:
+        size   = sizeof(BLT_StreamInfoEvent);
+        string = ((const BLT_StreamInfoEvent*)(const void*)event)->info.data_type;
+        break;
+
+      case BLT_EVENT_TYPE_DECODING_ERROR:
+        size   = sizeof(BLT_DecodingErrorEvent);
+        string = ((const BLT_DecodingErrorEvent*)(const void*)event)->message;
+        break;
+
+      default:
+        return NULL;
+    }
+    if (string) string_size = ATX_StringLength(string)+1;
+
+    /* copy the event, followed by its string */
+    pending = (StreamPendingEvent*)ATX_AllocateMemory(sizeof(StreamPendingEvent));
+    if (pending == NULL) return NULL;
+    pending->event = (BLT_Event*)ATX_AllocateMemory(size+string_size);
+    if (pending->event == NULL) {
+        ATX_FreeMemory(pending);
+        return NULL;
+    }
+    pending->source = source;
+    pending->type   = type;
+    ATX_CopyMemory(pending->event, event, size);
+    if (string) {
+        char* copy = (char*)pending->event+size;
+        ATX_CopyMemory(copy, string, string_size);
+        switch (type) {
+          case BLT_EVENT_TYPE_INFO:
+            ((BLT_InfoEvent*)(void*)pending->event)->message = copy;
+            break;
+
+          case BLT_EVENT_TYPE_DEBUG:
+            ((BLT_DebugEvent*)(void*)pending->event)->message = copy;
+            break;
+
+          case BLT_EVENT_TYPE_STREAM_INFO:
+            ((BLT_StreamInfoEvent*)(void*)pending->event)->info.data_type = copy;
+            break;
+
+          case BLT_EVENT_TYPE_DECODING_ERROR:
+            ((BLT_DecodingErrorEvent*)(void*)pending->event)->message = copy;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+    return pending;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_SendPendingEvent
+|
+|    sends an event copy to the listener and frees it
++---------------------------------------------------------------------*/
+static void
+Stream_SendPendingEvent(Stream* self, StreamPendingEvent* pending)
+{
+    if (self->event_listener) {
+        BLT_EventListener_OnEvent(self->event_listener,
+                                  pending->source,
+                                  pending->type,
+                                  pending->event);
+    }
+    ATX_FreeMemory(pending->event);
+    ATX_FreeMemory(pending);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_DeliverPendingEvents
+|
+|    the events sent by the workers are delivered on the thread that
+|    owns the stream, without the lock
++---------------------------------------------------------------------*/
+static void
+Stream_DeliverPendingEvents(Stream* self)
+{
+    for (;;) {
+        StreamPendingEvent* pending = NULL;
+        ATX_ListItem*       item;
+
+        BLT_Mutex_Lock(self->lock);
+        item = ATX_List_GetFirstItem(self->pending_events);
+        if (item) {
+            pending = (StreamPendingEvent*)ATX_ListItem_GetData(item);
+            ATX_List_RemoveItem(self->pending_events, item);
+        }
+        BLT_Mutex_Unlock(self->lock);
+
+        if (pending == NULL) break;
+        Stream_SendPendingEvent(self, pending);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ClearPendingEvents
++---------------------------------------------------------------------*/
+static void
+Stream_ClearPendingEvents(Stream* self)
+{
+    ATX_ListItem* item;
+
+    if (self->pending_events == NULL) return;
+
+    BLT_Mutex_Lock(self->lock);
+    for (item = ATX_List_GetFirstItem(self->pending_events);
+         item;
+         item = ATX_ListItem_GetNext(item)) {
+        StreamPendingEvent* pending = (StreamPendingEvent*)ATX_ListItem_GetData(item);
+        ATX_FreeMemory(pending->event);
+        ATX_FreeMemory(pending);
+    }
+    ATX_List_Clear(self->pending_events);
+    BLT_Mutex_Unlock(self->lock);
+}
+
 /*----------------------------------------------------------------------
 |    StreamNode_Activate
 +---------------------------------------------------------------------*/
@@ -537,15 +817,27 @@ Stream_Create(BLT_Core* core, BLT_Stream** object)
         return BLT_ERROR_OUT_OF_MEMORY;
     }
 
+    /* create the lock */
+    if (BLT_FAILED(BLT_Mutex_Create(&stream->lock))) {
+        ATX_FreeMemory(stream);
+        *object = NULL;
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
     /* construct the object */
     stream->reference_count = 1;
     stream->core            = core;
     ATX_Properties_Create(&stream->properties);
+    ATX_List_Create(&stream->property_listeners);
+    ATX_List_Create(&stream->worker_values);
+    ATX_List_Create(&stream->pending_events);
     stream->at_start        = ATX_TRUE;
+    Stream_ReadConfig(stream);
     
     /* setup interfaces */
     ATX_SET_INTERFACE(stream, Stream, BLT_Stream);
     ATX_SET_INTERFACE(stream, Stream, BLT_EventListener);
+    ATX_SET_INTERFACE(stream, Stream, ATX_Properties);
     ATX_SET_INTERFACE(stream, Stream, ATX_Referenceable);
     *object = &ATX_BASE(stream, BLT_Stream);    
 
@@ -560,6 +852,9 @@ Stream_Destroy(Stream* self)
 {
     ATX_LOG_FINE("Stream::Destroy");
     
+    /* stop the worker threads, if any */
+    Stream_ResetThreads(self);
+
     /* deactivate the nodes */
     {
         StreamNode* node = self->nodes.head;
@@ -593,8 +888,28 @@ Stream_Destroy(Stream* self)
     /* free the stream info data */
     Stream_ResetInfo(self);
 
-    /* destroy the properties object */
+    /* destroy the properties object and the listeners */
+    Stream_ClearPendingProperties(self);
     ATX_DESTROY_OBJECT(self->properties);
+    if (self->property_listeners) {
+        ATX_ListItem* item;
+        for (item = ATX_List_GetFirstItem(self->property_listeners);
+             item;
+             item = ATX_ListItem_GetNext(item)) {
+            StreamPropertyListener* entry = (StreamPropertyListener*)ATX_ListItem_GetData(item);
+            if (entry->name) ATX_FreeMemory(entry->name);
+            ATX_FreeMemory(entry);
+        }
+        ATX_List_Destroy(self->property_listeners);
+    }
+    if (self->worker_values) ATX_List_Destroy(self->worker_values);
+
+    /* drop the events that were never delivered */
+    Stream_ClearPendingEvents(self);
+    if (self->pending_events) ATX_List_Destroy(self->pending_events);
+
+    /* destroy the lock */
+    BLT_Mutex_Destroy(self->lock);
 
     /* free the object memory */
     ATX_FreeMemory((void*)self);
@@ -612,6 +927,9 @@ Stream_InsertChain(Stream*     self,
 {
     StreamNode* tail = chain;
 
+    /* the node groups no longer match the chain */
+    Stream_ResetThreads(self);
+
     /* find the tail of the chain */
     while (tail->next) {
         tail = tail->next;
@@ -676,6 +994,9 @@ Stream_RemoveNode(Stream* self, StreamNode* node)
         return BLT_SUCCESS;
     }
 
+    /* the node groups no longer match the chain */
+    Stream_ResetThreads(self);
+
     /* relink the chain */
     if (node->prev) {
         node->prev->next = node->next;
@@ -731,7 +1052,7 @@ static BLT_Result
 Stream_ResetProperties(Stream* self)
 {
     /* reset the properies object */
-    return ATX_Properties_Clear(self->properties);
+    return ATX_Properties_Clear(&ATX_BASE(self, ATX_Properties));
 } 
 
 /*----------------------------------------------------------------------
@@ -841,6 +1162,9 @@ Stream_SetInputNode(BLT_Stream*    _self,
     
     /* mark that we're at the start of the stream */
     self->at_start = ATX_TRUE;
+
+    /* pick up the threading and profiling configuration for this input */
+    Stream_ReadConfig(self);
     
     return BLT_SUCCESS;
 }
@@ -1186,6 +1510,35 @@ Stream_GetStreamNodeInfo(BLT_Stream*          _self,
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    Stream_GetNodeStatistics
++---------------------------------------------------------------------*/
+BLT_METHOD
+Stream_GetNodeStatistics(BLT_Stream*               _self,
+                         const BLT_MediaNode*      node,
+                         BLT_StreamNodeStatistics* statistics)
+{
+    Stream*     self = ATX_SELF(Stream, BLT_Stream);
+    StreamNode* stream_node;
+
+    /* check parameters */
+    if (node == NULL || statistics == NULL) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* find the node */
+    stream_node = Stream_FindNode(self, node);
+    if (stream_node == NULL) {
+        return BLT_ERROR_NO_SUCH_MEDIA_NODE;
+    }
+
+    /* return the statistics (the counters of nodes that run on a */
+    /* worker thread may be a little behind)                     */
+    *statistics = stream_node->statistics;
+
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |    Stream_GetFirstNode
 +---------------------------------------------------------------------*/
@@ -1377,6 +1730,65 @@ Stream_InterpolateChain(Stream*              self,
     return Stream_InsertChain(self, from_node, *new_node);
 }
 
+/*----------------------------------------------------------------------
+|    StreamNode_PutPacket
++---------------------------------------------------------------------*/
+static BLT_Result
+StreamNode_PutPacket(StreamNode*      self, 
+                     BLT_MediaPacket* packet, 
+                     BLT_Boolean      profiling)
+{
+    BLT_Size   size;
+    ATX_UInt64 start;
+    BLT_Result result;
+
+    if (!profiling) {
+        return BLT_PacketConsumer_PutPacket(self->input.iface.packet_consumer, packet);
+    }
+
+    /* the node may change the packet, so measure it first */
+    size   = BLT_MediaPacket_GetPayloadSize(packet);
+    start  = BLT_Time_GetMonotonicNanos();
+    result = BLT_PacketConsumer_PutPacket(self->input.iface.packet_consumer, packet);
+    self->statistics.put_packet_time += BLT_Time_GetMonotonicNanos()-start;
+    if (BLT_SUCCEEDED(result)) {
+        self->statistics.put_packet_count++;
+        self->statistics.put_packet_bytes += size;
+    } else if (result == BLT_ERROR_WOULD_BLOCK) {
+        self->statistics.would_block_count++;
+    }
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|    StreamNode_GetPacket
++---------------------------------------------------------------------*/
+static BLT_Result
+StreamNode_GetPacket(StreamNode*       self, 
+                     BLT_MediaPacket** packet, 
+                     BLT_Boolean       profiling)
+{
+    ATX_UInt64 start;
+    BLT_Result result;
+
+    if (!profiling) {
+        return BLT_PacketProducer_GetPacket(self->output.iface.packet_producer, packet);
+    }
+
+    start  = BLT_Time_GetMonotonicNanos();
+    result = BLT_PacketProducer_GetPacket(self->output.iface.packet_producer, packet);
+    self->statistics.get_packet_time += BLT_Time_GetMonotonicNanos()-start;
+    if (BLT_SUCCEEDED(result) && *packet) {
+        self->statistics.get_packet_count++;
+        self->statistics.get_packet_bytes += BLT_MediaPacket_GetPayloadSize(*packet);
+    } else if (result == BLT_ERROR_WOULD_BLOCK) {
+        self->statistics.would_block_count++;
+    }
+
+    return result;
+}
+
 /*----------------------------------------------------------------------
 |    Stream_DeliverPacket
 +---------------------------------------------------------------------*/
@@ -1402,14 +1814,14 @@ Stream_DeliverPacket(Stream*          self,
     for (watchdog=0; watchdog<16; watchdog++) {
         /* if we're connected, we can only try once */
         if (from_node->output.connected == BLT_TRUE) {
-            result = BLT_PacketConsumer_PutPacket(to_node->input.iface.packet_consumer, packet);
+            result = StreamNode_PutPacket(to_node, packet, self->profiling.enabled);
             break;
         } 
         
         /* check if the recipient uses the PACKET protocol */
         if (to_node->input.protocol == BLT_MEDIA_PORT_PROTOCOL_PACKET) {
             /* try to deliver the packet to the recipient */
-            result = BLT_PacketConsumer_PutPacket(to_node->input.iface.packet_consumer, packet);
+            result = StreamNode_PutPacket(to_node, packet, self->profiling.enabled);
             if (BLT_SUCCEEDED(result) || result != BLT_ERROR_INVALID_MEDIA_TYPE) {
                 /* success, or fatal error */
                 break;
@@ -1644,32 +2056,31 @@ Stream_ConnectPort(Stream*     self,
 }
 
 /*----------------------------------------------------------------------
-|    Stream_PumpPacket
+|    Stream_PumpNodes
+|
+|    pump one packet through the nodes from 'head' to 'tail', starting
+|    from the tail. When 'outbound' is not NULL, packets produced by the
+|    tail are queued instead of being delivered to the next node.
 +---------------------------------------------------------------------*/
-BLT_METHOD 
-Stream_PumpPacket(BLT_Stream* _self)
+static BLT_Result
+Stream_PumpNodes(Stream*          self, 
+                 StreamNode*      head, 
+                 StreamNode*      tail, 
+                 BLT_PacketQueue* outbound)
 {
-    Stream*          self = ATX_SELF(Stream, BLT_Stream);
-    StreamNode*      node;
+    StreamNode*      node = tail;
     BLT_MediaPacket* packet;
     BLT_Result       result = BLT_FAILURE;
 
-    /* check that we have an input and an output */
-    if (self->input.node  == NULL ||
-        self->output.node == NULL) {
-        ATX_LOG_WARNING("no input or output node");
-        return BLT_FAILURE;
-    }
-
     /* get the next available packet */
-    node = self->nodes.tail;
     while (node) {
         /* ensure that the node and its sources (if any) are started */
         StreamNode* target = node;
         while (target) {
             result = StreamNode_Start(target);
             if (BLT_FAILED(result)) return result;
-            if (!target->input.connected || 
+            if (target == head              ||
+                !target->input.connected    || 
                 target->input.protocol != BLT_MEDIA_PORT_PROTOCOL_STREAM_PULL) {
                 break;
             }
@@ -1682,15 +2093,24 @@ Stream_PumpPacket(BLT_Stream* _self)
             break;
 
           case BLT_MEDIA_PORT_PROTOCOL_PACKET:
+            /* don't take a packet from the tail if we can't queue it */
+            if (outbound && node == tail && BLT_PacketQueue_IsFull(outbound)) {
+                return BLT_ERROR_WOULD_BLOCK;
+            }
+
             /* get a packet from the node's output port */
-            result = BLT_PacketProducer_GetPacket(
-                node->output.iface.packet_producer,
-                &packet);
+            result = StreamNode_GetPacket(node, &packet, self->profiling.enabled);
             if (BLT_SUCCEEDED(result) && packet != NULL) {
+                /* several groups may get here at the same time */
+                BLT_Mutex_Lock(self->lock);
                 if (self->at_start) {
                     BLT_MediaPacket_SetFlags(packet, BLT_MEDIA_PACKET_FLAG_START_OF_STREAM);
                     self->at_start = ATX_FALSE;
                 }
+                BLT_Mutex_Unlock(self->lock);
+                if (outbound && node == tail) {
+                    return BLT_PacketQueue_Push(outbound, packet);
+                }
                 return Stream_DeliverPacket(self, packet, node);
             } else {
                 if (result != BLT_ERROR_PORT_HAS_NO_DATA) {
@@ -1718,9 +2138,330 @@ Stream_PumpPacket(BLT_Stream* _self)
         }
 
         /* move to the previous node */
+        if (node == head) break;
         node = node->prev;
     }
 
+    /* when pumping a node group, tell the caller that nothing came out */
+    if (outbound || head->prev) return BLT_ERROR_PORT_HAS_NO_DATA;
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_PumpThreadGroup
++---------------------------------------------------------------------*/
+static BLT_Result
+Stream_PumpThreadGroup(Stream* self, StreamThreadGroup* group)
+{
+    BLT_MediaPacket* packet;
+    BLT_Result       result;
+
+    /* let the nodes of the group produce what they can first */
+    result = Stream_PumpNodes(self, group->head, group->tail, group->outbound);
+    if (result != BLT_ERROR_PORT_HAS_NO_DATA || group->inbound == NULL) {
+        return result;
+    }
+
+    /* the group needs more input, take it from the upstream group */
+    result = BLT_PacketQueue_Pop(group->inbound, &packet);
+
+    /* the queue is empty, or closed with the upstream group's result */
+    if (BLT_FAILED(result)) return result;
+
+    return Stream_DeliverPacket(self, packet, group->head->prev);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ThreadGroupMain
++---------------------------------------------------------------------*/
+static void
+Stream_ThreadGroupMain(BLT_WorkerThread* thread, BLT_Any instance)
+{
+    StreamThreadGroup* group = (StreamThreadGroup*)instance;
+    Stream*            stream = group->stream;
+    BLT_Boolean        feeds_caller;
+    BLT_Result         result;
+
+    /* the last group is pumped by the caller of Stream_PumpPacket, */
+    /* which may want to know when it has something to pump        */
+    feeds_caller = (group == &stream->threading.groups[stream->threading.group_count-2]);
+
+    while (!BLT_WorkerThread_IsStopping(thread)) {
+        result = Stream_PumpThreadGroup(stream, group);
+        if (BLT_SUCCEEDED(result)) {
+            if (feeds_caller) Stream_NodeReady(stream, group->tail);
+        } else if (result == BLT_ERROR_WOULD_BLOCK) {
+            /* wait for the downstream group to catch up */
+            BLT_PacketQueue_WaitForSpace(group->outbound, 
+                                         BLT_STREAM_THREADING_WAIT_TIMEOUT);
+        } else if (result == BLT_ERROR_PORT_HAS_NO_DATA) {
+            if (group->inbound) {
+                /* wait for the upstream group */
+                BLT_PacketQueue_WaitForData(group->inbound, 
+                                            BLT_STREAM_THREADING_WAIT_TIMEOUT);
+            } else {
+                /* the input has nothing for us yet, it wakes us up with */
+                /* a NODE_READY event when it has (see Stream_OnEvent)   */
+                BLT_WorkerThread_Wait(thread, BLT_STREAM_THREADING_WAIT_TIMEOUT);
+            }
+        } else if (BLT_FAILED(result)) {
+            /* the downstream group gets the result once the queue is empty */
+            ATX_LOG_FINE_1("Stream::ThreadGroupMain - done (%d)", result);
+            BLT_PacketQueue_Close(group->outbound, result);
+            if (feeds_caller) Stream_NodeReady(stream, group->tail);
+            break;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ReadConfig
++---------------------------------------------------------------------*/
+static void
+Stream_ReadConfig(Stream* self)
+{
+    ATX_Properties*   properties = NULL;
+    ATX_PropertyValue property;
+
+    /* defaults */
+    self->threading.enabled    = BLT_FALSE;
+    self->threading.queue_size = BLT_CONFIG_STREAM_THREADING_DEFAULT_QUEUE_SIZE;
+    self->profiling.enabled    = BLT_FALSE;
+
+    /* the configuration is read from the core properties */
+    if (BLT_FAILED(BLT_Core_GetProperties(self->core, &properties)) || 
+        properties == NULL) {
+        return;
+    }
+    if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties, 
+                                                 BLT_STREAM_THREADING_ENABLED_PROPERTY, 
+                                                 &property)) &&
+        property.type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN) {
+        self->threading.enabled = property.data.boolean?BLT_TRUE:BLT_FALSE;
+    }
+    if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties, 
+                                                 BLT_STREAM_THREADING_QUEUE_SIZE_PROPERTY, 
+                                                 &property)) &&
+        property.type == ATX_PROPERTY_VALUE_TYPE_INTEGER &&
+        property.data.integer > 0) {
+        self->threading.queue_size = (BLT_Cardinal)property.data.integer;
+    }
+    if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties, 
+                                                 BLT_STREAM_PROFILING_ENABLED_PROPERTY, 
+                                                 &property)) &&
+        property.type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN) {
+        self->profiling.enabled = property.data.boolean?BLT_TRUE:BLT_FALSE;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Stream_BuildThreadGroups
++---------------------------------------------------------------------*/
+static BLT_Result
+Stream_BuildThreadGroups(Stream* self)
+{
+    StreamThreadGroup* groups = self->threading.groups;
+    StreamNode*        head   = self->nodes.head;
+    StreamNode*        node;
+    BLT_Cardinal       count = 0;
+    BLT_Cardinal       i;
+    BLT_Result         result;
+
+    /* all the connections must have been made, because the chain */
+    /* can only be modified when no node is running on a worker   */
+    for (node = self->nodes.head; node && node->next; node = node->next) {
+        if (!node->output.connected) return BLT_ERROR_INVALID_STATE;
+    }
+
+    /* split the chain after the first packet connections */
+    for (node = self->nodes.head; node; node = node->next) {
+        if (node->next == NULL ||
+            (node->output.protocol == BLT_MEDIA_PORT_PROTOCOL_PACKET &&
+             count < BLT_STREAM_MAX_THREAD_GROUPS-1)) {
+            ATX_SetMemory(&groups[count], 0, sizeof(groups[count]));
+            groups[count].stream = self;
+            groups[count].head   = head;
+            groups[count].tail   = node;
+            head = node->next;
+            ++count;
+        }
+    }
+    if (count < 2) return BLT_ERROR_NOT_SUPPORTED;
+
+    /* create the queues between the groups */
+    for (i=0; i<count-1; i++) {
+        result = BLT_PacketQueue_Create(self->threading.queue_size, 
+                                        &groups[i].outbound);
+        if (BLT_FAILED(result)) {
+            while (i--) BLT_PacketQueue_Destroy(groups[i].outbound);
+            return result;
+        }
+        groups[i+1].inbound = groups[i].outbound;
+    }
+    self->threading.group_count = count;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_StartThreads
++---------------------------------------------------------------------*/
+static BLT_Result
+Stream_StartThreads(Stream* self)
+{
+    BLT_Cardinal i;
+    BLT_Result   result;
+
+    /* split the chain into groups the first time around */
+    if (self->threading.group_count == 0) {
+        result = Stream_BuildThreadGroups(self);
+        if (BLT_FAILED(result)) return result;
+    }
+
+    /* from now on, property changes made by the workers are queued */
+    /* until the owner pumps the stream again                       */
+    self->threading.owner   = BLT_Thread_GetCurrentId();
+    self->threading.running = BLT_TRUE;
+
+    /* start one worker for each group except the last */
+    for (i=0; i<self->threading.group_count-1; i++) {
+        StreamThreadGroup* group = &self->threading.groups[i];
+
+        BLT_WorkerThread*  thread;
+
+        /* a group that has finished is not restarted */
+        if (BLT_PacketQueue_IsClosed(group->outbound)) continue;
+
+        result = BLT_WorkerThread_Create(Stream_ThreadGroupMain, 
+                                         group, 
+                                         &thread);
+        if (BLT_FAILED(result)) {
+            Stream_StopThreads(self);
+            return result;
+        }
+
+        /* Stream_WakeWorkers may look at it from another thread */
+        BLT_Mutex_Lock(self->lock);
+        group->thread = thread;
+        BLT_Mutex_Unlock(self->lock);
+    }
+
+    ATX_LOG_FINE_1("Stream::StartThreads - %d node groups", 
+                   self->threading.group_count);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_StopThreads
+|
+|    stop the worker threads, leaving the queued packets in place
++---------------------------------------------------------------------*/
+static BLT_Result
+Stream_StopThreads(Stream* self)
+{
+    BLT_Cardinal i;
+
+    /* tell all the workers to stop, then wake them up */
+    for (i=0; i<self->threading.group_count; i++) {
+        StreamThreadGroup* group = &self->threading.groups[i];
+        if (group->thread) BLT_WorkerThread_RequestStop(group->thread);
+    }
+    for (i=0; i<self->threading.group_count; i++) {
+        StreamThreadGroup* group = &self->threading.groups[i];
+        if (group->outbound) BLT_PacketQueue_Wake(group->outbound);
+    }
+
+    /* wait for them to exit */
+    for (i=0; i<self->threading.group_count; i++) {
+        StreamThreadGroup* group = &self->threading.groups[i];
+        BLT_WorkerThread*  thread;
+
+        /* Stream_WakeWorkers may look at it from another thread */
+        BLT_Mutex_Lock(self->lock);
+        thread = group->thread;
+        group->thread = NULL;
+        BLT_Mutex_Unlock(self->lock);
+
+        if (thread) BLT_WorkerThread_Destroy(thread);
+    }
+    self->threading.running = BLT_FALSE;
+
+    /* deliver what the workers have left behind, after which nothing */
+    /* can use the values they have read anymore                      */
+    Stream_ApplyPendingProperties(self);
+    Stream_DeliverPendingEvents(self);
+    Stream_ReleaseWorkerValues(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ResetThreads
+|
+|    stop the worker threads and drop the groups and queued packets
++---------------------------------------------------------------------*/
+static BLT_Result
+Stream_ResetThreads(Stream* self)
+{
+    BLT_Cardinal i;
+
+    /* quick check */
+    if (self->threading.group_count == 0) return BLT_SUCCESS;
+
+    Stream_StopThreads(self);
+    for (i=0; i<self->threading.group_count; i++) {
+        StreamThreadGroup* group = &self->threading.groups[i];
+        if (group->outbound) BLT_PacketQueue_Destroy(group->outbound);
+    }
+    ATX_SetMemory(self->threading.groups, 0, sizeof(self->threading.groups));
+    self->threading.group_count = 0;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_PumpPacket
++---------------------------------------------------------------------*/
+BLT_METHOD 
+Stream_PumpPacket(BLT_Stream* _self)
+{
+    Stream*    self = ATX_SELF(Stream, BLT_Stream);
+    BLT_Result result;
+
+    /* check that we have an input and an output */
+    if (self->input.node  == NULL ||
+        self->output.node == NULL) {
+        ATX_LOG_WARNING("no input or output node");
+        return BLT_FAILURE;
+    }
+
+    /* once the chain is complete, run the upstream groups on workers */
+    if (self->threading.enabled && !self->threading.running) {
+        Stream_StartThreads(self);
+    }
+    if (self->threading.running) {
+        /* what the workers have sent is delivered on this thread */
+        Stream_ApplyPendingProperties(self);
+        Stream_DeliverPendingEvents(self);
+
+        /* this doesn't wait for the upstream group: when it has nothing */
+        /* yet, the caller gets BLT_ERROR_PORT_HAS_NO_DATA, and a        */
+        /* NODE_READY event when it has (see Stream_ThreadGroupMain)     */
+        result = Stream_PumpThreadGroup(
+            self,
+            &self->threading.groups[self->threading.group_count-1]);
+    } else {
+        result = Stream_PumpNodes(self, self->nodes.head, self->nodes.tail, NULL);
+    }
+
+    /* keep the node statistics properties reasonably fresh */
+    if (self->profiling.enabled || self->profiling.published_node_count) {
+        Stream_UpdateNodeStatistics(self, result);
+    }
+    Stream_UpdatePacketPoolStats(self, result);
+
     return result;
 }
 
@@ -1751,6 +2492,9 @@ Stream_Stop(BLT_Stream* _self)
     Stream*     self = ATX_SELF(Stream, BLT_Stream);
     StreamNode* node = self->nodes.head;
 
+    /* stop the worker threads first, they will restart on the next pump */
+    Stream_StopThreads(self);
+
     /* stop all the nodes */
     while (node) {
         StreamNode_Stop(node);
@@ -1769,6 +2513,9 @@ Stream_Pause(BLT_Stream* _self)
     Stream*     self = ATX_SELF(Stream, BLT_Stream);
     StreamNode* node = self->nodes.head;
 
+    /* stop the worker threads first, they will restart on the next pump */
+    Stream_StopThreads(self);
+
     /* pause all the nodes */
     while (node) {
         StreamNode_Pause(node);
@@ -1784,8 +2531,12 @@ Stream_Pause(BLT_Stream* _self)
 BLT_METHOD
 Stream_SetInfo(BLT_Stream* _self, const BLT_StreamInfo* info)
 {
-    Stream*  self        = ATX_SELF(Stream, BLT_Stream);
-    BLT_Mask update_mask = 0;
+    Stream*             self        = ATX_SELF(Stream, BLT_Stream);
+    BLT_Mask            update_mask = 0;
+    StreamPendingEvent* pending     = NULL;
+
+    /* nodes running on worker threads may call this concurrently */
+    BLT_Mutex_Lock(self->lock);
 
     self->info.mask |= info->mask;
     if ((info->mask & BLT_STREAM_INFO_MASK_TYPE) &&
@@ -1868,12 +2619,22 @@ Stream_SetInfo(BLT_Stream* _self, const BLT_StreamInfo* info)
         event.update_mask = update_mask;
         event.info        = self->info;
         
-        BLT_EventListener_OnEvent(self->event_listener, 
-                                  (ATX_Object*)self, 
-                                  BLT_EVENT_TYPE_STREAM_INFO,
-                                  (const BLT_Event*)(const void*)&event);
+        /* the info can change as soon as the lock is released, so the */
+        /* listener gets a copy, which a worker leaves to the owner    */
+        pending = Stream_CopyEvent((ATX_Object*)self, 
+                                   BLT_EVENT_TYPE_STREAM_INFO,
+                                   (const BLT_Event*)(const void*)&event);
+        if (pending && Stream_IsWorkerThread(self)) {
+            ATX_List_AddData(self->pending_events, pending);
+            pending = NULL;
+        }
     }   
         
+    BLT_Mutex_Unlock(self->lock);
+
+    /* notify the listener without holding the lock */
+    if (pending) Stream_SendPendingEvent(self, pending);
+
     return BLT_SUCCESS;
 }
 
@@ -1885,7 +2646,9 @@ Stream_GetInfo(BLT_Stream* _self, BLT_StreamInfo* info)
 {
     Stream* self = ATX_SELF(Stream, BLT_Stream);
 
+    BLT_Mutex_Lock(self->lock);
     *info = self->info;
+    BLT_Mutex_Unlock(self->lock);
 
     return BLT_SUCCESS;
 }
@@ -1899,6 +2662,7 @@ Stream_GetStatus(BLT_Stream* _self, BLT_StreamStatus* status)
     Stream* self = ATX_SELF(Stream, BLT_Stream);
 
     /* set the stream status */
+    BLT_Mutex_Lock(self->lock);
     status->time_stamp = self->output.next_time_stamp;
     if (self->info.duration) {
         /* estimate the position from the time stamp and duration */
@@ -1908,6 +2672,7 @@ Stream_GetStatus(BLT_Stream* _self, BLT_StreamStatus* status)
         status->position.offset = 0;
         status->position.range  = 0;
     }
+    BLT_Mutex_Unlock(self->lock);
     
     /* compute the output node status */
     BLT_TimeStamp_Set(status->output_status.media_time, 0, 0);
@@ -1920,6 +2685,136 @@ Stream_GetStatus(BLT_Stream* _self, BLT_StreamStatus* status)
     return BLT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|    Stream_SetNodeStatisticsProperty
++---------------------------------------------------------------------*/
+static void
+Stream_SetNodeStatisticsProperty(Stream*                  self, 
+                                 BLT_Ordinal              index,
+                                 const char*              counter,
+                                 const ATX_PropertyValue* value)
+{
+    char name[64];
+
+    ATX_FormatStringN(name, sizeof(name), 
+                      BLT_STREAM_PROFILING_NODE_PROPERTY_PREFIX "%d.%s", 
+                      (int)index, counter);
+    ATX_Properties_SetProperty(&ATX_BASE(self, ATX_Properties), name, value);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_PublishNodeStatistics
++---------------------------------------------------------------------*/
+static void
+Stream_PublishNodeStatistics(Stream* self)
+{
+    static const char* const counters[] = {
+        BLT_STREAM_PROFILING_NODE_NAME,
+        BLT_STREAM_PROFILING_NODE_PUT_PACKET_COUNT,
+        BLT_STREAM_PROFILING_NODE_PUT_PACKET_BYTES,
+        BLT_STREAM_PROFILING_NODE_PUT_PACKET_TIME,
+        BLT_STREAM_PROFILING_NODE_GET_PACKET_COUNT,
+        BLT_STREAM_PROFILING_NODE_GET_PACKET_BYTES,
+        BLT_STREAM_PROFILING_NODE_GET_PACKET_TIME,
+        BLT_STREAM_PROFILING_NODE_WOULD_BLOCK_COUNT
+    };
+    StreamNode*  node;
+    BLT_Ordinal  node_count;
+    BLT_Ordinal  index = 0;
+    unsigned int i;
+
+    /* when profiling has been disabled, only remove what was published */
+    node = self->profiling.enabled?self->nodes.head:NULL;
+    for (; node; node = node->next, index++) {
+        const BLT_StreamNodeStatistics* statistics = &node->statistics;
+        BLT_MediaNodeInfo               info;
+        ATX_PropertyValue               value;
+
+        value.type = ATX_PROPERTY_VALUE_TYPE_STRING;
+        if (BLT_SUCCEEDED(BLT_MediaNode_GetInfo(node->media_node, &info)) && info.name) {
+            value.data.string = info.name;
+            Stream_SetNodeStatisticsProperty(self, index, counters[0], &value);
+        } else {
+            Stream_SetNodeStatisticsProperty(self, index, counters[0], NULL);
+        }
+
+        value.type = ATX_PROPERTY_VALUE_TYPE_LARGE_INTEGER;
+        value.data.large_integer = (ATX_Int64)statistics->put_packet_count;
+        Stream_SetNodeStatisticsProperty(self, index, counters[1], &value);
+        value.data.large_integer = (ATX_Int64)statistics->put_packet_bytes;
+        Stream_SetNodeStatisticsProperty(self, index, counters[2], &value);
+        value.data.large_integer = (ATX_Int64)statistics->put_packet_time;
+        Stream_SetNodeStatisticsProperty(self, index, counters[3], &value);
+        value.data.large_integer = (ATX_Int64)statistics->get_packet_count;
+        Stream_SetNodeStatisticsProperty(self, index, counters[4], &value);
+        value.data.large_integer = (ATX_Int64)statistics->get_packet_bytes;
+        Stream_SetNodeStatisticsProperty(self, index, counters[5], &value);
+        value.data.large_integer = (ATX_Int64)statistics->get_packet_time;
+        Stream_SetNodeStatisticsProperty(self, index, counters[6], &value);
+        value.data.large_integer = (ATX_Int64)statistics->would_block_count;
+        Stream_SetNodeStatisticsProperty(self, index, counters[7], &value);
+    }
+
+    node_count = index;
+
+    /* remove the properties of nodes that are no longer in the chain */
+    for (; index < self->profiling.published_node_count; index++) {
+        for (i=0; i<sizeof(counters)/sizeof(counters[0]); i++) {
+            Stream_SetNodeStatisticsProperty(self, index, counters[i], NULL);
+        }
+    }
+    self->profiling.published_node_count = node_count;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_UpdateNodeStatistics
+|
+|    publish the node statistics when they are stale or when the stream
+|    has stopped producing packets
++---------------------------------------------------------------------*/
+static void
+Stream_UpdateNodeStatistics(Stream* self, BLT_Result result)
+{
+    ATX_UInt64 now = BLT_Time_GetMonotonicNanos();
+
+    if (BLT_SUCCEEDED(result)                  || 
+        result == BLT_ERROR_WOULD_BLOCK        ||
+        result == BLT_ERROR_PORT_HAS_NO_DATA) {
+        if (now-self->profiling.published_time < 
+            (ATX_UInt64)BLT_CONFIG_STREAM_PROFILING_PUBLISH_INTERVAL*1000000) {
+            return;
+        }
+    }
+
+    Stream_PublishNodeStatistics(self);
+    self->profiling.published_time = now;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_UpdatePacketPoolStats
+|
+|    publish the core's packet pool statistics at a low rate, and when
+|    the stream has stopped producing packets, whether or not profiling
+|    is enabled
++---------------------------------------------------------------------*/
+static void
+Stream_UpdatePacketPoolStats(Stream* self, BLT_Result result)
+{
+    ATX_UInt64 now = BLT_Time_GetMonotonicNanos();
+
+    if (BLT_SUCCEEDED(result)                  || 
+        result == BLT_ERROR_WOULD_BLOCK        ||
+        result == BLT_ERROR_PORT_HAS_NO_DATA) {
+        if (now-self->pool_stats_time < 
+            (ATX_UInt64)BLT_CONFIG_STREAM_POOL_STATS_PUBLISH_INTERVAL*1000000) {
+            return;
+        }
+    }
+
+    BLT_Core_PublishPacketPoolStats(self->core);
+    self->pool_stats_time = now;
+}
+
 /*----------------------------------------------------------------------
 |    Stream_GetProperties
 +---------------------------------------------------------------------*/
@@ -1927,7 +2822,8 @@ BLT_METHOD
 Stream_GetProperties(BLT_Stream* _self, ATX_Properties** properties)
 {
     Stream* self = ATX_SELF(Stream, BLT_Stream);
-    *properties = self->properties;
+
+    *properties = &ATX_BASE(self, ATX_Properties);
     return BLT_SUCCESS;
 }
 
@@ -2063,6 +2959,9 @@ Stream_Seek(Stream*        self,
     /* check parameters */
     if (mode == NULL || point == NULL) return BLT_ERROR_INVALID_PARAMETERS;
 
+    /* stop the worker threads and drop the packets they have queued */
+    Stream_ResetThreads(self);
+
     /* go through all the nodes in reverse order */
     while (node) {
         /* tell the node to seek */
@@ -2147,12 +3046,484 @@ Stream_OnEvent(BLT_EventListener* _self,
                BLT_EventType      type,
                const BLT_Event*   event)
 {
-    Stream* self = ATX_SELF(Stream, BLT_EventListener);
+    Stream*             self = ATX_SELF(Stream, BLT_EventListener);
+    StreamPendingEvent* pending;
+    BLT_Boolean         from_worker;
+
+    /* a node that is ready may be one that a worker is waiting for.   */
+    /* This comes from any thread and is meant to wake up the threads */
+    /* that wait, so it is forwarded right away                        */
+    if (type == BLT_EVENT_TYPE_NODE_READY) {
+        Stream_WakeWorkers(self);
+        if (self->event_listener) {
+            BLT_EventListener_OnEvent(self->event_listener, source, type, event);
+        }
+        return;
+    }
 
-    if (self->event_listener) {
-        BLT_EventListener_OnEvent(self->event_listener, 
-                                  source, type, event);
+    /* quick check */
+    if (self->event_listener == NULL) return;
+
+    /* events from the workers are sent on the owner's thread */
+    BLT_Mutex_Lock(self->lock);
+    from_worker = Stream_IsWorkerThread(self);
+    if (from_worker) {
+        pending = Stream_CopyEvent(source, type, event);
+        if (pending) {
+            ATX_List_AddData(self->pending_events, pending);
+        } else {
+            ATX_LOG_WARNING_1("dropping event of type %d", type);
+        }
+    }
+    BLT_Mutex_Unlock(self->lock);
+
+    if (!from_worker) {
+        BLT_EventListener_OnEvent(self->event_listener, source, type, event);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Stream_IsWorkerThread
++---------------------------------------------------------------------*/
+static BLT_Boolean
+Stream_IsWorkerThread(Stream* self)
+{
+    return self->threading.running && 
+           BLT_Thread_GetCurrentId() != self->threading.owner;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_QueueProperty
+|
+|    called with the lock held
++---------------------------------------------------------------------*/
+static BLT_Result
+Stream_QueueProperty(Stream*                  self, 
+                     ATX_CString              name, 
+                     const ATX_PropertyValue* value)
+{
+    StreamPendingProperty* pending;
+    ATX_Property           property;
+
+    /* make room for one more */
+    if (self->pending_properties.count == self->pending_properties.allocated) {
+        BLT_Cardinal           allocated = self->pending_properties.allocated?
+                                           2*self->pending_properties.allocated:8;
+        StreamPendingProperty* items = (StreamPendingProperty*)
+            ATX_AllocateZeroMemory(allocated*sizeof(StreamPendingProperty));
+        if (items == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+        if (self->pending_properties.items) {
+            ATX_CopyMemory(items, 
+                           self->pending_properties.items,
+                           self->pending_properties.count*sizeof(StreamPendingProperty));
+            ATX_FreeMemory(self->pending_properties.items);
+        }
+        self->pending_properties.items     = items;
+        self->pending_properties.allocated = allocated;
     }
+
+    /* keep a copy, the caller's value may not outlive this call */
+    pending = &self->pending_properties.items[self->pending_properties.count];
+    ATX_SetMemory(&property, 0, sizeof(property));
+    property.name = name;
+    if (value) property.value = *value;
+    ATX_Property_Clone(&property, &pending->property);
+    pending->removed = value?ATX_FALSE:ATX_TRUE;
+    ++self->pending_properties.count;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_NotifyPropertyListeners
+|
+|    called on the thread that owns the stream, without the lock
++---------------------------------------------------------------------*/
+static void
+Stream_NotifyPropertyListeners(Stream*                  self, 
+                               ATX_CString              name,
+                               const ATX_PropertyValue* value)
+{
+    ATX_PropertyListener** listeners;
+    ATX_ListItem*          item;
+    BLT_Cardinal           count = 0;
+    BLT_Cardinal           i;
+
+    /* take a snapshot, so that the listeners can add or remove listeners */
+    BLT_Mutex_Lock(self->lock);
+    listeners = (ATX_PropertyListener**)ATX_AllocateMemory(
+        (ATX_List_GetItemCount(self->property_listeners)+1)*sizeof(ATX_PropertyListener*));
+    if (listeners) {
+        for (item = ATX_List_GetFirstItem(self->property_listeners);
+             item;
+             item = ATX_ListItem_GetNext(item)) {
+            StreamPropertyListener* entry = (StreamPropertyListener*)ATX_ListItem_GetData(item);
+            if (entry->name == NULL || ATX_StringsEqual(entry->name, name)) {
+                listeners[count++] = entry->listener;
+            }
+        }
+    }
+    BLT_Mutex_Unlock(self->lock);
+    if (listeners == NULL) return;
+
+    for (i=0; i<count; i++) {
+        ATX_PropertyListener_OnPropertyChanged(listeners[i], name, value);
+    }
+    ATX_FreeMemory(listeners);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_PropertyValuesEqual
++---------------------------------------------------------------------*/
+static ATX_Boolean
+Stream_PropertyValuesEqual(const ATX_PropertyValue* a, const ATX_PropertyValue* b)
+{
+    if (a->type != b->type) return ATX_FALSE;
+    switch (a->type) {
+      case ATX_PROPERTY_VALUE_TYPE_STRING:
+        if (a->data.string == NULL || b->data.string == NULL) {
+            return a->data.string == b->data.string;
+        }
+        return ATX_StringsEqual(a->data.string, b->data.string);
+
+      case ATX_PROPERTY_VALUE_TYPE_RAW_DATA:
+        return a->data.raw_data.size == b->data.raw_data.size &&
+               (a->data.raw_data.size == 0 ||
+                ATX_CompareMemory(a->data.raw_data.data, 
+                                  b->data.raw_data.data, 
+                                  a->data.raw_data.size) == 0);
+
+      default:
+        return ATX_FALSE;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    Stream_KeepWorkerValue
+|
+|    called with the lock held. The owner may replace a string or raw
+|    data value as soon as the lock is released, so a worker gets a copy
+|    that stays valid until the workers are stopped.
++---------------------------------------------------------------------*/
+static ATX_Result
+Stream_KeepWorkerValue(Stream* self, ATX_CString name, ATX_PropertyValue* value)
+{
+    ATX_ListItem* item;
+    ATX_Property  property;
+    ATX_Property* copy;
+    ATX_Result    result;
+
+    /* other values are returned by value */
+    if (value->type != ATX_PROPERTY_VALUE_TYPE_STRING &&
+        value->type != ATX_PROPERTY_VALUE_TYPE_RAW_DATA) {
+        return ATX_SUCCESS;
+    }
+
+    /* reuse a copy of the same value if there is one */
+    for (item = ATX_List_GetFirstItem(self->worker_values);
+         item;
+         item = ATX_ListItem_GetNext(item)) {
+        ATX_Property* kept = (ATX_Property*)ATX_ListItem_GetData(item);
+        if (ATX_StringsEqual(kept->name, name) &&
+            Stream_PropertyValuesEqual(&kept->value, value)) {
+            *value = kept->value;
+            return ATX_SUCCESS;
+        }
+    }
+
+    /* keep a new one */
+    copy = (ATX_Property*)ATX_AllocateZeroMemory(sizeof(ATX_Property));
+    if (copy == NULL) return ATX_ERROR_OUT_OF_MEMORY;
+    property.name  = name;
+    property.value = *value;
+    result = ATX_Property_Clone(&property, copy);
+    if (ATX_SUCCEEDED(result)) {
+        result = ATX_List_AddData(self->worker_values, copy);
+        if (ATX_FAILED(result)) ATX_Property_Destruct(copy);
+    }
+    if (ATX_FAILED(result)) {
+        ATX_FreeMemory(copy);
+        return result;
+    }
+    *value = copy->value;
+
+    return ATX_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ReleaseWorkerValues
+|
+|    only called when no worker is running
++---------------------------------------------------------------------*/
+static void
+Stream_ReleaseWorkerValues(Stream* self)
+{
+    ATX_ListItem* item;
+
+    BLT_Mutex_Lock(self->lock);
+    for (item = ATX_List_GetFirstItem(self->worker_values);
+         item;
+         item = ATX_ListItem_GetNext(item)) {
+        ATX_Property* kept = (ATX_Property*)ATX_ListItem_GetData(item);
+        ATX_Property_Destruct(kept);
+        ATX_FreeMemory(kept);
+    }
+    ATX_List_Clear(self->worker_values);
+    BLT_Mutex_Unlock(self->lock);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ApplyPendingProperties
+|
+|    the changes queued by the workers are applied, and the listeners
+|    notified, on the thread that owns the stream
++---------------------------------------------------------------------*/
+static void
+Stream_ApplyPendingProperties(Stream* self)
+{
+    StreamPendingProperty* items;
+    BLT_Cardinal           count;
+    BLT_Cardinal           i;
+
+    BLT_Mutex_Lock(self->lock);
+
+    /* detach the queue first, the listeners may set properties too */
+    items = self->pending_properties.items;
+    count = self->pending_properties.count;
+    self->pending_properties.items     = NULL;
+    self->pending_properties.count     = 0;
+    self->pending_properties.allocated = 0;
+
+    for (i=0; i<count; i++) {
+        ATX_Properties_SetProperty(self->properties, 
+                                   items[i].property.name,
+                                   items[i].removed?NULL:&items[i].property.value);
+    }
+
+    BLT_Mutex_Unlock(self->lock);
+
+    if (items == NULL) return;
+    for (i=0; i<count; i++) {
+        Stream_NotifyPropertyListeners(self,
+                                       items[i].property.name,
+                                       items[i].removed?NULL:&items[i].property.value);
+    }
+
+    /* a worker may still be using a value it has read back from the */
+    /* queue, so the copies are kept until the workers are stopped   */
+    BLT_Mutex_Lock(self->lock);
+    for (i=0; i<count; i++) {
+        ATX_Property* kept = NULL;
+        if (self->threading.running && !items[i].removed) {
+            kept = (ATX_Property*)ATX_AllocateMemory(sizeof(ATX_Property));
+        }
+        if (kept && ATX_SUCCEEDED(ATX_List_AddData(self->worker_values, kept))) {
+            *kept = items[i].property;
+        } else {
+            if (kept) ATX_FreeMemory(kept);
+            ATX_Property_Destruct(&items[i].property);
+        }
+    }
+    BLT_Mutex_Unlock(self->lock);
+
+    ATX_FreeMemory(items);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_ClearPendingProperties
++---------------------------------------------------------------------*/
+static void
+Stream_ClearPendingProperties(Stream* self)
+{
+    BLT_Cardinal i;
+
+    BLT_Mutex_Lock(self->lock);
+    for (i=0; i<self->pending_properties.count; i++) {
+        ATX_Property_Destruct(&self->pending_properties.items[i].property);
+    }
+    if (self->pending_properties.items) {
+        ATX_FreeMemory(self->pending_properties.items);
+    }
+    self->pending_properties.items     = NULL;
+    self->pending_properties.count     = 0;
+    self->pending_properties.allocated = 0;
+    BLT_Mutex_Unlock(self->lock);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_GetProperty
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_GetProperty(ATX_Properties*    _self, 
+                   ATX_CString        name, 
+                   ATX_PropertyValue* value)
+{
+    Stream*     self = ATX_SELF(Stream, ATX_Properties);
+    BLT_Ordinal i;
+    ATX_Result  result;
+
+    BLT_Mutex_Lock(self->lock);
+
+    /* a worker sees its own changes before they are applied. The */
+    /* queued copies are kept until the workers are stopped       */
+    for (i=self->pending_properties.count; i--;) {
+        StreamPendingProperty* pending = &self->pending_properties.items[i];
+        if (ATX_StringsEqual(pending->property.name, name)) {
+            if (pending->removed) {
+                BLT_Mutex_Unlock(self->lock);
+                return ATX_ERROR_NO_SUCH_PROPERTY;
+            }
+            if (value) *value = pending->property.value;
+            BLT_Mutex_Unlock(self->lock);
+            return ATX_SUCCESS;
+        }
+    }
+    result = ATX_Properties_GetProperty(self->properties, name, value);
+    if (ATX_SUCCEEDED(result) && value && Stream_IsWorkerThread(self)) {
+        result = Stream_KeepWorkerValue(self, name, value);
+    }
+
+    BLT_Mutex_Unlock(self->lock);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_SetProperty
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_SetProperty(ATX_Properties*          _self, 
+                   ATX_CString              name, 
+                   const ATX_PropertyValue* value)
+{
+    Stream*    self = ATX_SELF(Stream, ATX_Properties);
+    ATX_Result result;
+
+    BLT_Mutex_Lock(self->lock);
+    if (Stream_IsWorkerThread(self)) {
+        /* the listeners expect to be called on the owner's thread */
+        result = Stream_QueueProperty(self, name, value);
+        BLT_Mutex_Unlock(self->lock);
+        return result;
+    }
+    BLT_Mutex_Unlock(self->lock);
+
+    /* changes queued earlier must not overwrite this one */
+    Stream_ApplyPendingProperties(self);
+
+    BLT_Mutex_Lock(self->lock);
+    result = ATX_Properties_SetProperty(self->properties, name, value);
+    BLT_Mutex_Unlock(self->lock);
+
+    /* the listeners are called without the lock */
+    if (ATX_SUCCEEDED(result)) Stream_NotifyPropertyListeners(self, name, value);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_DeleteProperty
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_DeleteProperty(ATX_Properties* _self, ATX_CString name)
+{
+    return Stream_SetProperty(_self, name, NULL);
+}
+
+/*----------------------------------------------------------------------
+|    Stream_GetIterator
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_GetIterator(ATX_Properties* _self, ATX_Iterator** iterator)
+{
+    Stream*    self = ATX_SELF(Stream, ATX_Properties);
+    ATX_Result result;
+
+    BLT_Mutex_Lock(self->lock);
+    result = ATX_Properties_GetIterator(self->properties, iterator);
+    BLT_Mutex_Unlock(self->lock);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_AddListener
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_AddListener(ATX_Properties*             _self, 
+                   ATX_CString                 name,
+                   ATX_PropertyListener*       listener,
+                   ATX_PropertyListenerHandle* handle)
+{
+    Stream*                 self = ATX_SELF(Stream, ATX_Properties);
+    StreamPropertyListener* entry;
+    ATX_Result              result;
+
+    /* the stream calls the listeners itself, so that it can do it */
+    /* without holding the lock                                    */
+    entry = (StreamPropertyListener*)ATX_AllocateZeroMemory(sizeof(StreamPropertyListener));
+    if (entry == NULL) return ATX_ERROR_OUT_OF_MEMORY;
+    if (name) entry->name = ATX_DuplicateString(name);
+    entry->listener = listener;
+
+    BLT_Mutex_Lock(self->lock);
+    result = ATX_List_AddData(self->property_listeners, entry);
+    BLT_Mutex_Unlock(self->lock);
+    if (ATX_FAILED(result)) {
+        if (entry->name) ATX_FreeMemory(entry->name);
+        ATX_FreeMemory(entry);
+        return result;
+    }
+
+    if (handle) *handle = (ATX_PropertyListenerHandle)entry;
+    return ATX_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_RemoveListener
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_RemoveListener(ATX_Properties*            _self, 
+                      ATX_PropertyListenerHandle handle)
+{
+    Stream*                 self = ATX_SELF(Stream, ATX_Properties);
+    StreamPropertyListener* entry = NULL;
+    ATX_ListItem*           item;
+
+    BLT_Mutex_Lock(self->lock);
+    for (item = ATX_List_GetFirstItem(self->property_listeners);
+         item;
+         item = ATX_ListItem_GetNext(item)) {
+        if (ATX_ListItem_GetData(item) == (ATX_Any)handle) {
+            entry = (StreamPropertyListener*)ATX_ListItem_GetData(item);
+            ATX_List_RemoveItem(self->property_listeners, item);
+            break;
+        }
+    }
+    BLT_Mutex_Unlock(self->lock);
+    if (entry == NULL) return ATX_ERROR_NO_SUCH_LISTENER;
+
+    if (entry->name) ATX_FreeMemory(entry->name);
+    ATX_FreeMemory(entry);
+
+    return ATX_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    Stream_Clear
++---------------------------------------------------------------------*/
+ATX_METHOD
+Stream_Clear(ATX_Properties* _self)
+{
+    Stream*    self = ATX_SELF(Stream, ATX_Properties);
+    ATX_Result result;
+
+    BLT_Mutex_Lock(self->lock);
+    Stream_ClearPendingProperties(self);
+    result = ATX_Properties_Clear(self->properties);
+    BLT_Mutex_Unlock(self->lock);
+
+    return result;
 }
 
 /*----------------------------------------------------------------------
@@ -2161,6 +3532,7 @@ Stream_OnEvent(BLT_EventListener* _self,
 ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(Stream)
     ATX_GET_INTERFACE_ACCEPT(Stream, BLT_Stream)
     ATX_GET_INTERFACE_ACCEPT(Stream, BLT_EventListener)
+    ATX_GET_INTERFACE_ACCEPT(Stream, ATX_Properties)
     ATX_GET_INTERFACE_ACCEPT(Stream, ATX_Referenceable)
 ATX_END_GET_INTERFACE_IMPLEMENTATION
 
@@ -2180,6 +3552,7 @@ ATX_BEGIN_INTERFACE_MAP(Stream, BLT_Stream)
     Stream_AddNode,
     Stream_AddNodeByName,
     Stream_GetStreamNodeInfo,
+    Stream_GetNodeStatistics,
     Stream_GetFirstNode,
     Stream_GetNextNode,
     Stream_PumpPacket,
@@ -2202,6 +3575,19 @@ ATX_BEGIN_INTERFACE_MAP(Stream, BLT_EventListener)
     Stream_OnEvent
 ATX_END_INTERFACE_MAP
 
+/*----------------------------------------------------------------------
+|   ATX_Properties interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(Stream, ATX_Properties)
+    Stream_GetProperty,
+    Stream_SetProperty,
+    Stream_DeleteProperty,
+    Stream_GetIterator,
+    Stream_AddListener,
+    Stream_RemoveListener,
+    Stream_Clear
+ATX_END_INTERFACE_MAP
+
 /*----------------------------------------------------------------------
 |   ATX_Referenceable interface
 +---------------------------------------------------------------------*/
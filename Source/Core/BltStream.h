@@ -75,6 +75,35 @@
 /* Common stream properties */
 #define BLT_STREAM_PROPERTY_METADATA_JSON "Metadata.Json"
 
+/* Threaded execution, read from the core properties when an input is set.
+ * When enabled, the input/parser and decoder node groups run on worker
+ * threads, and PumpPacket runs the remaining nodes up to the output.
+ * PumpPacket never waits for the workers: it returns
+ * BLT_ERROR_PORT_HAS_NO_DATA when they have nothing ready yet, and a
+ * BLT_EVENT_TYPE_NODE_READY event follows when they have. The events and
+ * property changes coming from the workers are delivered on the thread
+ * that calls PumpPacket.
+ */
+#define BLT_STREAM_THREADING_ENABLED_PROPERTY    "Stream.Threading.Enabled"
+#define BLT_STREAM_THREADING_QUEUE_SIZE_PROPERTY "Stream.Threading.QueueSize"
+
+/* Per-node profiling, read from the core properties when an input is set.
+ * When enabled, BLT_Stream_PumpPacket publishes the statistics of each
+ * node as "Stream.Profiling.Node.<index>.<counter>", with the node index
+ * counted from the input, at most once per second and when the stream
+ * stops producing packets (end of stream or error).
+ */
+#define BLT_STREAM_PROFILING_ENABLED_PROPERTY              "Stream.Profiling.Enabled"
+#define BLT_STREAM_PROFILING_NODE_PROPERTY_PREFIX          "Stream.Profiling.Node."
+#define BLT_STREAM_PROFILING_NODE_NAME                     "Name"
+#define BLT_STREAM_PROFILING_NODE_PUT_PACKET_COUNT         "PutPacketCount"
+#define BLT_STREAM_PROFILING_NODE_PUT_PACKET_BYTES         "PutPacketBytes"
+#define BLT_STREAM_PROFILING_NODE_PUT_PACKET_TIME          "PutPacketTime"
+#define BLT_STREAM_PROFILING_NODE_GET_PACKET_COUNT         "GetPacketCount"
+#define BLT_STREAM_PROFILING_NODE_GET_PACKET_BYTES         "GetPacketBytes"
+#define BLT_STREAM_PROFILING_NODE_GET_PACKET_TIME          "GetPacketTime"
+#define BLT_STREAM_PROFILING_NODE_WOULD_BLOCK_COUNT        "WouldBlockCount"
+
 /*----------------------------------------------------------------------
 |   types
 +---------------------------------------------------------------------*/
@@ -155,6 +184,20 @@ typedef struct {
     BLT_OutputNodeStatus output_status;
 } BLT_StreamStatus;
 
+/**
+ * Profiling counters of a stream node. Times are in nanoseconds, and
+ * all the counters stay at 0 unless profiling is enabled.
+ */
+typedef struct {
+    BLT_UInt64 put_packet_count;  /**< Packets accepted by the node       */
+    BLT_UInt64 put_packet_bytes;  /**< Payload bytes accepted by the node */
+    BLT_UInt64 put_packet_time;   /**< Time spent in PutPacket            */
+    BLT_UInt64 get_packet_count;  /**< Packets returned by the node       */
+    BLT_UInt64 get_packet_bytes;  /**< Payload bytes returned by the node */
+    BLT_UInt64 get_packet_time;   /**< Time spent in GetPacket            */
+    BLT_UInt64 would_block_count; /**< Calls that returned WOULD_BLOCK    */
+} BLT_StreamNodeStatistics;
+
 /*----------------------------------------------------------------------
 |   BLT_Stream Interface
 +---------------------------------------------------------------------*/
@@ -187,6 +230,9 @@ ATX_BEGIN_INTERFACE_DEFINITION(BLT_Stream)
     BLT_Result (*GetStreamNodeInfo)(BLT_Stream*          self,
                                     const BLT_MediaNode* node,
                                     BLT_StreamNodeInfo*  info);
+    BLT_Result (*GetNodeStatistics)(BLT_Stream*               self,
+                                    const BLT_MediaNode*      node,
+                                    BLT_StreamNodeStatistics* statistics);
     BLT_Result (*GetFirstNode)(BLT_Stream*         self,
                                BLT_MediaNode**     node);
     BLT_Result (*GetNextNode)(BLT_Stream*         self,
@@ -248,6 +294,9 @@ ATX_INTERFACE(object)->AddNodeByName(object, where, name)
 #define BLT_Stream_GetStreamNodeInfo(object, node, info) \
 ATX_INTERFACE(object)->GetStreamNodeInfo(object, node, info)
 
+#define BLT_Stream_GetNodeStatistics(object, node, statistics) \
+ATX_INTERFACE(object)->GetNodeStatistics(object, node, statistics)
+
 #define BLT_Stream_GetFirstNode(object, node) \
 ATX_INTERFACE(object)->GetFirstNode(object, node)
 
@@ -0,0 +1,480 @@
+/*****************************************************************
+|
+|   BlueTune - Threading Support
+|
+|   (c) 2002-2006 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "Atomix.h"
+#include "Neptune.h"
+#include "BltConfig.h"
+#include "BltThreadsPriv.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*----------------------------------------------------------------------
+|   BLT_Mutex
++---------------------------------------------------------------------*/
+struct BLT_Mutex {
+    BLT_Mutex() : m_Mutex(true) {}
+    NPT_Mutex m_Mutex;
+};
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue
+|
+|   the producer only writes m_Tail and the consumer only writes m_Head,
+|   so the only shared state is the packet count, which is updated
+|   atomically after a slot has been filled or emptied. The shared
+|   variables are only used to wake up a side that is waiting, and are
+|   only signaled when someone is actually waiting on them. Both sides
+|   and the stream owner (Wake) can signal the same variable, so the
+|   increment is done under m_SignalLock.
++---------------------------------------------------------------------*/
+struct BLT_PacketQueue {
+    BLT_PacketQueue(BLT_Cardinal capacity);
+   ~BLT_PacketQueue();
+
+    void Signal(NPT_SharedVariable& variable) {
+        NPT_AutoLock lock(m_SignalLock);
+        variable.SetValue(variable.GetValue()+1);
+    }
+
+    BLT_MediaPacket**  m_Packets;
+    BLT_Cardinal       m_Capacity;
+    BLT_Cardinal       m_Head;
+    BLT_Cardinal       m_Tail;
+    NPT_AtomicVariable m_Count;
+    NPT_AtomicVariable m_Closed;
+    BLT_Result         m_CloseResult;
+    NPT_AtomicVariable m_DataWaiters;
+    NPT_AtomicVariable m_SpaceWaiters;
+    NPT_SharedVariable m_DataSignal;
+    NPT_SharedVariable m_SpaceSignal;
+    NPT_Mutex          m_SignalLock;
+};
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue::BLT_PacketQueue
++---------------------------------------------------------------------*/
+BLT_PacketQueue::BLT_PacketQueue(BLT_Cardinal capacity) :
+    m_Packets(new BLT_MediaPacket*[capacity]),
+    m_Capacity(capacity),
+    m_Head(0),
+    m_Tail(0),
+    m_Count(0),
+    m_Closed(0),
+    m_CloseResult(BLT_SUCCESS),
+    m_DataWaiters(0),
+    m_SpaceWaiters(0)
+{
+    NPT_SetMemory(m_Packets, 0, capacity*sizeof(BLT_MediaPacket*));
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue::~BLT_PacketQueue
++---------------------------------------------------------------------*/
+BLT_PacketQueue::~BLT_PacketQueue()
+{
+    BLT_PacketQueue_Flush(this);
+    delete[] m_Packets;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Create
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Create(BLT_Cardinal capacity, BLT_PacketQueue** queue)
+{
+    if (capacity == 0) {
+        *queue = NULL;
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+    *queue = new BLT_PacketQueue(capacity);
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Destroy(BLT_PacketQueue* self)
+{
+    delete self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Push
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Push(BLT_PacketQueue* self, BLT_MediaPacket* packet)
+{
+    if ((BLT_Cardinal)self->m_Count.GetValue() >= self->m_Capacity) {
+        return BLT_ERROR_WOULD_BLOCK;
+    }
+
+    // fill the slot, then publish it
+    self->m_Packets[self->m_Tail] = packet;
+    self->m_Tail = (self->m_Tail+1)%self->m_Capacity;
+    self->m_Count.Increment();
+
+    if (self->m_DataWaiters.GetValue()) {
+        self->Signal(self->m_DataSignal);
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Pop
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Pop(BLT_PacketQueue* self, BLT_MediaPacket** packet)
+{
+    *packet = NULL;
+    if (self->m_Count.GetValue() == 0) {
+        if (!self->m_Closed.GetValue()) {
+            return BLT_ERROR_PORT_HAS_NO_DATA;
+        }
+
+        // the producer pushes all its packets before closing, so check
+        // again now that we know the queue is closed
+        if (self->m_Count.GetValue() == 0) {
+            return self->m_CloseResult;
+        }
+    }
+
+    // take the packet, then release the slot
+    *packet = self->m_Packets[self->m_Head];
+    self->m_Packets[self->m_Head] = NULL;
+    self->m_Head = (self->m_Head+1)%self->m_Capacity;
+    self->m_Count.Decrement();
+
+    if (self->m_SpaceWaiters.GetValue()) {
+        self->Signal(self->m_SpaceSignal);
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Close
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Close(BLT_PacketQueue* self, BLT_Result result)
+{
+    self->m_CloseResult = result;
+    self->m_Closed.Increment();
+    self->Signal(self->m_DataSignal);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Flush
+|
+|   only safe when neither the producer nor the consumer is running
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Flush(BLT_PacketQueue* self)
+{
+    for (BLT_Cardinal i=0; i<self->m_Capacity; i++) {
+        if (self->m_Packets[i]) {
+            BLT_MediaPacket_Release(self->m_Packets[i]);
+            self->m_Packets[i] = NULL;
+        }
+    }
+    self->m_Head = 0;
+    self->m_Tail = 0;
+    self->m_Count.SetValue(0);
+    self->m_Closed.SetValue(0);
+    self->m_CloseResult = BLT_SUCCESS;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_IsFull
++---------------------------------------------------------------------*/
+BLT_Boolean
+BLT_PacketQueue_IsFull(BLT_PacketQueue* self)
+{
+    return (BLT_Cardinal)self->m_Count.GetValue() >= self->m_Capacity ? BLT_TRUE : BLT_FALSE;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_IsClosed
++---------------------------------------------------------------------*/
+BLT_Boolean
+BLT_PacketQueue_IsClosed(BLT_PacketQueue* self)
+{
+    return self->m_Closed.GetValue() ? BLT_TRUE : BLT_FALSE;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_WaitForSpace
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_WaitForSpace(BLT_PacketQueue* self, BLT_Timeout timeout)
+{
+    // register as a waiter before checking the condition, so that the
+    // consumer either sees us waiting or we see its update
+    self->m_SpaceWaiters.Increment();
+    int generation = self->m_SpaceSignal.GetValue();
+    if ((BLT_Cardinal)self->m_Count.GetValue() >= self->m_Capacity) {
+        self->m_SpaceSignal.WaitWhileEquals(generation, timeout);
+    }
+    self->m_SpaceWaiters.Decrement();
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_WaitForData
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_WaitForData(BLT_PacketQueue* self, BLT_Timeout timeout)
+{
+    // same protocol as BLT_PacketQueue_WaitForSpace
+    self->m_DataWaiters.Increment();
+    int generation = self->m_DataSignal.GetValue();
+    if (self->m_Count.GetValue() == 0 && !self->m_Closed.GetValue()) {
+        self->m_DataSignal.WaitWhileEquals(generation, timeout);
+    }
+    self->m_DataWaiters.Decrement();
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_PacketQueue_Wake
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_PacketQueue_Wake(BLT_PacketQueue* self)
+{
+    self->Signal(self->m_DataSignal);
+    self->Signal(self->m_SpaceSignal);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread
++---------------------------------------------------------------------*/
+struct BLT_WorkerThread : public NPT_Thread {
+    BLT_WorkerThread(BLT_WorkerThreadFunction function, BLT_Any instance) :
+        m_Function(function),
+        m_Instance(instance),
+        m_Stopping(0) {}
+
+    // NPT_Thread methods
+    virtual void Run() { m_Function(this, m_Instance); }
+
+    BLT_WorkerThreadFunction m_Function;
+    BLT_Any                  m_Instance;
+    NPT_AtomicVariable       m_Stopping;
+    NPT_SharedVariable       m_WakeSignal;
+    NPT_Mutex                m_WakeLock;
+};
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread_Create
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_WorkerThread_Create(BLT_WorkerThreadFunction function,
+                        BLT_Any                  instance,
+                        BLT_WorkerThread**       thread)
+{
+    *thread = new BLT_WorkerThread(function, instance);
+    NPT_Result result = (*thread)->Start();
+    if (NPT_FAILED(result)) {
+        delete *thread;
+        *thread = NULL;
+        return result;
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_WorkerThread_Destroy(BLT_WorkerThread* self)
+{
+    // ask the function to return and wait until it does
+    BLT_WorkerThread_RequestStop(self);
+    self->Wait();
+    delete self;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread_RequestStop
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_WorkerThread_RequestStop(BLT_WorkerThread* self)
+{
+    // set the flag before waking the thread up, see BLT_WorkerThread_Wait
+    self->m_Stopping.SetValue(1);
+    return BLT_WorkerThread_Wake(self);
+}
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread_IsStopping
++---------------------------------------------------------------------*/
+BLT_Boolean
+BLT_WorkerThread_IsStopping(BLT_WorkerThread* self)
+{
+    return self->m_Stopping.GetValue() ? BLT_TRUE : BLT_FALSE;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread_Wait
+|
+|   called by the thread itself, returns when it is woken up, asked to
+|   stop, or after the timeout
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_WorkerThread_Wait(BLT_WorkerThread* self, BLT_Timeout timeout)
+{
+    // read the generation before checking the stop flag, so that a wake
+    // up that comes after this point is not missed
+    int generation = self->m_WakeSignal.GetValue();
+    if (!self->m_Stopping.GetValue()) {
+        self->m_WakeSignal.WaitWhileEquals(generation, timeout);
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_WorkerThread_Wake
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_WorkerThread_Wake(BLT_WorkerThread* self)
+{
+    NPT_AutoLock lock(self->m_WakeLock);
+    self->m_WakeSignal.SetValue(self->m_WakeSignal.GetValue()+1);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Mutex_Create
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_Mutex_Create(BLT_Mutex** mutex)
+{
+    *mutex = new BLT_Mutex();
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Mutex_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_Mutex_Destroy(BLT_Mutex* self)
+{
+    delete self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Mutex_Lock
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_Mutex_Lock(BLT_Mutex* self)
+{
+    return self->m_Mutex.Lock();
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Mutex_Unlock
++---------------------------------------------------------------------*/
+BLT_Result
+BLT_Mutex_Unlock(BLT_Mutex* self)
+{
+    return self->m_Mutex.Unlock();
+}
+
+/*----------------------------------------------------------------------
+|   globals
++---------------------------------------------------------------------*/
+#if !defined(_MSC_VER) && !defined(__GNUC__)
+/* used when the compiler has no atomic intrinsics */
+static NPT_Mutex BLT_AtomicCounterLock;
+#endif
+
+/*----------------------------------------------------------------------
+|   BLT_AtomicCounter_Increment
+|
+|   returns the new value of the counter
++---------------------------------------------------------------------*/
+long
+BLT_AtomicCounter_Increment(BLT_AtomicCounter* counter)
+{
+#if defined(_MSC_VER)
+    return _InterlockedIncrement(counter);
+#elif defined(__GNUC__)
+    return __sync_add_and_fetch(counter, 1);
+#else
+    NPT_AutoLock lock(BLT_AtomicCounterLock);
+    return ++*counter;
+#endif
+}
+
+/*----------------------------------------------------------------------
+|   BLT_AtomicCounter_Decrement
+|
+|   returns the new value of the counter
++---------------------------------------------------------------------*/
+long
+BLT_AtomicCounter_Decrement(BLT_AtomicCounter* counter)
+{
+#if defined(_MSC_VER)
+    return _InterlockedDecrement(counter);
+#elif defined(__GNUC__)
+    return __sync_sub_and_fetch(counter, 1);
+#else
+    NPT_AutoLock lock(BLT_AtomicCounterLock);
+    return --*counter;
+#endif
+}
+
+/*----------------------------------------------------------------------
+|   BLT_AtomicCounter_Get
+|
+|   returns the current value of the counter, ordered with the other
+|   atomic operations on it
++---------------------------------------------------------------------*/
+long
+BLT_AtomicCounter_Get(BLT_AtomicCounter* counter)
+{
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchange(counter, 0, 0);
+#elif defined(__GNUC__)
+    return __sync_add_and_fetch(counter, 0);
+#else
+    NPT_AutoLock lock(BLT_AtomicCounterLock);
+    return *counter;
+#endif
+}
+
+/*----------------------------------------------------------------------
+|   BLT_Thread_GetCurrentId
++---------------------------------------------------------------------*/
+BLT_ThreadId
+BLT_Thread_GetCurrentId(void)
+{
+    return (BLT_ThreadId)NPT_Thread::GetCurrentThreadId();
+}
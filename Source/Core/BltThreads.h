@@ -0,0 +1,49 @@
+/*****************************************************************
+|
+|   BlueTune - Threading Support
+|
+|   (c) 2002-2006 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+/** @file
+ * Threading API
+ */
+
+#ifndef _BLT_THREADS_H_
+#define _BLT_THREADS_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "Atomix.h"
+#include "BltDefs.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Recursive mutex, for modules that share state between the thread
+ * that runs the stream and the threads that set their properties.
+ */
+typedef struct BLT_Mutex BLT_Mutex;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+BLT_Result BLT_Mutex_Create(BLT_Mutex** mutex);
+BLT_Result BLT_Mutex_Destroy(BLT_Mutex* mutex);
+BLT_Result BLT_Mutex_Lock(BLT_Mutex* mutex);
+BLT_Result BLT_Mutex_Unlock(BLT_Mutex* mutex);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _BLT_THREADS_H_ */
@@ -0,0 +1,102 @@
+/*****************************************************************
+|
+|   BlueTune - Threading Support Private API
+|
+|   (c) 2002-2006 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_THREADS_PRIV_H_
+#define _BLT_THREADS_PRIV_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "Atomix.h"
+#include "BltDefs.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+#include "BltMediaPacket.h"
+#include "BltMediaPort.h"
+#include "BltThreads.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#define BLT_TIMEOUT_INFINITE (-1)
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/** Timeout, in milliseconds */
+typedef BLT_Int32 BLT_Timeout;
+
+/**
+ * Counter that can be incremented and decremented from any thread.
+ */
+typedef volatile long BLT_AtomicCounter;
+
+/**
+ * Identifier of a thread, only meaningful when compared to another one.
+ */
+typedef unsigned long BLT_ThreadId;
+
+/**
+ * Bounded single-producer/single-consumer queue of media packets.
+ * Push and Pop never block: a full queue returns BLT_ERROR_WOULD_BLOCK
+ * and an empty one returns BLT_ERROR_PORT_HAS_NO_DATA. Once the producer
+ * has closed the queue, Pop returns the close result after the last
+ * packet has been consumed.
+ */
+typedef struct BLT_PacketQueue BLT_PacketQueue;
+
+/**
+ * Thread that runs a function until it returns. The function can sleep
+ * with BLT_WorkerThread_Wait until another thread wakes it up or asks
+ * it to stop.
+ */
+typedef struct BLT_WorkerThread BLT_WorkerThread;
+
+typedef void (*BLT_WorkerThreadFunction)(BLT_WorkerThread* thread,
+                                         BLT_Any           instance);
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+long BLT_AtomicCounter_Increment(BLT_AtomicCounter* counter);
+long BLT_AtomicCounter_Decrement(BLT_AtomicCounter* counter);
+long BLT_AtomicCounter_Get(BLT_AtomicCounter* counter);
+
+BLT_ThreadId BLT_Thread_GetCurrentId(void);
+
+BLT_Result  BLT_PacketQueue_Create(BLT_Cardinal capacity, BLT_PacketQueue** queue);
+BLT_Result  BLT_PacketQueue_Destroy(BLT_PacketQueue* queue);
+BLT_Result  BLT_PacketQueue_Push(BLT_PacketQueue* queue, BLT_MediaPacket* packet);
+BLT_Result  BLT_PacketQueue_Pop(BLT_PacketQueue* queue, BLT_MediaPacket** packet);
+BLT_Result  BLT_PacketQueue_Close(BLT_PacketQueue* queue, BLT_Result result);
+BLT_Result  BLT_PacketQueue_Flush(BLT_PacketQueue* queue);
+BLT_Boolean BLT_PacketQueue_IsFull(BLT_PacketQueue* queue);
+BLT_Boolean BLT_PacketQueue_IsClosed(BLT_PacketQueue* queue);
+BLT_Result  BLT_PacketQueue_WaitForSpace(BLT_PacketQueue* queue, BLT_Timeout timeout);
+BLT_Result  BLT_PacketQueue_WaitForData(BLT_PacketQueue* queue, BLT_Timeout timeout);
+BLT_Result  BLT_PacketQueue_Wake(BLT_PacketQueue* queue);
+
+BLT_Result  BLT_WorkerThread_Create(BLT_WorkerThreadFunction function,
+                                    BLT_Any                  instance,
+                                    BLT_WorkerThread**       thread);
+BLT_Result  BLT_WorkerThread_Destroy(BLT_WorkerThread* thread);
+BLT_Result  BLT_WorkerThread_RequestStop(BLT_WorkerThread* thread);
+BLT_Boolean BLT_WorkerThread_IsStopping(BLT_WorkerThread* thread);
+BLT_Result  BLT_WorkerThread_Wait(BLT_WorkerThread* thread, BLT_Timeout timeout);
+BLT_Result  BLT_WorkerThread_Wake(BLT_WorkerThread* thread);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _BLT_THREADS_PRIV_H_ */
@@ -13,6 +13,14 @@
 #include "Atomix.h"
 #include "BltTime.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
 /*----------------------------------------------------------------------
 |   BLT_TimeStamp_Add
 +---------------------------------------------------------------------*/
@@ -140,3 +148,32 @@ BLT_TimeStamp_FromSamples(ATX_Int64 sample_count,
 {
     return BLT_TimeStamp_FromMicros((sample_count*1000000)/sample_rate);
 }
+
+/*----------------------------------------------------------------------
+|   BLT_Time_GetMonotonicNanos
++---------------------------------------------------------------------*/
+ATX_UInt64
+BLT_Time_GetMonotonicNanos(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = {0};
+    LARGE_INTEGER        counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (ATX_UInt64)(counter.QuadPart/frequency.QuadPart)*1000000000+
+           (ATX_UInt64)(counter.QuadPart%frequency.QuadPart)*1000000000/frequency.QuadPart;
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase = {0, 0};
+    if (timebase.denom == 0) mach_timebase_info(&timebase);
+    return mach_absolute_time()*timebase.numer/timebase.denom;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (ATX_UInt64)now.tv_sec*1000000000+now.tv_nsec;
+#else
+    /* no monotonic clock on this platform, use the system time */
+    ATX_TimeStamp now;
+    ATX_System_GetCurrentTimeStamp(&now);
+    return (ATX_UInt64)now.seconds*1000000000+now.nanoseconds;
+#endif
+}
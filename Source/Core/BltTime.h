@@ -88,6 +88,12 @@ ATX_UInt64    BLT_TimeStamp_ToMillis(BLT_TimeStamp ts);
 BLT_TimeStamp BLT_TimeStamp_FromSamples(ATX_Int64 sample_count,
                                         ATX_Int32 sample_rate);
 
+/**
+ * Returns the value of a monotonic clock, in nanoseconds, for measuring
+ * time intervals. The origin of the clock is unspecified.
+ */
+ATX_UInt64    BLT_Time_GetMonotonicNanos(void);
+
 #if defined(__cplusplus)
 }
 #endif
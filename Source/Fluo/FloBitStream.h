@@ -41,6 +41,19 @@ typedef struct FLO_BitStream
     unsigned int    bits_cached;
 } FLO_BitStream;
 
+/* 64-bit reader for the Huffman decoding loops. The cache is left
+   aligned and refilled with a single 8-byte load, so that a whole 
+   codeword (with its linbits and sign bits) can be decoded without
+   touching memory again. */
+typedef struct FLO_BitReservoir
+{
+    const FLO_Byte* data;
+    FLO_Size        data_size;
+    FLO_Size        pos;
+    FLO_UInt64      cache;
+    unsigned int    bits_cached;
+} FLO_BitReservoir;
+
 /*----------------------------------------------------------------------
 |       prototypes
 +---------------------------------------------------------------------*/
@@ -232,4 +245,117 @@ FLO_BitStream_SkipBit(FLO_BitStream* bits)
    }
 }
 
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_LoadWord
++---------------------------------------------------------------------*/
+static inline FLO_UInt64
+FLO_BitReservoir_LoadWord(const FLO_Byte* in)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__)
+    FLO_UInt64 word;
+    __builtin_memcpy(&word, in, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+#else
+    return    (((FLO_UInt64) in[0]) << 56)
+            | (((FLO_UInt64) in[1]) << 48)
+            | (((FLO_UInt64) in[2]) << 40)
+            | (((FLO_UInt64) in[3]) << 32)
+            | (((FLO_UInt64) in[4]) << 24)
+            | (((FLO_UInt64) in[5]) << 16)
+            | (((FLO_UInt64) in[6]) <<  8)
+            | (((FLO_UInt64) in[7])      );
+#endif
+}
+
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_Refill
+|
+|       Tops the cache up to at least 56 bits. Past the end of the data,
+|       the stream reads as zeros.
++---------------------------------------------------------------------*/
+static inline void
+FLO_BitReservoir_Refill(FLO_BitReservoir* bits)
+{
+    if (bits->pos + 8 <= bits->data_size) {
+        /* only whole bytes are accounted for, the extra bits that */
+        /* come with the load are loaded again by the next refill  */
+        bits->cache |= FLO_BitReservoir_LoadWord(&bits->data[bits->pos]) >> bits->bits_cached;
+        bits->pos   += (63 - bits->bits_cached) >> 3;
+        bits->bits_cached |= 56;
+    } else {
+        while (bits->bits_cached < 56) {
+            if (bits->pos < bits->data_size) {
+                bits->cache |= ((FLO_UInt64)bits->data[bits->pos]) << (56 - bits->bits_cached);
+            }
+            bits->pos++;
+            bits->bits_cached += 8;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_Init
+|
+|       Starts reading where a bitstream is currently positioned. The
+|       bitstream itself does not move.
++---------------------------------------------------------------------*/
+static inline void
+FLO_BitReservoir_Init(FLO_BitReservoir* bits, const FLO_BitStream* stream)
+{
+    FLO_Size position = 8*stream->pos - stream->bits_cached;
+
+    bits->data        = stream->data;
+    bits->data_size   = stream->data_size;
+    bits->pos         = position/8;
+    bits->cache       = 0;
+    bits->bits_cached = 0;
+    FLO_BitReservoir_Refill(bits);
+    bits->cache      <<= position%8;
+    bits->bits_cached -= position%8;
+}
+
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_PeekBits
+|
+|       n must be between 1 and 32, and not more than the cached bits.
++---------------------------------------------------------------------*/
+static inline unsigned int
+FLO_BitReservoir_PeekBits(const FLO_BitReservoir* bits, unsigned int n)
+{
+    return (unsigned int)(bits->cache >> (64 - n));
+}
+
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_SkipBits
++---------------------------------------------------------------------*/
+static inline void
+FLO_BitReservoir_SkipBits(FLO_BitReservoir* bits, unsigned int n)
+{
+    bits->cache      <<= n;
+    bits->bits_cached -= n;
+}
+
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_ReadBits
++---------------------------------------------------------------------*/
+static inline unsigned int
+FLO_BitReservoir_ReadBits(FLO_BitReservoir* bits, unsigned int n)
+{
+    unsigned int result = FLO_BitReservoir_PeekBits(bits, n);
+    FLO_BitReservoir_SkipBits(bits, n);
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|       FLO_BitReservoir_ReadBit
++---------------------------------------------------------------------*/
+static inline unsigned int
+FLO_BitReservoir_ReadBit(FLO_BitReservoir* bits)
+{
+    return FLO_BitReservoir_ReadBits(bits, 1);
+}
+
 #endif /* _FLO_BIT_STREAM_H_ */
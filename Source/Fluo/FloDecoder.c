@@ -58,10 +58,10 @@ struct FLO_Decoder {
 static void
 FLO_UpdateBufferSize(FLO_SampleBuffer* buffer)
 {
-    /* assume 16 bits per sample */
     buffer->size = 
         buffer->sample_count *
-        buffer->format.channel_count * 2;
+        buffer->format.channel_count *
+        (buffer->format.bits_per_sample/8);
 }
 
 /*----------------------------------------------------------------------
@@ -160,6 +160,15 @@ FLO_Decoder_Flush(FLO_Decoder* decoder)
     return FLO_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|   FLO_Decoder_SetSampleType
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_Decoder_SetSampleType(FLO_Decoder* decoder, FLO_SampleType type)
+{
+    return FLO_Engine_SetSampleType(decoder->engine, type);
+}
+
 /*----------------------------------------------------------------------
 |   FLO_Decoder_SetSample
 +---------------------------------------------------------------------*/
@@ -170,6 +179,33 @@ FLO_Decoder_SetSample(FLO_Decoder* decoder, FLO_Int64 sample)
     return FLO_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|   FLO_Decoder_SkipSamples
+|
+|   Discards the next samples that would be decoded (the skipped samples
+|   are not counted). This must be called after a reset, which clears
+|   the skip count.
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_Decoder_SkipSamples(FLO_Decoder* decoder, FLO_Cardinal sample_count)
+{
+    decoder->samples_to_skip += sample_count;
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_Decoder_GetBufferedSize
+|
+|   Returns the number of bytes that have been fed but not consumed yet.
+|   After a frame has been found, this is counted from the frame start.
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_Decoder_GetBufferedSize(FLO_Decoder* decoder, FLO_Size* size)
+{
+    *size = FLO_ByteStream_GetBytesAvailable(&decoder->bits);
+    return FLO_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |   FLO_Decoder_FindFrame
 +---------------------------------------------------------------------*/
@@ -344,6 +380,7 @@ FLO_Decoder_DecodeFrame(FLO_Decoder*      decoder,
             decoder->samples_to_skip -= buffer->sample_count;
             buffer->sample_count = 0;
             buffer->size = 0;
+            decoder->state = FLO_DECODER_STATE_NEEDS_FRAME;
             return FLO_ERROR_SAMPLES_SKIPPED;
         } else {
             /* skip part of the buffer */
@@ -351,9 +388,10 @@ FLO_Decoder_DecodeFrame(FLO_Decoder*      decoder,
             buffer->sample_count -= decoder->samples_to_skip;
             FLO_UpdateBufferSize(buffer);
             buffer->samples = 
-                ((short*)buffer->samples) +
+                ((unsigned char*)buffer->samples) +
                 (decoder->samples_to_skip * 
-                 buffer->format.channel_count);
+                 buffer->format.channel_count *
+                 (buffer->format.bits_per_sample/8));
             decoder->samples_to_skip = 0;
         }
     }
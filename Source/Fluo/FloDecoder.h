@@ -24,7 +24,8 @@
 typedef struct FLO_Decoder FLO_Decoder;
 
 typedef enum {
-    FLO_SAMPLE_TYPE_INTERLACED_SIGNED
+    FLO_SAMPLE_TYPE_INTERLACED_SIGNED,
+    FLO_SAMPLE_TYPE_INTERLACED_FLOAT
 } FLO_SampleType;
 
 typedef struct {
@@ -101,8 +102,14 @@ FLO_Result FLO_Decoder_Feed(FLO_Decoder*   decoder,
                             FLO_Size*      size,
                             FLO_Flags      flags);
 FLO_Result FLO_Decoder_Flush(FLO_Decoder* decoder);
+FLO_Result FLO_Decoder_SetSampleType(FLO_Decoder*   decoder,
+                                     FLO_SampleType type);
 FLO_Result FLO_Decoder_SetSample(FLO_Decoder* decoder,
                                  FLO_Int64    sample);
+FLO_Result FLO_Decoder_SkipSamples(FLO_Decoder* decoder,
+                                   FLO_Cardinal sample_count);
+FLO_Result FLO_Decoder_GetBufferedSize(FLO_Decoder* decoder,
+                                       FLO_Size*    size);
 FLO_Result FLO_Decoder_FindFrame(FLO_Decoder*   decoder, 
                                  FLO_FrameInfo* frame_info);
 FLO_Result FLO_Decoder_SkipFrame(FLO_Decoder* decoder);
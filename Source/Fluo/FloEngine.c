@@ -55,6 +55,7 @@ typedef enum {
 
 typedef struct {
     FLO_OutputChannelsMode channels;
+    FLO_SampleType         sample_type;
 } FLO_EngineConfig;
 
 struct FLO_Engine {
@@ -103,6 +104,7 @@ FLO_Engine_Construct(FLO_Engine* self)
     FLO_SynthesisFilter_Create(&self->right_filter);
     FLO_LayerIII_ResetFrame(&self->frame.frame_III);
     self->config.channels = FLO_OUTPUT_STEREO;
+    self->config.sample_type = FLO_SAMPLE_TYPE_INTERLACED_SIGNED;
     self->main_data.available = 0;
     return FLO_SUCCESS;
 }
@@ -262,6 +264,8 @@ FLO_Engine_DecodeFrame(FLO_Engine*          self,
 {
     FLO_SynthesisFilter* left_filter  = self->left_filter;
     FLO_SynthesisFilter* right_filter = self->right_filter;
+    int                  float_output = (self->config.sample_type == FLO_SAMPLE_TYPE_INTERLACED_FLOAT);
+    FLO_Size             sample_size  = float_output ? 4 : 2;
     FLO_Result           result;
 
     /* read the header */
@@ -275,10 +279,12 @@ FLO_Engine_DecodeFrame(FLO_Engine*          self,
     
     /* setup the filters and audio buffer parameters */
     sample_buffer->sample_count           = frame_info->sample_count;
-    sample_buffer->format.type            = FLO_SAMPLE_TYPE_INTERLACED_SIGNED;
+    sample_buffer->format.type            = self->config.sample_type;
     sample_buffer->format.sample_rate     = frame_info->sample_rate;
     sample_buffer->format.channel_count   = frame_info->channel_count;
-    sample_buffer->format.bits_per_sample = 16;
+    sample_buffer->format.bits_per_sample = 8*sample_size;
+    left_filter->float_output  = float_output;
+    right_filter->float_output = float_output;
     if (frame_info->mode == FLO_MPEG_MODE_SINGLE_CHANNEL) {
         right_filter = NULL;
         left_filter->buffer = sample_buffer->samples;
@@ -309,7 +315,7 @@ FLO_Engine_DecodeFrame(FLO_Engine*          self,
           case FLO_OUTPUT_STEREO:
             left_filter->buffer            = sample_buffer->samples;
             left_filter->buffer_increment  = 2;
-            right_filter->buffer           = ((short*)sample_buffer->samples)+1;
+            right_filter->buffer           = ((unsigned char*)sample_buffer->samples)+sample_size;
             right_filter->buffer_increment = 2;
             break;
         }
@@ -351,7 +357,7 @@ FLO_Engine_DecodeFrame(FLO_Engine*          self,
 
     if (result == FLO_SUCCESS) {
         sample_buffer->size = sample_buffer->format.channel_count *
-                              frame_info->sample_count * 2;
+                              frame_info->sample_count * sample_size;
     } else {
         sample_buffer->size = 0;
     }
@@ -360,6 +366,28 @@ FLO_Engine_DecodeFrame(FLO_Engine*          self,
 }
 #endif
 
+/*----------------------------------------------------------------------
+|   FLO_Engine_SetSampleType
++---------------------------------------------------------------------*/
+#if (FLO_DECODER_ENGINE == FLO_DECODER_ENGINE_BUILTIN)
+FLO_Result
+FLO_Engine_SetSampleType(FLO_Engine* self, FLO_SampleType type)
+{
+    self->config.sample_type = type;
+    return FLO_SUCCESS;
+}
+#else
+FLO_Result
+FLO_Engine_SetSampleType(FLO_Engine* self, FLO_SampleType type)
+{
+    ATX_COMPILER_UNUSED(self);
+
+    /* the external engines only produce 16-bit samples */
+    return type == FLO_SAMPLE_TYPE_INTERLACED_SIGNED ? 
+           FLO_SUCCESS : FLO_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 /*----------------------------------------------------------------------
 |   FLO_Engine_Reset
 +---------------------------------------------------------------------*/
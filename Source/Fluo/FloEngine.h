@@ -28,6 +28,7 @@ typedef struct FLO_Engine FLO_Engine;
 FLO_Result FLO_Engine_Create(FLO_Engine** engine);
 FLO_Result FLO_Engine_Destroy(FLO_Engine* engine);
 FLO_Result FLO_Engine_Reset(FLO_Engine* engine);
+FLO_Result FLO_Engine_SetSampleType(FLO_Engine* engine, FLO_SampleType type);
 FLO_Result FLO_Engine_DecodeFrame(FLO_Engine*          engine, 
                                   const FLO_FrameInfo* frame_info,
                                   const unsigned char* frame_data,
@@ -47,10 +47,14 @@
 /* Decoder errors */
 #define FLO_ERROR_BASE_DECODER           (-80100)
 
+/* Frame Index errors */
+#define FLO_ERROR_BASE_FRAME_INDEX       (-80200)
+
 /*----------------------------------------------------------------------
 |    import some Atomix error codes
 +---------------------------------------------------------------------*/
 #define FLO_ERROR_OUT_OF_MEMORY      ATX_ERROR_OUT_OF_MEMORY
 #define FLO_ERROR_INVALID_PARAMETERS ATX_ERROR_INVALID_PARAMETERS
+#define FLO_ERROR_NOT_SUPPORTED      ATX_ERROR_NOT_SUPPORTED
 
 #endif /* _FLO_ERRORS_H_ */
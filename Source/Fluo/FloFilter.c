@@ -20,6 +20,38 @@
 
 #if (FLO_DECODER_ENGINE == FLO_DECODER_ENGINE_BUILTIN)
 
+/*----------------------------------------------------------------------
+|       SIMD support
++---------------------------------------------------------------------*/
+#if !defined(FLO_CONFIG_INTEGER_DECODE) && !defined(FLO_CONFIG_DISABLE_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLO_FILTER_HAVE_SIMD
+#define FLO_FILTER_HAVE_SSE
+#include <emmintrin.h>
+
+/* the AVX2 windowing is compiled for the target even when the rest of */
+/* the code isn't, and only used when the CPU supports it              */
+#if defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define FLO_FILTER_HAVE_AVX2
+#define FLO_FILTER_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && _MSC_VER >= 1700
+#define FLO_FILTER_HAVE_AVX2
+#define FLO_FILTER_AVX2_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FLO_FILTER_HAVE_SIMD
+#define FLO_FILTER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+#endif /* FLO_CONFIG_INTEGER_DECODE */
+
 /*----------------------------------------------------------------------
 |       constants
 +---------------------------------------------------------------------*/
@@ -97,6 +129,11 @@
 
 #define FLO_FILTER_STORE_SIZE      (16*17)
 
+/*----------------------------------------------------------------------
+|       forward declarations
++---------------------------------------------------------------------*/
+static FLO_SynthesisFilter_WindowFunction FLO_SynthesisFilter_SelectWindow(void);
+
 /*-------------------------------------------------------------------------
 |   FLO_SynthesisFilter_Create
 +-------------------------------------------------------------------------*/
@@ -129,6 +166,12 @@ FLO_SynthesisFilter_Create(FLO_SynthesisFilter** filter)
     /* no sumbsampling */
     (*filter)->subsampling = 0;
 
+    /* 16-bit output */
+    (*filter)->float_output = 0;
+
+    /* use the fastest windowing for this CPU */
+    (*filter)->window = FLO_SynthesisFilter_SelectWindow();
+
     /* reset the values */
     FLO_SynthesisFilter_Reset(*filter);
 
@@ -173,6 +216,7 @@ FLO_SynthesisFilter_Reset(FLO_SynthesisFilter* filter)
     filter->v_offset = 0;    
 }
 
+#if !defined(FLO_FILTER_HAVE_SIMD)
 /*-------------------------------------------------------------------------
 |       FLO_SynthesisFilter_Idct
 +-------------------------------------------------------------------------*/
@@ -513,23 +557,68 @@ FLO_SynthesisFilter_Idct(FLO_SynthesisFilter* filter)
         /*s1[0x100] = v[31];  */
     }
 }
+#endif /* FLO_FILTER_HAVE_SIMD */
 
 /*----------------------------------------------------------------------
 |   FLO_STORE_SAMPLE
-|   clip and store a sample in the output buffer 
+|   convert (clip in 16-bit mode) and store a sample in the output buffer
 +---------------------------------------------------------------------*/
 #define FLO_STORE_SAMPLE(buffer, sample)                \
 {                                                       \
-    int out = FLO_FIX_TO_SHORT(sample);                 \
-    if (out < -32768) {                                 \
-        *buffer = -32768;                               \
-    } else if (out > 32767) {                           \
-        *buffer = 32767;                                \
+    if (float_output) {                                 \
+        *(float*)(buffer) = FLO_FIX_TO_FLOAT(sample);   \
     } else {                                            \
-        *buffer = (short)out;                           \
+        int out = FLO_FIX_TO_SHORT(sample);             \
+        if (out < -32768) {                             \
+            *(short*)(buffer) = -32768;                 \
+        } else if (out > 32767) {                       \
+            *(short*)(buffer) = 32767;                  \
+        } else {                                        \
+            *(short*)(buffer) = (short)out;             \
+        }                                               \
     }                                                   \
+    (buffer) += increment;                              \
+}
+
+#if defined(FLO_FILTER_HAVE_SIMD)
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_StorePcm
+|   convert the samples computed by a vector windowing function and 
+|   store them in the output buffer
++---------------------------------------------------------------------*/
+static void
+FLO_SynthesisFilter_StorePcm(FLO_SynthesisFilter* filter,
+                             const FLO_Float*     samples,
+                             int                  sample_count)
+{
+    int increment = filter->buffer_increment;
+    int i;
+
+    if (filter->float_output) {
+        /* no clipping, out of range samples are kept as they are */
+        float* buffer = (float*)filter->buffer;
+        for (i = 0; i < sample_count; i++, buffer += increment) {
+            *buffer = FLO_FIX_TO_FLOAT(samples[i]);
+        }
+        filter->buffer = buffer;
+    } else {
+        short* buffer = (short*)filter->buffer;
+        for (i = 0; i < sample_count; i++, buffer += increment) {
+            int out = FLO_FIX_TO_SHORT(samples[i]);
+            if (out < -32768) {
+                *buffer = -32768;
+            } else if (out > 32767) {
+                *buffer = 32767;
+            } else {
+                *buffer = (short)out;
+            }
+        }
+        filter->buffer = buffer;
+    }
 }
+#endif /* FLO_FILTER_HAVE_SIMD */
 
+#if !defined(FLO_FILTER_HAVE_SIMD)
 /*----------------------------------------------------------------------
 |   FLO_SynthesisFilter_ComputeAndStorePcm
 +---------------------------------------------------------------------*/
@@ -538,7 +627,10 @@ FLO_SynthesisFilter_ComputeAndStorePcm(FLO_SynthesisFilter* filter)
 {
     register       FLO_Float* v = filter->v;
     register const FLO_Float* d = FLO_SynthesisFilter_D + (16-filter->v_offset);
-    short*                    buffer = filter->buffer;   
+    unsigned char*            buffer = (unsigned char*)filter->buffer;
+    int                       float_output = filter->float_output;
+    int                       increment = filter->buffer_increment*
+                                          (int)(float_output?sizeof(float):sizeof(short));
     int                       i;
 
     /* compute the first 16 samples */
@@ -560,7 +652,6 @@ FLO_SynthesisFilter_ComputeAndStorePcm(FLO_SynthesisFilter* filter)
               FLO_FC0_MUL(v[13], d[13]) + 
               FLO_FC0_MUL(v[14], d[14]) + 
               FLO_FC0_MUL(v[15], d[15]));
-        buffer += filter->buffer_increment;
     }
 
     /* for the second half, there is a phase inversion, so there is a sign */
@@ -576,7 +667,6 @@ FLO_SynthesisFilter_ComputeAndStorePcm(FLO_SynthesisFilter* filter)
               FLO_FC0_MUL(v[11], d[11]) + 
               FLO_FC0_MUL(v[13], d[13]) + 
               FLO_FC0_MUL(v[15], d[15]));
-        buffer += filter->buffer_increment;
 
         /* do the last 15 samples */
         d += (filter->v_offset<<1) - 48;
@@ -600,8 +690,7 @@ FLO_SynthesisFilter_ComputeAndStorePcm(FLO_SynthesisFilter* filter)
                   FLO_FC0_MUL(v[13], d[ 2]) +
                   FLO_FC0_MUL(v[14], d[ 1]) - 
                   FLO_FC0_MUL(v[15], d[ 0]));
-            buffer += filter->buffer_increment;
-        }
+            }
     } else {
         /* 17th sample, use the fact that some of the v[] values are FLO_ZERO */
         FLO_STORE_SAMPLE(buffer,
@@ -613,7 +702,6 @@ FLO_SynthesisFilter_ComputeAndStorePcm(FLO_SynthesisFilter* filter)
               FLO_FC0_MUL(v[10], d[10]) + 
               FLO_FC0_MUL(v[12], d[12]) + 
               FLO_FC0_MUL(v[14], d[14]));
-        buffer += filter->buffer_increment;
         
         /* do the last 15 samples */
         d += (filter->v_offset<<1) - 48;
@@ -637,11 +725,11 @@ FLO_SynthesisFilter_ComputeAndStorePcm(FLO_SynthesisFilter* filter)
                   FLO_FC0_MUL(v[ 2], d[13]) +
                   FLO_FC0_MUL(v[ 1], d[14]) - 
                   FLO_FC0_MUL(v[ 0], d[15]));
-            buffer += filter->buffer_increment;
-        }
+            }
     }
     filter->buffer = buffer;
 }
+#endif /* FLO_FILTER_HAVE_SIMD */
 
 /*----------------------------------------------------------------------
 |   FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled
@@ -651,7 +739,10 @@ FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(FLO_SynthesisFilter* filter)
 {
     register       FLO_Float* v = filter->v;
     register const FLO_Float* d = FLO_SynthesisFilter_D + (16-filter->v_offset);
-    short*                    buffer = filter->buffer;
+    unsigned char*            buffer = (unsigned char*)filter->buffer;
+    int                       float_output = filter->float_output;
+    int                       increment = filter->buffer_increment*
+                                          (int)(float_output?sizeof(float):sizeof(short));
     int                       mask;
     int                       i;
 
@@ -678,7 +769,6 @@ FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(FLO_SynthesisFilter* filter)
               FLO_FC0_MUL(v[13], d[13]) + 
               FLO_FC0_MUL(v[14], d[14]) + 
               FLO_FC0_MUL(v[15], d[15]));
-        buffer += filter->buffer_increment;
     }
 
     /* for the second half, there is a phase inversion, so there is a sign */
@@ -694,7 +784,6 @@ FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(FLO_SynthesisFilter* filter)
               FLO_FC0_MUL(v[11], d[11]) + 
               FLO_FC0_MUL(v[13], d[13]) + 
               FLO_FC0_MUL(v[15], d[15]));
-        buffer += filter->buffer_increment;
 
         /* do the last half of the samples */
         d += (filter->v_offset<<1) - 48;
@@ -719,8 +808,7 @@ FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(FLO_SynthesisFilter* filter)
                   FLO_FC0_MUL(v[13], d[ 2]) +
                   FLO_FC0_MUL(v[14], d[ 1]) - 
                   FLO_FC0_MUL(v[15], d[ 0]));
-            buffer += filter->buffer_increment;
-        }
+            }
     } else {
         /* middle sample, use the fact that some of the v[] values are FLO_ZERO */
         FLO_STORE_SAMPLE(buffer,
@@ -732,7 +820,6 @@ FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(FLO_SynthesisFilter* filter)
               FLO_FC0_MUL(v[10], d[10]) + 
               FLO_FC0_MUL(v[12], d[12]) + 
               FLO_FC0_MUL(v[14], d[14]));
-        buffer += filter->buffer_increment;
         
         /* do the last half of the samples */
         d += (filter->v_offset<<1) - 48;
@@ -757,12 +844,421 @@ FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(FLO_SynthesisFilter* filter)
                   FLO_FC0_MUL(v[ 2], d[13]) +
                   FLO_FC0_MUL(v[ 1], d[14]) - 
                   FLO_FC0_MUL(v[ 0], d[15]));
-            buffer += filter->buffer_increment;
-        }
+            }
     }
     filter->buffer = buffer;
 }
 
+/*----------------------------------------------------------------------
+|   SIMD kernels
+|
+|   In float builds, the DCT butterflies and the windowing are done 4
+|   values at a time with SSE or NEON, and the windowing 8 outputs at a
+|   time with AVX2 when the CPU supports it. The DCT gives the same
+|   results as the scalar code, the windowing only differs by the order
+|   in which the products are added.
++---------------------------------------------------------------------*/
+#if defined(FLO_FILTER_HAVE_SIMD)
+
+#if defined(FLO_FILTER_HAVE_SSE)
+typedef __m128 FLO_Vector;
+#define FLO_VECTOR_LOAD(p)      _mm_loadu_ps(p)
+#define FLO_VECTOR_STORE(p, x)  _mm_storeu_ps(p, x)
+#define FLO_VECTOR_SET(a,b,c,d) _mm_setr_ps(a, b, c, d)
+#define FLO_VECTOR_SET1(a)      _mm_set1_ps(a)
+#define FLO_VECTOR_ADD(x, y)    _mm_add_ps(x, y)
+#define FLO_VECTOR_SUB(x, y)    _mm_sub_ps(x, y)
+#define FLO_VECTOR_MUL(x, y)    _mm_mul_ps(x, y)
+#define FLO_VECTOR_REVERSE(x)   _mm_shuffle_ps(x, x, _MM_SHUFFLE(0,1,2,3))
+
+/* transposes a 4x4 matrix, one row per vector */
+static inline void
+FLO_Vector_Transpose4(FLO_Vector* r)
+{
+    _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+}
+
+/* returns the sums of the 4 lanes of a, b, c and d */
+static inline FLO_Vector
+FLO_Vector_Sum4(FLO_Vector a, FLO_Vector b, FLO_Vector c, FLO_Vector d)
+{
+    __m128 ab = _mm_add_ps(_mm_unpacklo_ps(a, b), _mm_unpackhi_ps(a, b));
+    __m128 cd = _mm_add_ps(_mm_unpacklo_ps(c, d), _mm_unpackhi_ps(c, d));
+    return _mm_add_ps(_mm_movelh_ps(ab, cd), _mm_movehl_ps(cd, ab));
+}
+#else
+typedef float32x4_t FLO_Vector;
+#define FLO_VECTOR_LOAD(p)      vld1q_f32(p)
+#define FLO_VECTOR_SET1(a)      vdupq_n_f32(a)
+#define FLO_VECTOR_STORE(p, x)  vst1q_f32(p, x)
+#define FLO_VECTOR_ADD(x, y)    vaddq_f32(x, y)
+#define FLO_VECTOR_SUB(x, y)    vsubq_f32(x, y)
+#define FLO_VECTOR_MUL(x, y)    vmulq_f32(x, y)
+#define FLO_VECTOR_REVERSE(x)   vcombine_f32(vget_high_f32(vrev64q_f32(x)), \
+                                             vget_low_f32(vrev64q_f32(x)))
+
+static inline FLO_Vector
+FLO_VECTOR_SET(float a, float b, float c, float d)
+{
+    float values[4];
+    values[0] = a; values[1] = b; values[2] = c; values[3] = d;
+    return vld1q_f32(values);
+}
+
+/* transposes a 4x4 matrix, one row per vector */
+static inline void
+FLO_Vector_Transpose4(FLO_Vector* r)
+{
+    float32x4x2_t t01 = vtrnq_f32(r[0], r[1]);
+    float32x4x2_t t23 = vtrnq_f32(r[2], r[3]);
+    r[0] = vcombine_f32(vget_low_f32(t01.val[0]),  vget_low_f32(t23.val[0]));
+    r[1] = vcombine_f32(vget_low_f32(t01.val[1]),  vget_low_f32(t23.val[1]));
+    r[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+/* returns the sums of the 4 lanes of a, b, c and d */
+static inline FLO_Vector
+FLO_Vector_Sum4(FLO_Vector a, FLO_Vector b, FLO_Vector c, FLO_Vector d)
+{
+    float32x2_t ab = vpadd_f32(vpadd_f32(vget_low_f32(a), vget_high_f32(a)),
+                               vpadd_f32(vget_low_f32(b), vget_high_f32(b)));
+    float32x2_t cd = vpadd_f32(vpadd_f32(vget_low_f32(c), vget_high_f32(c)),
+                               vpadd_f32(vget_low_f32(d), vget_high_f32(d)));
+    return vcombine_f32(ab, cd);
+}
+#endif
+
+static const FLO_Float FLO_SynthesisFilter_Cos64[16] = {
+    COS_01_64, COS_03_64, COS_05_64, COS_07_64, COS_09_64, COS_11_64, COS_13_64, COS_15_64,
+    COS_17_64, COS_19_64, COS_21_64, COS_23_64, COS_25_64, COS_27_64, COS_29_64, COS_31_64
+};
+static const FLO_Float FLO_SynthesisFilter_Cos32[8] = {
+    COS_01_32, COS_03_32, COS_05_32, COS_07_32, COS_09_32, COS_11_32, COS_13_32, COS_15_32
+};
+static const FLO_Float FLO_SynthesisFilter_Cos16[4] = {
+    COS_01_16, COS_03_16, COS_05_16, COS_07_16
+};
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_Dct16_Vector
+|
+|   first two butterfly stages of a 16 point DCT, in place
++---------------------------------------------------------------------*/
+static inline void
+FLO_SynthesisFilter_Dct16_Vector(FLO_Vector x[4])
+{
+    const FLO_Vector cos_32_a = FLO_VECTOR_LOAD(FLO_SynthesisFilter_Cos32);
+    const FLO_Vector cos_32_b = FLO_VECTOR_LOAD(FLO_SynthesisFilter_Cos32+4);
+    const FLO_Vector cos_16   = FLO_VECTOR_LOAD(FLO_SynthesisFilter_Cos16);
+    FLO_Vector       y0, y1, y2, y3;
+
+    y0 = FLO_VECTOR_REVERSE(x[3]);
+    y1 = FLO_VECTOR_REVERSE(x[2]);
+    y2 = FLO_VECTOR_MUL(cos_32_a, FLO_VECTOR_SUB(x[0], y0));
+    y3 = FLO_VECTOR_MUL(cos_32_b, FLO_VECTOR_SUB(x[1], y1));
+    y0 = FLO_VECTOR_ADD(x[0], y0);
+    y1 = FLO_VECTOR_ADD(x[1], y1);
+
+    y1   = FLO_VECTOR_REVERSE(y1);
+    y3   = FLO_VECTOR_REVERSE(y3);
+    x[0] = FLO_VECTOR_ADD(y0, y1);
+    x[1] = FLO_VECTOR_MUL(cos_16, FLO_VECTOR_SUB(y0, y1));
+    x[2] = FLO_VECTOR_ADD(y2, y3);
+    x[3] = FLO_VECTOR_MUL(cos_16, FLO_VECTOR_SUB(y2, y3));
+}
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_Dct4
+|
+|   last two butterfly stages of a 16 point DCT, in place
++---------------------------------------------------------------------*/
+static inline void
+FLO_SynthesisFilter_Dct4(FLO_Float* p)
+{
+    int i;
+
+    for (i = 0; i < 16; i += 4, p += 4) {
+        FLO_Float pp0 = p[0] + p[3];
+        FLO_Float pp1 = p[1] + p[2];
+        FLO_Float pp2 = FLO_FC6_MUL(COS_01_08, (p[0] - p[3]));
+        FLO_Float pp3 = FLO_FC6_MUL(COS_03_08, (p[1] - p[2]));
+        p[0] = pp0 + pp1;
+        p[1] = FLO_FC6_MUL(COS_01_04, (pp0 - pp1));
+        p[2] = pp2 + pp3;
+        p[3] = FLO_FC6_MUL(COS_01_04, (pp2 - pp3));
+    }
+}
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_Idct_Vector
++---------------------------------------------------------------------*/
+static void
+FLO_SynthesisFilter_Idct_Vector(FLO_SynthesisFilter* filter)
+{
+    const FLO_Float* s  = filter->input;
+    FLO_Float*       s0 = filter->v + filter->v_offset;
+    FLO_Float*       s1 = (filter->v == filter->v0 ?
+                           filter->v1 :
+                           filter->v0) + filter->v_offset;
+    FLO_Vector       even[4];
+    FLO_Vector       odd[4];
+    FLO_Float        e[16];
+    FLO_Float        o[16];
+    int              i;
+
+    /* split the input into the sums and the differences of symmetric values */
+    for (i = 0; i < 4; i++) {
+        FLO_Vector head = FLO_VECTOR_LOAD(s+4*i);
+        FLO_Vector tail = FLO_VECTOR_REVERSE(FLO_VECTOR_LOAD(s+28-4*i));
+        even[i] = FLO_VECTOR_ADD(head, tail);
+        odd[i]  = FLO_VECTOR_MUL(FLO_VECTOR_LOAD(FLO_SynthesisFilter_Cos64+4*i),
+                                 FLO_VECTOR_SUB(head, tail));
+    }
+
+    /* a 16 point DCT for each */
+    FLO_SynthesisFilter_Dct16_Vector(even);
+    FLO_SynthesisFilter_Dct16_Vector(odd);
+    for (i = 0; i < 4; i++) {
+        FLO_VECTOR_STORE(e+4*i, even[i]);
+        FLO_VECTOR_STORE(o+4*i, odd[i]);
+    }
+    FLO_SynthesisFilter_Dct4(e);
+    FLO_SynthesisFilter_Dct4(o);
+
+    /* recombine, in the same way as FLO_SynthesisFilter_Idct */
+    {
+        FLO_Float tmp;
+
+        tmp   = e[ 6] + e[ 7];
+        s1[0x040] = -(e[ 5] + tmp);
+        s1[0x0C0] = -(e[ 4] + tmp);
+        tmp   = e[11] + e[15];
+        s0[0x0A0] = tmp;
+        s0[0x060] = e[13] + tmp;
+        tmp   = e[14] + e[15];
+        s1[0x0E0] = -(e[ 8] + e[12] + tmp);
+        s1[0x020] = -(e[ 9] + e[13] + tmp);
+        tmp  += e[10] + e[11];
+        s1[0x060] = -(e[13] + tmp);
+        s1[0x0A0] = -(e[12] + tmp);
+        s0[0x020] = e[ 9] + e[13] + e[15];
+        s0[0x040] = e[ 5] + e[ 7];
+        s1[0x100] = -e[ 0];
+        s0[0x000] = e[ 1];
+        s0[0x080] = e[ 3];
+        s0[0x0C0] = e[ 7];
+        s0[0x0E0] = e[15];
+        s1[0x080] = -(e[ 2] + e[ 3]);
+
+        tmp   = o[13] + o[15];
+        s0[0x010] = o[ 1] + o[ 9] + tmp;
+        s0[0x050] = o[ 5] + o[ 7] + o[11] + tmp;
+        tmp  += o[ 9];
+        s1[0x010] = -(o[ 1] + o[14] + tmp);
+        tmp  += o[ 5] + o[ 7];
+        s0[0x030] = tmp;
+        s1[0x030] = -(o[ 6] + o[14] + tmp);
+        tmp   = o[10] + o[11] + o[12] + o[13] + o[14] + o[15];
+        s1[0x070] = -(o[ 2] + o[ 3] + tmp - o[12]);
+        s1[0x0B0] = -(o[ 4] + o[ 6] + o[ 7] + tmp - o[13]);
+        s1[0x050] = -(o[ 5] + o[ 6] + o[ 7] + tmp - o[12]);
+        s1[0x090] = -(o[ 2] + o[ 3] + tmp - o[13]);
+        tmp   = o[ 8] + o[12] + o[14] + o[15];
+        s1[0x0F0] = -(o[ 0] + tmp);
+        s1[0x0D0] = -(o[ 4] + o[ 6] + o[ 7] + tmp);
+        tmp   = o[11] + o[15];
+        s0[0x0B0] = o[ 7] + tmp;
+        tmp  += o[ 3];
+        s0[0x090] = tmp;
+        s0[0x070] = o[13] + tmp;
+        s0[0x0D0] = o[ 7] + o[15];
+        s0[0x0F0] = o[15];
+    }
+
+    s0[0x100] = FLO_ZERO;
+    s1[0x000] = -s0[0x000];
+}
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_MiddleSample
+|
+|   17th sample, use the fact that half of the v[] values are FLO_ZERO
++---------------------------------------------------------------------*/
+static inline FLO_Float
+FLO_SynthesisFilter_MiddleSample(const FLO_Float* v, const FLO_Float* d, int odd)
+{
+    return FLO_FC0_MUL(v[odd+ 0], d[odd+ 0]) +
+           FLO_FC0_MUL(v[odd+ 2], d[odd+ 2]) +
+           FLO_FC0_MUL(v[odd+ 4], d[odd+ 4]) +
+           FLO_FC0_MUL(v[odd+ 6], d[odd+ 6]) +
+           FLO_FC0_MUL(v[odd+ 8], d[odd+ 8]) +
+           FLO_FC0_MUL(v[odd+10], d[odd+10]) +
+           FLO_FC0_MUL(v[odd+12], d[odd+12]) +
+           FLO_FC0_MUL(v[odd+14], d[odd+14]);
+}
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_Window_Vector
++---------------------------------------------------------------------*/
+static void
+FLO_SynthesisFilter_Window_Vector(FLO_SynthesisFilter* filter, FLO_Float* buffer)
+{
+    const FLO_Float* v = filter->v;
+    const FLO_Float* d = FLO_SynthesisFilter_D + (16-filter->v_offset);
+    const FLO_Vector signs = FLO_VECTOR_SET(1.0f, -1.0f, 1.0f, -1.0f);
+    FLO_Vector       sum[4];
+    FLO_Float        last[16];
+    int              odd = (filter->v == filter->v0);
+    int              i, k;
+
+    /* compute the first 16 samples, 4 at a time */
+    for (i = 0; i < 16; i += 4) {
+        for (k = 0; k < 4; k++, d += 32, v += 16) {
+            sum[k] = FLO_VECTOR_ADD(
+                FLO_VECTOR_ADD(FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v   ), FLO_VECTOR_LOAD(d   )),
+                               FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v+ 4), FLO_VECTOR_LOAD(d+ 4))),
+                FLO_VECTOR_ADD(FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v+ 8), FLO_VECTOR_LOAD(d+ 8)),
+                               FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v+12), FLO_VECTOR_LOAD(d+12))));
+        }
+        FLO_VECTOR_STORE(buffer+i, FLO_Vector_Sum4(sum[0], sum[1], sum[2], sum[3]));
+    }
+
+    /* 17th sample */
+    buffer[16] = FLO_SynthesisFilter_MiddleSample(v, d, odd);
+
+    /* the last 15 samples, with the coefficients in reverse order and    */
+    /* alternating signs (one more sample is computed, and thrown away)   */
+    d += (filter->v_offset<<1) - 48;
+    v -= 16;
+    for (i = 0; i < 16; i += 4) {
+        for (k = 0; k < 4; k++, d -= 32, v -= 16) {
+            sum[k] = FLO_VECTOR_ADD(
+                FLO_VECTOR_ADD(
+                    FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v   ), FLO_VECTOR_REVERSE(FLO_VECTOR_LOAD(d+12))),
+                    FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v+ 4), FLO_VECTOR_REVERSE(FLO_VECTOR_LOAD(d+ 8)))),
+                FLO_VECTOR_ADD(
+                    FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v+ 8), FLO_VECTOR_REVERSE(FLO_VECTOR_LOAD(d+ 4))),
+                    FLO_VECTOR_MUL(FLO_VECTOR_LOAD(v+12), FLO_VECTOR_REVERSE(FLO_VECTOR_LOAD(d   )))));
+            sum[k] = FLO_VECTOR_MUL(sum[k], signs);
+        }
+        FLO_VECTOR_STORE(last+i, FLO_Vector_Sum4(sum[0], sum[1], sum[2], sum[3]));
+    }
+
+    /* there is a phase inversion between odd and even runs */
+    for (i = 0; i < 15; i++) {
+        buffer[17+i] = odd ? last[i] : -last[i];
+    }
+}
+
+#if defined(FLO_FILTER_HAVE_AVX2)
+/*----------------------------------------------------------------------
+|   FLO_Vector8_Sum8
+|
+|   returns the sums of the 8 lanes of each of the 8 vectors
++---------------------------------------------------------------------*/
+FLO_FILTER_AVX2_TARGET static inline __m256
+FLO_Vector8_Sum8(const __m256* x)
+{
+    __m256 s0123 = _mm256_hadd_ps(_mm256_hadd_ps(x[0], x[1]), _mm256_hadd_ps(x[2], x[3]));
+    __m256 s4567 = _mm256_hadd_ps(_mm256_hadd_ps(x[4], x[5]), _mm256_hadd_ps(x[6], x[7]));
+    return _mm256_add_ps(_mm256_permute2f128_ps(s0123, s4567, 0x20),
+                         _mm256_permute2f128_ps(s0123, s4567, 0x31));
+}
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_Window_AVX2
++---------------------------------------------------------------------*/
+FLO_FILTER_AVX2_TARGET static void
+FLO_SynthesisFilter_Window_AVX2(FLO_SynthesisFilter* filter, FLO_Float* buffer)
+{
+    const FLO_Float* v = filter->v;
+    const FLO_Float* d = FLO_SynthesisFilter_D + (16-filter->v_offset);
+    const __m256     signs   = _mm256_setr_ps(1.0f, -1.0f, 1.0f, -1.0f,
+                                              1.0f, -1.0f, 1.0f, -1.0f);
+    const __m256i    reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256           sum[8];
+    FLO_Float        last[16];
+    int              odd = (filter->v == filter->v0);
+    int              i, k;
+
+    /* compute the first 16 samples, 8 at a time */
+    for (i = 0; i < 16; i += 8) {
+        for (k = 0; k < 8; k++, d += 32, v += 16) {
+            sum[k] = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(v),   _mm256_loadu_ps(d)),
+                                   _mm256_mul_ps(_mm256_loadu_ps(v+8), _mm256_loadu_ps(d+8)));
+        }
+        _mm256_storeu_ps(buffer+i, FLO_Vector8_Sum8(sum));
+    }
+
+    /* 17th sample */
+    buffer[16] = FLO_SynthesisFilter_MiddleSample(v, d, odd);
+
+    /* the last 15 samples, with the coefficients in reverse order and    */
+    /* alternating signs (one more sample is computed, and thrown away)   */
+    d += (filter->v_offset<<1) - 48;
+    v -= 16;
+    for (i = 0; i < 16; i += 8) {
+        for (k = 0; k < 8; k++, d -= 32, v -= 16) {
+            __m256 d_hi = _mm256_permutevar8x32_ps(_mm256_loadu_ps(d+8), reverse);
+            __m256 d_lo = _mm256_permutevar8x32_ps(_mm256_loadu_ps(d),   reverse);
+            sum[k] = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(v),   d_hi),
+                                   _mm256_mul_ps(_mm256_loadu_ps(v+8), d_lo));
+            sum[k] = _mm256_mul_ps(sum[k], signs);
+        }
+        _mm256_storeu_ps(last+i, FLO_Vector8_Sum8(sum));
+    }
+
+    /* there is a phase inversion between odd and even runs */
+    for (i = 0; i < 15; i++) {
+        buffer[17+i] = odd ? last[i] : -last[i];
+    }
+}
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_CpuHasAVX2
++---------------------------------------------------------------------*/
+static int
+FLO_SynthesisFilter_CpuHasAVX2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return 0;
+
+    /* the OS must also save the YMM registers */
+    __cpuid(info, 1);
+    if (!(info[2] & (1<<27)) || (_xgetbv(0) & 6) != 6) return 0;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1<<5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif /* FLO_FILTER_HAVE_AVX2 */
+
+#endif /* FLO_FILTER_HAVE_SIMD */
+
+/*----------------------------------------------------------------------
+|   FLO_SynthesisFilter_SelectWindow
+|
+|   picks the fastest windowing function that can run on this CPU
++---------------------------------------------------------------------*/
+static FLO_SynthesisFilter_WindowFunction
+FLO_SynthesisFilter_SelectWindow(void)
+{
+#if defined(FLO_FILTER_HAVE_AVX2)
+    if (FLO_SynthesisFilter_CpuHasAVX2()) return FLO_SynthesisFilter_Window_AVX2;
+#endif
+#if defined(FLO_FILTER_HAVE_SIMD)
+    return FLO_SynthesisFilter_Window_Vector;
+#else
+    /* the scalar code stores directly in the output buffer */
+    return NULL;
+#endif
+}
+
 /*----------------------------------------------------------------------
 |       FLO_SynthesisFilter_NullPcm
 +---------------------------------------------------------------------*/
@@ -780,8 +1276,13 @@ FLO_SynthesisFilter_NullPcm(FLO_SynthesisFilter* filter)
         /* fill the samples buffer with silence */
         for (i=0; i<FLO_FILTER_NB_SAMPLES; i++) {
             if (i & mask) continue;
-            *filter->buffer = 0;
-            filter->buffer += filter->buffer_increment;
+            if (filter->float_output) {
+                *(float*)filter->buffer = 0.0f;
+                filter->buffer = (float*)filter->buffer + filter->buffer_increment;
+            } else {
+                *(short*)filter->buffer = 0;
+                filter->buffer = (short*)filter->buffer + filter->buffer_increment;
+            }
         }
     }
 }
@@ -810,13 +1311,23 @@ FLO_SynthesisFilter_ComputePcm(FLO_SynthesisFilter* filter)
     if (filter->equalizer) FLO_SynthesisFilter_Equalize(filter);
 
     /* compute the DCT values */
+#if defined(FLO_FILTER_HAVE_SIMD)
+    FLO_SynthesisFilter_Idct_Vector(filter);
+#else
     FLO_SynthesisFilter_Idct(filter);
+#endif
 
-    /* do the windowing to compute the output samples */
+    /* do the windowing to compute the output samples, and store them */
     if (filter->subsampling) {
         FLO_SynthesisFilter_ComputeAndStorePcm_Subsampled(filter);
     } else {
+#if defined(FLO_FILTER_HAVE_SIMD)
+        FLO_Float samples[FLO_FILTER_NB_SAMPLES];
+        filter->window(filter, samples);
+        FLO_SynthesisFilter_StorePcm(filter, samples, FLO_FILTER_NB_SAMPLES);
+#else
         FLO_SynthesisFilter_ComputeAndStorePcm(filter);
+#endif
     }
 
     /* decrement and wrap-around the store offset counter */
@@ -1135,6 +1646,162 @@ FLO_HybridFilter_Imdct_36(FLO_HybridFilter *filter, int subband, int window_type
     }
 }
 
+#if defined(FLO_FILTER_HAVE_SIMD)
+/*-------------------------------------------------------------------------
+|   FLO_HybridFilter_Imdct_36_Vector
+|
+|   same as FLO_HybridFilter_Imdct_36, for 4 subbands at once (one per
+|   vector lane), starting with an even subband. The operations are done
+|   in the same order, so the results are the same.
++-------------------------------------------------------------------------*/
+#define FLO_VADD(a, b)  FLO_VECTOR_ADD(a, b)
+#define FLO_VSUB(a, b)  FLO_VECTOR_SUB(a, b)
+#define FLO_VMUL(c, a)  FLO_VECTOR_MUL(FLO_VECTOR_SET1(c), a)
+
+static void
+FLO_HybridFilter_Imdct_36_Vector(FLO_HybridFilter* filter, int subband, int window_type)
+{
+    const FLO_Float* win_even = FLO_LayerIII_ImdctWindows_Even[window_type];
+    const FLO_Float* win_odd  = FLO_LayerIII_ImdctWindows_Odd[window_type];
+    FLO_Vector       in[FLO_HYBRID_BAND_WIDTH];
+    FLO_Vector       store[FLO_HYBRID_BAND_WIDTH];
+    FLO_Vector       tmp[FLO_HYBRID_BAND_WIDTH];
+    int              i, k;
+
+    /* load the input and the overlap of the 4 subbands, one per lane */
+    for (k = 0; k < 16; k += 4) {
+        for (i = 0; i < 4; i++) {
+            in[k+i]    = FLO_VECTOR_LOAD(filter->in[subband+i]+k);
+            store[k+i] = FLO_VECTOR_LOAD(filter->store[subband+i]+k);
+        }
+        FLO_Vector_Transpose4(in+k);
+        FLO_Vector_Transpose4(store+k);
+    }
+    for (k = 16; k < FLO_HYBRID_BAND_WIDTH; k++) {
+        in[k]    = FLO_VECTOR_SET(filter->in[subband  ][k], filter->in[subband+1][k],
+                                  filter->in[subband+2][k], filter->in[subband+3][k]);
+        store[k] = FLO_VECTOR_SET(filter->store[subband  ][k], filter->store[subband+1][k],
+                                  filter->store[subband+2][k], filter->store[subband+3][k]);
+    }
+
+    for (k = FLO_HYBRID_BAND_WIDTH-1; k > 0; k--) {
+        in[k] = FLO_VADD(in[k], in[k-1]);
+    }
+    for (k = FLO_HYBRID_BAND_WIDTH-1; k > 2; k -= 2) {
+        in[k] = FLO_VADD(in[k], in[k-2]);
+    }
+
+    /* 9 points IDCT, even and odd indices */
+    for (i = 0; i < 2; i++) {
+        const FLO_Vector* x = in+i;
+        FLO_Vector        t0, t1, t2, t3, t4, t5, t6, t7;
+        FLO_Vector        r[9];
+
+        t1   = FLO_VMUL(COS_02_06, x[12]);
+        t2   = FLO_VMUL(COS_02_06, FLO_VSUB(FLO_VADD(x[8], x[16]), x[4]));
+        t3   = FLO_VADD(x[0], t1);
+        t4   = FLO_VSUB(FLO_VSUB(x[0], t1), t1);
+        t5   = FLO_VSUB(t4, t2);
+        t0   = FLO_VMUL(COS_01_09, FLO_VADD(x[4], x[8]));
+        t1   = FLO_VMUL(COS_05_09, FLO_VSUB(x[8], x[16]));
+        r[4] = FLO_VADD(FLO_VADD(t4, t2), t2);
+        t2   = FLO_VMUL(COS_07_09, FLO_VADD(x[4], x[16]));
+        t6   = FLO_VSUB(FLO_VSUB(t3, t0), t2);
+        t0   = FLO_VADD(t0, FLO_VADD(t3, t1));
+        t3   = FLO_VADD(t3, FLO_VSUB(t2, t1));
+        t2   = FLO_VMUL(COS_01_18, FLO_VADD(x[2],  x[10]));
+        t4   = FLO_VMUL(COS_11_18, FLO_VSUB(x[10], x[14]));
+        t7   = FLO_VMUL(COS_01_06, x[6]);
+        t1   = FLO_VADD(FLO_VADD(t2, t4), t7);
+        r[0] = FLO_VADD(t0, t1);
+        r[8] = FLO_VSUB(t0, t1);
+        t1   = FLO_VMUL(COS_13_18, FLO_VADD(x[2], x[14]));
+        t2   = FLO_VADD(t2, FLO_VSUB(t1, t7));
+        r[3] = FLO_VADD(t3, t2);
+        t0   = FLO_VMUL(COS_01_06, FLO_VSUB(FLO_VADD(x[10], x[14]), x[2]));
+        r[5] = FLO_VSUB(t3, t2);
+        t4   = FLO_VSUB(t4, FLO_VADD(t1, t7));
+        r[1] = FLO_VSUB(t5, t0);
+        r[7] = FLO_VADD(t5, t0);
+        r[2] = FLO_VADD(t6, t4);
+        r[6] = FLO_VSUB(t6, t4);
+
+        if (i == 0) {
+            for (k = 0; k < 9; k++) tmp[k] = r[k];
+        } else {
+            tmp[17] = FLO_VMUL(COS_01_36, r[0]);
+            tmp[16] = FLO_VMUL(COS_03_36, r[1]);
+            tmp[15] = FLO_VMUL(COS_05_36, r[2]);
+            tmp[14] = FLO_VMUL(COS_07_36, r[3]);
+            tmp[13] = FLO_VMUL(COS_09_36, r[4]);
+            tmp[12] = FLO_VMUL(COS_11_36, r[5]);
+            tmp[11] = FLO_VMUL(COS_13_36, r[6]);
+            tmp[10] = FLO_VMUL(COS_15_36, r[7]);
+            tmp[ 9] = FLO_VMUL(COS_17_36, r[8]);
+        }
+    }
+
+    /* window, overlap and add */
+    for (k = 0; k < 9; k++) {
+        FLO_Vector diff = FLO_VSUB(tmp[k], tmp[17-k]);
+        FLO_Vector sum  = FLO_VADD(tmp[k], tmp[17-k]);
+        FLO_VECTOR_STORE(&filter->out[8-k][subband],
+                         FLO_VADD(FLO_VECTOR_MUL(FLO_VECTOR_SET(win_even[8-k], win_odd[8-k],
+                                                                win_even[8-k], win_odd[8-k]),
+                                                 diff),
+                                  store[8-k]));
+        FLO_VECTOR_STORE(&filter->out[9+k][subband],
+                         FLO_VADD(FLO_VECTOR_MUL(FLO_VECTOR_SET(win_even[9+k], win_odd[9+k],
+                                                                win_even[9+k], win_odd[9+k]),
+                                                 diff),
+                                  store[9+k]));
+        store[8-k] = FLO_VECTOR_MUL(FLO_VECTOR_SET(win_even[26-k], win_odd[26-k],
+                                                   win_even[26-k], win_odd[26-k]),
+                                    sum);
+        store[9+k] = FLO_VECTOR_MUL(FLO_VECTOR_SET(win_even[27+k], win_odd[27+k],
+                                                   win_even[27+k], win_odd[27+k]),
+                                    sum);
+    }
+
+    /* save the overlap for the next granule */
+    for (k = 0; k < 16; k += 4) {
+        FLO_Vector_Transpose4(store+k);
+        for (i = 0; i < 4; i++) {
+            FLO_VECTOR_STORE(filter->store[subband+i]+k, store[k+i]);
+        }
+    }
+    for (k = 16; k < FLO_HYBRID_BAND_WIDTH; k++) {
+        FLO_Float lanes[4];
+        FLO_VECTOR_STORE(lanes, store[k]);
+        for (i = 0; i < 4; i++) {
+            filter->store[subband+i][k] = lanes[i];
+        }
+    }
+}
+
+#undef FLO_VADD
+#undef FLO_VSUB
+#undef FLO_VMUL
+#endif /* FLO_FILTER_HAVE_SIMD */
+
+/*-------------------------------------------------------------------------
+|   FLO_HybridFilter_Imdct_36_Bands
++-------------------------------------------------------------------------*/
+void
+FLO_HybridFilter_Imdct_36_Bands(FLO_HybridFilter* filter, int band_count, int window_type)
+{
+    int subband = 0;
+
+#if defined(FLO_FILTER_HAVE_SIMD)
+    for (; subband+4 <= band_count; subband += 4) {
+        FLO_HybridFilter_Imdct_36_Vector(filter, subband, window_type);
+    }
+#endif
+    for (; subband < band_count; subband++) {
+        FLO_HybridFilter_Imdct_36(filter, subband, window_type);
+    }
+}
+
 /*-------------------------------------------------------------------------
 |       FLO_ZERO_BAND
 +-------------------------------------------------------------------------*/
@@ -30,7 +30,13 @@
 /*----------------------------------------------------------------------
 |   types
 +---------------------------------------------------------------------*/
-typedef struct {
+typedef struct FLO_SynthesisFilter FLO_SynthesisFilter;
+
+/* computes the 32 windowed samples of a filter run */
+typedef void (*FLO_SynthesisFilter_WindowFunction)(FLO_SynthesisFilter* filter,
+                                                   FLO_Float*           buffer);
+
+struct FLO_SynthesisFilter {
     FLO_Float* v0;
     FLO_Float* v1;
     FLO_Float* v;
@@ -38,9 +44,11 @@ typedef struct {
     FLO_Float* equalizer;
     int        subsampling;
     int        v_offset;
-    short*     buffer;
+    void*      buffer;
     int        buffer_increment;
-} FLO_SynthesisFilter;
+    int        float_output;
+    FLO_SynthesisFilter_WindowFunction window;
+};
 
 typedef struct {
     FLO_Float in   [FLO_HYBRID_NB_BANDS][FLO_HYBRID_BAND_WIDTH];
@@ -63,6 +71,7 @@ void       FLO_SynthesisFilter_ComputePcm(FLO_SynthesisFilter* filter);
 void       FLO_SynthesisFilter_NullPcm(FLO_SynthesisFilter* filter);
 void       FLO_HybridFilter_Reset(FLO_HybridFilter* filter);
 void       FLO_HybridFilter_Imdct_36(FLO_HybridFilter* filter, int group, int window_type);
+void       FLO_HybridFilter_Imdct_36_Bands(FLO_HybridFilter* filter, int band_count, int window_type);
 void       FLO_HybridFilter_Imdct_12(FLO_HybridFilter* filter, int group);
 void       FLO_HybridFilter_Imdct_Null(FLO_HybridFilter* filter, int group);
 
@@ -0,0 +1,507 @@
+/*****************************************************************
+|
+|   Fluo - Frame Index
+|
+|   (c) 2002-2006 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "Atomix.h"
+#include "FloConfig.h"
+#include "FloTypes.h"
+#include "FloDecoder.h"
+#include "FloFrame.h"
+#include "FloFrameIndex.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/* number of recent frames remembered while scanning */
+#define FLO_FRAME_INDEX_HISTORY_SIZE     32
+
+/* frames decoded before an indexed frame to prime the filters */
+#define FLO_FRAME_INDEX_PRIMING_FRAMES   2
+
+/* maximum main_data_begin values (size of the bit reservoir) */
+#define FLO_FRAME_INDEX_MPEG1_RESERVOIR  511
+#define FLO_FRAME_INDEX_MPEG2_RESERVOIR  255
+
+/* serialized format */
+#define FLO_FRAME_INDEX_MAGIC            0x464C4F49 /* 'FLOI' */
+#define FLO_FRAME_INDEX_VERSION          1
+#define FLO_FRAME_INDEX_HEADER_SIZE      36
+#define FLO_FRAME_INDEX_ENTRY_SIZE       20
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef struct {
+    FLO_UInt64 offset;  /* where decoding must start                 */
+    FLO_UInt64 sample;  /* first sample of the indexed frame         */
+    FLO_UInt32 preroll; /* samples decoded from offset up to sample  */
+} FLO_FrameIndexEntry;
+
+typedef struct {
+    FLO_UInt64 offset;
+    FLO_UInt64 sample;
+    FLO_Size   main_data_size;
+} FLO_FrameIndexFrame;
+
+struct FLO_FrameIndex {
+    FLO_Cardinal         granularity;
+    FLO_Boolean          complete;
+    FLO_Cardinal         lead;
+    FLO_UInt64           sample_count;
+    FLO_UInt64           stream_size;
+    FLO_FrameIndexEntry* entries;
+    FLO_Cardinal         entry_count;
+    FLO_Cardinal         entry_capacity;
+    struct {
+        FLO_Decoder*        decoder;
+        FLO_UInt64          bytes_fed;
+        FLO_UInt64          next_sample;
+        FLO_Cardinal        frame_count;
+        FLO_FrameIndexFrame history[FLO_FRAME_INDEX_HISTORY_SIZE];
+    }                    scan;
+};
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_Create
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_FrameIndex_Create(FLO_Cardinal granularity, FLO_FrameIndex** index)
+{
+    FLO_Result result;
+
+    /* check parameters */
+    if (granularity == 0) return FLO_ERROR_INVALID_PARAMETERS;
+
+    *index = ATX_AllocateZeroMemory(sizeof(FLO_FrameIndex));
+    if (*index == NULL) return FLO_ERROR_OUT_OF_MEMORY;
+    (*index)->granularity = granularity;
+
+    /* create a decoder to find the frames */
+    result = FLO_Decoder_Create(&(*index)->scan.decoder);
+    if (FLO_FAILED(result)) {
+        ATX_FreeMemory(*index);
+        *index = NULL;
+        return result;
+    }
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_Destroy
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_FrameIndex_Destroy(FLO_FrameIndex* index)
+{
+    if (index->scan.decoder) FLO_Decoder_Destroy(index->scan.decoder);
+    if (index->entries) ATX_FreeMemory(index->entries);
+    ATX_FreeMemory(index);
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_AddEntry
++---------------------------------------------------------------------*/
+static FLO_Result
+FLO_FrameIndex_AddEntry(FLO_FrameIndex* index, 
+                        FLO_UInt64      offset,
+                        FLO_UInt64      sample,
+                        FLO_UInt32      preroll)
+{
+    FLO_FrameIndexEntry* entry;
+
+    /* make room for the entry if needed */
+    if (index->entry_count == index->entry_capacity) {
+        FLO_Cardinal         capacity = index->entry_capacity ? 2*index->entry_capacity : 256;
+        FLO_FrameIndexEntry* entries  = ATX_AllocateMemory(capacity*sizeof(FLO_FrameIndexEntry));
+        if (entries == NULL) return FLO_ERROR_OUT_OF_MEMORY;
+        if (index->entries) {
+            ATX_CopyMemory(entries, index->entries, index->entry_count*sizeof(FLO_FrameIndexEntry));
+            ATX_FreeMemory(index->entries);
+        }
+        index->entries        = entries;
+        index->entry_capacity = capacity;
+    }
+
+    entry = &index->entries[index->entry_count++];
+    entry->offset  = offset;
+    entry->sample  = sample;
+    entry->preroll = preroll;
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_AddFrame
++---------------------------------------------------------------------*/
+static FLO_Result
+FLO_FrameIndex_AddFrame(FLO_FrameIndex*      index, 
+                        FLO_UInt64           offset,
+                        const FLO_FrameInfo* frame_info)
+{
+    FLO_Cardinal         current = index->scan.frame_count;
+    FLO_FrameIndexFrame* frame   = &index->scan.history[current%FLO_FRAME_INDEX_HISTORY_SIZE];
+    FLO_Result           result;
+
+    /* remember the frame */
+    frame->offset         = offset;
+    frame->sample         = index->sample_count;
+    frame->main_data_size = 0;
+    if (frame_info->layer == FLO_MPEG_LAYER_III) {
+        /* the header info does not say if there is a CRC, so assume  */
+        /* there is one, which may only underestimate the main data   */
+        FLO_Size overhead = 4+2;
+        if (frame_info->level == FLO_MPEG_LEVEL_MPEG_1) {
+            overhead += frame_info->channel_count == 1 ? 17 : 32;
+        } else {
+            overhead += frame_info->channel_count == 1 ? 9 : 17;
+        }
+        if (frame_info->size > overhead) {
+            frame->main_data_size = frame_info->size-overhead;
+        }
+    }
+
+    /* check if this frame is the next one to index */
+    if (frame->sample >= index->scan.next_sample) {
+        FLO_Cardinal start     = current;
+        FLO_Cardinal oldest    = current+1 > FLO_FRAME_INDEX_HISTORY_SIZE ?
+                                 current+1-FLO_FRAME_INDEX_HISTORY_SIZE : 0;
+        FLO_Size     reservoir = 0;
+        FLO_Size     available = 0;
+
+        /* start with a few frames to prime the filters */
+        while (start > oldest && current-start < FLO_FRAME_INDEX_PRIMING_FRAMES) {
+            start--;
+        }
+
+        /* go back far enough for the main data of the first decoded */
+        /* frame to be in the reservoir                              */
+        if (frame_info->layer == FLO_MPEG_LAYER_III) {
+            reservoir = frame_info->level == FLO_MPEG_LEVEL_MPEG_1 ?
+                        FLO_FRAME_INDEX_MPEG1_RESERVOIR :
+                        FLO_FRAME_INDEX_MPEG2_RESERVOIR;
+        }
+        while (start > oldest && available < reservoir) {
+            start--;
+            available += index->scan.history[start%FLO_FRAME_INDEX_HISTORY_SIZE].main_data_size;
+        }
+
+        frame = &index->scan.history[start%FLO_FRAME_INDEX_HISTORY_SIZE];
+        result = FLO_FrameIndex_AddEntry(index, 
+                                         frame->offset, 
+                                         index->sample_count,
+                                         (FLO_UInt32)(index->sample_count-frame->sample));
+        if (FLO_FAILED(result)) return result;
+
+        /* the next entry is at the next multiple of the granularity */
+        index->scan.next_sample = 
+            (index->sample_count/index->granularity+1)*index->granularity;
+    }
+
+    /* count the frame and its samples */
+    index->scan.frame_count++;
+    index->sample_count += frame_info->sample_count;
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_Feed
+|
+|   Feeds the next bytes of the stream, which must be given in order
+|   from the start of the stream. The flags are the same as for 
+|   FLO_Decoder_Feed: the index is complete when the last buffer has
+|   been fed with the FLO_DECODER_BUFFER_IS_END_OF_STREAM flag.
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_FrameIndex_Feed(FLO_FrameIndex* index,
+                    FLO_ByteBuffer  buffer,
+                    FLO_Size        size,
+                    FLO_Flags       flags)
+{
+    FLO_Decoder*  decoder = index->scan.decoder;
+    FLO_FrameInfo frame_info;
+    FLO_Result    result;
+
+    /* check the state */
+    if (index->complete || decoder == NULL) return FLO_ERROR_INVALID_FRAME_INDEX;
+
+    for (;;) {
+        FLO_Size     chunk = size;
+        FLO_Cardinal frame_count = index->scan.frame_count;
+
+        /* give the decoder as much as it will take */
+        result = FLO_Decoder_Feed(decoder, buffer, &chunk, 0);
+        if (FLO_FAILED(result)) return result;
+        buffer += chunk;
+        size   -= chunk;
+        index->scan.bytes_fed += chunk;
+        if (size == 0 && (flags & FLO_DECODER_BUFFER_IS_END_OF_STREAM)) {
+            FLO_Decoder_Feed(decoder, NULL, &size, FLO_DECODER_BUFFER_IS_END_OF_STREAM);
+        }
+
+        /* record all the frames we can find */
+        for (;;) {
+            FLO_Size buffered;
+            result = FLO_Decoder_FindFrame(decoder, &frame_info);
+            if (result == FLO_ERROR_FRAME_SKIPPED ||
+                result == FLO_ERROR_INVALID_BITSTREAM) {
+                continue;
+            }
+            if (result == FLO_ERROR_NOT_ENOUGH_DATA) break;
+            if (FLO_FAILED(result)) return result;
+
+            /* the frame starts at the first byte that is still buffered */
+            FLO_Decoder_GetBufferedSize(decoder, &buffered);
+            result = FLO_FrameIndex_AddFrame(index, index->scan.bytes_fed-buffered, &frame_info);
+            if (FLO_FAILED(result)) return result;
+            FLO_Decoder_SkipFrame(decoder);
+        }
+
+        if (size == 0) break;
+
+        /* the decoder's buffer is full and holds no frame, give up */
+        if (chunk == 0 && frame_count == index->scan.frame_count) {
+            return FLO_ERROR_INVALID_BITSTREAM;
+        }
+    }
+
+    /* finish up at the end of the stream */
+    if (flags & FLO_DECODER_BUFFER_IS_END_OF_STREAM) {
+        FLO_DecoderStatus* status;
+
+        /* the decoder skips its delays at the start of the stream */
+        /* when the stream has an info header                      */
+        FLO_Decoder_GetStatus(decoder, &status);
+        if (status->flags & FLO_DECODER_STATUS_STREAM_HAS_INFO) {
+            index->lead = status->stream_info.decoder_delay +
+                          status->stream_info.encoder_delay + 1;
+        }
+        index->stream_size = index->scan.bytes_fed;
+        index->complete    = FLO_TRUE;
+
+        /* we don't need the decoder anymore */
+        FLO_Decoder_Destroy(decoder);
+        index->scan.decoder = NULL;
+    }
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_IsComplete
++---------------------------------------------------------------------*/
+FLO_Boolean
+FLO_FrameIndex_IsComplete(FLO_FrameIndex* index)
+{
+    return index->complete;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_GetStreamSize
++---------------------------------------------------------------------*/
+FLO_UInt64
+FLO_FrameIndex_GetStreamSize(FLO_FrameIndex* index)
+{
+    return index->stream_size;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_Lookup
+|
+|   Returns the offset from which to decode in order to get 'sample' 
+|   (counted like the samples returned by the decoder), and the number
+|   of samples that must be skipped after decoding from there.
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_FrameIndex_Lookup(FLO_FrameIndex* index,
+                      FLO_UInt64      sample,
+                      FLO_UInt64*     offset,
+                      FLO_Cardinal*   samples_to_skip)
+{
+    FLO_UInt64   target = sample+index->lead;
+    FLO_Cardinal low    = 0;
+    FLO_Cardinal high;
+
+    /* check the state */
+    if (!index->complete) return FLO_ERROR_FRAME_INDEX_INCOMPLETE;
+    if (index->entry_count == 0 || 
+        target < index->entries[0].sample ||
+        target >= index->sample_count) {
+        return FLO_ERROR_SAMPLE_NOT_INDEXED;
+    }
+
+    /* find the last entry at or before the target */
+    high = index->entry_count-1;
+    while (low < high) {
+        FLO_Cardinal middle = (low+high+1)/2;
+        if (index->entries[middle].sample <= target) {
+            low = middle;
+        } else {
+            high = middle-1;
+        }
+    }
+
+    *offset          = index->entries[low].offset;
+    *samples_to_skip = index->entries[low].preroll+
+                       (FLO_Cardinal)(target-index->entries[low].sample);
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_GetSerializedSize
++---------------------------------------------------------------------*/
+FLO_Size
+FLO_FrameIndex_GetSerializedSize(FLO_FrameIndex* index)
+{
+    return FLO_FRAME_INDEX_HEADER_SIZE+
+           index->entry_count*FLO_FRAME_INDEX_ENTRY_SIZE;
+}
+
+/*----------------------------------------------------------------------
+|   serialization helpers (all values are big-endian)
++---------------------------------------------------------------------*/
+static unsigned char*
+FLO_FrameIndex_WriteUInt32(unsigned char* buffer, FLO_UInt32 value)
+{
+    buffer[0] = (unsigned char)(value>>24);
+    buffer[1] = (unsigned char)(value>>16);
+    buffer[2] = (unsigned char)(value>> 8);
+    buffer[3] = (unsigned char)(value    );
+    return buffer+4;
+}
+
+static unsigned char*
+FLO_FrameIndex_WriteUInt64(unsigned char* buffer, FLO_UInt64 value)
+{
+    buffer = FLO_FrameIndex_WriteUInt32(buffer, (FLO_UInt32)(value>>32));
+    return FLO_FrameIndex_WriteUInt32(buffer, (FLO_UInt32)value);
+}
+
+static FLO_UInt32
+FLO_FrameIndex_ReadUInt32(const unsigned char* buffer)
+{
+    return ((FLO_UInt32)buffer[0]<<24) |
+           ((FLO_UInt32)buffer[1]<<16) |
+           ((FLO_UInt32)buffer[2]<< 8) |
+           ((FLO_UInt32)buffer[3]    );
+}
+
+static FLO_UInt64
+FLO_FrameIndex_ReadUInt64(const unsigned char* buffer)
+{
+    return ((FLO_UInt64)FLO_FrameIndex_ReadUInt32(buffer)<<32) |
+           FLO_FrameIndex_ReadUInt32(buffer+4);
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_Serialize
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_FrameIndex_Serialize(FLO_FrameIndex* index,
+                         unsigned char*  buffer,
+                         FLO_Size        size)
+{
+    FLO_Cardinal i;
+
+    /* check parameters and state */
+    if (!index->complete) return FLO_ERROR_FRAME_INDEX_INCOMPLETE;
+    if (size < FLO_FrameIndex_GetSerializedSize(index)) {
+        return FLO_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* header */
+    buffer = FLO_FrameIndex_WriteUInt32(buffer, FLO_FRAME_INDEX_MAGIC);
+    buffer = FLO_FrameIndex_WriteUInt32(buffer, FLO_FRAME_INDEX_VERSION);
+    buffer = FLO_FrameIndex_WriteUInt32(buffer, index->granularity);
+    buffer = FLO_FrameIndex_WriteUInt32(buffer, index->lead);
+    buffer = FLO_FrameIndex_WriteUInt64(buffer, index->sample_count);
+    buffer = FLO_FrameIndex_WriteUInt64(buffer, index->stream_size);
+    buffer = FLO_FrameIndex_WriteUInt32(buffer, index->entry_count);
+
+    /* entries */
+    for (i = 0; i < index->entry_count; i++) {
+        buffer = FLO_FrameIndex_WriteUInt64(buffer, index->entries[i].offset);
+        buffer = FLO_FrameIndex_WriteUInt64(buffer, index->entries[i].sample);
+        buffer = FLO_FrameIndex_WriteUInt32(buffer, index->entries[i].preroll);
+    }
+
+    return FLO_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FLO_FrameIndex_Deserialize
++---------------------------------------------------------------------*/
+FLO_Result 
+FLO_FrameIndex_Deserialize(const unsigned char* buffer,
+                           FLO_Size             size,
+                           FLO_FrameIndex**     index)
+{
+    FLO_Cardinal entry_count;
+    FLO_Cardinal i;
+    
+    /* default return value */
+    *index = NULL;
+
+    /* check the header */
+    if (size < FLO_FRAME_INDEX_HEADER_SIZE ||
+        FLO_FrameIndex_ReadUInt32(buffer)   != FLO_FRAME_INDEX_MAGIC ||
+        FLO_FrameIndex_ReadUInt32(buffer+4) != FLO_FRAME_INDEX_VERSION ||
+        FLO_FrameIndex_ReadUInt32(buffer+8) == 0) {
+        return FLO_ERROR_INVALID_FRAME_INDEX;
+    }
+    entry_count = FLO_FrameIndex_ReadUInt32(buffer+32);
+    if (entry_count > (size-FLO_FRAME_INDEX_HEADER_SIZE)/FLO_FRAME_INDEX_ENTRY_SIZE ||
+        size != FLO_FRAME_INDEX_HEADER_SIZE+entry_count*FLO_FRAME_INDEX_ENTRY_SIZE) {
+        return FLO_ERROR_INVALID_FRAME_INDEX;
+    }
+
+    /* create the index */
+    *index = ATX_AllocateZeroMemory(sizeof(FLO_FrameIndex));
+    if (*index == NULL) return FLO_ERROR_OUT_OF_MEMORY;
+    (*index)->granularity  = FLO_FrameIndex_ReadUInt32(buffer+8);
+    (*index)->lead         = FLO_FrameIndex_ReadUInt32(buffer+12);
+    (*index)->sample_count = FLO_FrameIndex_ReadUInt64(buffer+16);
+    (*index)->stream_size  = FLO_FrameIndex_ReadUInt64(buffer+24);
+    (*index)->complete     = FLO_TRUE;
+    if (entry_count) {
+        (*index)->entries = ATX_AllocateMemory(entry_count*sizeof(FLO_FrameIndexEntry));
+        if ((*index)->entries == NULL) {
+            ATX_FreeMemory(*index);
+            *index = NULL;
+            return FLO_ERROR_OUT_OF_MEMORY;
+        }
+        (*index)->entry_capacity = entry_count;
+    }
+
+    /* read the entries, which must be in order and inside the stream */
+    buffer += FLO_FRAME_INDEX_HEADER_SIZE;
+    for (i = 0; i < entry_count; i++) {
+        FLO_FrameIndexEntry* entry = &(*index)->entries[i];
+        entry->offset  = FLO_FrameIndex_ReadUInt64(buffer);
+        entry->sample  = FLO_FrameIndex_ReadUInt64(buffer+8);
+        entry->preroll = FLO_FrameIndex_ReadUInt32(buffer+16);
+        buffer += FLO_FRAME_INDEX_ENTRY_SIZE;
+        if ((i && entry->sample <= entry[-1].sample) || 
+            entry->preroll > entry->sample            ||
+            entry->sample >= (*index)->sample_count   ||
+            entry->offset >= (*index)->stream_size) {
+            FLO_FrameIndex_Destroy(*index);
+            *index = NULL;
+            return FLO_ERROR_INVALID_FRAME_INDEX;
+        }
+        (*index)->entry_count++;
+    }
+
+    return FLO_SUCCESS;
+}
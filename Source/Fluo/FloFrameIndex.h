@@ -0,0 +1,68 @@
+/*****************************************************************
+|
+|   Fluo - Frame Index
+|
+|   (c) 2002-2006 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+/** @file
+ * Fluo - Frame Index
+ *
+ * A frame index maps sample positions to byte offsets in a stream.
+ * It is built by scanning the frame headers of the whole stream, and
+ * records one entry every 'granularity' samples. Each entry points a
+ * few frames before the indexed frame, far enough back for the bit
+ * reservoir and the filters to be primed, so that decoding from the
+ * entry and skipping the preroll samples gives the same samples as
+ * decoding from the start of the stream.
+ * An index can be serialized, so that it can be cached and reloaded
+ * without scanning the stream again.
+ */
+
+#ifndef _FLO_FRAME_INDEX_H_
+#define _FLO_FRAME_INDEX_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "FloTypes.h"
+#include "FloErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef struct FLO_FrameIndex FLO_FrameIndex;
+
+/*----------------------------------------------------------------------
+|   error codes
++---------------------------------------------------------------------*/
+#define FLO_ERROR_INVALID_FRAME_INDEX      (FLO_ERROR_BASE_FRAME_INDEX - 0)
+#define FLO_ERROR_FRAME_INDEX_INCOMPLETE   (FLO_ERROR_BASE_FRAME_INDEX - 1)
+#define FLO_ERROR_SAMPLE_NOT_INDEXED       (FLO_ERROR_BASE_FRAME_INDEX - 2)
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+FLO_Result  FLO_FrameIndex_Create(FLO_Cardinal     granularity,
+                                  FLO_FrameIndex** index);
+FLO_Result  FLO_FrameIndex_Destroy(FLO_FrameIndex* index);
+FLO_Result  FLO_FrameIndex_Feed(FLO_FrameIndex* index,
+                                FLO_ByteBuffer  buffer,
+                                FLO_Size        size,
+                                FLO_Flags       flags);
+FLO_Boolean FLO_FrameIndex_IsComplete(FLO_FrameIndex* index);
+FLO_UInt64  FLO_FrameIndex_GetStreamSize(FLO_FrameIndex* index);
+FLO_Result  FLO_FrameIndex_Lookup(FLO_FrameIndex* index,
+                                  FLO_UInt64      sample,
+                                  FLO_UInt64*     offset,
+                                  FLO_Cardinal*   samples_to_skip);
+FLO_Size    FLO_FrameIndex_GetSerializedSize(FLO_FrameIndex* index);
+FLO_Result  FLO_FrameIndex_Serialize(FLO_FrameIndex* index,
+                                     unsigned char*  buffer,
+                                     FLO_Size        size);
+FLO_Result  FLO_FrameIndex_Deserialize(const unsigned char* buffer,
+                                       FLO_Size             size,
+                                       FLO_FrameIndex**     index);
+
+#endif /* _FLO_FRAME_INDEX_H_ */
@@ -18,331 +18,706 @@
 
 /*-------------------------------------------------------------------------
 |       tables
+|
+|   Each table is indexed with the next 'lookup_bits' bits of the stream.
+|   An entry is either a code, with its length in bits 8-11 and its value
+|   in bits 0-7 (x<<4|y for pairs, vwxy for quads), or, when bit 15 is
+|   set, a link to a sub-table indexed with the bits that follow, with
+|   the number of index bits in bits 12-14 and the sub-table offset in
+|   bits 0-11. Codes longer than 8 bits go through sub-table(s) of up to
+|   6 bits. These tables were generated from the code trees of
+|   ISO/IEC 11172-3 Annex B, table B.7.
 +-------------------------------------------------------------------------*/
-static short const Table_0[] = 
-{ 
-   0
+static FLO_UInt16 const Table_0[2] =
+{
+    0x0000, 0x0000
 };
 
-static short const Table_1[] =
+static FLO_UInt16 const Table_1[8] =
 {
-    -5,  -3,  -1,  17,   1,  16,
-     0
+    0x0311, 0x0301, 0x0210, 0x0210, 0x0100, 0x0100, 0x0100, 0x0100
 };
 
-static short const Table_2[] =
+static FLO_UInt16 const Table_2[64] =
 {
-    -15, -11,  -9,  -5,  -3,  -1,  34,   2,  
-     18,  -1,  33,  32,  17,  -1,   1,  16,   
-      0
+    0x0622, 0x0602, 0x0512, 0x0512, 0x0521, 0x0521, 0x0520, 0x0520,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100
 };
 
-static short const Table_3[] =
+static FLO_UInt16 const Table_3[64] =
 {
-    -13, -11,  -9,  -5,  -3,  -1,  34,   2,  18,  -1,  33,  32,  16,  17,  -1,
-      1,   0
+    0x0622, 0x0602, 0x0512, 0x0512, 0x0521, 0x0521, 0x0520, 0x0520,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0201, 0x0201, 0x0201, 0x0201, 0x0201, 0x0201, 0x0201, 0x0201,
+    0x0201, 0x0201, 0x0201, 0x0201, 0x0201, 0x0201, 0x0201, 0x0201,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200
 };
 
 /* Table_4 is not used */
 
-static short const Table_5[] =
+static FLO_UInt16 const Table_5[256] =
 {
-    -29, -25, -23, -15,  -7,  -5,  -3,  -1,  51,  35,  50,  49,  -3,  -1,  19,
-      3,  -1,  48,  34,  -3,  -1,  18,  33,  -1,   2,  32,  17,  -1,   1,  16,
-      0
+    0x0833, 0x0823, 0x0732, 0x0732, 0x0631, 0x0631, 0x0631, 0x0631,
+    0x0713, 0x0713, 0x0703, 0x0703, 0x0730, 0x0730, 0x0722, 0x0722,
+    0x0612, 0x0612, 0x0612, 0x0612, 0x0621, 0x0621, 0x0621, 0x0621,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100
 };
 
-static short const Table_6[] =
+static FLO_UInt16 const Table_6[128] =
 {
-    -25, -19, -13,  -9,  -5,  -3,  -1,  51,   3,  35,  -1,  50,  48,  -1,  19,
-     49,  -3,  -1,  34,   2,  18,  -3,  -1,  33,  32,   1,  -1,  17,  -1,  16,
-      0
+    0x0733, 0x0703, 0x0623, 0x0623, 0x0632, 0x0632, 0x0630, 0x0630,
+    0x0513, 0x0513, 0x0513, 0x0513, 0x0531, 0x0531, 0x0531, 0x0531,
+    0x0522, 0x0522, 0x0522, 0x0522, 0x0502, 0x0502, 0x0502, 0x0502,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300
 };
 
-static short const Table_7[] =
+static FLO_UInt16 const Table_7[268] =
 {
-    -69, -65, -57, -39, -29, -17, -11,  -7,  -3,  -1,  85,  69,  -1,  84,  83,
-     -1,  53,  68,  -3,  -1,  37,  82,  21,  -5,  -1,  81,  -1,   5,  52,  -1,
-     80,  -1,  67,  51,  -5,  -3,  -1,  36,  66,  20,  -1,  65,  64, -11,  -7,
-     -3,  -1,   4,  35,  -1,  50,   3,  -1,  19,  49,  -3,  -1,  48,  34,  18,
-     -5,  -1,  33,  -1,   2,  32,  17,  -1,   1,  16,   0
+    0xa100, 0x9104, 0x9106, 0x0815, 0x0851, 0x9108, 0x0850, 0x910a,
+    0x0824, 0x0842, 0x0714, 0x0714, 0x0741, 0x0741, 0x0740, 0x0740,
+    0x0804, 0x0823, 0x0832, 0x0803, 0x0713, 0x0713, 0x0731, 0x0731,
+    0x0730, 0x0730, 0x0722, 0x0722, 0x0612, 0x0612, 0x0612, 0x0612,
+    0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0255, 0x0245, 0x0254, 0x0253, 0x0135, 0x0144, 0x0125, 0x0152,
+    0x0105, 0x0134, 0x0143, 0x0133
 };
 
-static short const Table_8[] =
+static FLO_UInt16 const Table_8[274] =
 {
-    -65, -63, -59, -45, -31, -19, -13,  -7,  -5,  -3,  -1,  85,  84,  69,  83,
-     -3,  -1,  53,  68,  37,  -3,  -1,  82,   5,  21,  -5,  -1,  81,  -1,  52,
-     67,  -3,  -1,  80,  51,  36,  -5,  -3,  -1,  66,  20,  65,  -3,  -1,   4,
-     64,  -1,  35,  50,  -9,  -7,  -3,  -1,  19,  49,  -1,   3,  48,  34,  -1,
-      2,  32,  -1,  18,  33,  17,  -3,  -1,   1,  16,   0
+    0xb100, 0xa108, 0x910c, 0x0815, 0x0851, 0x910e, 0x9110, 0x0824,
+    0x0842, 0x0814, 0x0741, 0x0741, 0x0804, 0x0840, 0x0823, 0x0832,
+    0x0813, 0x0831, 0x0803, 0x0830, 0x0622, 0x0622, 0x0622, 0x0622,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211, 0x0211,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0355, 0x0354, 0x0245, 0x0245, 0x0153, 0x0153, 0x0153, 0x0153,
+    0x0235, 0x0244, 0x0125, 0x0125, 0x0152, 0x0105, 0x0134, 0x0143,
+    0x0150, 0x0133
 };
 
-static short const Table_9[] =
+static FLO_UInt16 const Table_9[260] =
 {
-    -63, -53, -41, -29, -19, -11,  -5,  -3,  -1,  85,  69,  53,  -1,  83,  -1,
-     84,   5,  -3,  -1,  68,  37,  -1,  82,  21,  -3,  -1,  81,  52,  -1,  67,
-     -1,  80,   4,  -7,  -3,  -1,  36,  66,  -1,  51,  64,  -1,  20,  65,  -5,
-     -3,  -1,  35,  50,  19,  -1,  49,  -1,   3,  48,  -5,  -3,  -1,  34,   2,
-     18,  -1,  33,  32,  -3,  -1,  17,   1,  -1,  16,   0
+    0x9100, 0x0835, 0x0853, 0x9102, 0x0844, 0x0825, 0x0852, 0x0815,
+    0x0751, 0x0751, 0x0734, 0x0734, 0x0743, 0x0743, 0x0850, 0x0804,
+    0x0724, 0x0724, 0x0742, 0x0742, 0x0733, 0x0733, 0x0740, 0x0740,
+    0x0614, 0x0614, 0x0614, 0x0614, 0x0641, 0x0641, 0x0641, 0x0641,
+    0x0623, 0x0623, 0x0623, 0x0623, 0x0632, 0x0632, 0x0632, 0x0632,
+    0x0513, 0x0513, 0x0513, 0x0513, 0x0513, 0x0513, 0x0513, 0x0513,
+    0x0531, 0x0531, 0x0531, 0x0531, 0x0531, 0x0531, 0x0531, 0x0531,
+    0x0603, 0x0603, 0x0603, 0x0603, 0x0630, 0x0630, 0x0630, 0x0630,
+    0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522,
+    0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420,
+    0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420, 0x0420,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0155, 0x0145, 0x0154, 0x0105
 };
 
-static short const Table_10[] =
+static FLO_UInt16 const Table_10[306] =
 {
-    -125,-121,-111, -83, -55, -35, -21, -13,  -7,  -3,  -1, 119, 103,  -1, 118,
-      87,  -3,  -1, 117, 102,  71,  -3,  -1, 116,  86,  -1, 101,  55,  -9,  -3,
-      -1, 115,  70,  -3,  -1,  85,  84,  99,  -1,  39, 114, -11,  -5,  -3,  -1,
-     100,   7, 112,  -1,  98,  -1,  69,  53,  -5,  -1,   6,  -1,  83,  68,  23,
-     -17,  -5,  -1, 113,  -1,  54,  38,  -5,  -3,  -1,  37,  82,  21,  -1,  81,
-      -1,  52,  67,  -3,  -1,  22,  97,  -1,  96,  -1,   5,  80, -19, -11,  -7,
-      -3,  -1,  36,  66,  -1,  51,   4,  -1,  20,  65,  -3,  -1,  64,  35,  -1,
-      50,   3,  -3,  -1,  19,  49,  -1,  48,  34,  -7,  -3,  -1,  18,  33,  -1,
-       2,  32,  17,  -1,   1,  16,   0
+    0xb100, 0xa108, 0xb10c, 0x9114, 0xa116, 0xa11a, 0xa11e, 0x0817,
+    0x0871, 0x9122, 0xa124, 0xa128, 0x0816, 0x0861, 0x0860, 0x912c,
+    0x912e, 0x9130, 0x0814, 0x0841, 0x0840, 0x0823, 0x0832, 0x0803,
+    0x0713, 0x0713, 0x0731, 0x0731, 0x0730, 0x0730, 0x0722, 0x0722,
+    0x0612, 0x0612, 0x0612, 0x0612, 0x0621, 0x0621, 0x0621, 0x0621,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0377, 0x0367, 0x0376, 0x0357, 0x0375, 0x0366, 0x0247, 0x0247,
+    0x0274, 0x0256, 0x0265, 0x0237, 0x0273, 0x0273, 0x0246, 0x0246,
+    0x0355, 0x0354, 0x0263, 0x0263, 0x0127, 0x0172, 0x0264, 0x0207,
+    0x0170, 0x0170, 0x0162, 0x0162, 0x0245, 0x0235, 0x0106, 0x0106,
+    0x0253, 0x0244, 0x0136, 0x0126, 0x0225, 0x0252, 0x0115, 0x0115,
+    0x0151, 0x0151, 0x0234, 0x0243, 0x0105, 0x0150, 0x0124, 0x0142,
+    0x0133, 0x0104
 };
 
-static short const Table_11[] =
+static FLO_UInt16 const Table_11[286] =
 {
-    -121,-113, -89, -59, -43, -27, -17,  -7,  -3,  -1, 119, 103,  -1, 118, 117,
-      -3,  -1, 102,  71,  -1, 116,  -1,  87,  85,  -5,  -3,  -1,  86, 101,  55,
-      -1, 115,  70,  -9,  -7,  -3,  -1,  69,  84,  -1,  53,  83,  39,  -1, 114,
-      -1, 100,   7,  -5,  -1, 113,  -1,  23, 112,  -3,  -1,  54,  99,  -1,  96,
-      -1,  68,  37, -13,  -7,  -5,  -3,  -1,  82,   5,  21,  98,  -3,  -1,  38,
-       6,  22,  -5,  -1,  97,  -1,  81,  52,  -5,  -1,  80,  -1,  67,  51,  -1,
-      36,  66, -15, -11,  -7,  -3,  -1,  20,  65,  -1,   4,  64,  -1,  35,  50,
-      -1,  19,  49,  -5,  -3,  -1,   3,  48,  34,  33,  -5,  -1,  18,  -1,   2,
-      32,  17,  -3,  -1,   1,  16,   0
+    0xa100, 0xb104, 0xa10c, 0x9110, 0xa112, 0x0827, 0x0872, 0x9116,
+    0x0771, 0x0771, 0x0817, 0x0870, 0x0836, 0x0863, 0x0860, 0x9118,
+    0x911a, 0x0815, 0x0762, 0x0762, 0x0826, 0x0806, 0x0716, 0x0716,
+    0x0761, 0x0761, 0x0851, 0x0834, 0x0850, 0x911c, 0x0824, 0x0842,
+    0x0814, 0x0841, 0x0804, 0x0840, 0x0723, 0x0723, 0x0732, 0x0732,
+    0x0613, 0x0613, 0x0613, 0x0613, 0x0631, 0x0631, 0x0631, 0x0631,
+    0x0703, 0x0703, 0x0730, 0x0730, 0x0622, 0x0622, 0x0622, 0x0622,
+    0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502,
+    0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200, 0x0200,
+    0x0277, 0x0267, 0x0276, 0x0275, 0x0266, 0x0266, 0x0247, 0x0247,
+    0x0274, 0x0274, 0x0357, 0x0355, 0x0256, 0x0265, 0x0137, 0x0137,
+    0x0173, 0x0146, 0x0245, 0x0254, 0x0235, 0x0253, 0x0164, 0x0107,
+    0x0144, 0x0125, 0x0152, 0x0105, 0x0143, 0x0133
 };
 
-static short const Table_12[] =
+static FLO_UInt16 const Table_12[272] =
 {
-    -115, -99, -73, -45, -27, -17,  -9,  -5,  -3,  -1, 119, 103, 118,  -1,  87,
-     117,  -3,  -1, 102,  71,  -1, 116, 101,  -3,  -1,  86,  55,  -3,  -1, 115,
-      85,  39,  -7,  -3,  -1, 114,  70,  -1, 100,  23,  -5,  -1, 113,  -1,   7,
-     112,  -1,  54,  99, -13,  -9,  -3,  -1,  69,  84,  -1,  68,  -1,   6,   5,
-      -1,  38,  98,  -5,  -1,  97,  -1,  22,  96,  -3,  -1,  53,  83,  -1,  37,
-      82, -17,  -7,  -3,  -1,  21,  81,  -1,  52,  67,  -5,  -3,  -1,  80,   4,
-      36,  -1,  66,  20,  -3,  -1,  51,  65,  -1,  35,  50, -11,  -7,  -5,  -3,
-      -1,  64,   3,  48,  19,  -1,  49,  34,  -1,  18,  33,  -7,  -5,  -3,  -1,
-       2,  32,   0,  17,  -1,   1,  16
+    0xa100, 0x9104, 0x9106, 0x9108, 0x0856, 0x0837, 0x910a, 0x0827,
+    0x0872, 0x0846, 0x0864, 0x0817, 0x0871, 0x910c, 0x0836, 0x0863,
+    0x0845, 0x0854, 0x0844, 0x910e, 0x0726, 0x0726, 0x0762, 0x0762,
+    0x0761, 0x0761, 0x0816, 0x0860, 0x0835, 0x0853, 0x0825, 0x0852,
+    0x0715, 0x0715, 0x0751, 0x0751, 0x0734, 0x0734, 0x0743, 0x0743,
+    0x0850, 0x0804, 0x0724, 0x0724, 0x0742, 0x0742, 0x0714, 0x0714,
+    0x0633, 0x0633, 0x0633, 0x0633, 0x0641, 0x0641, 0x0641, 0x0641,
+    0x0623, 0x0623, 0x0623, 0x0623, 0x0632, 0x0632, 0x0632, 0x0632,
+    0x0740, 0x0740, 0x0703, 0x0703, 0x0630, 0x0630, 0x0630, 0x0630,
+    0x0513, 0x0513, 0x0513, 0x0513, 0x0513, 0x0513, 0x0513, 0x0513,
+    0x0531, 0x0531, 0x0531, 0x0531, 0x0531, 0x0531, 0x0531, 0x0531,
+    0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412, 0x0412,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421, 0x0421,
+    0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502,
+    0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520,
+    0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400,
+    0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301, 0x0301,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0277, 0x0267, 0x0176, 0x0176, 0x0157, 0x0175, 0x0166, 0x0147,
+    0x0174, 0x0165, 0x0173, 0x0155, 0x0107, 0x0170, 0x0106, 0x0105
 };
 
-static short const Table_13[] =
+static FLO_UInt16 const Table_13[602] =
 {
-    -509,-503,-475,-405,-333,-265,-205,-153,-115, -83, -53, -35, -21, -13,  -9,
-      -7,  -5,  -3,  -1, 254, 252, 253, 237, 255,  -1, 239, 223,  -3,  -1, 238,
-     207,  -1, 222, 191,  -9,  -3,  -1, 251, 206,  -1, 220,  -1, 175, 233,  -1,
-     236, 221,  -9,  -5,  -3,  -1, 250, 205, 190,  -1, 235, 159,  -3,  -1, 249,
-     234,  -1, 189, 219, -17,  -9,  -3,  -1, 143, 248,  -1, 204,  -1, 174, 158,
-      -5,  -1, 142,  -1, 127, 126, 247,  -5,  -1, 218,  -1, 173, 188,  -3,  -1,
-     203, 246, 111, -15,  -7,  -3,  -1, 232,  95,  -1, 157, 217,  -3,  -1, 245,
-     231,  -1, 172, 187,  -9,  -3,  -1,  79, 244,  -3,  -1, 202, 230, 243,  -1,
-      63,  -1, 141, 216, -21,  -9,  -3,  -1,  47, 242,  -3,  -1, 110, 156,  15,
-      -5,  -3,  -1, 201,  94, 171,  -3,  -1, 125, 215,  78, -11,  -5,  -3,  -1,
-     200, 214,  62,  -1, 185,  -1, 155, 170,  -1,  31, 241, -23, -13,  -5,  -1,
-     240,  -1, 186, 229,  -3,  -1, 228, 140,  -1, 109, 227,  -5,  -1, 226,  -1,
-      46,  14,  -1,  30, 225, -15,  -7,  -3,  -1, 224,  93,  -1, 213, 124,  -3,
-      -1, 199,  77,  -1, 139, 184,  -7,  -3,  -1, 212, 154,  -1, 169, 108,  -1,
-     198,  61, -37, -21,  -9,  -5,  -3,  -1, 211, 123,  45,  -1, 210,  29,  -5,
-      -1, 183,  -1,  92, 197,  -3,  -1, 153, 122, 195,  -7,  -5,  -3,  -1, 167,
-     151,  75, 209,  -3,  -1,  13, 208,  -1, 138, 168, -11,  -7,  -3,  -1,  76,
-     196,  -1, 107, 182,  -1,  60,  44,  -3,  -1, 194,  91,  -3,  -1, 181, 137,
-      28, -43, -23, -11,  -5,  -1, 193,  -1, 152,  12,  -1, 192,  -1, 180, 106,
-      -5,  -3,  -1, 166, 121,  59,  -1, 179,  -1, 136,  90, -11,  -5,  -1,  43,
-      -1, 165, 105,  -1, 164,  -1, 120, 135,  -5,  -1, 148,  -1, 119, 118, 178,
-     -11,  -3,  -1,  27, 177,  -3,  -1,  11, 176,  -1, 150,  74,  -7,  -3,  -1,
-      58, 163,  -1,  89, 149,  -1,  42, 162, -47, -23,  -9,  -3,  -1,  26, 161,
-      -3,  -1,  10, 104, 160,  -5,  -3,  -1, 134,  73, 147,  -3,  -1,  57,  88,
-      -1, 133, 103,  -9,  -3,  -1,  41, 146,  -3,  -1,  87, 117,  56,  -5,  -1,
-     131,  -1, 102,  71,  -3,  -1, 116,  86,  -1, 101, 115, -11,  -3,  -1,  25,
-     145,  -3,  -1,   9, 144,  -1,  72, 132,  -7,  -5,  -1, 114,  -1,  70, 100,
-      40,  -1, 130,  24, -41, -27, -11,  -5,  -3,  -1,  55,  39,  23,  -1, 113,
-      -1,  85,   7,  -7,  -3,  -1, 112,  54,  -1,  99,  69,  -3,  -1,  84,  38,
-      -1,  98,  53,  -5,  -1, 129,  -1,   8, 128,  -3,  -1,  22,  97,  -1,   6,
-      96, -13,  -9,  -5,  -3,  -1,  83,  68,  37,  -1,  82,   5,  -1,  21,  81,
-      -7,  -3,  -1,  52,  67,  -1,  80,  36,  -3,  -1,  66,  51,  20, -19, -11,
-      -5,  -1,  65,  -1,   4,  64,  -3,  -1,  35,  50,  19,  -3,  -1,  49,   3,
-      -1,  48,  34,  -3,  -1,  18,  33,  -1,   2,  32,  -3,  -1,  17,   1,  16,
-       0
+    0xe100, 0xd188, 0xd1a8, 0xc1c8, 0xc1d8, 0xc1e8, 0xb1f8, 0xb200,
+    0xb208, 0xb210, 0xb218, 0xb220, 0x9228, 0xa22a, 0xb22e, 0x9236,
+    0xa238, 0xa23c, 0xa240, 0xa244, 0x0881, 0x9248, 0x924a, 0x924c,
+    0xa24e, 0x9252, 0x0815, 0x0851, 0x9254, 0x9256, 0x9258, 0x0814,
+    0x0741, 0x0741, 0x0804, 0x0840, 0x0823, 0x0832, 0x0713, 0x0713,
+    0x0731, 0x0731, 0x0703, 0x0703, 0x0730, 0x0730, 0x0722, 0x0722,
+    0x0612, 0x0612, 0x0612, 0x0612, 0x0621, 0x0621, 0x0621, 0x0621,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0xd140, 0xa160, 0xb164, 0x916c, 0xa16e, 0x9172, 0x9174, 0x9176,
+    0x9178, 0xa17a, 0xa17e, 0x06f7, 0x06da, 0x9182, 0x9184, 0x066f,
+    0x06e8, 0x065f, 0x069d, 0x06d9, 0x06f5, 0x06e7, 0x06ac, 0x06bb,
+    0x064f, 0x06f4, 0x9186, 0x06f3, 0x053f, 0x053f, 0x068d, 0x06d8,
+    0x052f, 0x052f, 0x05f2, 0x05f2, 0x066e, 0x069c, 0x050f, 0x050f,
+    0x06c9, 0x065e, 0x05ab, 0x05ab, 0x067d, 0x06d7, 0x054e, 0x054e,
+    0x06c8, 0x06d6, 0x053e, 0x053e, 0x05b9, 0x05b9, 0x069b, 0x06aa,
+    0x041f, 0x041f, 0x041f, 0x041f, 0x04f1, 0x04f1, 0x04f1, 0x04f1,
+    0x05fe, 0x05fc, 0x04fd, 0x04fd, 0x03ed, 0x03ed, 0x03ed, 0x03ed,
+    0x02ff, 0x02ff, 0x02ff, 0x02ff, 0x02ff, 0x02ff, 0x02ff, 0x02ff,
+    0x02ef, 0x02ef, 0x02ef, 0x02ef, 0x02ef, 0x02ef, 0x02ef, 0x02ef,
+    0x02df, 0x02df, 0x02df, 0x02df, 0x02df, 0x02df, 0x02df, 0x02df,
+    0x02ee, 0x02cf, 0x02de, 0x02bf, 0x02fb, 0x02fb, 0x02ce, 0x02ce,
+    0x02dc, 0x02dc, 0x03af, 0x03e9, 0x01ec, 0x01dd, 0x02fa, 0x02cd,
+    0x01be, 0x01be, 0x01eb, 0x019f, 0x01f9, 0x01ea, 0x01bd, 0x01db,
+    0x018f, 0x01f8, 0x01cc, 0x01cc, 0x02ae, 0x029e, 0x018e, 0x018e,
+    0x027f, 0x027e, 0x01ad, 0x01bc, 0x01cb, 0x01f6, 0x01ca, 0x01e6,
+    0x04f0, 0x04f0, 0x05ba, 0x05e5, 0x05e4, 0x058c, 0x056d, 0x05e3,
+    0x04e2, 0x04e2, 0x052e, 0x050e, 0x041e, 0x041e, 0x04e1, 0x04e1,
+    0x05e0, 0x055d, 0x05d5, 0x057c, 0x05c7, 0x054d, 0x058b, 0x05b8,
+    0x05d4, 0x059a, 0x05a9, 0x056c, 0x04c6, 0x04c6, 0x043d, 0x043d,
+    0x05d3, 0x057b, 0x042d, 0x042d, 0x04d2, 0x04d2, 0x041d, 0x041d,
+    0x04b7, 0x04b7, 0x055c, 0x05c5, 0x0599, 0x057a, 0x04c3, 0x04c3,
+    0x05a7, 0x0597, 0x044b, 0x044b, 0x03d1, 0x03d1, 0x03d1, 0x03d1,
+    0x040d, 0x040d, 0x04d0, 0x04d0, 0x048a, 0x048a, 0x04a8, 0x04a8,
+    0x044c, 0x04c4, 0x046b, 0x04b6, 0x033c, 0x033c, 0x032c, 0x032c,
+    0x03c2, 0x03c2, 0x035b, 0x035b, 0x04b5, 0x0489, 0x031c, 0x031c,
+    0x03c1, 0x03c1, 0x0498, 0x040c, 0x03c0, 0x03c0, 0x04b4, 0x046a,
+    0x04a6, 0x0479, 0x033b, 0x033b, 0x03b3, 0x03b3, 0x0488, 0x045a,
+    0x032b, 0x032b, 0x04a5, 0x0469, 0x03a4, 0x03a4, 0x0478, 0x0487,
+    0x0394, 0x0394, 0x0477, 0x0476, 0x02b2, 0x02b2, 0x02b2, 0x02b2,
+    0x021b, 0x021b, 0x02b1, 0x02b1, 0x030b, 0x03b0, 0x0396, 0x034a,
+    0x033a, 0x03a3, 0x0359, 0x0395, 0x022a, 0x022a, 0x02a2, 0x02a2,
+    0x021a, 0x021a, 0x02a1, 0x02a1, 0x030a, 0x0368, 0x02a0, 0x02a0,
+    0x0386, 0x0349, 0x0293, 0x0293, 0x0339, 0x0358, 0x0385, 0x0367,
+    0x0229, 0x0229, 0x0292, 0x0292, 0x0357, 0x0375, 0x0238, 0x0238,
+    0x0283, 0x0283, 0x0366, 0x0347, 0x0374, 0x0356, 0x0365, 0x0373,
+    0x0119, 0x0191, 0x0209, 0x0290, 0x0248, 0x0284, 0x0272, 0x0272,
+    0x0346, 0x0364, 0x0128, 0x0128, 0x0128, 0x0128, 0x0182, 0x0118,
+    0x0237, 0x0227, 0x0117, 0x0117, 0x0171, 0x0171, 0x0255, 0x0207,
+    0x0270, 0x0236, 0x0263, 0x0245, 0x0254, 0x0226, 0x0262, 0x0235,
+    0x0108, 0x0180, 0x0116, 0x0161, 0x0106, 0x0160, 0x0253, 0x0244,
+    0x0125, 0x0125, 0x0152, 0x0105, 0x0134, 0x0143, 0x0150, 0x0124,
+    0x0142, 0x0133
 };
 
 /* Table_14 is not used */
 
-static short const Table_15[] =
+static FLO_UInt16 const Table_15[534] =
 {
-    -495,-445,-355,-263,-183,-115, -77, -43, -27, -13,  -7,  -3,  -1, 255, 239,
-      -1, 254, 223,  -1, 238,  -1, 253, 207,  -7,  -3,  -1, 252, 222,  -1, 237,
-     191,  -1, 251,  -1, 206, 236,  -7,  -3,  -1, 221, 175,  -1, 250, 190,  -3,
-      -1, 235, 205,  -1, 220, 159, -15,  -7,  -3,  -1, 249, 234,  -1, 189, 219,
-      -3,  -1, 143, 248,  -1, 204, 158,  -7,  -3,  -1, 233, 127,  -1, 247, 173,
-      -3,  -1, 218, 188,  -1, 111,  -1, 174,  15, -19, -11,  -3,  -1, 203, 246,
-      -3,  -1, 142, 232,  -1,  95, 157,  -3,  -1, 245, 126,  -1, 231, 172,  -9,
-      -3,  -1, 202, 187,  -3,  -1, 217, 141,  79,  -3,  -1, 244,  63,  -1, 243,
-     216, -33, -17,  -9,  -3,  -1, 230,  47,  -1, 242,  -1, 110, 240,  -3,  -1,
-      31, 241,  -1, 156, 201,  -7,  -3,  -1,  94, 171,  -1, 186, 229,  -3,  -1,
-     125, 215,  -1,  78, 228, -15,  -7,  -3,  -1, 140, 200,  -1,  62, 109,  -3,
-      -1, 214, 227,  -1, 155, 185,  -7,  -3,  -1,  46, 170,  -1, 226,  30,  -5,
-      -1, 225,  -1,  14, 224,  -1,  93, 213, -45, -25, -13,  -7,  -3,  -1, 124,
-     199,  -1,  77, 139,  -1, 212,  -1, 184, 154,  -7,  -3,  -1, 169, 108,  -1,
-     198,  61,  -1, 211, 210,  -9,  -5,  -3,  -1,  45,  13,  29,  -1, 123, 183,
-      -5,  -1, 209,  -1,  92, 208,  -1, 197, 138, -17,  -7,  -3,  -1, 168,  76,
-      -1, 196, 107,  -5,  -1, 182,  -1, 153,  12,  -1,  60, 195,  -9,  -3,  -1,
-     122, 167,  -1, 166,  -1, 192,  11,  -1, 194,  -1,  44,  91, -55, -29, -15,
-      -7,  -3,  -1, 181,  28,  -1, 137, 152,  -3,  -1, 193,  75,  -1, 180, 106,
-      -5,  -3,  -1,  59, 121, 179,  -3,  -1, 151, 136,  -1,  43,  90, -11,  -5,
-      -1, 178,  -1, 165,  27,  -1, 177,  -1, 176, 105,  -7,  -3,  -1, 150,  74,
-      -1, 164, 120,  -3,  -1, 135,  58, 163, -17,  -7,  -3,  -1,  89, 149,  -1,
-      42, 162,  -3,  -1,  26, 161,  -3,  -1,  10, 160, 104,  -7,  -3,  -1, 134,
-      73,  -1, 148,  57,  -5,  -1, 147,  -1, 119,   9,  -1,  88, 133, -53, -29,
-     -13,  -7,  -3,  -1,  41, 103,  -1, 118, 146,  -1, 145,  -1,  25, 144,  -7,
-      -3,  -1,  72, 132,  -1,  87, 117,  -3,  -1,  56, 131,  -1, 102,  71,  -7,
-      -3,  -1,  40, 130,  -1,  24, 129,  -7,  -3,  -1, 116,   8,  -1, 128,  86,
-      -3,  -1, 101,  55,  -1, 115,  70, -17,  -7,  -3,  -1,  39, 114,  -1, 100,
-      23,  -3,  -1,  85, 113,  -3,  -1,   7, 112,  54,  -7,  -3,  -1,  99,  69,
-      -1,  84,  38,  -3,  -1,  98,  22,  -3,  -1,   6,  96,  53, -33, -19,  -9,
-      -5,  -1,  97,  -1,  83,  68,  -1,  37,  82,  -3,  -1,  21,  81,  -3,  -1,
-       5,  80,  52,  -7,  -3,  -1,  67,  36,  -1,  66,  51,  -1,  65,  -1,  20,
-       4,  -9,  -3,  -1,  35,  50,  -3,  -1,  64,   3,  19,  -3,  -1,  49,  48,
-      34,  -9,  -7,  -3,  -1,  18,  33,  -1,   2,  32,  17,  -3,  -1,   1,  16,
-       0
+    0xd100, 0xd120, 0xc140, 0xc150, 0xc160, 0xb170, 0xb178, 0xc180,
+    0xb190, 0xb198, 0xb1a0, 0xb1a8, 0xa1b0, 0xb1b4, 0xb1bc, 0xa1c4,
+    0xa1c8, 0xa1cc, 0xa1d0, 0xa1d4, 0xa1d8, 0xa1dc, 0xa1e0, 0xa1e4,
+    0x91e8, 0x91ea, 0x91ec, 0xa1ee, 0x91f2, 0x91f4, 0xa1f6, 0x91fa,
+    0x91fc, 0x91fe, 0x0891, 0x9200, 0x9202, 0x9204, 0x9206, 0x9208,
+    0x0828, 0x0882, 0x0818, 0x0881, 0x920a, 0x920c, 0x920e, 0x9210,
+    0x0827, 0x0872, 0x0864, 0x0817, 0x0855, 0x0871, 0x9212, 0x0836,
+    0x0863, 0x0845, 0x0854, 0x0826, 0x0862, 0x0816, 0x9214, 0x0835,
+    0x0761, 0x0761, 0x0853, 0x0844, 0x0725, 0x0725, 0x0752, 0x0752,
+    0x0715, 0x0715, 0x0751, 0x0751, 0x0805, 0x0850, 0x0734, 0x0734,
+    0x0743, 0x0743, 0x0724, 0x0724, 0x0742, 0x0742, 0x0733, 0x0733,
+    0x0641, 0x0641, 0x0641, 0x0641, 0x0714, 0x0714, 0x0704, 0x0704,
+    0x0623, 0x0623, 0x0623, 0x0623, 0x0632, 0x0632, 0x0632, 0x0632,
+    0x0740, 0x0740, 0x0703, 0x0703, 0x0613, 0x0613, 0x0613, 0x0613,
+    0x0631, 0x0631, 0x0631, 0x0631, 0x0630, 0x0630, 0x0630, 0x0630,
+    0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522, 0x0522,
+    0x0512, 0x0512, 0x0512, 0x0512, 0x0512, 0x0512, 0x0512, 0x0512,
+    0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521,
+    0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502, 0x0502,
+    0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520, 0x0520,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311, 0x0311,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410,
+    0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300,
+    0x05ff, 0x05ef, 0x05fe, 0x05df, 0x04ee, 0x04ee, 0x05fd, 0x05cf,
+    0x05fc, 0x05de, 0x05ed, 0x05bf, 0x04fb, 0x04fb, 0x05ce, 0x05ec,
+    0x04dd, 0x04dd, 0x04af, 0x04af, 0x04fa, 0x04fa, 0x04be, 0x04be,
+    0x04eb, 0x04eb, 0x04cd, 0x04cd, 0x04dc, 0x04dc, 0x049f, 0x049f,
+    0x04f9, 0x04f9, 0x04ea, 0x04ea, 0x04bd, 0x04bd, 0x04db, 0x04db,
+    0x048f, 0x048f, 0x04f8, 0x04f8, 0x04cc, 0x04cc, 0x049e, 0x049e,
+    0x04e9, 0x04e9, 0x047f, 0x047f, 0x04f7, 0x04f7, 0x04ad, 0x04ad,
+    0x04da, 0x04da, 0x04bc, 0x04bc, 0x046f, 0x046f, 0x05ae, 0x050f,
+    0x03cb, 0x03cb, 0x03f6, 0x03f6, 0x048e, 0x04e8, 0x045f, 0x049d,
+    0x03f5, 0x03f5, 0x037e, 0x037e, 0x03e7, 0x03e7, 0x03ac, 0x03ac,
+    0x03ca, 0x03ca, 0x03bb, 0x03bb, 0x04d9, 0x048d, 0x034f, 0x034f,
+    0x03f4, 0x03f4, 0x033f, 0x033f, 0x03f3, 0x03f3, 0x03d8, 0x03d8,
+    0x03e6, 0x03e6, 0x032f, 0x032f, 0x03f2, 0x03f2, 0x046e, 0x04f0,
+    0x031f, 0x031f, 0x03f1, 0x03f1, 0x039c, 0x039c, 0x03c9, 0x03c9,
+    0x035e, 0x03ab, 0x03ba, 0x03e5, 0x037d, 0x03d7, 0x034e, 0x03e4,
+    0x038c, 0x03c8, 0x033e, 0x036d, 0x03d6, 0x03e3, 0x039b, 0x03b9,
+    0x032e, 0x032e, 0x03aa, 0x03aa, 0x03e2, 0x03e2, 0x031e, 0x031e,
+    0x03e1, 0x03e1, 0x040e, 0x04e0, 0x035d, 0x035d, 0x03d5, 0x03d5,
+    0x037c, 0x03c7, 0x034d, 0x038b, 0x02d4, 0x02d4, 0x03b8, 0x039a,
+    0x03a9, 0x036c, 0x03c6, 0x033d, 0x02d3, 0x02d3, 0x02d2, 0x02d2,
+    0x032d, 0x030d, 0x021d, 0x021d, 0x027b, 0x027b, 0x02b7, 0x02b7,
+    0x02d1, 0x02d1, 0x035c, 0x03d0, 0x02c5, 0x02c5, 0x028a, 0x028a,
+    0x02a8, 0x024c, 0x02c4, 0x026b, 0x02b6, 0x02b6, 0x0399, 0x030c,
+    0x023c, 0x023c, 0x02c3, 0x02c3, 0x027a, 0x027a, 0x02a7, 0x02a7,
+    0x02a6, 0x02a6, 0x03c0, 0x030b, 0x01c2, 0x01c2, 0x022c, 0x025b,
+    0x02b5, 0x021c, 0x0289, 0x0298, 0x02c1, 0x024b, 0x02b4, 0x026a,
+    0x023b, 0x0279, 0x01b3, 0x01b3, 0x0297, 0x0288, 0x022b, 0x025a,
+    0x01b2, 0x01b2, 0x02a5, 0x021b, 0x01b1, 0x01b1, 0x02b0, 0x0269,
+    0x0296, 0x024a, 0x02a4, 0x0278, 0x0287, 0x023a, 0x01a3, 0x01a3,
+    0x0159, 0x0195, 0x012a, 0x01a2, 0x011a, 0x01a1, 0x020a, 0x02a0,
+    0x0168, 0x0168, 0x0186, 0x0149, 0x0194, 0x0139, 0x0193, 0x0193,
+    0x0277, 0x0209, 0x0158, 0x0185, 0x0129, 0x0167, 0x0176, 0x0192,
+    0x0119, 0x0190, 0x0148, 0x0184, 0x0157, 0x0175, 0x0138, 0x0183,
+    0x0166, 0x0147, 0x0174, 0x0108, 0x0180, 0x0156, 0x0165, 0x0137,
+    0x0173, 0x0146, 0x0107, 0x0170, 0x0106, 0x0160
 };
 
-static short const Table_16[] =
+static FLO_UInt16 const Table_16[632] =
 {
-    -509,-503,-461,-323,-103, -37, -27, -15,  -7,  -3,  -1, 239, 254,  -1, 223,
-     253,  -3,  -1, 207, 252,  -1, 191, 251,  -5,  -1, 175,  -1, 250, 159,  -3,
-      -1, 249, 248, 143,  -7,  -3,  -1, 127, 247,  -1, 111, 246, 255,  -9,  -5,
-      -3,  -1,  95, 245,  79,  -1, 244, 243, -53,  -1, 240,  -1,  63, -29, -19,
-     -13,  -7,  -5,  -1, 206,  -1, 236, 221, 222,  -1, 233,  -1, 234, 217,  -1,
-     238,  -1, 237, 235,  -3,  -1, 190, 205,  -3,  -1, 220, 219, 174, -11,  -5,
-      -1, 204,  -1, 173, 218,  -3,  -1, 126, 172, 202,  -5,  -3,  -1, 201, 125,
-      94, 189, 242, -93,  -5,  -3,  -1,  47,  15,  31,  -1, 241, -49, -25, -13,
-      -5,  -1, 158,  -1, 188, 203,  -3,  -1, 142, 232,  -1, 157, 231,  -7,  -3,
-      -1, 187, 141,  -1, 216, 110,  -1, 230, 156, -13,  -7,  -3,  -1, 171, 186,
-      -1, 229, 215,  -1,  78,  -1, 228, 140,  -3,  -1, 200,  62,  -1, 109,  -1,
-     214, 155, -19, -11,  -5,  -3,  -1, 185, 170, 225,  -1, 212,  -1, 184, 169,
-      -5,  -1, 123,  -1, 183, 208, 227,  -7,  -3,  -1,  14, 224,  -1,  93, 213,
-      -3,  -1, 124, 199,  -1,  77, 139, -75, -45, -27, -13,  -7,  -3,  -1, 154,
-     108,  -1, 198,  61,  -3,  -1,  92, 197,  13,  -7,  -3,  -1, 138, 168,  -1,
-     153,  76,  -3,  -1, 182, 122,  60, -11,  -5,  -3,  -1,  91, 137,  28,  -1,
-     192,  -1, 152, 121,  -1, 226,  -1,  46,  30, -15,  -7,  -3,  -1, 211,  45,
-      -1, 210, 209,  -5,  -1,  59,  -1, 151, 136,  29,  -7,  -3,  -1, 196, 107,
-      -1, 195, 167,  -1,  44,  -1, 194, 181, -23, -13,  -7,  -3,  -1, 193,  12,
-      -1,  75, 180,  -3,  -1, 106, 166, 179,  -5,  -3,  -1,  90, 165,  43,  -1,
-     178,  27, -13,  -5,  -1, 177,  -1,  11, 176,  -3,  -1, 105, 150,  -1,  74,
-     164,  -5,  -3,  -1, 120, 135, 163,  -3,  -1,  58,  89,  42, -97, -57, -33,
-     -19, -11,  -5,  -3,  -1, 149, 104, 161,  -3,  -1, 134, 119, 148,  -5,  -3,
-      -1,  73,  87, 103, 162,  -5,  -1,  26,  -1,  10, 160,  -3,  -1,  57, 147,
-      -1,  88, 133,  -9,  -3,  -1,  41, 146,  -3,  -1, 118,   9,  25,  -5,  -1,
-     145,  -1, 144,  72,  -3,  -1, 132, 117,  -1,  56, 131, -21, -11,  -5,  -3,
-      -1, 102,  40, 130,  -3,  -1,  71, 116,  24,  -3,  -1, 129, 128,  -3,  -1,
-       8,  86,  55,  -9,  -5,  -1, 115,  -1, 101,  70,  -1,  39, 114,  -5,  -3,
-      -1, 100,  85,   7,  23, -23, -13,  -5,  -1, 113,  -1, 112,  54,  -3,  -1,
-      99,  69,  -1,  84,  38,  -3,  -1,  98,  22,  -1,  97,  -1,   6,  96,  -9,
-      -5,  -1,  83,  -1,  53,  68,  -1,  37,  82,  -1,  81,  -1,  21,   5, -33,
-     -23, -13,  -7,  -3,  -1,  52,  67,  -1,  80,  36,  -3,  -1,  66,  51,  20,
-      -5,  -1,  65,  -1,   4,  64,  -1,  35,  50,  -3,  -1,  19,  49,  -3,  -1,
-       3,  48,  34,  -3,  -1,  18,  33,  -1,   2,  32,  -3,  -1,  17,   1,  16,
-       0
+    0xb100, 0xb108, 0xa110, 0x08ff, 0xa114, 0x9118, 0xe11a, 0x08f2,
+    0x9170, 0x081f, 0x08f1, 0xe172, 0xd1b2, 0xd1d2, 0xc1f2, 0xc202,
+    0xc212, 0xb222, 0xb22a, 0xb232, 0xb23a, 0xb242, 0xb24a, 0xb252,
+    0xa25a, 0xa25e, 0x9262, 0xa264, 0xa268, 0x926c, 0x0851, 0x926e,
+    0x9270, 0x9272, 0x9274, 0x0814, 0x0841, 0x9276, 0x0823, 0x0832,
+    0x0713, 0x0713, 0x0731, 0x0731, 0x0803, 0x0830, 0x0722, 0x0722,
+    0x0612, 0x0612, 0x0612, 0x0612, 0x0621, 0x0621, 0x0621, 0x0621,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310, 0x0310,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x03ef, 0x03fe, 0x03df, 0x03fd, 0x03cf, 0x03fc, 0x03bf, 0x03fb,
+    0x02af, 0x02af, 0x03fa, 0x039f, 0x03f9, 0x03f8, 0x028f, 0x028f,
+    0x027f, 0x02f7, 0x026f, 0x02f6, 0x025f, 0x02f5, 0x014f, 0x014f,
+    0x01f4, 0x01f3, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0,
+    0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0,
+    0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0,
+    0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0, 0x01f0,
+    0x01f0, 0x01f0, 0x023f, 0x023f, 0x023f, 0x023f, 0x023f, 0x023f,
+    0x023f, 0x023f, 0x023f, 0x023f, 0x023f, 0x023f, 0x023f, 0x023f,
+    0x023f, 0x023f, 0xb15a, 0xa162, 0x06ee, 0x9166, 0x06be, 0x06cd,
+    0x9168, 0x06ae, 0x06cc, 0x916a, 0x916c, 0x06ca, 0x916e, 0x065e,
+    0x05bd, 0x05bd, 0x02ce, 0x02ce, 0x03ec, 0x03dd, 0x01de, 0x01de,
+    0x01de, 0x01de, 0x01e9, 0x01e9, 0x02ea, 0x02d9, 0x01ed, 0x01eb,
+    0x01dc, 0x01db, 0x01ad, 0x01da, 0x017e, 0x01ac, 0x01c9, 0x017d,
+    0x012f, 0x010f, 0x059e, 0x059e, 0x06bc, 0x06cb, 0x068e, 0x06e8,
+    0x069d, 0x06e7, 0x06bb, 0x068d, 0x06d8, 0x066e, 0x05e6, 0x05e6,
+    0x059c, 0x059c, 0x06ab, 0x06ba, 0x06e5, 0x06d7, 0x054e, 0x054e,
+    0x06e4, 0x068c, 0x05c8, 0x05c8, 0x053e, 0x053e, 0x056d, 0x056d,
+    0x06d6, 0x069b, 0x06b9, 0x06aa, 0x05e1, 0x05e1, 0x05d4, 0x05d4,
+    0x06b8, 0x06a9, 0x057b, 0x057b, 0x06b7, 0x06d0, 0x04e3, 0x04e3,
+    0x04e3, 0x04e3, 0x050e, 0x050e, 0x05e0, 0x05e0, 0x055d, 0x055d,
+    0x05d5, 0x05d5, 0x057c, 0x057c, 0x05c7, 0x05c7, 0x054d, 0x054d,
+    0x058b, 0x058b, 0x059a, 0x056c, 0x05c6, 0x053d, 0x055c, 0x05c5,
+    0x040d, 0x040d, 0x058a, 0x05a8, 0x0599, 0x054c, 0x05b6, 0x057a,
+    0x043c, 0x043c, 0x055b, 0x0589, 0x041c, 0x041c, 0x04c0, 0x04c0,
+    0x0598, 0x0579, 0x03e2, 0x03e2, 0x03e2, 0x03e2, 0x042e, 0x042e,
+    0x041e, 0x041e, 0x04d3, 0x04d3, 0x042d, 0x042d, 0x04d2, 0x04d2,
+    0x04d1, 0x04d1, 0x043b, 0x043b, 0x0597, 0x0588, 0x031d, 0x031d,
+    0x031d, 0x031d, 0x04c4, 0x04c4, 0x046b, 0x046b, 0x04c3, 0x04c3,
+    0x04a7, 0x04a7, 0x032c, 0x032c, 0x032c, 0x032c, 0x04c2, 0x04c2,
+    0x04b5, 0x04b5, 0x04c1, 0x040c, 0x044b, 0x04b4, 0x046a, 0x04a6,
+    0x03b3, 0x03b3, 0x045a, 0x04a5, 0x032b, 0x032b, 0x03b2, 0x03b2,
+    0x031b, 0x031b, 0x03b1, 0x03b1, 0x040b, 0x04b0, 0x0469, 0x0496,
+    0x044a, 0x04a4, 0x0478, 0x0487, 0x03a3, 0x03a3, 0x043a, 0x0459,
+    0x032a, 0x032a, 0x0495, 0x0468, 0x03a1, 0x03a1, 0x0486, 0x0477,
+    0x0394, 0x0394, 0x0449, 0x0457, 0x0367, 0x0367, 0x02a2, 0x02a2,
+    0x02a2, 0x02a2, 0x021a, 0x021a, 0x030a, 0x03a0, 0x0339, 0x0393,
+    0x0358, 0x0385, 0x0229, 0x0229, 0x0292, 0x0292, 0x0376, 0x0309,
+    0x0219, 0x0219, 0x0291, 0x0291, 0x0390, 0x0348, 0x0384, 0x0375,
+    0x0338, 0x0383, 0x0366, 0x0328, 0x0282, 0x0282, 0x0347, 0x0374,
+    0x0218, 0x0218, 0x0281, 0x0281, 0x0280, 0x0280, 0x0308, 0x0356,
+    0x0237, 0x0237, 0x0273, 0x0273, 0x0365, 0x0346, 0x0227, 0x0227,
+    0x0272, 0x0272, 0x0364, 0x0355, 0x0207, 0x0207, 0x0117, 0x0117,
+    0x0117, 0x0117, 0x0171, 0x0171, 0x0270, 0x0236, 0x0263, 0x0245,
+    0x0254, 0x0226, 0x0162, 0x0116, 0x0161, 0x0161, 0x0206, 0x0260,
+    0x0153, 0x0153, 0x0235, 0x0244, 0x0125, 0x0152, 0x0115, 0x0105,
+    0x0134, 0x0143, 0x0150, 0x0124, 0x0142, 0x0133, 0x0104, 0x0140
 };
 
 /* Tables_17,18,19,20,21,22,23 are the same as 16 with different linbits */
 
-static short const Table_24[] =
+static FLO_UInt16 const Table_24[470] =
 {
-    -451,-117, -43, -25, -15,  -7,  -3,  -1, 239, 254,  -1, 223, 253,  -3,  -1,
-     207, 252,  -1, 191, 251,  -5,  -1, 250,  -1, 175, 159,  -1, 249, 248,  -9,
-      -5,  -3,  -1, 143, 127, 247,  -1, 111, 246,  -3,  -1,  95, 245,  -1,  79,
-     244, -71,  -7,  -3,  -1,  63, 243,  -1,  47, 242,  -5,  -1, 241,  -1,  31,
-     240, -25,  -9,  -1,  15,  -3,  -1, 238, 222,  -1, 237, 206,  -7,  -3,  -1,
-     236, 221,  -1, 190, 235,  -3,  -1, 205, 220,  -1, 174, 234, -15,  -7,  -3,
-      -1, 189, 219,  -1, 204, 158,  -3,  -1, 233, 173,  -1, 218, 188,  -7,  -3,
-      -1, 203, 142,  -1, 232, 157,  -3,  -1, 217, 126,  -1, 231, 172, 255,-235,
-    -143, -77, -45, -25, -15,  -7,  -3,  -1, 202, 187,  -1, 141, 216,  -5,  -3,
-      -1,  14, 224,  13, 230,  -5,  -3,  -1, 110, 156, 201,  -1,  94, 186,  -9,
-      -5,  -1, 229,  -1, 171, 125,  -1, 215, 228,  -3,  -1, 140, 200,  -3,  -1,
-      78,  46,  62, -15,  -7,  -3,  -1, 109, 214,  -1, 227, 155,  -3,  -1, 185,
-     170,  -1, 226,  30,  -7,  -3,  -1, 225,  93,  -1, 213, 124,  -3,  -1, 199,
-      77,  -1, 139, 184, -31, -15,  -7,  -3,  -1, 212, 154,  -1, 169, 108,  -3,
-      -1, 198,  61,  -1, 211,  45,  -7,  -3,  -1, 210,  29,  -1, 123, 183,  -3,
-      -1, 209,  92,  -1, 197, 138, -17,  -7,  -3,  -1, 168, 153,  -1,  76, 196,
-      -3,  -1, 107, 182,  -3,  -1, 208,  12,  60,  -7,  -3,  -1, 195, 122,  -1,
-     167,  44,  -3,  -1, 194,  91,  -1, 181,  28, -57, -35, -19,  -7,  -3,  -1,
-     137, 152,  -1, 193,  75,  -5,  -3,  -1, 192,  11,  59,  -3,  -1, 176,  10,
-      26,  -5,  -1, 180,  -1, 106, 166,  -3,  -1, 121, 151,  -3,  -1, 160,   9,
-     144,  -9,  -3,  -1, 179, 136,  -3,  -1,  43,  90, 178,  -7,  -3,  -1, 165,
-      27,  -1, 177, 105,  -1, 150, 164, -17,  -9,  -5,  -3,  -1,  74, 120, 135,
-      -1,  58, 163,  -3,  -1,  89, 149,  -1,  42, 162,  -7,  -3,  -1, 161, 104,
-      -1, 134, 119,  -3,  -1,  73, 148,  -1,  57, 147, -63, -31, -15,  -7,  -3,
-      -1,  88, 133,  -1,  41, 103,  -3,  -1, 118, 146,  -1,  25, 145,  -7,  -3,
-      -1,  72, 132,  -1,  87, 117,  -3,  -1,  56, 131,  -1, 102,  40, -17,  -7,
-      -3,  -1, 130,  24,  -1,  71, 116,  -5,  -1, 129,  -1,   8, 128,  -1,  86,
-     101,  -7,  -5,  -1,  23,  -1,   7, 112, 115,  -3,  -1,  55,  39, 114, -15,
-      -7,  -3,  -1,  70, 100,  -1,  85, 113,  -3,  -1,  54,  99,  -1,  69,  84,
-      -7,  -3,  -1,  38,  98,  -1,  22,  97,  -5,  -3,  -1,   6,  96,  53,  -1,
-      83,  68, -51, -37, -23, -15,  -9,  -3,  -1,  37,  82,  -1,  21,  -1,   5,
-      80,  -1,  81,  -1,  52,  67,  -3,  -1,  36,  66,  -1,  51,  20,  -9,  -5,
-      -1,  65,  -1,   4,  64,  -1,  35,  50,  -1,  19,  49,  -7,  -5,  -3,  -1,
-       3,  48,  34,  18,  -1,  33,  -1,   2,  32,  -3,  -1,  17,   1,  -1,  16,
-       0
+    0x08ef, 0x08fe, 0x08df, 0x08fd, 0x08cf, 0x08fc, 0x08bf, 0x08fb,
+    0x07fa, 0x07fa, 0x08af, 0x089f, 0x07f9, 0x07f9, 0x07f8, 0x07f8,
+    0x088f, 0x087f, 0x07f7, 0x07f7, 0x076f, 0x076f, 0x07f6, 0x07f6,
+    0x075f, 0x075f, 0x07f5, 0x07f5, 0x074f, 0x074f, 0x07f4, 0x07f4,
+    0x073f, 0x073f, 0x07f3, 0x07f3, 0x072f, 0x072f, 0x07f2, 0x07f2,
+    0x07f1, 0x07f1, 0x081f, 0x08f0, 0xb100, 0xb108, 0xb110, 0xb118,
+    0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff,
+    0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff, 0x04ff,
+    0xc120, 0xb130, 0xb138, 0xb140, 0xa148, 0xa14c, 0xa150, 0xa154,
+    0xa158, 0xa15c, 0xa160, 0xa164, 0xa168, 0xb16c, 0xa174, 0xa178,
+    0xa17c, 0xb180, 0xa188, 0xb18c, 0x9194, 0xa196, 0xa19a, 0x919e,
+    0xa1a0, 0x91a4, 0x91a6, 0x91a8, 0x91aa, 0x91ac, 0x91ae, 0x91b0,
+    0x91b2, 0x91b4, 0x91b6, 0x91b8, 0x91ba, 0x91bc, 0x91be, 0x91c0,
+    0x91c2, 0x91c4, 0xa1c6, 0x91ca, 0xa1cc, 0x0873, 0x91d0, 0x0872,
+    0x0846, 0x0864, 0x0855, 0x0871, 0x0836, 0x0863, 0x0845, 0x0854,
+    0x0826, 0x0862, 0x0816, 0x0861, 0x91d2, 0x0835, 0x0853, 0x0844,
+    0x0825, 0x0852, 0x0815, 0x91d4, 0x0751, 0x0751, 0x0834, 0x0843,
+    0x0724, 0x0724, 0x0742, 0x0742, 0x0733, 0x0733, 0x0714, 0x0714,
+    0x0741, 0x0741, 0x0804, 0x0840, 0x0723, 0x0723, 0x0732, 0x0732,
+    0x0613, 0x0613, 0x0613, 0x0613, 0x0631, 0x0631, 0x0631, 0x0631,
+    0x0703, 0x0703, 0x0730, 0x0730, 0x0622, 0x0622, 0x0622, 0x0622,
+    0x0512, 0x0512, 0x0512, 0x0512, 0x0512, 0x0512, 0x0512, 0x0512,
+    0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521, 0x0521,
+    0x0602, 0x0602, 0x0602, 0x0602, 0x0620, 0x0620, 0x0620, 0x0620,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411, 0x0411,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410,
+    0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410, 0x0410,
+    0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400,
+    0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400, 0x0400,
+    0x010f, 0x010f, 0x010f, 0x010f, 0x03ee, 0x03de, 0x03ed, 0x03ce,
+    0x03ec, 0x03dd, 0x03be, 0x03eb, 0x03cd, 0x03dc, 0x03ae, 0x03ea,
+    0x03bd, 0x03db, 0x03cc, 0x039e, 0x03e9, 0x03ad, 0x03da, 0x03bc,
+    0x03cb, 0x038e, 0x03e8, 0x039d, 0x03d9, 0x037e, 0x03e7, 0x03ac,
+    0x03ca, 0x03ca, 0x03bb, 0x03bb, 0x038d, 0x038d, 0x03d8, 0x03d8,
+    0x040e, 0x04e0, 0x030d, 0x030d, 0x02e6, 0x02e6, 0x02e6, 0x02e6,
+    0x036e, 0x039c, 0x02c9, 0x02c9, 0x025e, 0x025e, 0x02ba, 0x02ba,
+    0x02e5, 0x02e5, 0x03ab, 0x037d, 0x02d7, 0x02d7, 0x02e4, 0x02e4,
+    0x028c, 0x028c, 0x02c8, 0x02c8, 0x034e, 0x032e, 0x023e, 0x023e,
+    0x026d, 0x02d6, 0x02e3, 0x029b, 0x02b9, 0x02aa, 0x02e2, 0x021e,
+    0x02e1, 0x025d, 0x02d5, 0x027c, 0x02c7, 0x024d, 0x028b, 0x02b8,
+    0x02d4, 0x029a, 0x02a9, 0x026c, 0x02c6, 0x023d, 0x02d3, 0x022d,
+    0x02d2, 0x021d, 0x027b, 0x02b7, 0x02d1, 0x025c, 0x02c5, 0x028a,
+    0x02a8, 0x0299, 0x024c, 0x02c4, 0x026b, 0x026b, 0x02b6, 0x02b6,
+    0x03d0, 0x030c, 0x023c, 0x023c, 0x02c3, 0x027a, 0x02a7, 0x022c,
+    0x02c2, 0x025b, 0x02b5, 0x021c, 0x0289, 0x0298, 0x02c1, 0x024b,
+    0x03c0, 0x030b, 0x023b, 0x023b, 0x03b0, 0x030a, 0x021a, 0x021a,
+    0x01b4, 0x01b4, 0x026a, 0x02a6, 0x0279, 0x0279, 0x0297, 0x0297,
+    0x03a0, 0x0309, 0x0290, 0x0290, 0x01b3, 0x0188, 0x022b, 0x025a,
+    0x01b2, 0x01b2, 0x02a5, 0x021b, 0x02b1, 0x0269, 0x0196, 0x01a4,
+    0x024a, 0x0278, 0x0187, 0x0187, 0x013a, 0x01a3, 0x0159, 0x0195,
+    0x012a, 0x01a2, 0x01a1, 0x0168, 0x0186, 0x0177, 0x0149, 0x0194,
+    0x0139, 0x0193, 0x0158, 0x0185, 0x0129, 0x0167, 0x0176, 0x0192,
+    0x0119, 0x0191, 0x0148, 0x0184, 0x0157, 0x0175, 0x0138, 0x0183,
+    0x0166, 0x0128, 0x0182, 0x0118, 0x0147, 0x0174, 0x0181, 0x0181,
+    0x0208, 0x0280, 0x0156, 0x0165, 0x0117, 0x0117, 0x0207, 0x0270,
+    0x0137, 0x0127, 0x0106, 0x0160, 0x0105, 0x0150
 };
 
-/* Table_25,26,27,28,29,30,21 are the same as 24 with different linbits */
+/* Table_25,26,27,28,29,30,31 are the same as 24 with different linbits */
 
-static short const Table_A[] =
+static FLO_UInt16 const Table_A[64] =
 {
-    -29, -21, -13,  -7,  -3,  -1,  11,  15,  -1,  13,  14,  -3,  -1,   7,   5,
-      9,  -3,  -1,   6,   3,  -1,  10,  12,  -3,  -1,   2,   1,  -1,   4,   8,
-      0
+    0x060b, 0x060f, 0x060d, 0x060e, 0x0607, 0x0605, 0x0509, 0x0509,
+    0x0506, 0x0506, 0x0503, 0x0503, 0x050a, 0x050a, 0x050c, 0x050c,
+    0x0402, 0x0402, 0x0402, 0x0402, 0x0401, 0x0401, 0x0401, 0x0401,
+    0x0404, 0x0404, 0x0404, 0x0404, 0x0408, 0x0408, 0x0408, 0x0408,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+    0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100
 };
 
-static short const Table_B[] =
+static FLO_UInt16 const Table_B[16] =
 {
-    -15,  -7,  -3,  -1,  15,  14,  -1,  13,  12,  -3,  -1,  11,  10,  -1,   9,
-      8,  -7,  -3,  -1,   7,   6,  -1,   5,   4,  -3,  -1,   3,   2,  -1,   1,
-      0
+    0x040f, 0x040e, 0x040d, 0x040c, 0x040b, 0x040a, 0x0409, 0x0408,
+    0x0407, 0x0406, 0x0405, 0x0404, 0x0403, 0x0402, 0x0401, 0x0400
 };
 
 
 /* now the tables with linbits */
 FLO_HuffmanTable const FLO_HuffmanTables_Pair[32] = 
 {
-    {  0, Table_0  },
-    {  0, Table_1  },
-    {  0, Table_2  },
-    {  0, Table_3  },
-    {  0, Table_0  },
-    {  0, Table_5  },
-    {  0, Table_6  },
-    {  0, Table_7  },
-    {  0, Table_8  },
-    {  0, Table_9  },
-    {  0, Table_10 },
-    {  0, Table_11 },
-    {  0, Table_12 },
-    {  0, Table_13 },
-    {  0, Table_0  },
-    {  0, Table_15 },
-    {  1, Table_16 },
-    {  2, Table_16 },
-    {  3, Table_16 },
-    {  4, Table_16 },
-    {  6, Table_16 },
-    {  8, Table_16 },
-    { 10, Table_16 },
-    { 13, Table_16 },
-    {  4, Table_24 },
-    {  5, Table_24 },
-    {  6, Table_24 },
-    {  7, Table_24 },
-    {  8, Table_24 },
-    {  9, Table_24 },
-    { 11, Table_24 },
-    { 13, Table_24 }
+    {  0,  1, Table_0  },
+    {  0,  3, Table_1  },
+    {  0,  6, Table_2  },
+    {  0,  6, Table_3  },
+    {  0,  1, Table_0  },
+    {  0,  8, Table_5  },
+    {  0,  7, Table_6  },
+    {  0,  8, Table_7  },
+    {  0,  8, Table_8  },
+    {  0,  8, Table_9  },
+    {  0,  8, Table_10 },
+    {  0,  8, Table_11 },
+    {  0,  8, Table_12 },
+    {  0,  8, Table_13 },
+    {  0,  1, Table_0  },
+    {  0,  8, Table_15 },
+    {  1,  8, Table_16 },
+    {  2,  8, Table_16 },
+    {  3,  8, Table_16 },
+    {  4,  8, Table_16 },
+    {  6,  8, Table_16 },
+    {  8,  8, Table_16 },
+    { 10,  8, Table_16 },
+    { 13,  8, Table_16 },
+    {  4,  8, Table_24 },
+    {  5,  8, Table_24 },
+    {  6,  8, Table_24 },
+    {  7,  8, Table_24 },
+    {  8,  8, Table_24 },
+    {  9,  8, Table_24 },
+    { 11,  8, Table_24 },
+    { 13,  8, Table_24 }
 };
 
 FLO_HuffmanTable const FLO_HuffmanTables_Quad[2] = 
 {
-    { 0, Table_A },
-    { 0, Table_B }
+    {  0,  6, Table_A  },
+    {  0,  4, Table_B  }
 };
 
 #endif /* FLO_DECODER_ENGINE == FLO_DECODER_ENGINE_BUILTIN */
@@ -17,35 +17,67 @@
 #include "FloBitStream.h"
 #include "FloTables.h"
 
+/*-------------------------------------------------------------------------
+|       constants
++-------------------------------------------------------------------------*/
+#define FLO_HUFFMAN_ENTRY_SUBTABLE_FLAG     0x8000
+#define FLO_HUFFMAN_ENTRY_SUBTABLE_BITS(e)  (((e) >> 12) & 0x7)
+#define FLO_HUFFMAN_ENTRY_SUBTABLE_BASE(e)  ((e) & 0x0FFF)
+#define FLO_HUFFMAN_ENTRY_CODE_LENGTH(e)    (((e) >> 8) & 0xF)
+#define FLO_HUFFMAN_ENTRY_CODE_VALUE(e)     ((e) & 0xFF)
+
 /*-------------------------------------------------------------------------
 |       types
 +-------------------------------------------------------------------------*/
 typedef struct {
-    int          linbits;
-    const short *lookup;
+    int               linbits;
+    unsigned int      lookup_bits;
+    const FLO_UInt16* lookup;
 } FLO_HuffmanTable;
- 
+
+/*-------------------------------------------------------------------------
+|       FLO_Huffman_DecodeValue
++-------------------------------------------------------------------------*/
+#define FLO_Huffman_DecodeValue(bits, table, value, bits_left)         \
+{                                                                       \
+    const FLO_UInt16* lookup = table->lookup;                           \
+    unsigned int      index_bits = table->lookup_bits;                  \
+    unsigned int      entry;                                            \
+                                                                        \
+    entry = lookup[FLO_BitReservoir_PeekBits(bits, index_bits)];        \
+    while (entry & FLO_HUFFMAN_ENTRY_SUBTABLE_FLAG) {                   \
+        FLO_BitReservoir_SkipBits(bits, index_bits);                    \
+        bits_left -= index_bits;                                        \
+        index_bits = FLO_HUFFMAN_ENTRY_SUBTABLE_BITS(entry);            \
+        entry = lookup[FLO_HUFFMAN_ENTRY_SUBTABLE_BASE(entry) +         \
+                       FLO_BitReservoir_PeekBits(bits, index_bits)];    \
+    }                                                                   \
+    FLO_BitReservoir_SkipBits(bits, FLO_HUFFMAN_ENTRY_CODE_LENGTH(entry));\
+    bits_left -= FLO_HUFFMAN_ENTRY_CODE_LENGTH(entry);                  \
+    value = FLO_HUFFMAN_ENTRY_CODE_VALUE(entry);                        \
+}
+
 /*-------------------------------------------------------------------------
 |       FLO_Huffman_DecodePair
+|
+|   a pair, with its linbits and sign bits, is at most 47 bits long, so
+|   one refill is enough.
 +-------------------------------------------------------------------------*/
 #define FLO_Huffman_DecodePair(bits, table, factor, sample, bits_left, inc)\
 {                                                                       \
-    const short *lookup = table->lookup;                                \
-    short  value;                                                       \
-    int    x,y;                                                         \
+    int value;                                                          \
+    int x,y;                                                            \
                                                                         \
-    while ((value = *lookup++) < 0 ) {                                  \
-        if (FLO_BitStream_ReadBit(bits)) lookup -= value;               \
-        bits_left--;                                                    \
-    }                                                                   \
+    FLO_BitReservoir_Refill(bits);                                      \
+    FLO_Huffman_DecodeValue(bits, table, value, bits_left);             \
     x = value >> 4;                                                     \
     y = value & 0x0F;                                                   \
     if (x) {                                                            \
-        if (x == 15) {                                                  \
-            x += FLO_BitStream_ReadBits(bits, table->linbits);          \
+        if (x == 15 && table->linbits) {                                \
+            x += FLO_BitReservoir_ReadBits(bits, table->linbits);       \
             bits_left -= table->linbits;                                \
         }                                                               \
-        if (FLO_BitStream_ReadBit(bits)) {                              \
+        if (FLO_BitReservoir_ReadBit(bits)) {                           \
             *sample = -FLO_FC8_MUL(factor, FLO_Power_4_3[x]);           \
         } else {                                                        \
             *sample =  FLO_FC8_MUL(factor, FLO_Power_4_3[x]);           \
@@ -56,11 +88,11 @@ typedef struct {
     }                                                                   \
     sample += inc;                                                      \
     if (y) {                                                            \
-        if (y == 15) {                                                  \
-            y += FLO_BitStream_ReadBits(bits, table->linbits);          \
+        if (y == 15 && table->linbits) {                                \
+            y += FLO_BitReservoir_ReadBits(bits, table->linbits);       \
             bits_left -= table->linbits;                                \
         }                                                               \
-        if (FLO_BitStream_ReadBit(bits)) {                              \
+        if (FLO_BitReservoir_ReadBit(bits)) {                           \
             *sample = -FLO_FC8_MUL(factor, FLO_Power_4_3[y]);           \
         } else {                                                        \
             *sample =  FLO_FC8_MUL(factor, FLO_Power_4_3[y]);           \
@@ -74,15 +106,13 @@ typedef struct {
 
 /*-------------------------------------------------------------------------
 |       FLO_Huffman_DecodeQuad
+|
+|   also refills for the (up to 4) sign bits that follow the code.
 +-------------------------------------------------------------------------*/
 #define FLO_Huffman_DecodeQuad(bits, table, quad, bits_left)            \
 {                                                                       \
-    const short *lookup = table->lookup;                                \
-                                                                        \
-    while ((quad = *lookup++) < 0 ) {                                   \
-        if (FLO_BitStream_ReadBit(bits)) lookup -= quad;                \
-        bits_left--;                                                    \
-    }                                                                   \
+    FLO_BitReservoir_Refill(bits);                                      \
+    FLO_Huffman_DecodeValue(bits, table, quad, bits_left);              \
 }
 
 /*-------------------------------------------------------------------------
@@ -636,7 +636,7 @@ FLO_LayerIII_ReadScalefactors(FLO_BitStream* bits,
 +-------------------------------------------------------------------------*/
 #define STORE_QUAD_1(samples, value, quad, n, bits, bits_left) \
     if ((quad) & (8 >> (n))) {                                 \
-        if (FLO_BitStream_ReadBit(bits)) {                     \
+        if (FLO_BitReservoir_ReadBit(bits)) {                  \
             *samples++ = -FLO_FC8_SCL(value);                  \
         } else {                                               \
             *samples++ =  FLO_FC8_SCL(value);                  \
@@ -651,7 +651,7 @@ FLO_LayerIII_ReadScalefactors(FLO_BitStream* bits,
 +-------------------------------------------------------------------------*/
 #define STORE_QUAD_N(samples, value, quad, n, bits, bits_left, inc) \
     if ((quad) & (8 >> (n))) {                                      \
-        if (FLO_BitStream_ReadBit(bits)) {                          \
+        if (FLO_BitReservoir_ReadBit(bits)) {                       \
             *samples = -FLO_FC8_SCL(value);                         \
         } else {                                                    \
             *samples =  FLO_FC8_SCL(value);                         \
@@ -722,7 +722,9 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
     FLO_Granule*                 gp = &frame->side_info.granules[granule][channel];
     FLO_Float*                   samples = (FLO_Float*)frame->hybrid[channel].in;
     int                          region_size[4];
-    int                          bits_left = gp->part_2_3_length-gp->part_2_length;
+    int                          huffman_bits = gp->part_2_3_length-gp->part_2_length;
+    int                          bits_left = huffman_bits;
+    FLO_BitReservoir             reservoir;
     int                          subband_count = 0;
     const FLO_LayerIII_BandInfo* subband_info;
     int                          gain_shift = 1 + gp->scalefactor_scale;
@@ -751,6 +753,10 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
     /* reset the null band counter */
     frame->hybrid[channel].nb_zero_bands = 0;
 
+    /* the huffman data is read through a reservoir, the bitstream */
+    /* is moved to the end of the granule when we're done          */
+    FLO_BitReservoir_Init(&reservoir, bits);
+
     /* now read the data */
     if (gp->block_type == FLO_SYNTAX_MPEG_LAYER_III_BLOCK_TYPE_SHORT_WINDOWS) {
         /* short blocks, or mixed long/short */
@@ -799,7 +805,7 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
 
             for (i = region_size[region]/2; i; i--) {
                 BOUNDARY_CHECKPOINT_SHORT;
-                FLO_Huffman_DecodePair(bits, table, factor, 
+                FLO_Huffman_DecodePair(&reservoir, table, factor, 
                                        samples, bits_left, sample_spacing);
             }
         }
@@ -810,20 +816,20 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
                 &FLO_HuffmanTables_Quad[gp->count1_table_selection];
             int quad;
             for (i = region_size[3]/4; i && bits_left > 0; i--) {
-                FLO_Huffman_DecodeQuad(bits, table, quad, bits_left);
+                FLO_Huffman_DecodeQuad(&reservoir, table, quad, bits_left);
 
                 /* store first 2 samples of the quad */
                 BOUNDARY_CHECKPOINT_SHORT;
-                STORE_QUAD_N(samples, factor, quad, 0, bits, 
+                STORE_QUAD_N(samples, factor, quad, 0, &reservoir, 
                              bits_left, sample_spacing);
-                STORE_QUAD_N(samples, factor, quad, 1, bits, 
+                STORE_QUAD_N(samples, factor, quad, 1, &reservoir, 
                              bits_left, sample_spacing);
 
                 /* store last 2 samples of the quad */
                 BOUNDARY_CHECKPOINT_SHORT;
-                STORE_QUAD_N(samples, factor, quad, 2, bits, 
+                STORE_QUAD_N(samples, factor, quad, 2, &reservoir, 
                              bits_left, sample_spacing);
-                STORE_QUAD_N(samples, factor, quad, 3, bits, 
+                STORE_QUAD_N(samples, factor, quad, 3, &reservoir, 
                              bits_left, sample_spacing);
             }
         }
@@ -865,7 +871,7 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
 
             for (i = region_size[region]/2; i; i--) {
                 BOUNDARY_CHECKPOINT_LONG;
-                FLO_Huffman_DecodePair(bits, table, factor, samples, bits_left,1);
+                FLO_Huffman_DecodePair(&reservoir, table, factor, samples, bits_left,1);
             }
         }       
 
@@ -876,17 +882,17 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
             int quad;
 
             for (i = region_size[3]/4; i && bits_left > 0; i--) {
-                FLO_Huffman_DecodeQuad(bits, table, quad, bits_left);
+                FLO_Huffman_DecodeQuad(&reservoir, table, quad, bits_left);
 
                 /* store first 2 samples of the quad */
                 BOUNDARY_CHECKPOINT_LONG;
-                STORE_QUAD_1(samples, factor, quad, 0, bits, bits_left);
-                STORE_QUAD_1(samples, factor, quad, 1, bits, bits_left);
+                STORE_QUAD_1(samples, factor, quad, 0, &reservoir, bits_left);
+                STORE_QUAD_1(samples, factor, quad, 1, &reservoir, bits_left);
 
                 /* store last 2 samples of the quad */
                 BOUNDARY_CHECKPOINT_LONG;
-                STORE_QUAD_1(samples, factor, quad, 2, bits, bits_left);
-                STORE_QUAD_1(samples, factor, quad, 3, bits, bits_left);
+                STORE_QUAD_1(samples, factor, quad, 2, &reservoir, bits_left);
+                STORE_QUAD_1(samples, factor, quad, 3, &reservoir, bits_left);
             }
         }
 
@@ -907,21 +913,11 @@ FLO_LayerIII_ReadHuffmanSamples(FLO_BitStream* bits,
         }
     }
 
-    /* flush the end of the granule */
-    if (bits_left) {
-        if (bits_left > 0) {
-            while (bits_left >= 32) {
-                FLO_BitStream_ReadBits(bits, 32);
-                bits_left -= 32;
-            }
-            if (bits_left) FLO_BitStream_ReadBits(bits, bits_left);
-        } else {
-            while (bits_left <= -32) {
-                FLO_BitStream_Rewind(bits, 32);
-                bits_left += 32;
-            }
-            if (bits_left) FLO_BitStream_Rewind(bits, -bits_left);
-        }
+    /* move to the end of the granule */
+    if (huffman_bits > 0) {
+        FLO_BitStream_SkipBits(bits, huffman_bits);
+    } else if (huffman_bits < 0) {
+        FLO_BitStream_Rewind(bits, -huffman_bits);
     }
 }
 
@@ -1026,9 +1022,7 @@ FLO_LayerIII_Hybrid(FLO_Frame_III* frame, int granule, int channel)
         }
     } else {
         /* do the non null bands */
-        for (subband = 0; subband < non_zero; subband++) {
-            FLO_HybridFilter_Imdct_36(filter, subband, gp->block_type);
-        }
+        FLO_HybridFilter_Imdct_36_Bands(filter, non_zero, gp->block_type);
     }
 
     /* do the null (full of zeros) bands */
@@ -90,6 +90,7 @@ static inline long FLO_FIX_MUL(FLO_Float x, FLO_Float y, int bits)
 
 #define FLO_FIX_CONV(x) ((FLO_Float)((x)<0.0?((x)-0.5):((x)+0.5)))
 #define FLO_FIX_TO_SHORT(sample) ((int)(sample)>>(FLO_FIX_BITS-16+FLO_FC0_BITS-FLO_FC0_DSCL))
+#define FLO_FIX_TO_FLOAT(sample) ((float)(sample)*(1.0f/(float)(1L<<(FLO_FIX_BITS-1+FLO_FC0_BITS-FLO_FC0_DSCL))))
 #if FLO_FC0_BITS > 15
 #define FLO_FC0(x) ((FLO_Float)((x)*(1<<(FLO_FC0_BITS-15))))
 #else
@@ -140,6 +141,7 @@ FLO_DECLARE_FIX_MUL(FC8, (FLO_FC9_BITS+FLO_FC8_BITS-(FLO_FIX_BITS-1)))
 typedef float FLO_Float;
 #define FLO_FDIV2(x) (0.5f*(x))
 #define FLO_FIX_TO_SHORT(sample) ((int)(sample))
+#define FLO_FIX_TO_FLOAT(sample) ((sample)*(1.0f/32768.0f))
 #define FLO_FC0(x) x##f
 #define FLO_FC1(x) ((FLO_Float)(x))
 #define FLO_FC2(x) ((FLO_Float)(x))
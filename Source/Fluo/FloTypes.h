@@ -41,6 +41,7 @@ typedef ATX_AnyConst     FLO_AnyConst;
 typedef ATX_ByteBuffer   FLO_ByteBuffer;
 typedef ATX_Size         FLO_Size;
 typedef ATX_Int64        FLO_Int64;
+typedef ATX_UInt64       FLO_UInt64;
 
 #define FLO_TRUE         ATX_TRUE
 #define FLO_FALSE        ATX_FALSE
@@ -20,5 +20,6 @@
 #include "FloErrors.h"
 #include "FloDecoder.h"
 #include "FloByteStream.h"
+#include "FloFrameIndex.h"
 
 #endif /* _FLUO_H_ */
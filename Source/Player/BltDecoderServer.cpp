@@ -29,7 +29,8 @@ ATX_SET_LOCAL_LOGGER("bluetune.player.decoder-server")
 /*----------------------------------------------------------------------
 |   constants
 +---------------------------------------------------------------------*/
-const unsigned int BLT_PLAYER_LOOP_WAIT_DURATION = 50; // milliseconds
+const unsigned int BLT_PLAYER_LOOP_WAIT_DURATION  = 50;   // milliseconds
+const unsigned int BLT_PLAYER_READY_WAIT_DURATION = 1000; // milliseconds, safety net for missed signals
 
 /*----------------------------------------------------------------------
 |   BLT_DecoderServer_Message::MessageType
@@ -37,6 +38,38 @@ const unsigned int BLT_PLAYER_LOOP_WAIT_DURATION = 50; // milliseconds
 NPT_Message::Type 
 BLT_DecoderServer_Message::MessageType = "BLT_DecoderServer Message";
 
+/*----------------------------------------------------------------------
+|   BLT_DecoderServer_ReadyMessage
+|
+|   posted to the server's own queue to wake up the decoding loop when
+|   a node becomes ready. At most one such message is pending at a time.
++---------------------------------------------------------------------*/
+class BLT_DecoderServer_ReadyMessage : public NPT_Message
+{
+public:
+    // functions
+    static NPT_Message::Type MessageType;
+    NPT_Message::Type GetType() {
+        return MessageType;
+    }
+
+    // methods
+    BLT_DecoderServer_ReadyMessage(NPT_AtomicVariable& pending) : 
+        m_Pending(pending) {}
+    virtual NPT_Result Dispatch(NPT_MessageHandler* /*handler*/) {
+        // the next signal will post a new message
+        m_Pending.SetValue(0);
+        return NPT_SUCCESS;
+    }
+
+private:
+    // members
+    NPT_AtomicVariable& m_Pending;
+};
+
+NPT_Message::Type 
+BLT_DecoderServer_ReadyMessage::MessageType = "BLT_DecoderServer Ready Message";
+
 /*----------------------------------------------------------------------
 |   dynamic cast support
 +---------------------------------------------------------------------*/
@@ -104,7 +137,11 @@ BLT_DecoderServer::BLT_DecoderServer(NPT_MessageReceiver* client) :
     m_Client(client),
     m_TimeStampUpdateQuantum(1000),
     m_PositionUpdateRange(BLT_DECODER_SERVER_DEFAULT_POSITION_UPDATE_RANGE),
-    m_State(STATE_STOPPED)
+    m_State(STATE_STOPPED),
+    m_EventDriven(false),
+    m_ReadyPending(0),
+    m_InputSignaled(0),
+    m_OutputSignaled(0)
 {
     // create a queue to receive messages
     m_MessageQueue = new NPT_SimpleMessageQueue();
@@ -270,9 +307,21 @@ BLT_DecoderServer::Run()
             result = BLT_Decoder_PumpPacketWithOptions(m_Decoder, BLT_DECODER_PUMP_OPTION_NON_BLOCKING);
             if (BLT_FAILED(result)) {
                 if (result == BLT_ERROR_WOULD_BLOCK || result == BLT_ERROR_PORT_HAS_NO_DATA) {
-                    /* not fatal, just wait and try again later */
-                    ATX_LOG_FINER("pump would block, waiting a short time");
-                    result = m_MessageQueue->PumpMessage(BLT_PLAYER_LOOP_WAIT_DURATION);
+                    /* not fatal, just wait and try again later. A full */
+                    /* output queue is the output's to signal, no data  */
+                    /* is the upstream nodes'                           */
+                    bool signaled = (result == BLT_ERROR_WOULD_BLOCK) ?
+                                    m_OutputSignaled.GetValue() != 0 :
+                                    m_InputSignaled.GetValue()  != 0;
+                    if (m_EventDriven && signaled) {
+                        /* a node signaling that it is ready posts a message, */
+                        /* nodes that have never signaled are still polled    */
+                        ATX_LOG_FINER("pump would block, waiting for a node to be ready");
+                        result = m_MessageQueue->PumpMessage(BLT_PLAYER_READY_WAIT_DURATION);
+                    } else {
+                        ATX_LOG_FINER("pump would block, waiting a short time");
+                        result = m_MessageQueue->PumpMessage(BLT_PLAYER_LOOP_WAIT_DURATION);
+                    }
                 } else {
                     ATX_LOG_FINE_1("stopped on %d", result);
                     if (result != BLT_ERROR_EOS) {
@@ -452,6 +501,9 @@ BLT_DecoderServer::OnSetInputCommand(BLT_CString name, BLT_CString type)
                    BLT_SAFE_STRING(name), BLT_SAFE_STRING(type));
     result = BLT_Decoder_SetInput(m_Decoder, name, type);
 
+    // wait until the new chain signals readiness before relying on it
+    m_InputSignaled.SetValue(0);
+
     // update the state if we were in the STATE_EOS state
     if (m_State == STATE_EOS) SetState(STATE_STOPPED);
     
@@ -480,6 +532,10 @@ BLT_DecoderServer::OnSetOutputCommand(BLT_CString name, BLT_CString type)
     ATX_LOG_FINE_2("set output (%s / %s",
                    BLT_SAFE_STRING(name), BLT_SAFE_STRING(type));
     result = BLT_Decoder_SetOutput(m_Decoder, name, type);
+
+    // wait until the new output signals readiness before relying on it
+    m_OutputSignaled.SetValue(0);
+
     if (BLT_SUCCEEDED(result)) {
         // notify of the new volume
         float volume=0.0f;
@@ -814,6 +870,22 @@ BLT_DecoderServer::OnEvent(const ATX_Object* /*source*/,
           break;
       }
 
+      case BLT_EVENT_TYPE_NODE_READY: {
+          // this may be called from any thread: remember which side of
+          // the output is ready, and wake up the decoding loop, unless a
+          // wake up message is already pending
+          BLT_NodeReadyEvent* e = (BLT_NodeReadyEvent*)event;
+          if (e->node && ATX_CAST(e->node, BLT_OutputNode)) {
+              m_OutputSignaled.SetValue(1);
+          } else {
+              m_InputSignaled.SetValue(1);
+          }
+          if (m_ReadyPending.Increment() == 1) {
+              PostMessage(new BLT_DecoderServer_ReadyMessage(m_ReadyPending));
+          }
+          break;
+      }
+
       default:
           break;
     }
@@ -842,6 +914,13 @@ BLT_DecoderServer::OnPropertyChanged(BLT_PropertyScope        scope,
                                      const char*              name, 
                                      const ATX_PropertyValue* value)
 {
+    if (scope == BLT_PROPERTY_SCOPE_CORE && name &&
+        NPT_StringsEqual(name, BLT_DECODER_SERVER_EVENT_DRIVEN_PROPERTY)) {
+        m_EventDriven = value != NULL &&
+                        value->type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN &&
+                        value->data.boolean;
+    }
+
     m_Client->PostMessage(new BLT_DecoderClient_PropertyNotificationMessage(scope,
                                                                             source,
                                                                             name,
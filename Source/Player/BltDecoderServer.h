@@ -21,6 +21,17 @@
 +---------------------------------------------------------------------*/
 const BLT_Size BLT_DECODER_SERVER_DEFAULT_POSITION_UPDATE_RANGE = 400;
 
+/**
+ * Core property (boolean) that selects the event-driven decoding loop.
+ * When the decoder can't make progress, the server thread sleeps until it
+ * receives a message or a node signals that it is ready
+ * (BLT_EVENT_TYPE_NODE_READY) instead of polling the decoder: the output
+ * for a full output queue, the nodes upstream of it when the output has
+ * no data. Until the node concerned has signaled once, for nodes that
+ * never do, the decoder is still polled every 50ms.
+ */
+#define BLT_DECODER_SERVER_EVENT_DRIVEN_PROPERTY "DecoderServer.EventDriven"
+
 /*----------------------------------------------------------------------
 |   BLT_DecoderServer_PropertyValueWrapper
 +---------------------------------------------------------------------*/
@@ -538,6 +549,10 @@ class BLT_DecoderServer : public NPT_Thread,
     BLT_Size             m_PositionUpdateRange;
     BLT_DecoderStatus    m_DecoderStatus;
     State                m_State;
+    bool                 m_EventDriven;
+    NPT_AtomicVariable   m_ReadyPending;
+    NPT_AtomicVariable   m_InputSignaled;  // a node upstream of the output signals readiness
+    NPT_AtomicVariable   m_OutputSignaled; // the output signals when it has space
 
     BLT_DecoderServer_EventListenerWrapper    m_EventListener;
     BLT_DecoderServer_PropertyListenerWrapper m_CorePropertyListener;
@@ -14,6 +14,9 @@
 #include "BltConfig.h"
 #include "BltCore.h"
 #include "BltPcmAdapter.h"
+#include "BltPcmDither.h"
+#include "BltPcmMixer.h"
+#include "BltPcmResampler.h"
 #include "BltMediaNode.h"
 #include "BltMedia.h"
 #include "BltPcm.h"
@@ -26,6 +29,17 @@
 +---------------------------------------------------------------------*/
 ATX_SET_LOCAL_LOGGER("bluetune.plugins.adapters.pcm")
 
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_ADAPTER_DEFAULT_RESAMPLER_QUALITY)
+#define BLT_CONFIG_PCM_ADAPTER_DEFAULT_RESAMPLER_QUALITY BLT_PCM_ADAPTER_RESAMPLER_QUALITY_HIGH
+#endif
+
+#if !defined(BLT_CONFIG_PCM_ADAPTER_DEFAULT_DITHER)
+#define BLT_CONFIG_PCM_ADAPTER_DEFAULT_DITHER BLT_PCM_ADAPTER_DITHER_NONE
+#endif
+
 /*----------------------------------------------------------------------
 |    types
 +---------------------------------------------------------------------*/
@@ -47,13 +61,29 @@ typedef struct {
     BLT_MediaPacket* packet;
 } PcmAdapterOutput;
 
+typedef struct {
+    float*   samples;
+    BLT_Size size;
+} PcmAdapterBuffer;
+
+typedef struct {
+    PcmResampler* resampler;
+    BLT_Boolean   time_base_valid;
+    BLT_TimeStamp time_base;
+    ATX_Int64     frame_count;
+} PcmAdapterResampling;
+
 typedef struct {
     /* base class */
     ATX_EXTENDS(BLT_BaseMediaNode);
 
     /* members */
-    PcmAdapterInput  input;
-    PcmAdapterOutput output;
+    PcmAdapterInput      input;
+    PcmAdapterOutput     output;
+    PcmMixer*            mixer;
+    PcmAdapterResampling resampling;
+    PcmDither*           dither;
+    PcmAdapterBuffer     buffers[2];
 } PcmAdapter;
 
 /*----------------------------------------------------------------------
@@ -63,6 +93,448 @@ ATX_DECLARE_INTERFACE_MAP(PcmAdapterModule, BLT_Module)
 ATX_DECLARE_INTERFACE_MAP(PcmAdapter, BLT_MediaNode)
 ATX_DECLARE_INTERFACE_MAP(PcmAdapter, ATX_Referenceable)
 
+/*----------------------------------------------------------------------
+|    PcmAdapter_CanConvert
++---------------------------------------------------------------------*/
+static BLT_Boolean
+PcmAdapter_CanConvert(const BLT_MediaType* from, const BLT_MediaType* to)
+{
+    /* BLT_Pcm_CanConvert doesn't know about sample rate and channel */
+    /* conversions, so check everything else with those left open    */
+    if (from->id == BLT_MEDIA_TYPE_ID_AUDIO_PCM &&
+        to->id   == BLT_MEDIA_TYPE_ID_AUDIO_PCM &&
+        to->extension_size >= sizeof(BLT_PcmMediaType)-sizeof(BLT_MediaType)) {
+        const BLT_PcmMediaType* from_pcm = (const BLT_PcmMediaType*)from;
+        BLT_PcmMediaType        to_pcm   = *(const BLT_PcmMediaType*)to;
+        if (to_pcm.channel_count != 0 && 
+            to_pcm.channel_count != from_pcm->channel_count) {
+            if (from_pcm->channel_count > BLT_PCM_MIXER_MAX_CHANNEL_COUNT ||
+                to_pcm.channel_count    > BLT_PCM_MIXER_MAX_CHANNEL_COUNT) {
+                return BLT_FALSE;
+            }
+            to_pcm.channel_count = 0;
+        }
+        to_pcm.sample_rate = 0;
+        return BLT_Pcm_CanConvert(from, &to_pcm.base);
+    }
+
+    return BLT_Pcm_CanConvert(from, to);
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_GetProperty
++---------------------------------------------------------------------*/
+static BLT_Boolean
+PcmAdapter_GetProperty(PcmAdapter*           self, 
+                       BLT_CString           name, 
+                       ATX_PropertyValueType type,
+                       ATX_PropertyValue*    value)
+{
+    ATX_Properties* properties;
+
+    if (ATX_BASE(self, BLT_BaseMediaNode).context == NULL) return BLT_FALSE;
+    if (BLT_FAILED(BLT_Stream_GetProperties(ATX_BASE(self, BLT_BaseMediaNode).context,
+                                            &properties))) {
+        return BLT_FALSE;
+    }
+    if (ATX_FAILED(ATX_Properties_GetProperty(properties, name, value))) {
+        return BLT_FALSE;
+    }
+
+    return value->type == type;
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_GetResamplerQuality
++---------------------------------------------------------------------*/
+static unsigned int
+PcmAdapter_GetResamplerQuality(PcmAdapter* self)
+{
+    ATX_PropertyValue property;
+
+    if (PcmAdapter_GetProperty(self,
+                               BLT_PCM_ADAPTER_RESAMPLER_QUALITY_PROPERTY,
+                               ATX_PROPERTY_VALUE_TYPE_INTEGER,
+                               &property) &&
+        property.data.integer >= BLT_PCM_ADAPTER_RESAMPLER_QUALITY_LOW &&
+        property.data.integer <= BLT_PCM_ADAPTER_RESAMPLER_QUALITY_BEST) {
+        return (unsigned int)property.data.integer;
+    }
+
+    return BLT_CONFIG_PCM_ADAPTER_DEFAULT_RESAMPLER_QUALITY;
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_GetChannelMatrix
++---------------------------------------------------------------------*/
+static BLT_CString
+PcmAdapter_GetChannelMatrix(PcmAdapter* self)
+{
+    ATX_PropertyValue property;
+
+    if (PcmAdapter_GetProperty(self,
+                               BLT_PCM_ADAPTER_CHANNEL_MATRIX_PROPERTY,
+                               ATX_PROPERTY_VALUE_TYPE_STRING,
+                               &property) &&
+        property.data.string && property.data.string[0]) {
+        return property.data.string;
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_GetDitherMode
++---------------------------------------------------------------------*/
+static unsigned int
+PcmAdapter_GetDitherMode(PcmAdapter*             self,
+                         const BLT_PcmMediaType* in_type,
+                         const BLT_PcmMediaType* out_type)
+{
+    ATX_PropertyValue property;
+    unsigned int      out_bits = out_type->bits_per_sample ? 
+                                 out_type->bits_per_sample : 
+                                 in_type->bits_per_sample;
+
+    /* only integer outputs of 24 bits or less lose resolution */
+    if (out_type->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_BE ||
+        out_type->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_LE ||
+        out_bits < 8 || out_bits > 24) {
+        return BLT_PCM_ADAPTER_DITHER_NONE;
+    }
+    if (in_type->sample_format != BLT_PCM_SAMPLE_FORMAT_FLOAT_BE &&
+        in_type->sample_format != BLT_PCM_SAMPLE_FORMAT_FLOAT_LE &&
+        in_type->bits_per_sample <= out_bits) {
+        return BLT_PCM_ADAPTER_DITHER_NONE;
+    }
+
+    if (PcmAdapter_GetProperty(self,
+                               BLT_PCM_ADAPTER_DITHER_PROPERTY,
+                               ATX_PROPERTY_VALUE_TYPE_INTEGER,
+                               &property) &&
+        property.data.integer >= BLT_PCM_ADAPTER_DITHER_NONE &&
+        property.data.integer <= BLT_PCM_ADAPTER_DITHER_SHAPED) {
+        return (unsigned int)property.data.integer;
+    }
+
+    return BLT_CONFIG_PCM_ADAPTER_DEFAULT_DITHER;
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_GetBuffer
++---------------------------------------------------------------------*/
+static float*
+PcmAdapter_GetBuffer(PcmAdapter* self, unsigned int index, BLT_Cardinal sample_count)
+{
+    PcmAdapterBuffer* buffer = &self->buffers[index];
+    BLT_Size          size   = sample_count*sizeof(float);
+
+    if (size > buffer->size) {
+        if (buffer->samples) ATX_FreeMemory(buffer->samples);
+        buffer->samples = (float*)ATX_AllocateMemory(size);
+        buffer->size    = buffer->samples ? size : 0;
+    }
+
+    return buffer->samples;
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_ResetResampling
++---------------------------------------------------------------------*/
+static void
+PcmAdapter_ResetResampling(PcmAdapter* self)
+{
+    if (self->resampling.resampler) {
+        PcmResampler_Reset(self->resampling.resampler);
+    }
+    self->resampling.time_base_valid = BLT_FALSE;
+    self->resampling.frame_count     = 0;
+}
+
+/*----------------------------------------------------------------------
+|    PcmAdapter_ProcessPacket
+|
+|   sample rate, channel and dithered resolution conversions, done on
+|   native-endian floats
++---------------------------------------------------------------------*/
+static BLT_Result
+PcmAdapter_ProcessPacket(PcmAdapter*             self,
+                         BLT_MediaPacket*        in,
+                         const BLT_PcmMediaType* in_type,
+                         BLT_CString             matrix,
+                         unsigned int            dither,
+                         BLT_MediaPacket**       out)
+{
+    PcmAdapterResampling* resampling = &self->resampling;
+    BLT_PcmMediaType      out_type;
+    BLT_PcmMediaType      float_type;
+    BLT_Flags             flags = BLT_MediaPacket_GetFlags(in);
+    unsigned int          in_channels;
+    unsigned int          out_channels;
+    unsigned int          channels;
+    BLT_Boolean           mix;
+    BLT_Boolean           resample;
+    BLT_Boolean           direct;
+    BLT_Cardinal          frames;
+    BLT_Cardinal          max_out_frames;
+    const float*          samples;
+    float*                out_samples;
+    float*                target;
+    unsigned int          next = 0;
+    BLT_Result            result;
+
+    /* default */
+    *out = NULL;
+
+    /* do automatic setting of output parameters */
+    out_type = self->output.pcm_type;
+    if (out_type.bits_per_sample == 0) {
+        out_type.bits_per_sample = in_type->bits_per_sample;
+    }
+    if (out_type.channel_count == 0) {
+        out_type.channel_count = in_type->channel_count;
+        if (out_type.channel_mask == 0) out_type.channel_mask = in_type->channel_mask;
+    }
+    if (out_type.sample_rate == 0) {
+        out_type.sample_rate = in_type->sample_rate;
+    }
+    in_channels  = in_type->channel_count;
+    out_channels = out_type.channel_count;
+    if (in_channels == 0 || in_type->sample_rate == 0 || in_type->bits_per_sample < 8) {
+        return BLT_ERROR_INVALID_MEDIA_TYPE;
+    }
+    mix      = (in_channels != out_channels || matrix != NULL);
+    resample = (in_type->sample_rate != out_type.sample_rate);
+
+    /* (re)create the mixer if the layouts have changed */
+    if (mix) {
+        if (self->mixer == NULL ||
+            !PcmMixer_Matches(self->mixer,
+                              in_channels,  in_type->channel_mask,
+                              out_channels, out_type.channel_mask,
+                              matrix)) {
+            PcmMixer_Destroy(self->mixer);
+            self->mixer = NULL;
+            result = PcmMixer_Create(in_channels,  in_type->channel_mask,
+                                     out_channels, out_type.channel_mask,
+                                     matrix,
+                                     BLT_PCM_KERNEL_ANY,
+                                     &self->mixer);
+            if (BLT_FAILED(result)) return result;
+            if (matrix && !PcmMixer_HasCustomMatrix(self->mixer)) {
+                ATX_LOG_WARNING_2("PcmAdapter::ProcessPacket - ignoring channel matrix, expected %d rows of %d",
+                                  out_channels, in_channels);
+            }
+        }
+        if (out_type.channel_mask == 0) {
+            out_type.channel_mask = PcmMixer_GetOutputChannelMask(self->mixer);
+        }
+    }
+
+    /* mix before resampling when that reduces the channel count */
+    channels = (mix && out_channels < in_channels) ? out_channels : in_channels;
+
+    /* (re)create the converter if the parameters have changed */
+    if (resample) {
+        unsigned int quality = PcmAdapter_GetResamplerQuality(self);
+        if (resampling->resampler == NULL ||
+            !PcmResampler_Matches(resampling->resampler,
+                                  in_type->sample_rate,
+                                  out_type.sample_rate,
+                                  channels,
+                                  quality)) {
+            ATX_LOG_FINE_3("PcmAdapter::ProcessPacket - converting from %d to %d Hz (quality %d)",
+                           (int)in_type->sample_rate, (int)out_type.sample_rate, quality);
+            PcmResampler_Destroy(resampling->resampler);
+            resampling->resampler = NULL;
+            result = PcmResampler_Create(in_type->sample_rate,
+                                         out_type.sample_rate,
+                                         channels,
+                                         quality,
+                                         BLT_PCM_KERNEL_ANY,
+                                         &resampling->resampler);
+            if (BLT_FAILED(result)) return result;
+            PcmAdapter_ResetResampling(self);
+        }
+
+        /* a new stream doesn't continue from the previous samples */
+        if (flags & (BLT_MEDIA_PACKET_FLAG_START_OF_STREAM |
+                     BLT_MEDIA_PACKET_FLAG_STREAM_DISCONTINUITY)) {
+            PcmAdapter_ResetResampling(self);
+        }
+        if (!resampling->time_base_valid) {
+            resampling->time_base       = BLT_MediaPacket_GetTimeStamp(in);
+            resampling->time_base_valid = BLT_TRUE;
+        }
+    }
+
+    /* get the input as floats */
+    BLT_PcmMediaType_Init(&float_type);
+    float_type.sample_rate     = in_type->sample_rate;
+    float_type.channel_count   = in_channels;
+    float_type.bits_per_sample = 32;
+    float_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+    frames = BLT_MediaPacket_GetPayloadSize(in)/(in_channels*(in_type->bits_per_sample/8));
+    if (in_type->sample_format   == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE &&
+        in_type->bits_per_sample == 32) {
+        samples = (const float*)BLT_MediaPacket_GetPayloadBuffer(in);
+    } else {
+        target = PcmAdapter_GetBuffer(self, next, frames*in_channels);
+        if (target == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+        result = BLT_Pcm_ConvertSamples(in_type,
+                                        BLT_MediaPacket_GetPayloadBuffer(in),
+                                        &float_type,
+                                        target,
+                                        frames*in_channels,
+                                        BLT_PCM_KERNEL_ANY);
+        if (BLT_FAILED(result)) return result;
+        samples = target;
+        next ^= 1;
+    }
+
+    /* allocate the output packet */
+    max_out_frames = resample ? 
+                     PcmResampler_GetMaxOutputFrames(resampling->resampler, frames) :
+                     frames;
+    result = BLT_Core_CreateMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
+                                        max_out_frames*out_channels*(out_type.bits_per_sample/8),
+                                        (const BLT_MediaType*)&out_type,
+                                        out);
+    if (BLT_FAILED(result)) return result;
+
+    /* the last stage writes directly into the packet when it holds floats */
+    out_samples = (float*)BLT_MediaPacket_GetPayloadBuffer(*out);
+    direct = (out_type.sample_format   == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE &&
+              out_type.bits_per_sample == 32);
+
+    /* downmix */
+    if (mix && out_channels < in_channels) {
+        if (direct && !resample) {
+            target = out_samples;
+        } else {
+            target = PcmAdapter_GetBuffer(self, next, frames*out_channels);
+            if (target == NULL) goto fail_oom;
+            next ^= 1;
+        }
+        PcmMixer_Process(self->mixer, samples, target, frames);
+        samples = target;
+    }
+
+    /* resample */
+    if (resample) {
+        BLT_Cardinal in_frames = frames;
+        if (direct && !(mix && out_channels >= in_channels)) {
+            target = out_samples;
+        } else {
+            target = PcmAdapter_GetBuffer(self, next, max_out_frames*channels);
+            if (target == NULL) goto fail_oom;
+            next ^= 1;
+        }
+        result = PcmResampler_Process(resampling->resampler,
+                                      samples,
+                                      in_frames,
+                                      target,
+                                      &frames);
+        if (BLT_FAILED(result)) goto fail;
+        if (flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM) {
+            BLT_Cardinal tail_frames = 0;
+            result = PcmResampler_Flush(resampling->resampler,
+                                        target+frames*channels,
+                                        &tail_frames);
+            if (BLT_FAILED(result)) goto fail;
+            frames += tail_frames;
+        }
+        samples = target;
+    }
+
+    /* upmix or remix */
+    if (mix && out_channels >= in_channels) {
+        if (direct) {
+            target = out_samples;
+        } else {
+            target = PcmAdapter_GetBuffer(self, next, frames*out_channels);
+            if (target == NULL) goto fail_oom;
+        }
+        PcmMixer_Process(self->mixer, samples, target, frames);
+        samples = target;
+    }
+
+    /* requantize to the output resolution */
+    if (dither != BLT_PCM_ADAPTER_DITHER_NONE) {
+        if (self->dither == NULL ||
+            !PcmDither_Matches(self->dither, out_channels, out_type.bits_per_sample, dither)) {
+            ATX_LOG_FINE_2("PcmAdapter::ProcessPacket - dithering to %d bits (mode %d)",
+                           (int)out_type.bits_per_sample, dither);
+            PcmDither_Destroy(self->dither);
+            self->dither = NULL;
+            result = PcmDither_Create(out_channels, 
+                                      out_type.bits_per_sample, 
+                                      dither, 
+                                      BLT_PCM_KERNEL_ANY,
+                                      &self->dither);
+            if (BLT_FAILED(result)) goto fail;
+        }
+        if (flags & (BLT_MEDIA_PACKET_FLAG_START_OF_STREAM |
+                     BLT_MEDIA_PACKET_FLAG_STREAM_DISCONTINUITY)) {
+            PcmDither_Reset(self->dither);
+        }
+
+        /* our own buffers can be processed in place */
+        if (samples == self->buffers[0].samples || samples == self->buffers[1].samples) {
+            target = (float*)samples;
+        } else {
+            target = PcmAdapter_GetBuffer(self, next, frames*out_channels);
+            if (target == NULL) goto fail_oom;
+        }
+        PcmDither_Process(self->dither, samples, target, frames);
+        samples = target;
+    }
+
+    /* convert to the output format */
+    if (samples != out_samples) {
+        float_type.sample_rate   = out_type.sample_rate;
+        float_type.channel_count = out_channels;
+        result = BLT_Pcm_ConvertSamples(&float_type,
+                                        samples,
+                                        &out_type,
+                                        out_samples,
+                                        frames*out_channels,
+                                        BLT_PCM_KERNEL_ANY);
+        if (BLT_FAILED(result)) goto fail;
+    }
+    BLT_MediaPacket_SetPayloadSize(*out, frames*out_channels*(out_type.bits_per_sample/8));
+    BLT_MediaPacket_SetFlags(*out, flags);
+
+    /* timestamps follow the number of frames produced */
+    if (resample) {
+        BLT_MediaPacket_SetTimeStamp(*out, 
+                                     BLT_TimeStamp_Add(resampling->time_base,
+                                                       BLT_TimeStamp_FromSamples(resampling->frame_count,
+                                                                                 out_type.sample_rate)));
+        resampling->frame_count += frames;
+        if (flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM) {
+            PcmAdapter_ResetResampling(self);
+        }
+
+        /* nothing to emit until the converter has enough input */
+        if (frames == 0 && flags == 0) {
+            BLT_MediaPacket_Release(*out);
+            *out = NULL;
+        }
+    } else {
+        BLT_MediaPacket_SetTimeStamp(*out, BLT_MediaPacket_GetTimeStamp(in));
+    }
+
+    return BLT_SUCCESS;
+
+fail_oom:
+    result = BLT_ERROR_OUT_OF_MEMORY;
+fail:
+    BLT_MediaPacket_Release(*out);
+    *out = NULL;
+    return result;
+}
+
 /*----------------------------------------------------------------------
 |    PcmAdapterInput_PutPacket
 +---------------------------------------------------------------------*/
@@ -70,14 +542,34 @@ BLT_METHOD
 PcmAdapterInput_PutPacket(BLT_PacketConsumer* _self,
                           BLT_MediaPacket*    packet)
 {
-    PcmAdapter* self = ATX_SELF_M(input, PcmAdapter, BLT_PacketConsumer);
-    BLT_Result  result;
+    PcmAdapter*             self = ATX_SELF_M(input, PcmAdapter, BLT_PacketConsumer);
+    const BLT_PcmMediaType* in_type;
+    const BLT_PcmMediaType* out_type = &self->output.pcm_type;
+    BLT_CString             matrix;
+    unsigned int            dither = BLT_PCM_ADAPTER_DITHER_NONE;
+    BLT_Result              result;
+
+    /* get the media type */
+    result = BLT_MediaPacket_GetMediaType(packet, (const BLT_MediaType**)(const void*)&in_type);
+    if (BLT_FAILED(result)) return result;
 
     /* transform the packet data */
-    result =  BLT_Pcm_ConvertMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
-                                         packet, 
-                                         &self->output.pcm_type, 
-                                         &self->output.packet);
+    matrix = PcmAdapter_GetChannelMatrix(self);
+    if (in_type->base.id == BLT_MEDIA_TYPE_ID_AUDIO_PCM) {
+        dither = PcmAdapter_GetDitherMode(self, in_type, out_type);
+    }
+    if (in_type->base.id == BLT_MEDIA_TYPE_ID_AUDIO_PCM &&
+        ((out_type->sample_rate   != 0 && out_type->sample_rate   != in_type->sample_rate)   ||
+         (out_type->channel_count != 0 && out_type->channel_count != in_type->channel_count) ||
+         matrix != NULL || dither != BLT_PCM_ADAPTER_DITHER_NONE)) {
+        result = PcmAdapter_ProcessPacket(self, packet, in_type, matrix, dither, &self->output.packet);
+    } else {
+        PcmAdapter_ResetResampling(self);
+        result = BLT_Pcm_ConvertMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
+                                            packet, 
+                                            &self->output.pcm_type, 
+                                            &self->output.packet);
+    }
     if (BLT_FAILED(result)) {
         ATX_LOG_WARNING_1("PcmAdapterInput::PutPacket - failed to convert PCM (%d)", result);
     }
@@ -262,6 +754,13 @@ PcmAdapter_Destroy(PcmAdapter* self)
         BLT_MediaPacket_Release(self->output.packet);
     }
 
+    /* release the converters */
+    PcmMixer_Destroy(self->mixer);
+    PcmResampler_Destroy(self->resampling.resampler);
+    PcmDither_Destroy(self->dither);
+    if (self->buffers[0].samples) ATX_FreeMemory(self->buffers[0].samples);
+    if (self->buffers[1].samples) ATX_FreeMemory(self->buffers[1].samples);
+
     /* destruct the inherited object */
     BLT_BaseMediaNode_Destruct(&ATX_BASE(self, BLT_BaseMediaNode));
 
@@ -293,6 +792,32 @@ PcmAdapter_GetPortByName(BLT_MediaNode*  _self,
     }
 }
 
+/*----------------------------------------------------------------------
+|    PcmAdapter_Seek
++---------------------------------------------------------------------*/
+BLT_METHOD
+PcmAdapter_Seek(BLT_MediaNode* _self,
+                BLT_SeekMode*  mode,
+                BLT_SeekPoint* point)
+{
+    PcmAdapter* self = ATX_SELF_EX(PcmAdapter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    BLT_COMPILER_UNUSED(mode);
+    BLT_COMPILER_UNUSED(point);
+
+    /* drop any pending output */
+    if (self->output.packet) {
+        BLT_MediaPacket_Release(self->output.packet);
+        self->output.packet = NULL;
+    }
+
+    /* the converter history is from before the seek point */
+    PcmAdapter_ResetResampling(self);
+    if (self->dither) PcmDither_Reset(self->dither);
+
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |   GetInterface implementation
 +---------------------------------------------------------------------*/
@@ -313,7 +838,7 @@ ATX_BEGIN_INTERFACE_MAP_EX(PcmAdapter, BLT_BaseMediaNode, BLT_MediaNode)
     BLT_BaseMediaNode_Stop,
     BLT_BaseMediaNode_Pause,
     BLT_BaseMediaNode_Resume,
-    BLT_BaseMediaNode_Seek
+    PcmAdapter_Seek
 };
 
 /*----------------------------------------------------------------------
@@ -359,8 +884,8 @@ PcmAdapterModule_Probe(BLT_Module*              self,
                 }
 
                 /* check that the in and out formats are supported */
-                if (!BLT_Pcm_CanConvert(constructor->spec.input.media_type, 
-                                        constructor->spec.output.media_type)) {
+                if (!PcmAdapter_CanConvert(constructor->spec.input.media_type, 
+                                           constructor->spec.output.media_type)) {
                     return BLT_FAILURE;
                 }
             } else {
@@ -388,8 +913,8 @@ PcmAdapterModule_Probe(BLT_Module*              self,
                 }
 
                 /* check that the in and out formats are supported */
-                if (!BLT_Pcm_CanConvert(constructor->spec.input.media_type, 
-                                        constructor->spec.output.media_type)) {
+                if (!PcmAdapter_CanConvert(constructor->spec.input.media_type, 
+                                           constructor->spec.output.media_type)) {
                     return BLT_FAILURE;
                 }
             }
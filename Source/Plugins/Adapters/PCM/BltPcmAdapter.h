@@ -21,6 +21,16 @@
  * needs to be transformed before it can be consumed by another media node.
  * This includes, for example, going from single channel to stereo, or from 
  * 24-bit samples to 16-bit samples, or floating point samples to integer samples.
+ * When the sample rates differ, the samples go through a polyphase
+ * windowed-sinc sample rate converter, whose quality can be selected with
+ * the BLT_PCM_ADAPTER_RESAMPLER_QUALITY_PROPERTY stream property.
+ * When the channel counts differ, the channels are mixed with a standard
+ * downmix or upmix matrix chosen from the channel masks, or with the
+ * matrix set in the BLT_PCM_ADAPTER_CHANNEL_MATRIX_PROPERTY stream property.
+ * When the samples are narrowed to 24 bits or less, for example floats or
+ * 24-bit samples going to a 16-bit output, they can be dithered instead of
+ * truncated, as selected with the BLT_PCM_ADAPTER_DITHER_PROPERTY stream
+ * property.
  * @{ 
  */
 
@@ -30,6 +40,31 @@
 #include "BltTypes.h"
 #include "BltModule.h"
 
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/** integer stream property, one of the quality values below */
+#define BLT_PCM_ADAPTER_RESAMPLER_QUALITY_PROPERTY "PcmAdapter.ResamplerQuality"
+
+#define BLT_PCM_ADAPTER_RESAMPLER_QUALITY_LOW      0 /* 16 taps  */
+#define BLT_PCM_ADAPTER_RESAMPLER_QUALITY_MEDIUM   1 /* 32 taps  */
+#define BLT_PCM_ADAPTER_RESAMPLER_QUALITY_HIGH     2 /* 64 taps  */
+#define BLT_PCM_ADAPTER_RESAMPLER_QUALITY_BEST     3 /* 128 taps */
+
+/** 
+ * string stream property: one row of coefficients per output channel,
+ * rows separated by ';' and coefficients by ',' (ex: "1,0,0.7;0,1,0.7"
+ * mixes FL FR FC into FL FR)
+ */
+#define BLT_PCM_ADAPTER_CHANNEL_MATRIX_PROPERTY    "PcmAdapter.ChannelMatrix"
+
+/** integer stream property, one of the dither values below */
+#define BLT_PCM_ADAPTER_DITHER_PROPERTY            "PcmAdapter.Dither"
+
+#define BLT_PCM_ADAPTER_DITHER_NONE                0 /* truncate                  */
+#define BLT_PCM_ADAPTER_DITHER_TPDF                1 /* triangular noise          */
+#define BLT_PCM_ADAPTER_DITHER_SHAPED              2 /* triangular, noise shaped  */
+
 /*----------------------------------------------------------------------
 |   module
 +---------------------------------------------------------------------*/
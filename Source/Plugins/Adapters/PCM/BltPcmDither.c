@@ -0,0 +1,319 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - Dither
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltPcmAdapter.h"
+#include "BltPcmDither.h"
+#include "BltPcmSimd.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/* number of samples of noise generated at a time (multiple of 4) */
+#define BLT_PCM_DITHER_BLOCK_SIZE 256
+
+/* the random generator runs 4 independent lanes, so that they can be */
+/* computed in a single vector                                        */
+#define BLT_PCM_DITHER_LANE_COUNT 4
+
+/* noise shaping filter (Lipshitz et al.), which moves the noise to */
+/* where the ear is least sensitive at 44.1 and 48 kHz              */
+#define BLT_PCM_DITHER_SHAPING_TAP_COUNT 5
+static const float PcmDitherShapingFilter[BLT_PCM_DITHER_SHAPING_TAP_COUNT] = {
+    2.033f, -2.165f, 1.959f, -1.590f, 0.6149f
+};
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/* refills the noise block */
+typedef void (*PcmDitherNoiseGenerator)(PcmDither* self);
+
+struct PcmDither {
+    unsigned int channel_count;
+    unsigned int bits_per_sample;
+    unsigned int mode;
+    float        scale;     /* 1.0 in units of the output LSB */
+    float        min;       /* smallest output value, in LSBs */
+    float        max;       /* largest output value, in LSBs  */
+    BLT_UInt32   random[BLT_PCM_DITHER_LANE_COUNT];
+    float        noise[BLT_PCM_DITHER_BLOCK_SIZE];
+
+    /* the variant selected by the kernel flags */
+    PcmDitherNoiseGenerator generate_noise;
+
+    /* errors[c*BLT_PCM_DITHER_SHAPING_TAP_COUNT+k] is the error */
+    /* of the sample k+1 frames ago on channel c                 */
+    float*       errors;
+};
+
+/*----------------------------------------------------------------------
+|   PcmDither_GenerateNoise
+|
+|   fills the noise block with TPDF values between -1 and 1, as the
+|   difference of two uniform values with 24 bits of resolution. Each
+|   lane is a xorshift32 generator, and all the variants produce the
+|   same values.
++---------------------------------------------------------------------*/
+static void
+PcmDither_GenerateNoise(PcmDither* self)
+{
+    float*       noise = self->noise;
+    unsigned int i;
+
+    for (i=0; i<BLT_PCM_DITHER_BLOCK_SIZE; i++) {
+        BLT_UInt32* x = &self->random[i%BLT_PCM_DITHER_LANE_COUNT];
+        BLT_Int32   a, b;
+        *x ^= *x<<13; *x ^= *x>>17; *x ^= *x<<5;
+        a = (BLT_Int32)(*x>>8);
+        *x ^= *x<<13; *x ^= *x>>17; *x ^= *x<<5;
+        b = (BLT_Int32)(*x>>8);
+        noise[i] = (float)(a-b)*(1.0f/16777216.0f);
+    }
+}
+
+/*----------------------------------------------------------------------
+|   PcmDither_GenerateNoise_SSE2
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+static void
+PcmDither_GenerateNoise_SSE2(PcmDither* self)
+{
+    float*        noise = self->noise;
+    __m128i       x     = _mm_loadu_si128((const __m128i*)self->random);
+    const __m128  scale = _mm_set1_ps(1.0f/16777216.0f);
+    unsigned int  i;
+
+    for (i=0; i<BLT_PCM_DITHER_BLOCK_SIZE; i+=4) {
+        __m128i a, b;
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        a = _mm_srli_epi32(x, 8);
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        b = _mm_srli_epi32(x, 8);
+        _mm_storeu_ps(noise+i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(a, b)), scale));
+    }
+    _mm_storeu_si128((__m128i*)self->random, x);
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   PcmDither_GenerateNoise_NEON
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_SIMD_HAVE_NEON)
+static void
+PcmDither_GenerateNoise_NEON(PcmDither* self)
+{
+    float*       noise = self->noise;
+    uint32x4_t   x     = vld1q_u32(self->random);
+    unsigned int i;
+
+    for (i=0; i<BLT_PCM_DITHER_BLOCK_SIZE; i+=4) {
+        int32x4_t a, b;
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        x = veorq_u32(x, vshlq_n_u32(x, 5));
+        a = vreinterpretq_s32_u32(vshrq_n_u32(x, 8));
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        x = veorq_u32(x, vshlq_n_u32(x, 5));
+        b = vreinterpretq_s32_u32(vshrq_n_u32(x, 8));
+        vst1q_f32(noise+i, vmulq_n_f32(vcvtq_f32_s32(vsubq_s32(a, b)), 1.0f/16777216.0f));
+    }
+    vst1q_u32(self->random, x);
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   PcmDither_SelectNoiseGenerator
++---------------------------------------------------------------------*/
+static PcmDitherNoiseGenerator
+PcmDither_SelectNoiseGenerator(BLT_Flags kernels)
+{
+    kernels &= BLT_Pcm_GetAvailableKernels();
+
+    /* the noise has 4 lanes, so wider vectors wouldn't help */
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+    if (kernels & BLT_PCM_KERNEL_SSE2) return PcmDither_GenerateNoise_SSE2;
+#endif
+#if defined(BLT_PCM_SIMD_HAVE_NEON)
+    if (kernels & BLT_PCM_KERNEL_NEON) return PcmDither_GenerateNoise_NEON;
+#endif
+    return PcmDither_GenerateNoise;
+}
+
+/*----------------------------------------------------------------------
+|   PcmDither_Create
++---------------------------------------------------------------------*/
+BLT_Result
+PcmDither_Create(unsigned int channel_count,
+                 unsigned int bits_per_sample,
+                 unsigned int mode,
+                 BLT_Flags    kernels,
+                 PcmDither**  dither)
+{
+    PcmDither* self;
+
+    /* default */
+    *dither = NULL;
+
+    /* check parameters */
+    if (channel_count == 0 || bits_per_sample < 8 || bits_per_sample > 24) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+    if (mode != BLT_PCM_ADAPTER_DITHER_TPDF &&
+        mode != BLT_PCM_ADAPTER_DITHER_SHAPED) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* allocate the object */
+    self = (PcmDither*)ATX_AllocateZeroMemory(sizeof(PcmDither));
+    if (self == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    self->channel_count   = channel_count;
+    self->bits_per_sample = bits_per_sample;
+    self->mode            = mode;
+    self->scale           = (float)(1L<<(bits_per_sample-1));
+    self->min             = -self->scale;
+    self->max             = self->scale-1.0f;
+    self->generate_noise  = PcmDither_SelectNoiseGenerator(kernels);
+
+    /* any non-zero seeds will do */
+    self->random[0] = 0x9E3779B9;
+    self->random[1] = 0x7F4A7C15;
+    self->random[2] = 0x85EBCA6B;
+    self->random[3] = 0xC2B2AE35;
+
+    /* allocate the error history */
+    if (mode == BLT_PCM_ADAPTER_DITHER_SHAPED) {
+        self->errors = (float*)ATX_AllocateZeroMemory(channel_count*
+                                                      BLT_PCM_DITHER_SHAPING_TAP_COUNT*
+                                                      sizeof(float));
+        if (self->errors == NULL) {
+            ATX_FreeMemory(self);
+            return BLT_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    *dither = self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmDither_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+PcmDither_Destroy(PcmDither* self)
+{
+    if (self == NULL) return BLT_SUCCESS;
+
+    if (self->errors) ATX_FreeMemory(self->errors);
+    ATX_FreeMemory(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmDither_Reset
++---------------------------------------------------------------------*/
+void
+PcmDither_Reset(PcmDither* self)
+{
+    if (self->errors) {
+        ATX_SetMemory(self->errors, 0, self->channel_count*
+                                       BLT_PCM_DITHER_SHAPING_TAP_COUNT*
+                                       sizeof(float));
+    }
+}
+
+/*----------------------------------------------------------------------
+|   PcmDither_Matches
++---------------------------------------------------------------------*/
+BLT_Boolean
+PcmDither_Matches(PcmDither*   self,
+                  unsigned int channel_count,
+                  unsigned int bits_per_sample,
+                  unsigned int mode)
+{
+    return self->channel_count   == channel_count   &&
+           self->bits_per_sample == bits_per_sample &&
+           self->mode            == mode;
+}
+
+/*----------------------------------------------------------------------
+|   PcmDither_Process
++---------------------------------------------------------------------*/
+void
+PcmDither_Process(PcmDither*   self,
+                  const float* input,
+                  float*       output,
+                  BLT_Cardinal frame_count)
+{
+    unsigned int channel_count = self->channel_count;
+    BLT_Cardinal sample_count  = frame_count*channel_count;
+    float        scale         = self->scale;
+    float        inverse_scale = 1.0f/scale;
+    unsigned int channel       = 0;
+
+    while (sample_count) {
+        unsigned int chunk = sample_count < BLT_PCM_DITHER_BLOCK_SIZE ?
+                             (unsigned int)sample_count :
+                             BLT_PCM_DITHER_BLOCK_SIZE;
+        unsigned int i;
+
+        self->generate_noise(self);
+
+        if (self->errors == NULL) {
+            /* plain TPDF */
+            for (i=0; i<chunk; i++) {
+                float q = (float)floor(input[i]*scale+self->noise[i]+0.5f);
+                if (q < self->min) q = self->min;
+                if (q > self->max) q = self->max;
+                output[i] = q*inverse_scale;
+            }
+        } else {
+            /* TPDF with error feedback */
+            for (i=0; i<chunk; i++) {
+                float* e = &self->errors[channel*BLT_PCM_DITHER_SHAPING_TAP_COUNT];
+                float  v = input[i]*scale -
+                           (PcmDitherShapingFilter[0]*e[0] +
+                            PcmDitherShapingFilter[1]*e[1] +
+                            PcmDitherShapingFilter[2]*e[2] +
+                            PcmDitherShapingFilter[3]*e[3] +
+                            PcmDitherShapingFilter[4]*e[4]);
+                float  q = (float)floor(v+self->noise[i]+0.5f);
+
+                /* the error is measured before clipping, so that it */
+                /* stays bounded and the filter stays stable          */
+                e[4] = e[3];
+                e[3] = e[2];
+                e[2] = e[1];
+                e[1] = e[0];
+                e[0] = q-v;
+
+                if (q < self->min) q = self->min;
+                if (q > self->max) q = self->max;
+                output[i] = q*inverse_scale;
+                if (++channel == channel_count) channel = 0;
+            }
+        }
+
+        input        += chunk;
+        output       += chunk;
+        sample_count -= chunk;
+    }
+}
@@ -0,0 +1,80 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - Dither
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_PCM_DITHER_H_
+#define _BLT_PCM_DITHER_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Requantizer for interleaved native-endian float samples. Each sample
+ * gets triangular (TPDF) noise of +/- 1 LSB of the target resolution
+ * added before being rounded, optionally with the quantization error fed
+ * back through a noise shaping filter, one error history per channel.
+ * The output samples are floats that fall exactly on the integer grid
+ * of the target resolution, so that the final conversion is lossless.
+ */
+typedef struct PcmDither PcmDither;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates a ditherer. mode is one of the BLT_PCM_ADAPTER_DITHER_XXX
+ * values other than BLT_PCM_ADAPTER_DITHER_NONE, and bits_per_sample the
+ * resolution of the output, between 8 and 24. 'kernels' is a
+ * combination of BLT_PCM_KERNEL_XXX flags that restricts which vector
+ * code may be used to generate the noise.
+ */
+BLT_Result PcmDither_Create(unsigned int channel_count,
+                            unsigned int bits_per_sample,
+                            unsigned int mode,
+                            BLT_Flags    kernels,
+                            PcmDither**  dither);
+BLT_Result PcmDither_Destroy(PcmDither* self);
+
+/**
+ * Clears the noise shaping history, for when the next samples don't
+ * follow the previous ones.
+ */
+void PcmDither_Reset(PcmDither* self);
+
+/**
+ * Returns true if the ditherer was created with these parameters.
+ */
+BLT_Boolean PcmDither_Matches(PcmDither*   self,
+                              unsigned int channel_count,
+                              unsigned int bits_per_sample,
+                              unsigned int mode);
+
+/**
+ * Requantizes frame_count frames. 'input' and 'output' may be the same.
+ */
+void PcmDither_Process(PcmDither*   self,
+                       const float* input,
+                       float*       output,
+                       BLT_Cardinal frame_count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_PCM_DITHER_H_ */
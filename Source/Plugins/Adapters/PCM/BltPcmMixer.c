@@ -0,0 +1,559 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - Channel Mixer
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltPcm.h"
+#include "BltPcmMixer.h"
+#include "BltPcmSimd.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#define BLT_PCM_MIXER_SPEAKER_COUNT 18
+#define BLT_PCM_MIXER_MAX_ROUTES    3
+
+#define BLT_PCM_MIXER_MINUS_3DB     0.70710678f
+#define BLT_PCM_MIXER_MINUS_6DB     0.5f
+
+/* short names for the routing table */
+#define MIX_FL  BLT_PCM_SPEAKER_FRONT_LEFT
+#define MIX_FR  BLT_PCM_SPEAKER_FRONT_RIGHT
+#define MIX_FC  BLT_PCM_SPEAKER_FRONT_CENTER
+#define MIX_BL  BLT_PCM_SPEAKER_BACK_LEFT
+#define MIX_BR  BLT_PCM_SPEAKER_BACK_RIGHT
+#define MIX_SL  BLT_PCM_SPEAKER_SIDE_LEFT
+#define MIX_SR  BLT_PCM_SPEAKER_SIDE_RIGHT
+#define MIX_M3  BLT_PCM_MIXER_MINUS_3DB
+#define MIX_M6  BLT_PCM_MIXER_MINUS_6DB
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/* mixes as many whole vectors of frames as it can, returns how many */
+typedef BLT_Cardinal (*PcmMixerVectorProcess)(const PcmMixer* self,
+                                              const float*    input,
+                                              float*          output,
+                                              BLT_Cardinal    frame_count);
+
+typedef struct {
+    BLT_UInt32 targets; /* all of these need to be in the output */
+    float      gain;    /* applied for each of the targets       */
+} PcmMixerRoute;
+
+struct PcmMixer {
+    unsigned int input_channel_count;
+    BLT_UInt32   input_channel_mask;
+    unsigned int output_channel_count;
+    BLT_UInt32   output_channel_mask;
+    ATX_String   matrix_spec;
+    BLT_Boolean  custom_matrix;
+
+    /* coefficients[o*input_channel_count+i] is the gain from i to o */
+    float*       coefficients;
+
+    /* for 1 and 2 output channels, each input channel's coefficients */
+    /* repeated to fill a vector that covers 4 or 2 frames            */
+    float*       columns;
+
+    /* the variant selected by the kernel flags, NULL for the portable code */
+    PcmMixerVectorProcess process_vectors;
+};
+
+/*----------------------------------------------------------------------
+|   globals
++---------------------------------------------------------------------*/
+/* where a speaker goes when the output doesn't have it: the first    */
+/* route whose targets are all present is used. The LFE channel isn't */
+/* routed anywhere else.                                              */
+static const PcmMixerRoute PcmMixerRoutes[BLT_PCM_MIXER_SPEAKER_COUNT][BLT_PCM_MIXER_MAX_ROUTES] = {
+    /* FL  */ {{MIX_FC,        MIX_M3}, {0, 0.0f},                {0, 0.0f}},
+    /* FR  */ {{MIX_FC,        MIX_M3}, {0, 0.0f},                {0, 0.0f}},
+    /* FC  */ {{MIX_FL|MIX_FR, MIX_M3}, {0, 0.0f},                {0, 0.0f}},
+    /* LFE */ {{0,             0.0f},   {0, 0.0f},                {0, 0.0f}},
+    /* BL  */ {{MIX_SL,        1.0f},   {MIX_FL,        MIX_M3},  {MIX_FC,        MIX_M6}},
+    /* BR  */ {{MIX_SR,        1.0f},   {MIX_FR,        MIX_M3},  {MIX_FC,        MIX_M6}},
+    /* FLC */ {{MIX_FL|MIX_FC, MIX_M3}, {MIX_FL,        1.0f},    {MIX_FC,        1.0f}},
+    /* FRC */ {{MIX_FR|MIX_FC, MIX_M3}, {MIX_FR,        1.0f},    {MIX_FC,        1.0f}},
+    /* BC  */ {{MIX_BL|MIX_BR, MIX_M3}, {MIX_SL|MIX_SR, MIX_M3},  {MIX_FL|MIX_FR, MIX_M6}},
+    /* SL  */ {{MIX_BL,        1.0f},   {MIX_FL,        MIX_M3},  {MIX_FC,        MIX_M6}},
+    /* SR  */ {{MIX_BR,        1.0f},   {MIX_FR,        MIX_M3},  {MIX_FC,        MIX_M6}},
+    /* TC  */ {{MIX_FC,        MIX_M3}, {MIX_FL|MIX_FR, MIX_M6},  {0, 0.0f}},
+    /* TFL */ {{MIX_FL,        MIX_M3}, {MIX_FC,        MIX_M6},  {0, 0.0f}},
+    /* TFC */ {{MIX_FC,        MIX_M3}, {MIX_FL|MIX_FR, MIX_M6},  {0, 0.0f}},
+    /* TFR */ {{MIX_FR,        MIX_M3}, {MIX_FC,        MIX_M6},  {0, 0.0f}},
+    /* TBL */ {{MIX_BL,        MIX_M3}, {MIX_SL,        MIX_M3},  {MIX_FL,        MIX_M6}},
+    /* TBC */ {{MIX_BL|MIX_BR, MIX_M6}, {MIX_SL|MIX_SR, MIX_M6},  {MIX_FL|MIX_FR, MIX_M6}},
+    /* TBR */ {{MIX_BR,        MIX_M3}, {MIX_SR,        MIX_M3},  {MIX_FR,        MIX_M6}}
+};
+
+/*----------------------------------------------------------------------
+|   PcmMixer_CountChannels
++---------------------------------------------------------------------*/
+static unsigned int
+PcmMixer_CountChannels(BLT_UInt32 mask)
+{
+    unsigned int count = 0;
+    while (mask) {
+        mask &= mask-1;
+        ++count;
+    }
+    return count;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_GetDefaultChannelMask
++---------------------------------------------------------------------*/
+BLT_UInt32
+PcmMixer_GetDefaultChannelMask(unsigned int channel_count)
+{
+    switch (channel_count) {
+        case 1: return BLT_CHANNEL_MASK_MONO;
+        case 2: return BLT_CHANNEL_MASK_STEREO;
+        case 3: return BLT_CHANNEL_MASK_STEREO | BLT_PCM_SPEAKER_FRONT_CENTER;
+        case 4: return BLT_CHANNEL_MASK_QUAD;
+        case 5: return BLT_CHANNEL_MASK_QUAD   | BLT_PCM_SPEAKER_FRONT_CENTER;
+        case 6: return BLT_CHANNEL_MASK_5POINT1;
+        case 7: return BLT_CHANNEL_MASK_5POINT1 | BLT_PCM_SPEAKER_BACK_CENTER;
+        case 8: return BLT_CHANNEL_MASK_7POINT1_SURROUND;
+        default: return 0;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_ResolveChannelMask
++---------------------------------------------------------------------*/
+static BLT_UInt32
+PcmMixer_ResolveChannelMask(unsigned int channel_count, BLT_UInt32 mask)
+{
+    if (mask == 0) mask = PcmMixer_GetDefaultChannelMask(channel_count);
+
+    /* a mask that doesn't describe all the channels isn't usable */
+    if (PcmMixer_CountChannels(mask) != channel_count) return 0;
+
+    return mask;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_GetChannelIndex
+|
+|   channels are interleaved in the order of their mask bits
++---------------------------------------------------------------------*/
+static unsigned int
+PcmMixer_GetChannelIndex(BLT_UInt32 mask, BLT_UInt32 speaker)
+{
+    return PcmMixer_CountChannels(mask & (speaker-1));
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_ComputeStandardMatrix
++---------------------------------------------------------------------*/
+static void
+PcmMixer_ComputeStandardMatrix(PcmMixer* self)
+{
+    unsigned int ic = self->input_channel_count;
+    unsigned int oc = self->output_channel_count;
+    BLT_UInt32   in_mask  = self->input_channel_mask;
+    BLT_UInt32   out_mask = self->output_channel_mask;
+    float        max_gain = 0.0f;
+    unsigned int b, i, o;
+
+    ATX_SetMemory(self->coefficients, 0, ic*oc*sizeof(float));
+
+    /* without known layouts, just map the channels in order */
+    if (in_mask == 0 || out_mask == 0) {
+        for (i=0; i<ic && i<oc; i++) {
+            self->coefficients[i*ic+i] = 1.0f;
+        }
+        return;
+    }
+
+    for (b=0; b<BLT_PCM_MIXER_SPEAKER_COUNT; b++) {
+        BLT_UInt32 speaker = 1<<b;
+        unsigned int r;
+
+        if ((in_mask & speaker) == 0) continue;
+        i = PcmMixer_GetChannelIndex(in_mask, speaker);
+
+        /* same speaker in the output */
+        if (out_mask & speaker) {
+            o = PcmMixer_GetChannelIndex(out_mask, speaker);
+            self->coefficients[o*ic+i] += 1.0f;
+            continue;
+        }
+
+        /* mono is played at full level on both sides */
+        if (in_mask == BLT_CHANNEL_MASK_MONO &&
+            (out_mask & BLT_CHANNEL_MASK_STEREO) == BLT_CHANNEL_MASK_STEREO) {
+            self->coefficients[PcmMixer_GetChannelIndex(out_mask, BLT_PCM_SPEAKER_FRONT_LEFT)*ic+i]  = 1.0f;
+            self->coefficients[PcmMixer_GetChannelIndex(out_mask, BLT_PCM_SPEAKER_FRONT_RIGHT)*ic+i] = 1.0f;
+            continue;
+        }
+
+        /* use the first route that the output can take */
+        for (r=0; r<BLT_PCM_MIXER_MAX_ROUTES; r++) {
+            const PcmMixerRoute* route = &PcmMixerRoutes[b][r];
+            if (route->targets == 0 || (route->targets & out_mask) != route->targets) {
+                continue;
+            }
+            for (o=0; o<BLT_PCM_MIXER_SPEAKER_COUNT; o++) {
+                if (route->targets & (1<<o)) {
+                    unsigned int index = PcmMixer_GetChannelIndex(out_mask, 1<<o);
+                    self->coefficients[index*ic+i] += route->gain;
+                }
+            }
+            break;
+        }
+    }
+
+    /* scale everything down if an output could clip */
+    for (o=0; o<oc; o++) {
+        float gain = 0.0f;
+        for (i=0; i<ic; i++) {
+            float c = self->coefficients[o*ic+i];
+            gain += c < 0.0f ? -c : c;
+        }
+        if (gain > max_gain) max_gain = gain;
+    }
+    if (max_gain > 1.0f) {
+        for (i=0; i<ic*oc; i++) {
+            self->coefficients[i] /= max_gain;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_ParseMatrix
++---------------------------------------------------------------------*/
+static BLT_Result
+PcmMixer_ParseMatrix(PcmMixer* self, const char* matrix)
+{
+    unsigned int ic = self->input_channel_count;
+    unsigned int oc = self->output_channel_count;
+    unsigned int row = 0;
+    unsigned int column = 0;
+    ATX_String   token = ATX_EMPTY_STRING;
+    const char*  start = NULL;
+    const char*  cursor;
+    BLT_Result   result = BLT_SUCCESS;
+
+    for (cursor = matrix; ; cursor++) {
+        char c = *cursor;
+        if (c == ';' || c == ',' || c == ' ' || c == '\t' || c == '\0') {
+            /* end of a coefficient */
+            if (start) {
+                float value;
+                if (row >= oc || column >= ic) {
+                    result = BLT_ERROR_INVALID_PARAMETERS;
+                    break;
+                }
+                ATX_String_AssignN(&token, start, (ATX_Size)(cursor-start));
+                if (ATX_FAILED(ATX_String_ToFloat(&token, &value, ATX_FALSE))) {
+                    result = BLT_ERROR_INVALID_PARAMETERS;
+                    break;
+                }
+                self->coefficients[row*ic+column] = value;
+                ++column;
+                start = NULL;
+            }
+
+            /* end of a row */
+            if (c == ';' || c == '\0') {
+                if (column != 0 || c == ';') {
+                    if (column != ic) {
+                        result = BLT_ERROR_INVALID_PARAMETERS;
+                        break;
+                    }
+                    ++row;
+                    column = 0;
+                }
+                if (c == '\0') break;
+            }
+        } else if (start == NULL) {
+            start = cursor;
+        }
+    }
+    ATX_String_Destruct(&token);
+
+    if (BLT_SUCCEEDED(result) && row != oc) result = BLT_ERROR_INVALID_PARAMETERS;
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_ProcessVectors_SSE2
+|
+|   for 1 output channel, 4 frames at a time, for 2, 2 frames at a time
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+static BLT_Cardinal
+PcmMixer_ProcessVectors_SSE2(const PcmMixer* self,
+                             const float*    input,
+                             float*          output,
+                             BLT_Cardinal    frame_count)
+{
+    unsigned int ic = self->input_channel_count;
+    BLT_Cardinal done = 0;
+    unsigned int i;
+
+    if (self->output_channel_count == 1) {
+        for (; done+4 <= frame_count; done += 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (i=0; i<ic; i++) {
+                __m128 x = _mm_set_ps(input[3*ic+i], input[2*ic+i], input[ic+i], input[i]);
+                acc = _mm_add_ps(acc, _mm_mul_ps(x, _mm_loadu_ps(&self->columns[4*i])));
+            }
+            _mm_storeu_ps(output, acc);
+            input  += 4*ic;
+            output += 4;
+        }
+    } else {
+        for (; done+2 <= frame_count; done += 2) {
+            __m128 acc = _mm_setzero_ps();
+            for (i=0; i<ic; i++) {
+                __m128 x = _mm_set_ps(input[ic+i], input[ic+i], input[i], input[i]);
+                acc = _mm_add_ps(acc, _mm_mul_ps(x, _mm_loadu_ps(&self->columns[4*i])));
+            }
+            _mm_storeu_ps(output, acc);
+            input  += 2*ic;
+            output += 4;
+        }
+    }
+
+    return done;
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   PcmMixer_ProcessVectors_NEON
++---------------------------------------------------------------------*/
+#if defined(BLT_PCM_SIMD_HAVE_NEON)
+static BLT_Cardinal
+PcmMixer_ProcessVectors_NEON(const PcmMixer* self,
+                             const float*    input,
+                             float*          output,
+                             BLT_Cardinal    frame_count)
+{
+    unsigned int ic = self->input_channel_count;
+    BLT_Cardinal done = 0;
+    unsigned int i;
+
+    if (self->output_channel_count == 1) {
+        for (; done+4 <= frame_count; done += 4) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (i=0; i<ic; i++) {
+                float32x4_t x = vcombine_f32(vset_lane_f32(input[ic+i],   vdup_n_f32(input[i]),      1),
+                                             vset_lane_f32(input[3*ic+i], vdup_n_f32(input[2*ic+i]), 1));
+                acc = vmlaq_f32(acc, x, vld1q_f32(&self->columns[4*i]));
+            }
+            vst1q_f32(output, acc);
+            input  += 4*ic;
+            output += 4;
+        }
+    } else {
+        for (; done+2 <= frame_count; done += 2) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (i=0; i<ic; i++) {
+                float32x4_t x = vcombine_f32(vdup_n_f32(input[i]), vdup_n_f32(input[ic+i]));
+                acc = vmlaq_f32(acc, x, vld1q_f32(&self->columns[4*i]));
+            }
+            vst1q_f32(output, acc);
+            input  += 2*ic;
+            output += 4;
+        }
+    }
+
+    return done;
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   PcmMixer_SelectVectorProcess
++---------------------------------------------------------------------*/
+static PcmMixerVectorProcess
+PcmMixer_SelectVectorProcess(BLT_Flags kernels)
+{
+    kernels &= BLT_Pcm_GetAvailableKernels();
+
+    /* a gather of 4 frames doesn't gain anything from wider vectors */
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+    if (kernels & BLT_PCM_KERNEL_SSE2) return PcmMixer_ProcessVectors_SSE2;
+#endif
+#if defined(BLT_PCM_SIMD_HAVE_NEON)
+    if (kernels & BLT_PCM_KERNEL_NEON) return PcmMixer_ProcessVectors_NEON;
+#endif
+    return NULL;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_Create
++---------------------------------------------------------------------*/
+BLT_Result
+PcmMixer_Create(unsigned int input_channel_count,
+                BLT_UInt32   input_channel_mask,
+                unsigned int output_channel_count,
+                BLT_UInt32   output_channel_mask,
+                const char*  matrix,
+                BLT_Flags    kernels,
+                PcmMixer**   mixer)
+{
+    PcmMixer*    self;
+    unsigned int ic = input_channel_count;
+    unsigned int oc = output_channel_count;
+
+    /* default */
+    *mixer = NULL;
+
+    /* check parameters */
+    if (ic == 0 || ic > BLT_PCM_MIXER_MAX_CHANNEL_COUNT ||
+        oc == 0 || oc > BLT_PCM_MIXER_MAX_CHANNEL_COUNT) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* allocate the object */
+    self = (PcmMixer*)ATX_AllocateZeroMemory(sizeof(PcmMixer));
+    if (self == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    self->input_channel_count  = ic;
+    self->input_channel_mask   = input_channel_mask;
+    self->output_channel_count = oc;
+    self->output_channel_mask  = output_channel_mask;
+    if (matrix) ATX_String_Assign(&self->matrix_spec, matrix);
+    self->coefficients = (float*)ATX_AllocateZeroMemory(ic*oc*sizeof(float));
+    if (oc <= 2) {
+        self->columns = (float*)ATX_AllocateMemory(ic*4*sizeof(float));
+    }
+    if (self->coefficients == NULL || (oc <= 2 && self->columns == NULL)) {
+        PcmMixer_Destroy(self);
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* compute the coefficients */
+    if (matrix && matrix[0] && BLT_SUCCEEDED(PcmMixer_ParseMatrix(self, matrix))) {
+        self->custom_matrix = BLT_TRUE;
+    } else {
+        /* use a standard matrix between the two layouts */
+        self->input_channel_mask  = PcmMixer_ResolveChannelMask(ic, input_channel_mask);
+        self->output_channel_mask = PcmMixer_ResolveChannelMask(oc, output_channel_mask);
+        PcmMixer_ComputeStandardMatrix(self);
+    }
+
+    /* lay the columns out for the vector loops */
+    if (self->columns) {
+        self->process_vectors = PcmMixer_SelectVectorProcess(kernels);
+        unsigned int i;
+        for (i=0; i<ic; i++) {
+            float* column = &self->columns[4*i];
+            if (oc == 1) {
+                column[0] = column[1] = column[2] = column[3] = self->coefficients[i];
+            } else {
+                column[0] = column[2] = self->coefficients[i];
+                column[1] = column[3] = self->coefficients[ic+i];
+            }
+        }
+    }
+
+    /* restore the requested masks so that Matches can compare them */
+    self->input_channel_mask  = input_channel_mask;
+    self->output_channel_mask = output_channel_mask;
+
+    *mixer = self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+PcmMixer_Destroy(PcmMixer* self)
+{
+    if (self == NULL) return BLT_SUCCESS;
+
+    ATX_String_Destruct(&self->matrix_spec);
+    if (self->coefficients) ATX_FreeMemory(self->coefficients);
+    if (self->columns)      ATX_FreeMemory(self->columns);
+    ATX_FreeMemory(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_Matches
++---------------------------------------------------------------------*/
+BLT_Boolean
+PcmMixer_Matches(PcmMixer*    self,
+                 unsigned int input_channel_count,
+                 BLT_UInt32   input_channel_mask,
+                 unsigned int output_channel_count,
+                 BLT_UInt32   output_channel_mask,
+                 const char*  matrix)
+{
+    return self->input_channel_count  == input_channel_count  &&
+           self->input_channel_mask   == input_channel_mask   &&
+           self->output_channel_count == output_channel_count &&
+           self->output_channel_mask  == output_channel_mask  &&
+           ATX_String_Equals(&self->matrix_spec, matrix ? matrix : "", ATX_FALSE);
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_HasCustomMatrix
++---------------------------------------------------------------------*/
+BLT_Boolean
+PcmMixer_HasCustomMatrix(PcmMixer* self)
+{
+    return self->custom_matrix;
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_GetOutputChannelMask
++---------------------------------------------------------------------*/
+BLT_UInt32
+PcmMixer_GetOutputChannelMask(PcmMixer* self)
+{
+    return PcmMixer_ResolveChannelMask(self->output_channel_count,
+                                       self->output_channel_mask);
+}
+
+/*----------------------------------------------------------------------
+|   PcmMixer_Process
++---------------------------------------------------------------------*/
+void
+PcmMixer_Process(PcmMixer*    self,
+                 const float* input,
+                 float*       output,
+                 BLT_Cardinal frame_count)
+{
+    unsigned int ic = self->input_channel_count;
+    unsigned int oc = self->output_channel_count;
+    unsigned int i, o;
+
+    if (self->process_vectors) {
+        BLT_Cardinal done = self->process_vectors(self, input, output, frame_count);
+        input       += done*ic;
+        output      += done*oc;
+        frame_count -= done;
+    }
+
+    /* remaining frames */
+    for (; frame_count; frame_count--) {
+        const float* coefficients = self->coefficients;
+        for (o=0; o<oc; o++) {
+            float sum = 0.0f;
+            for (i=0; i<ic; i++) {
+                sum += coefficients[i]*input[i];
+            }
+            output[o] = sum;
+            coefficients += ic;
+        }
+        input  += ic;
+        output += oc;
+    }
+}
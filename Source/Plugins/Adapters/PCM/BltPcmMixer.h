@@ -0,0 +1,95 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - Channel Mixer
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_PCM_MIXER_H_
+#define _BLT_PCM_MIXER_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#define BLT_PCM_MIXER_MAX_CHANNEL_COUNT 32
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Channel mixer, working on interleaved native-endian float samples.
+ * Each output channel is a weighted sum of the input channels.
+ */
+typedef struct PcmMixer PcmMixer;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates a mixer. A channel mask of 0 means the default layout for
+ * the channel count. If 'matrix' is not NULL, it is parsed as one row
+ * of coefficients per output channel, rows separated by ';' and
+ * coefficients by ',' or spaces. When it can't be parsed, or doesn't
+ * have the right dimensions, the standard matrix for the channel masks
+ * is used instead, which PcmMixer_HasCustomMatrix can tell.
+ * 'kernels' is a combination of BLT_PCM_KERNEL_XXX flags that restricts
+ * which vector code may be used.
+ */
+BLT_Result PcmMixer_Create(unsigned int input_channel_count,
+                           BLT_UInt32   input_channel_mask,
+                           unsigned int output_channel_count,
+                           BLT_UInt32   output_channel_mask,
+                           const char*  matrix,
+                           BLT_Flags    kernels,
+                           PcmMixer**   mixer);
+BLT_Result PcmMixer_Destroy(PcmMixer* self);
+
+/**
+ * Returns true if the mixer was created with these parameters.
+ */
+BLT_Boolean PcmMixer_Matches(PcmMixer*    self,
+                             unsigned int input_channel_count,
+                             BLT_UInt32   input_channel_mask,
+                             unsigned int output_channel_count,
+                             BLT_UInt32   output_channel_mask,
+                             const char*  matrix);
+
+BLT_Boolean PcmMixer_HasCustomMatrix(PcmMixer* self);
+
+/**
+ * Returns the channel mask of the output, or 0 if the layout is unknown.
+ */
+BLT_UInt32 PcmMixer_GetOutputChannelMask(PcmMixer* self);
+
+/**
+ * Mixes frame_count frames. The buffers must not overlap.
+ */
+void PcmMixer_Process(PcmMixer*    self,
+                      const float* input,
+                      float*       output,
+                      BLT_Cardinal frame_count);
+
+/**
+ * Returns the usual channel mask for a channel count, or 0 if there
+ * isn't one.
+ */
+BLT_UInt32 PcmMixer_GetDefaultChannelMask(unsigned int channel_count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_PCM_MIXER_H_ */
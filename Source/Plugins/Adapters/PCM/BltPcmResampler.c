@@ -0,0 +1,600 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - Sample Rate Converter
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltPcmAdapter.h"
+#include "BltPcmResampler.h"
+#include "BltPcmSimd.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/* above this many coefficients, the filter is stored with a fixed   */
+/* number of phases and interpolated between them, instead of having */
+/* one phase for each output position                                */
+#if !defined(BLT_CONFIG_PCM_RESAMPLER_MAX_EXACT_COEFFICIENTS)
+#define BLT_CONFIG_PCM_RESAMPLER_MAX_EXACT_COEFFICIENTS 262144
+#endif
+
+/* the filter gets longer when downsampling, up to this many taps */
+#define BLT_PCM_RESAMPLER_MAX_TAP_COUNT 1024
+
+#define BLT_PCM_RESAMPLER_PI 3.14159265358979323846
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef struct {
+    unsigned int tap_count;   /* filter length, when not downsampling */
+    unsigned int phase_count; /* phases stored when interpolating     */
+    double       beta;        /* Kaiser window parameter              */
+    double       cutoff;      /* relative to the lower Nyquist rate   */
+} PcmResamplerPreset;
+
+typedef float (*PcmResamplerDotProduct)(const float* x, const float* h, unsigned int count);
+
+struct PcmResampler {
+    BLT_UInt32   input_rate;
+    BLT_UInt32   output_rate;
+    unsigned int channel_count;
+    unsigned int quality;
+
+    /* the output advances by step/phase_count input frames per frame */
+    unsigned int step;
+    unsigned int phase_count;
+
+    /* filter bank: filter_phase_count+1 filters of tap_count taps */
+    unsigned int tap_count;
+    unsigned int filter_phase_count;
+    BLT_Boolean  interpolate;
+    float*       filters;
+    float*       coefficients;
+
+    /* the variant selected by the kernel flags */
+    PcmResamplerDotProduct dot_product;
+
+    /* input history, one buffer per channel */
+    float*       buffers;
+    BLT_Cardinal buffer_capacity;
+    BLT_Cardinal buffer_length;
+
+    /* position of the next output frame in the buffers */
+    BLT_Cardinal index;
+    unsigned int phase;
+};
+
+/*----------------------------------------------------------------------
+|   globals
++---------------------------------------------------------------------*/
+/* the cutoff puts the middle of the window's transition band just */
+/* below Nyquist, so aliasing stays under the stopband attenuation */
+static const PcmResamplerPreset PcmResamplerPresets[] = {
+    {  16,  32,  5.0, 0.800 }, /* BLT_PCM_ADAPTER_RESAMPLER_QUALITY_LOW    ~55dB */
+    {  32,  64,  7.0, 0.860 }, /* BLT_PCM_ADAPTER_RESAMPLER_QUALITY_MEDIUM ~70dB */
+    {  64, 256,  9.0, 0.910 }, /* BLT_PCM_ADAPTER_RESAMPLER_QUALITY_HIGH   ~90dB */
+    { 128, 512, 11.0, 0.945 }  /* BLT_PCM_ADAPTER_RESAMPLER_QUALITY_BEST  ~110dB */
+};
+
+/*----------------------------------------------------------------------
+|   PcmResampler_GreatestCommonDivisor
++---------------------------------------------------------------------*/
+static BLT_UInt32
+PcmResampler_GreatestCommonDivisor(BLT_UInt32 a, BLT_UInt32 b)
+{
+    while (b) {
+        BLT_UInt32 r = a%b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_BesselI0
++---------------------------------------------------------------------*/
+static double
+PcmResampler_BesselI0(double x)
+{
+    double sum  = 1.0;
+    double term = 1.0;
+    unsigned int k;
+
+    for (k=1; k<64; k++) {
+        double f = x/(2.0*k);
+        term *= f*f;
+        sum  += term;
+        if (term < sum*1e-14) break;
+    }
+
+    return sum;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_ComputeFilters
++---------------------------------------------------------------------*/
+static void
+PcmResampler_ComputeFilters(PcmResampler* self, double beta, double cutoff)
+{
+    double       half = (double)(self->tap_count/2);
+    double       i0_beta = PcmResampler_BesselI0(beta);
+    unsigned int p;
+
+    for (p=0; p<=self->filter_phase_count; p++) {
+        float*       filter = &self->filters[p*self->tap_count];
+        double       frac = (double)p/(double)self->filter_phase_count;
+        double       sum = 0.0;
+        unsigned int k;
+
+        /* tap k is applied to the input frame at (k-half+1) from the */
+        /* integer part of the output position                        */
+        for (k=0; k<self->tap_count; k++) {
+            double t = (double)k-half+1.0-frac;
+            double x = t/half;
+            double h;
+            if (x <= -1.0 || x >= 1.0) {
+                h = 0.0;
+            } else {
+                double w = PcmResampler_BesselI0(beta*sqrt(1.0-x*x))/i0_beta;
+                double s = cutoff*t;
+                h = cutoff*w;
+                if (s != 0.0) h *= sin(BLT_PCM_RESAMPLER_PI*s)/(BLT_PCM_RESAMPLER_PI*s);
+            }
+            filter[k] = (float)h;
+            sum += h;
+        }
+
+        /* normalize to unity gain at DC */
+        if (sum != 0.0) {
+            for (k=0; k<self->tap_count; k++) {
+                filter[k] = (float)(filter[k]/sum);
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_DotProduct
+|
+|   tap_count is always a multiple of 8
++---------------------------------------------------------------------*/
+static float
+PcmResampler_DotProduct(const float* x, const float* h, unsigned int count)
+{
+    float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+    unsigned int i;
+
+    for (i=0; i<count; i+=4) {
+        acc0 += x[i  ]*h[i  ];
+        acc1 += x[i+1]*h[i+1];
+        acc2 += x[i+2]*h[i+2];
+        acc3 += x[i+3]*h[i+3];
+    }
+    return (acc0+acc1)+(acc2+acc3);
+}
+
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+static float
+PcmResampler_DotProduct_SSE2(const float* x, const float* h, unsigned int count)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    float  result[4];
+    unsigned int i;
+
+    for (i=0; i<count; i+=8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x+i),   _mm_loadu_ps(h+i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x+i+4), _mm_loadu_ps(h+i+4)));
+    }
+    _mm_storeu_ps(result, _mm_add_ps(acc0, acc1));
+    return (result[0]+result[1])+(result[2]+result[3]);
+}
+#endif
+
+#if defined(BLT_PCM_SIMD_HAVE_AVX2)
+BLT_PCM_SIMD_AVX2_TARGET static float
+PcmResampler_DotProduct_AVX2(const float* x, const float* h, unsigned int count)
+{
+    __m256 acc = _mm256_setzero_ps();
+    __m128 sum;
+    float  result[4];
+    unsigned int i;
+
+    for (i=0; i<count; i+=8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(x+i), _mm256_loadu_ps(h+i)));
+    }
+    sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    _mm_storeu_ps(result, sum);
+    return (result[0]+result[1])+(result[2]+result[3]);
+}
+#endif
+
+#if defined(BLT_PCM_SIMD_HAVE_NEON)
+static float
+PcmResampler_DotProduct_NEON(const float* x, const float* h, unsigned int count)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc;
+    unsigned int i;
+
+    for (i=0; i<count; i+=8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(x+i),   vld1q_f32(h+i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(x+i+4), vld1q_f32(h+i+4));
+    }
+    acc = vaddq_f32(acc0, acc1);
+    return (vgetq_lane_f32(acc, 0)+vgetq_lane_f32(acc, 1))+
+           (vgetq_lane_f32(acc, 2)+vgetq_lane_f32(acc, 3));
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   PcmResampler_SelectDotProduct
++---------------------------------------------------------------------*/
+static PcmResamplerDotProduct
+PcmResampler_SelectDotProduct(BLT_Flags kernels)
+{
+    kernels &= BLT_Pcm_GetAvailableKernels();
+
+    /* pick the widest variant we are allowed to use */
+#if defined(BLT_PCM_SIMD_HAVE_AVX2)
+    if (kernels & BLT_PCM_KERNEL_AVX2) return PcmResampler_DotProduct_AVX2;
+#endif
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+    if (kernels & BLT_PCM_KERNEL_SSE2) return PcmResampler_DotProduct_SSE2;
+#endif
+#if defined(BLT_PCM_SIMD_HAVE_NEON)
+    if (kernels & BLT_PCM_KERNEL_NEON) return PcmResampler_DotProduct_NEON;
+#endif
+    return PcmResampler_DotProduct;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Create
++---------------------------------------------------------------------*/
+BLT_Result
+PcmResampler_Create(BLT_UInt32     input_rate,
+                    BLT_UInt32     output_rate,
+                    unsigned int   channel_count,
+                    unsigned int   quality,
+                    BLT_Flags      kernels,
+                    PcmResampler** resampler)
+{
+    const PcmResamplerPreset* preset;
+    PcmResampler*             self;
+    BLT_UInt32                gcd;
+    double                    cutoff;
+
+    /* default */
+    *resampler = NULL;
+
+    /* check parameters */
+    if (input_rate == 0 || output_rate == 0 || channel_count == 0) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+    if (quality >= sizeof(PcmResamplerPresets)/sizeof(PcmResamplerPresets[0])) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+    preset = &PcmResamplerPresets[quality];
+
+    /* allocate the object */
+    self = (PcmResampler*)ATX_AllocateZeroMemory(sizeof(PcmResampler));
+    if (self == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    self->input_rate    = input_rate;
+    self->output_rate   = output_rate;
+    self->channel_count = channel_count;
+    self->quality       = quality;
+    self->dot_product   = PcmResampler_SelectDotProduct(kernels);
+
+    /* reduce the conversion ratio */
+    gcd = PcmResampler_GreatestCommonDivisor(input_rate, output_rate);
+    self->step        = input_rate/gcd;
+    self->phase_count = output_rate/gcd;
+
+    /* when downsampling, the cutoff moves down, so the filter needs */
+    /* to be proportionally longer to keep the same transition band  */
+    self->tap_count = preset->tap_count;
+    cutoff = preset->cutoff;
+    if (self->step > self->phase_count) {
+        unsigned int factor = (self->step+self->phase_count-1)/self->phase_count;
+        self->tap_count *= factor;
+        if (self->tap_count > BLT_PCM_RESAMPLER_MAX_TAP_COUNT) {
+            self->tap_count = BLT_PCM_RESAMPLER_MAX_TAP_COUNT;
+        }
+        cutoff *= (double)self->phase_count/(double)self->step;
+    }
+
+    /* use one filter per phase if that's not too big */
+    if ((double)self->phase_count*(double)self->tap_count <=
+        (double)BLT_CONFIG_PCM_RESAMPLER_MAX_EXACT_COEFFICIENTS) {
+        self->filter_phase_count = self->phase_count;
+        self->interpolate        = BLT_FALSE;
+    } else {
+        self->filter_phase_count = preset->phase_count;
+        self->interpolate        = BLT_TRUE;
+    }
+
+    /* allocate the filters */
+    self->filters = (float*)ATX_AllocateMemory((self->filter_phase_count+1)*self->tap_count*sizeof(float));
+    self->coefficients = (float*)ATX_AllocateMemory(self->tap_count*sizeof(float));
+    if (self->filters == NULL || self->coefficients == NULL) {
+        PcmResampler_Destroy(self);
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+    PcmResampler_ComputeFilters(self, preset->beta, cutoff);
+
+    /* start empty */
+    PcmResampler_Reset(self);
+
+    *resampler = self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+PcmResampler_Destroy(PcmResampler* self)
+{
+    if (self == NULL) return BLT_SUCCESS;
+
+    if (self->filters)      ATX_FreeMemory(self->filters);
+    if (self->coefficients) ATX_FreeMemory(self->coefficients);
+    if (self->buffers)      ATX_FreeMemory(self->buffers);
+    ATX_FreeMemory(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Reset
++---------------------------------------------------------------------*/
+void
+PcmResampler_Reset(PcmResampler* self)
+{
+    /* the history starts with enough silence for the first output */
+    /* frame to be aligned with the first input frame              */
+    unsigned int lead = self->tap_count/2-1;
+    unsigned int c;
+
+    self->buffer_length = 0;
+    if (self->buffer_capacity >= lead) {
+        for (c=0; c<self->channel_count; c++) {
+            ATX_SetMemory(&self->buffers[c*self->buffer_capacity], 0, lead*sizeof(float));
+        }
+        self->buffer_length = lead;
+    }
+    self->index = lead;
+    self->phase = 0;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Matches
++---------------------------------------------------------------------*/
+BLT_Boolean
+PcmResampler_Matches(PcmResampler* self,
+                     BLT_UInt32    input_rate,
+                     BLT_UInt32    output_rate,
+                     unsigned int  channel_count,
+                     unsigned int  quality)
+{
+    return self->input_rate    == input_rate    &&
+           self->output_rate   == output_rate   &&
+           self->channel_count == channel_count &&
+           self->quality       == quality;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_GetMaxOutputFrames
++---------------------------------------------------------------------*/
+BLT_Cardinal
+PcmResampler_GetMaxOutputFrames(PcmResampler* self, BLT_Cardinal input_frames)
+{
+    /* frames between the current position and the end of the input */
+    double span = (double)self->tap_count/2+
+                  (double)self->buffer_length+
+                  (double)input_frames-
+                  (double)self->index;
+    return (BLT_Cardinal)(span*(double)self->phase_count/(double)self->step)+2;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Reserve
++---------------------------------------------------------------------*/
+static BLT_Result
+PcmResampler_Reserve(PcmResampler* self, BLT_Cardinal frames)
+{
+    BLT_Cardinal needed = self->buffer_length+frames;
+    float*       buffers;
+    unsigned int c;
+
+    if (needed <= self->buffer_capacity) return BLT_SUCCESS;
+
+    /* grow with some headroom, so that packets of a similar size */
+    /* don't cause a reallocation each time                       */
+    needed += needed/2;
+    buffers = (float*)ATX_AllocateMemory(needed*self->channel_count*sizeof(float));
+    if (buffers == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    for (c=0; c<self->channel_count; c++) {
+        if (self->buffer_length) {
+            ATX_CopyMemory(&buffers[c*needed],
+                           &self->buffers[c*self->buffer_capacity],
+                           self->buffer_length*sizeof(float));
+        }
+    }
+    if (self->buffers) ATX_FreeMemory(self->buffers);
+    self->buffers         = buffers;
+    self->buffer_capacity = needed;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Append
++---------------------------------------------------------------------*/
+static BLT_Result
+PcmResampler_Append(PcmResampler* self, const float* input, BLT_Cardinal frames)
+{
+    unsigned int c;
+    BLT_Result   result;
+
+    result = PcmResampler_Reserve(self, frames);
+    if (BLT_FAILED(result)) return result;
+
+    /* deinterleave, or pad with silence if there's no input */
+    for (c=0; c<self->channel_count; c++) {
+        float*       buffer = &self->buffers[c*self->buffer_capacity+self->buffer_length];
+        BLT_Cardinal i;
+        if (input) {
+            const float* source = input+c;
+            for (i=0; i<frames; i++) {
+                buffer[i] = *source;
+                source += self->channel_count;
+            }
+        } else {
+            ATX_SetMemory(buffer, 0, frames*sizeof(float));
+        }
+    }
+    self->buffer_length += frames;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Run
++---------------------------------------------------------------------*/
+static BLT_Cardinal
+PcmResampler_Run(PcmResampler* self, BLT_Cardinal end, float* output)
+{
+    unsigned int channel_count = self->channel_count;
+    unsigned int tap_count     = self->tap_count;
+    unsigned int lead          = tap_count/2-1;
+    unsigned int step_frames   = self->step/self->phase_count;
+    unsigned int step_phase    = self->step%self->phase_count;
+    BLT_Cardinal count         = 0;
+
+    /* compute output frames while their position is before 'end' */
+    while (self->index < end) {
+        const float* filter;
+        unsigned int c;
+
+        if (self->interpolate) {
+            /* blend the two nearest stored phases */
+            double       position = (double)self->phase*(double)self->filter_phase_count/
+                                    (double)self->phase_count;
+            unsigned int p = (unsigned int)position;
+            float        alpha = (float)(position-(double)p);
+            const float* f0 = &self->filters[p*tap_count];
+            const float* f1 = f0+tap_count;
+            unsigned int k;
+            for (k=0; k<tap_count; k++) {
+                self->coefficients[k] = f0[k]+alpha*(f1[k]-f0[k]);
+            }
+            filter = self->coefficients;
+        } else {
+            filter = &self->filters[self->phase*tap_count];
+        }
+
+        for (c=0; c<channel_count; c++) {
+            const float* x = &self->buffers[c*self->buffer_capacity+self->index-lead];
+            output[c] = self->dot_product(x, filter, tap_count);
+        }
+        output += channel_count;
+        ++count;
+
+        /* advance */
+        self->index += step_frames;
+        self->phase += step_phase;
+        if (self->phase >= self->phase_count) {
+            self->phase -= self->phase_count;
+            ++self->index;
+        }
+    }
+
+    /* drop the input that no future output frame will need */
+    if (self->index > lead) {
+        BLT_Cardinal drop = self->index-lead;
+        unsigned int c;
+        if (drop > self->buffer_length) drop = self->buffer_length;
+        for (c=0; c<channel_count; c++) {
+            float*       buffer = &self->buffers[c*self->buffer_capacity];
+            BLT_Cardinal i;
+            for (i=drop; i<self->buffer_length; i++) {
+                buffer[i-drop] = buffer[i];
+            }
+        }
+        self->buffer_length -= drop;
+        self->index         -= drop;
+    }
+
+    return count;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Process
++---------------------------------------------------------------------*/
+BLT_Result
+PcmResampler_Process(PcmResampler* self,
+                     const float*  input,
+                     BLT_Cardinal  input_frames,
+                     float*        output,
+                     BLT_Cardinal* output_frames)
+{
+    BLT_Result result;
+
+    /* default */
+    *output_frames = 0;
+
+    /* make sure the initial silence is there */
+    if (self->buffer_capacity == 0) {
+        result = PcmResampler_Reserve(self, input_frames+self->tap_count);
+        if (BLT_FAILED(result)) return result;
+        PcmResampler_Reset(self);
+    }
+
+    result = PcmResampler_Append(self, input, input_frames);
+    if (BLT_FAILED(result)) return result;
+
+    /* an output frame needs tap_count/2 frames after its position */
+    if (self->buffer_length >= self->tap_count/2) {
+        *output_frames = PcmResampler_Run(self, self->buffer_length-self->tap_count/2, output);
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   PcmResampler_Flush
++---------------------------------------------------------------------*/
+BLT_Result
+PcmResampler_Flush(PcmResampler* self,
+                   float*        output,
+                   BLT_Cardinal* output_frames)
+{
+    BLT_Cardinal end = self->buffer_length;
+    BLT_Result   result;
+
+    /* default */
+    *output_frames = 0;
+    if (self->buffer_capacity == 0) return BLT_SUCCESS;
+
+    /* pad with silence, and stop after the last input frame */
+    result = PcmResampler_Append(self, NULL, self->tap_count/2);
+    if (BLT_FAILED(result)) return result;
+    *output_frames = PcmResampler_Run(self, end, output);
+
+    PcmResampler_Reset(self);
+
+    return BLT_SUCCESS;
+}
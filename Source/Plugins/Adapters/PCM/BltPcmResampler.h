@@ -0,0 +1,94 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - Sample Rate Converter
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_PCM_RESAMPLER_H_
+#define _BLT_PCM_RESAMPLER_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Polyphase windowed-sinc sample rate converter, working on interleaved
+ * native-endian float samples. The converter keeps the tail of its input
+ * between calls, so a stream can be processed one packet at a time.
+ */
+typedef struct PcmResampler PcmResampler;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates a converter. quality is one of the
+ * BLT_PCM_ADAPTER_RESAMPLER_QUALITY_XXX values, and kernels a
+ * combination of BLT_PCM_KERNEL_XXX flags that restricts which vector
+ * code may be used (the portable code is used when none of them can).
+ */
+BLT_Result PcmResampler_Create(BLT_UInt32     input_rate,
+                               BLT_UInt32     output_rate,
+                               unsigned int   channel_count,
+                               unsigned int   quality,
+                               BLT_Flags      kernels,
+                               PcmResampler** resampler);
+BLT_Result PcmResampler_Destroy(PcmResampler* self);
+
+/**
+ * Returns the converter to its initial state, dropping any buffered input.
+ */
+void PcmResampler_Reset(PcmResampler* self);
+
+/**
+ * Returns true if the converter was created with these parameters.
+ */
+BLT_Boolean PcmResampler_Matches(PcmResampler* self,
+                                 BLT_UInt32    input_rate,
+                                 BLT_UInt32    output_rate,
+                                 unsigned int  channel_count,
+                                 unsigned int  quality);
+
+/**
+ * Returns the largest number of frames that a call to Process with
+ * input_frames frames, followed by a call to Flush, can produce.
+ */
+BLT_Cardinal PcmResampler_GetMaxOutputFrames(PcmResampler* self,
+                                             BLT_Cardinal  input_frames);
+
+/**
+ * Consumes input_frames frames and writes all the frames that can be
+ * computed so far to 'output'.
+ */
+BLT_Result PcmResampler_Process(PcmResampler* self,
+                                const float*  input,
+                                BLT_Cardinal  input_frames,
+                                float*        output,
+                                BLT_Cardinal* output_frames);
+
+/**
+ * Writes the frames that are still pending at the end of the stream to
+ * 'output', and resets the converter.
+ */
+BLT_Result PcmResampler_Flush(PcmResampler* self,
+                              float*        output,
+                              BLT_Cardinal* output_frames);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_PCM_RESAMPLER_H_ */
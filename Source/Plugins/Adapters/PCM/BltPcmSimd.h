@@ -0,0 +1,57 @@
+/*****************************************************************
+|
+|   PCM Adapter Module - SIMD Support
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_PCM_SIMD_H_
+#define _BLT_PCM_SIMD_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltPcm.h"
+
+/*----------------------------------------------------------------------
+|   SIMD support
+|
+|   the vector code of the resampler, mixer and ditherer is compiled
+|   under the same conditions as the sample conversion kernels, and
+|   selected at run time with the same BLT_PCM_KERNEL_XXX flags, so
+|   that it only runs when BLT_Pcm_GetAvailableKernels reports it
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_PCM_SIMD_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* AVX2 code is compiled for the target even when the rest of the */
+/* code isn't, and only used when the CPU supports it             */
+#if defined(BLT_PCM_SIMD_HAVE_SSE2)
+#if defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define BLT_PCM_SIMD_HAVE_AVX2
+#define BLT_PCM_SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && _MSC_VER >= 1700
+#define BLT_PCM_SIMD_HAVE_AVX2
+#define BLT_PCM_SIMD_AVX2_TARGET
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLT_PCM_SIMD_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
+#endif /* _BLT_PCM_SIMD_H_ */
@@ -160,6 +160,14 @@ BLT_Builtins_RegisterModules(BLT_Core* core)
     BLT_REGISTER_BUILTIN(GainControlFilter)
 #endif
 
+#if defined(BLT_CONFIG_MODULES_ENABLE_LOUDNESS_FILTER)
+    BLT_REGISTER_BUILTIN(LoudnessFilter)
+#endif
+
+#if defined(BLT_CONFIG_MODULES_ENABLE_EQUALIZER_FILTER)
+    BLT_REGISTER_BUILTIN(EqualizerFilter)
+#endif
+
 #if defined(BLT_CONFIG_MODULES_ENABLE_FINGERPRINT_FILTER)
     BLT_REGISTER_BUILTIN(FingerprintFilter)
 #endif
@@ -51,7 +51,7 @@ BLT_ReplayGain_SetStreamProperties(BLT_Stream*           stream,
                 case BLT_REPLAY_GAIN_SET_MODE_IGNORE:
                     break;
             }
-            switch (track_gain_mode) {
+            switch (album_gain_mode) {
                 case BLT_REPLAY_GAIN_SET_MODE_UPDATE:
                     property_value.data.integer = (ATX_Int32)(album_gain*100.0f);
                     ATX_Properties_SetProperty(properties,
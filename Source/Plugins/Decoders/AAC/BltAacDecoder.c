@@ -501,6 +501,13 @@ AacDecoderModule_Attach(BLT_Module* _self, BLT_Core* core)
         &self->mp4es_type_id);
     if (BLT_FAILED(result)) return result;
     
+    /* only probe us for mp4 audio elementary stream input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_PACKET,
+                                         self->mp4es_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("AacDecoderModule::Attach (" BLT_MP4_AUDIO_ES_MIME_TYPE " = %d)", self->mp4es_type_id);
 
     return BLT_SUCCESS;
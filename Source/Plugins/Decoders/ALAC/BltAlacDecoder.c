@@ -1043,6 +1043,13 @@ AlacDecoderModule_Attach(BLT_Module* _self, BLT_Core* core)
         &self->iso_base_es_type_id);
     if (BLT_FAILED(result)) return result;
     
+    /* only probe us for iso base audio elementary stream input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_PACKET,
+                                         self->iso_base_es_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("AlacDecoderModule::Attach (" BLT_ISO_BASE_AUDIO_ES_MIME_TYPE " = %d)", 
                    self->iso_base_es_type_id);
 
@@ -948,6 +948,13 @@ FlacDecoderModule_Attach(BLT_Module* _self, BLT_Core* core)
         &self->flac_type_id);
     if (BLT_FAILED(result)) return result;
     
+    /* only probe us for audio/x-flac input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_STREAM_PULL,
+                                         self->flac_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("FlacDecoderModule::Attach (audio/x-flac type = %d)", self->flac_type_id);
 
     return BLT_SUCCESS;
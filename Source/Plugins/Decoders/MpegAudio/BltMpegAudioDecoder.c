@@ -20,6 +20,7 @@
 #include "BltPcm.h"
 #include "BltPacketProducer.h"
 #include "BltPacketConsumer.h"
+#include "BltByteStreamProvider.h"
 #include "BltStream.h"
 #include "BltReplayGain.h"
 
@@ -57,9 +58,14 @@ typedef struct {
 
     /* members */
     BLT_Boolean      eos;
+    BLT_Boolean      float_samples;
     BLT_PcmMediaType media_type;
     BLT_TimeStamp    time_stamp;
     ATX_Int64        sample_count;
+    BLT_Cardinal     packet_duration;
+    BLT_MediaPacket* packet;
+    BLT_Size         packet_capacity;
+    BLT_Size         frame_size;
 } MpegAudioDecoderOutput;
 
 typedef struct {
@@ -87,6 +93,11 @@ typedef struct {
         unsigned int level;
         unsigned int layer;
     }                      mpeg_info;
+    struct {
+        BLT_Cardinal    granularity;
+        BLT_Boolean     attempted;
+        FLO_FrameIndex* index;
+    }                      seek_index;
 } MpegAudioDecoder;
 
 /*----------------------------------------------------------------------
@@ -98,6 +109,18 @@ typedef struct {
 #define BLT_BITRATE_AVERAGING_LONG_WINDOW     4096
 #define BLT_BITRATE_AVERAGING_PRECISION       4000
 
+#define BLT_MPEG_AUDIO_DECODER_MAX_PACKET_DURATION 1000 /* ms */
+
+#if !defined(BLT_CONFIG_MPEG_AUDIO_DECODER_DEFAULT_PACKET_DURATION)
+#define BLT_CONFIG_MPEG_AUDIO_DECODER_DEFAULT_PACKET_DURATION 0 /* ms */
+#endif
+
+#define BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_SCAN_BUFFER_SIZE 65536
+
+#if !defined(BLT_CONFIG_MPEG_AUDIO_DECODER_DEFAULT_SEEK_INDEX_GRANULARITY)
+#define BLT_CONFIG_MPEG_AUDIO_DECODER_DEFAULT_SEEK_INDEX_GRANULARITY 0 /* samples */
+#endif
+
 /*----------------------------------------------------------------------
 |   forward declarations
 +---------------------------------------------------------------------*/
@@ -205,8 +228,13 @@ MpegAudioDecoder_UpdateInfo(MpegAudioDecoder* self,
         BLT_PcmMediaType_Init(&self->output.media_type);
         self->output.media_type.channel_count   = (BLT_UInt16)frame_info->channel_count;
         self->output.media_type.sample_rate     = frame_info->sample_rate;
-        self->output.media_type.bits_per_sample = 16;
-        self->output.media_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE;
+        if (self->output.float_samples) {
+            self->output.media_type.bits_per_sample = 32;
+            self->output.media_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+        } else {
+            self->output.media_type.bits_per_sample = 16;
+            self->output.media_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE;
+        }
         
         {
             BLT_StreamInfo info;
@@ -427,26 +455,74 @@ MpegAudioDecoder_UpdateReplayGainInfo(MpegAudioDecoder*  self,
     }
 }
 
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_GetFramesPerPacket
++---------------------------------------------------------------------*/
+static BLT_Cardinal
+MpegAudioDecoder_GetFramesPerPacket(MpegAudioDecoder* self,
+                                    FLO_FrameInfo*    frame_info)
+{
+    BLT_Cardinal frame_count;
+    ATX_UInt64   target;
+
+    if (self->output.packet_duration == 0 ||
+        frame_info->sample_count     == 0 ||
+        frame_info->sample_rate      == 0) {
+        return 1;
+    }
+
+    /* round to the nearest number of frames */
+    target = ((ATX_UInt64)self->output.packet_duration*frame_info->sample_rate)/1000;
+    frame_count = (BLT_Cardinal)((target+frame_info->sample_count/2)/frame_info->sample_count);
+
+    return frame_count ? frame_count : 1;
+}
+
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_PacketIsComplete
++---------------------------------------------------------------------*/
+static BLT_Boolean
+MpegAudioDecoder_PacketIsComplete(MpegAudioDecoder* self)
+{
+    /* the packet is complete when the next frame would not fit */
+    return self->output.packet != NULL &&
+           BLT_MediaPacket_GetPayloadSize(self->output.packet) + 
+           self->output.frame_size > self->output.packet_capacity;
+}
+
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_ReleasePacket
++---------------------------------------------------------------------*/
+static void
+MpegAudioDecoder_ReleasePacket(MpegAudioDecoder* self)
+{
+    if (self->output.packet) {
+        BLT_MediaPacket_Release(self->output.packet);
+        self->output.packet = NULL;
+    }
+}
+
 /*----------------------------------------------------------------------
 |   MpegAudioDecoder_DecodeFrame
+|
+|   Decodes the next frame at the end of the current output packet,
+|   creating the packet if needed.
 +---------------------------------------------------------------------*/
 static BLT_Result
-MpegAudioDecoder_DecodeFrame(MpegAudioDecoder* self,
-                             BLT_MediaPacket** packet)
+MpegAudioDecoder_DecodeFrame(MpegAudioDecoder* self)
 {
     FLO_SampleBuffer   sample_buffer;
     FLO_FrameInfo      frame_info;        
     FLO_DecoderStatus* fluo_status;
     FLO_Cardinal       samples_skipped = 0;
+    BLT_Size           payload_size;
+    unsigned char*     payload;
     FLO_Result         result;
     
     /* try to find a frame */
     result = FLO_Decoder_FindFrame(self->fluo, &frame_info);
     if (FLO_FAILED(result)) return result;
 
-    /* setup default return value */
-    *packet = NULL;
-
     /* update the stream info */
     result = MpegAudioDecoder_UpdateInfo(self, &frame_info);
     if (BLT_FAILED(result)) return result;
@@ -462,18 +538,29 @@ MpegAudioDecoder_DecodeFrame(MpegAudioDecoder* self,
     /* update the replay gain info */
     MpegAudioDecoder_UpdateReplayGainInfo(self, fluo_status);
 
-    /* get a packet from the core */
-    sample_buffer.size = frame_info.sample_count*frame_info.channel_count*2;
-    result = BLT_Core_CreateMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
-                                        sample_buffer.size,
-                                        (const BLT_MediaType*)&self->output.media_type,
-                                        packet);
-    if (BLT_FAILED(result)) return result;
-
-    /* get the address of the packet payload */
-    sample_buffer.samples = BLT_MediaPacket_GetPayloadBuffer(*packet);
+    /* get a packet from the core, or make room in the current one */
+    self->output.frame_size = frame_info.sample_count*frame_info.channel_count*
+                              (self->output.media_type.bits_per_sample/8);
+    if (self->output.packet == NULL) {
+        self->output.packet_capacity = self->output.frame_size*
+            MpegAudioDecoder_GetFramesPerPacket(self, &frame_info);
+        result = BLT_Core_CreateMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
+                                            self->output.packet_capacity,
+                                            (const BLT_MediaType*)&self->output.media_type,
+                                            &self->output.packet);
+        if (BLT_FAILED(result)) return result;
+        payload_size = 0;
+    } else {
+        payload_size = BLT_MediaPacket_GetPayloadSize(self->output.packet);
+        result = BLT_MediaPacket_SetAllocatedSize(self->output.packet, 
+                                                  payload_size+self->output.frame_size);
+        if (BLT_FAILED(result)) return result;
+    }
 
-    /* decode the frame */
+    /* decode the frame after what the packet already holds */
+    payload = (unsigned char*)BLT_MediaPacket_GetPayloadBuffer(self->output.packet)+payload_size;
+    sample_buffer.size    = self->output.frame_size;
+    sample_buffer.samples = payload;
     result = FLO_Decoder_DecodeFrame(self->fluo, 
                                      &sample_buffer,
                                      &samples_skipped);
@@ -486,43 +573,40 @@ MpegAudioDecoder_DecodeFrame(MpegAudioDecoder* self,
             FLO_Decoder_Reset(self->fluo, FLO_TRUE);
         }
 
-        /* release the packet */
-        BLT_MediaPacket_Release(*packet);
-        *packet = NULL;
+        /* don't keep an empty packet */
+        if (payload_size == 0) MpegAudioDecoder_ReleasePacket(self);
         return result;
     }
 
-    /* adjust for skipped samples */
-    if (samples_skipped) {
-        BLT_Offset offset = samples_skipped*sample_buffer.format.channel_count*2;
-        BLT_MediaPacket_SetPayloadWindow(*packet, offset, sample_buffer.size);
-    } else {
-        /* set the packet payload size */
-        BLT_MediaPacket_SetPayloadSize(*packet, sample_buffer.size);
+    /* skipped samples are at the start of the frame, move the rest down */
+    /* (this is rare, and a forward copy is safe with overlapping ranges) */
+    if (samples_skipped && (unsigned char*)sample_buffer.samples != payload) {
+        const unsigned char* source = (const unsigned char*)sample_buffer.samples;
+        BLT_Size             i;
+        for (i = 0; i < sample_buffer.size; i++) payload[i] = source[i];
     }
+    BLT_MediaPacket_SetPayloadSize(self->output.packet, payload_size+sample_buffer.size);
 
     /* update the sample count */
     self->output.sample_count = fluo_status->sample_count;
 
-    /* set start of stream packet flags */
-    {
-        if (self->output.sample_count == 0) {
-            BLT_MediaPacket_SetFlags(*packet, 
-                                     BLT_MEDIA_PACKET_FLAG_START_OF_STREAM);
-        }
-    }
-
-    /* update the timestamp */
+    /* update the timestamp, which is the position after the last */
+    /* sample of the packet, as when each frame has its own packet */
     if (frame_info.channel_count             != 0 && 
         frame_info.sample_rate               != 0 &&
         sample_buffer.format.bits_per_sample != 0) {
-        /* compute time stamp */
         self->output.time_stamp = 
             BLT_TimeStamp_FromSamples(self->output.sample_count,
                                       frame_info.sample_rate);
-        BLT_MediaPacket_SetTimeStamp(*packet, self->output.time_stamp);
+        BLT_MediaPacket_SetTimeStamp(self->output.packet, self->output.time_stamp);
     } 
 
+    /* set start of stream packet flags */
+    if (payload_size == 0 && self->output.sample_count == 0) {
+        BLT_MediaPacket_SetFlags(self->output.packet, 
+                                 BLT_MEDIA_PACKET_FLAG_START_OF_STREAM);
+    }
+
     return BLT_SUCCESS;
 }
 
@@ -550,8 +634,23 @@ MpegAudioDecoderOutput_GetPacket(BLT_PacketProducer* _self,
 
     do {
         /* try to decode a frame */
-        result = MpegAudioDecoder_DecodeFrame(self, packet);
-        if (BLT_SUCCEEDED(result)) return BLT_SUCCESS;
+        result = MpegAudioDecoder_DecodeFrame(self);
+        if (BLT_SUCCEEDED(result)) {
+            if (MpegAudioDecoder_PacketIsComplete(self)) {
+                *packet = self->output.packet;
+                self->output.packet = NULL;
+                return BLT_SUCCESS;
+            }
+
+            /* keep filling the same packet */
+            try_again = BLT_TRUE;
+            continue;
+        }
+        if (result == FLO_ERROR_SAMPLES_SKIPPED) {
+            /* the whole frame was skipped (after a seek), go to the next one */
+            try_again = BLT_TRUE;
+            continue;
+        }
         if (FLO_ERROR_IS_FATAL(result)) {
             return result;
         }             
@@ -602,9 +701,14 @@ MpegAudioDecoderOutput_GetPacket(BLT_PacketProducer* _self,
         } 
     } while (try_again);
 
-    /* if we've reached the end of stream, generate an empty packet with */
-    /* a flag to indicate that situation                                 */
+    /* if we've reached the end of stream, return what's left, and then */
+    /* generate an empty packet with a flag to indicate that situation   */
     if (self->input.eos) {
+        if (self->output.packet) {
+            *packet = self->output.packet;
+            self->output.packet = NULL;
+            return BLT_SUCCESS;
+        }
         result = BLT_Core_CreateMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
                                             0,
                                             (const BLT_MediaType*)&self->output.media_type,
@@ -668,6 +772,8 @@ MpegAudioDecoder_SetupPorts(MpegAudioDecoder* self)
     BLT_PcmMediaType_Init(&self->output.media_type);
     self->output.sample_count = 0;
     BLT_TimeStamp_Set(self->output.time_stamp, 0, 0);
+    self->output.packet_duration = BLT_CONFIG_MPEG_AUDIO_DECODER_DEFAULT_PACKET_DURATION;
+    self->output.packet = NULL;
 
     return BLT_SUCCESS;
 }
@@ -719,6 +825,41 @@ MpegAudioDecoder_Create(BLT_Module*              module,
         return result;
     }
 
+    /* produce floating point samples when the float pipeline is enabled */
+    if (BLT_Pcm_IsFloatPipelineEnabled(core) &&
+        FLO_SUCCEEDED(FLO_Decoder_SetSampleType(self->fluo, 
+                                                FLO_SAMPLE_TYPE_INTERLACED_FLOAT))) {
+        self->output.float_samples = BLT_TRUE;
+    }
+
+    /* get the output packet duration and the seek index granularity */
+    self->seek_index.granularity = BLT_CONFIG_MPEG_AUDIO_DECODER_DEFAULT_SEEK_INDEX_GRANULARITY;
+    {
+        ATX_Properties* properties = NULL;
+        if (BLT_SUCCEEDED(BLT_Core_GetProperties(core, &properties)) && properties) {
+            ATX_PropertyValue property;
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties, 
+                                                         BLT_MPEG_AUDIO_DECODER_PACKET_DURATION_PROPERTY,
+                                                         &property)) &&
+                property.type == ATX_PROPERTY_VALUE_TYPE_INTEGER &&
+                property.data.integer >= 0) {
+                self->output.packet_duration = property.data.integer;
+            }
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties, 
+                                                         BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_GRANULARITY_PROPERTY,
+                                                         &property)) &&
+                property.type == ATX_PROPERTY_VALUE_TYPE_INTEGER &&
+                property.data.integer >= 0) {
+                self->seek_index.granularity = property.data.integer;
+            }
+        }
+        if (self->output.packet_duration > BLT_MPEG_AUDIO_DECODER_MAX_PACKET_DURATION) {
+            self->output.packet_duration = BLT_MPEG_AUDIO_DECODER_MAX_PACKET_DURATION;
+        }
+        ATX_LOG_FINE_1("MpegAudioDecoder::Create - packet duration = %d ms", 
+                       (int)self->output.packet_duration);
+    }
+
     /* setup interfaces */
     ATX_SET_INTERFACE_EX(self, MpegAudioDecoder, BLT_BaseMediaNode, BLT_MediaNode);
     ATX_SET_INTERFACE_EX(self, MpegAudioDecoder, BLT_BaseMediaNode, ATX_Referenceable);
@@ -751,7 +892,13 @@ MpegAudioDecoder_Destroy(MpegAudioDecoder* self)
         item = ATX_ListItem_GetNext(item);
     }
     ATX_List_Destroy(self->input.packets);
+
+    /* release the packet we were filling */
+    MpegAudioDecoder_ReleasePacket(self);
     
+    /* destroy the seek index */
+    if (self->seek_index.index) FLO_FrameIndex_Destroy(self->seek_index.index);
+
     /* destroy the fluo decoder */
     FLO_Decoder_Destroy(self->fluo);
     
@@ -786,6 +933,236 @@ MpegAudioDecoder_GetPortByName(BLT_MediaNode*  _self,
     }
 }
 
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_GetInputStream
+|
+|   Gets the byte stream from which the previous node reads the packets
+|   it sends us, which is also the one it seeks in.
++---------------------------------------------------------------------*/
+static BLT_Result
+MpegAudioDecoder_GetInputStream(MpegAudioDecoder* self, ATX_InputStream** stream)
+{
+    BLT_Stream*              context    = ATX_BASE(self, BLT_BaseMediaNode).context;
+    BLT_MediaNode*           me         = &ATX_BASE_EX(self, BLT_BaseMediaNode, BLT_MediaNode);
+    BLT_MediaNode*           node       = NULL;
+    BLT_MediaNode*           packetizer = NULL;
+    BLT_MediaNode*           source     = NULL;
+    BLT_MediaPort*           port       = NULL;
+    BLT_InputStreamProvider* provider;
+    BLT_StreamNodeInfo       info;
+    BLT_Result               result;
+
+    /* default return value */
+    *stream = NULL;
+
+    /* find the two nodes before this one */
+    BLT_Stream_GetFirstNode(context, &node);
+    while (node && node != me) {
+        source     = packetizer;
+        packetizer = node;
+        BLT_Stream_GetNextNode(context, node, &node);
+    }
+    if (node == NULL || source == NULL) return BLT_FAILURE;
+
+    /* the previous node must read from a byte stream */
+    result = BLT_Stream_GetStreamNodeInfo(context, packetizer, &info);
+    if (BLT_FAILED(result)) return result;
+    if (info.input.protocol != BLT_MEDIA_PORT_PROTOCOL_STREAM_PULL) {
+        return BLT_FAILURE;
+    }
+
+    /* get the stream from the node that provides it */
+    result = BLT_MediaNode_GetPortByName(source, "output", &port);
+    if (BLT_FAILED(result)) return result;
+    provider = ATX_CAST(port, BLT_InputStreamProvider);
+    if (provider == NULL) return BLT_FAILURE;
+
+    return BLT_InputStreamProvider_GetStream(provider, stream);
+}
+
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_LoadSeekIndex
++---------------------------------------------------------------------*/
+static BLT_Result
+MpegAudioDecoder_LoadSeekIndex(MpegAudioDecoder* self, 
+                               BLT_CString       cache_file, 
+                               ATX_LargeSize     stream_size)
+{
+    ATX_DataBuffer* buffer = NULL;
+    FLO_FrameIndex* index  = NULL;
+    BLT_Result      result;
+
+    result = ATX_LoadFile(cache_file, &buffer);
+    if (ATX_FAILED(result)) return result;
+    result = FLO_FrameIndex_Deserialize(ATX_DataBuffer_GetData(buffer),
+                                        ATX_DataBuffer_GetDataSize(buffer),
+                                        &index);
+    ATX_DataBuffer_Destroy(buffer);
+    if (FLO_FAILED(result)) return result;
+
+    /* the index is stale if the stream has changed */
+    if (FLO_FrameIndex_GetStreamSize(index) != stream_size) {
+        FLO_FrameIndex_Destroy(index);
+        return BLT_FAILURE;
+    }
+    self->seek_index.index = index;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_SaveSeekIndex
++---------------------------------------------------------------------*/
+static BLT_Result
+MpegAudioDecoder_SaveSeekIndex(MpegAudioDecoder* self, BLT_CString cache_file)
+{
+    BLT_Size          size   = FLO_FrameIndex_GetSerializedSize(self->seek_index.index);
+    unsigned char*    buffer = NULL;
+    ATX_File*         file   = NULL;
+    ATX_OutputStream* stream = NULL;
+    BLT_Result        result;
+
+    /* serialize the index */
+    buffer = ATX_AllocateMemory(size);
+    if (buffer == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    result = FLO_FrameIndex_Serialize(self->seek_index.index, buffer, size);
+    if (FLO_FAILED(result)) goto end;
+
+    /* write it to the file */
+    result = ATX_File_Create(cache_file, &file);
+    if (ATX_FAILED(result)) goto end;
+    result = ATX_File_Open(file, 
+                           ATX_FILE_OPEN_MODE_WRITE  |
+                           ATX_FILE_OPEN_MODE_CREATE |
+                           ATX_FILE_OPEN_MODE_TRUNCATE);
+    if (ATX_FAILED(result)) goto end;
+    result = ATX_File_GetOutputStream(file, &stream);
+    if (ATX_FAILED(result)) goto end;
+    result = ATX_OutputStream_WriteFully(stream, buffer, size);
+
+end:
+    ATX_RELEASE_OBJECT(stream);
+    if (file) ATX_DESTROY_OBJECT(file);
+    ATX_FreeMemory(buffer);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_ScanSeekIndex
++---------------------------------------------------------------------*/
+static BLT_Result
+MpegAudioDecoder_ScanSeekIndex(MpegAudioDecoder* self, ATX_InputStream* stream)
+{
+    unsigned char*  buffer;
+    FLO_FrameIndex* index = NULL;
+    BLT_Result      result;
+
+    /* read the stream from the start */
+    result = ATX_InputStream_Seek(stream, 0);
+    if (ATX_FAILED(result)) return result;
+    buffer = ATX_AllocateMemory(BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_SCAN_BUFFER_SIZE);
+    if (buffer == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    result = FLO_FrameIndex_Create(self->seek_index.granularity, &index);
+    if (FLO_FAILED(result)) goto end;
+
+    /* feed everything to the index */
+    do {
+        ATX_Size  bytes_read = 0;
+        FLO_Flags flags = 0;
+        result = ATX_InputStream_Read(stream, 
+                                      buffer, 
+                                      BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_SCAN_BUFFER_SIZE,
+                                      &bytes_read);
+        if (result == BLT_ERROR_EOS) {
+            flags = FLO_DECODER_BUFFER_IS_END_OF_STREAM;
+        } else if (BLT_FAILED(result)) {
+            goto end;
+        }
+        result = FLO_FrameIndex_Feed(index, buffer, bytes_read, flags);
+        if (FLO_FAILED(result)) goto end;
+    } while (!FLO_FrameIndex_IsComplete(index));
+
+    self->seek_index.index = index;
+    index = NULL;
+
+end:
+    if (index) FLO_FrameIndex_Destroy(index);
+    ATX_FreeMemory(buffer);
+
+    return result;
+}
+
+/*----------------------------------------------------------------------
+|   MpegAudioDecoder_BuildSeekIndex
++---------------------------------------------------------------------*/
+static void
+MpegAudioDecoder_BuildSeekIndex(MpegAudioDecoder* self)
+{
+    BLT_Stream*       context    = ATX_BASE(self, BLT_BaseMediaNode).context;
+    ATX_InputStream*  stream     = NULL;
+    ATX_LargeSize     size       = 0;
+    ATX_Properties*   properties = NULL;
+    ATX_PropertyValue cache_file;
+    BLT_StreamInfo    info;
+    BLT_Result        result;
+
+    /* only try once */
+    self->seek_index.attempted = BLT_TRUE;
+
+    /* a continuous stream, like a radio, has no end to scan to */
+    if (BLT_SUCCEEDED(BLT_Stream_GetInfo(context, &info)) &&
+        (info.flags & BLT_STREAM_INFO_FLAG_CONTINUOUS)) {
+        ATX_LOG_FINE("MpegAudioDecoder::BuildSeekIndex - continuous stream");
+        return;
+    }
+
+    /* we need a stream of known size */
+    result = MpegAudioDecoder_GetInputStream(self, &stream);
+    if (BLT_FAILED(result)) {
+        ATX_LOG_FINE("MpegAudioDecoder::BuildSeekIndex - no input stream");
+        return;
+    }
+    if (ATX_FAILED(ATX_InputStream_GetSize(stream, &size)) || size == 0) {
+        ATX_LOG_FINE("MpegAudioDecoder::BuildSeekIndex - unknown stream size");
+        ATX_RELEASE_OBJECT(stream);
+        return;
+    }
+
+    /* see if we have a cache file */
+    cache_file.type = ATX_PROPERTY_VALUE_TYPE_STRING;
+    cache_file.data.string = NULL;
+    if (BLT_SUCCEEDED(BLT_Stream_GetProperties(context, &properties)) && properties) {
+        if (ATX_FAILED(ATX_Properties_GetProperty(properties,
+                                                  BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_CACHE_FILE_PROPERTY,
+                                                  &cache_file)) ||
+            cache_file.type != ATX_PROPERTY_VALUE_TYPE_STRING) {
+            cache_file.data.string = NULL;
+        }
+    }
+
+    /* load the index from the cache, or scan the stream */
+    if (cache_file.data.string &&
+        BLT_SUCCEEDED(MpegAudioDecoder_LoadSeekIndex(self, cache_file.data.string, size))) {
+        ATX_LOG_FINE_1("MpegAudioDecoder::BuildSeekIndex - loaded from %s", cache_file.data.string);
+    } else {
+        result = MpegAudioDecoder_ScanSeekIndex(self, stream);
+        if (BLT_SUCCEEDED(result)) {
+            ATX_LOG_FINE("MpegAudioDecoder::BuildSeekIndex - stream scanned");
+            if (cache_file.data.string) {
+                result = MpegAudioDecoder_SaveSeekIndex(self, cache_file.data.string);
+                if (BLT_FAILED(result)) {
+                    ATX_LOG_FINE_1("MpegAudioDecoder::BuildSeekIndex - cannot write cache (%d)", result);
+                }
+            }
+        } else {
+            ATX_LOG_FINE_1("MpegAudioDecoder::BuildSeekIndex - scan failed (%d)", result);
+        }
+    }
+
+    ATX_RELEASE_OBJECT(stream);
+}
+
 /*----------------------------------------------------------------------
 |    MpegAudioDecoder_Seek
 +---------------------------------------------------------------------*/
@@ -799,6 +1176,9 @@ MpegAudioDecoder_Seek(BLT_MediaNode* _self,
     /* flush pending input packets */
     MpegAudioDecoderInput_Flush(self);
 
+    /* drop what we have decoded so far */
+    MpegAudioDecoder_ReleasePacket(self);
+
     /* clear the eos flag */
     self->input.eos  = BLT_FALSE;
     self->output.eos = BLT_FALSE;
@@ -819,6 +1199,23 @@ MpegAudioDecoder_Seek(BLT_MediaNode* _self,
     self->output.time_stamp = point->time_stamp;
     FLO_Decoder_SetSample(self->fluo, point->sample);
 
+    /* with a seek index, start at an exact frame and skip to the sample */
+    if (self->seek_index.granularity && !self->seek_index.attempted) {
+        MpegAudioDecoder_BuildSeekIndex(self);
+    }
+    if (self->seek_index.index) {
+        FLO_UInt64   offset;
+        FLO_Cardinal samples_to_skip;
+        if (FLO_SUCCEEDED(FLO_FrameIndex_Lookup(self->seek_index.index, 
+                                                point->sample, 
+                                                &offset, 
+                                                &samples_to_skip))) {
+            point->offset = offset;
+            point->mask |= BLT_SEEK_POINT_MASK_OFFSET;
+            FLO_Decoder_SkipSamples(self->fluo, samples_to_skip);
+        }
+    }
+
     return BLT_SUCCESS;
 }
 
@@ -919,6 +1316,13 @@ MpegAudioDecoderModule_Attach(BLT_Module* _self, BLT_Core* core)
                                    BLT_REGISTRY_NAME_CATEGORY_MEDIA_TYPE_IDS,
                                    "audio/x-mpeg3", self->mpeg_audio_type_id);
 
+    /* only probe us for audio/mpeg input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_PACKET,
+                                         self->mpeg_audio_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("MpegAudioDecoderModule::Attach (audio/mpeg type = %d)", self->mpeg_audio_type_id);
 
     return BLT_SUCCESS;
@@ -27,6 +27,39 @@
 #include "BltTypes.h"
 #include "BltModule.h"
 
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/**
+ * Core property: target duration, in milliseconds, of the PCM packets
+ * produced by the decoder (integer). Consecutive MPEG frames are decoded
+ * into the same packet until it is reached. 0 produces one packet per
+ * frame, for the lowest latency.
+ */
+#define BLT_MPEG_AUDIO_DECODER_PACKET_DURATION_PROPERTY "Plugins.MpegAudioDecoder.PacketDuration"
+
+/**
+ * Core property: granularity, in samples, of the seek index (integer).
+ * When not 0, the first seek scans the frame headers of the whole input
+ * to build an index of the frame offsets, and all seeks then start at an
+ * exact frame and are sample accurate. This requires the decoder to be
+ * fed from a seekable byte stream of known size, and is skipped for
+ * continuous streams. The scan runs synchronously inside that first seek
+ * and reads the input to the end, so with a network input the seek waits
+ * until the whole input has been downloaded. Only set this for local
+ * inputs, or with a cache file that already holds the index (see below).
+ * 0 disables the index.
+ */
+#define BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_GRANULARITY_PROPERTY "Plugins.MpegAudioDecoder.SeekIndex.Granularity"
+
+/**
+ * Stream property: name of a file used to cache the seek index (string).
+ * When the file holds the index of an input of the same size, it is loaded
+ * instead of scanning the input again. Otherwise, it is written after the
+ * input has been scanned.
+ */
+#define BLT_MPEG_AUDIO_DECODER_SEEK_INDEX_CACHE_FILE_PROPERTY "Plugins.MpegAudioDecoder.SeekIndex.CacheFile"
+
 /*----------------------------------------------------------------------
 |   module
 +---------------------------------------------------------------------*/
@@ -67,6 +67,7 @@ typedef struct {
     ATX_IMPLEMENTS(BLT_PacketProducer);
 
     /* members */
+    BLT_Boolean      float_samples;
     BLT_PcmMediaType media_type;
     BLT_Cardinal     packet_count;
     ATX_Int64        sample_count;
@@ -239,8 +240,13 @@ VorbisDecoder_OpenStream(VorbisDecoder* self)
     self->output.media_type.sample_rate     = (BLT_UInt32)info->rate;
     self->output.media_type.channel_count   = info->channels;
     self->output.media_type.channel_mask    = 0;
-    self->output.media_type.bits_per_sample = 16;
-    self->output.media_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE;
+    if (self->output.float_samples) {
+        self->output.media_type.bits_per_sample = 32;
+        self->output.media_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+    } else {
+        self->output.media_type.bits_per_sample = 16;
+        self->output.media_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE;
+    }
 
     /* update the stream info */
     if (ATX_BASE(self, BLT_BaseMediaNode).context) {
@@ -417,6 +423,41 @@ ATX_BEGIN_INTERFACE_MAP(VorbisDecoderInput, BLT_MediaPort)
     BLT_MediaPort_DefaultQueryMediaType
 ATX_END_INTERFACE_MAP
 
+#if !defined(BLT_CONFIG_VORBIS_USE_TREMOR)
+/*----------------------------------------------------------------------
+|    VorbisDecoder_ReadFloat
+|
+|    Same as ov_read, but with interleaved native-endian float samples
++---------------------------------------------------------------------*/
+static long
+VorbisDecoder_ReadFloat(VorbisDecoder* self, float* buffer, int* current_section)
+{
+    unsigned int channel_count = self->output.media_type.channel_count;
+    float**      pcm;
+    long         frame_count;
+    long         i;
+    unsigned int c;
+
+    if (channel_count == 0) return OV_EINVAL;
+    frame_count = ov_read_float(&self->input.vorbis_file,
+                                &pcm,
+                                BLT_VORBIS_DECODER_PACKET_SIZE/(4*channel_count),
+                                current_section);
+    if (frame_count <= 0) return frame_count;
+
+    /* interleave the channels */
+    for (c = 0; c < channel_count; c++) {
+        const float* in  = pcm[c];
+        float*       out = buffer+c;
+        for (i = 0; i < frame_count; i++, out += channel_count) {
+            *out = in[i];
+        }
+    }
+
+    return frame_count*4*channel_count;
+}
+#endif
+
 /*----------------------------------------------------------------------
 |    VorbisDecoderOutput_GetPacket
 +---------------------------------------------------------------------*/
@@ -454,10 +495,16 @@ VorbisDecoderOutput_GetPacket(BLT_PacketProducer* _self,
                              BLT_VORBIS_DECODER_PACKET_SIZE,
                              &current_section);
 #else
-        bytes_read = ov_read(&self->input.vorbis_file,
-                             buffer,
-                             BLT_VORBIS_DECODER_PACKET_SIZE,
-                             0, 2, 1, &current_section);
+        if (self->output.float_samples) {
+            bytes_read = VorbisDecoder_ReadFloat(self, 
+                                                 (float*)buffer, 
+                                                 &current_section);
+        } else {
+            bytes_read = ov_read(&self->input.vorbis_file,
+                                 buffer,
+                                 BLT_VORBIS_DECODER_PACKET_SIZE,
+                                 0, 2, 1, &current_section);
+        }
 #endif
     } while (bytes_read == OV_HOLE);
     if (bytes_read == 0) {
@@ -566,6 +613,10 @@ VorbisDecoder_Create(BLT_Module*              module,
     /* construct the object */
     decoder->input.media_type_id = ATX_SELF_EX_O(module, VorbisDecoderModule, BLT_BaseModule, BLT_Module)->ogg_type_id;
     BLT_PcmMediaType_Init(&decoder->output.media_type);
+#if !defined(BLT_CONFIG_VORBIS_USE_TREMOR)
+    /* tremor only decodes to integers, libvorbis can produce floats */
+    decoder->output.float_samples = BLT_Pcm_IsFloatPipelineEnabled(core);
+#endif
 
     /* setup interfaces */
     ATX_SET_INTERFACE_EX(decoder, VorbisDecoder, BLT_BaseMediaNode, BLT_MediaNode);
@@ -749,6 +800,13 @@ VorbisDecoderModule_Attach(BLT_Module* _self, BLT_Core* core)
         &self->ogg_type_id);
     if (BLT_FAILED(result)) return result;
     
+    /* only probe us for application/ogg input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_STREAM_PULL,
+                                         self->ogg_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("VorbisDecoderModule::Attach (application/ogg type = %d)", self->ogg_type_id);
 
     return BLT_SUCCESS;
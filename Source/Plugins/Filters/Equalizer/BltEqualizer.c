@@ -0,0 +1,475 @@
+/*****************************************************************
+|
+|   Equalizer Filter Module - Equalizer
+|
+|   (c) 2002-2010 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltEqualizer.h"
+
+/*----------------------------------------------------------------------
+|   SIMD support
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_EQUALIZER_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#define BLT_EQUALIZER_PI 3.14159265358979323846
+
+/* the samples of a channel are filtered by blocks of this many frames, */
+/* one band at a time                                                    */
+#define BLT_EQUALIZER_BLOCK_SIZE 256
+
+/* coefficient changes are spread over 20 ms, in steps of 32 frames */
+#define BLT_EQUALIZER_RAMP_DURATION 0.020
+#define BLT_EQUALIZER_RAMP_STEP     32
+
+#define BLT_EQUALIZER_MAX_GAIN     24.0f
+#define BLT_EQUALIZER_MIN_Q        0.05f
+#define BLT_EQUALIZER_DEFAULT_Q    0.70710678f
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef struct {
+    EqualizerBandType type;
+    double            coefficients[5]; /* b0 b1 b2 a1 a2, in use           */
+    double            targets[5];      /* coefficients at the end of ramp  */
+    double            steps[5];
+    unsigned int      ramp;            /* steps left before the targets    */
+} EqualizerStage;
+
+struct Equalizer {
+    BLT_UInt32      sample_rate;
+    unsigned int    channel_count;
+    unsigned int    band_count;
+    unsigned int    ramp_steps;
+    BLT_Boolean     running;  /* the filters have a state */
+    EqualizerStage* stages;
+    unsigned int*   active;   /* indexes of the stages to apply */
+
+    /* states[(2*b+k)*channel_count+c] is the state k of band b for */
+    /* channel c                                                     */
+    double*         states;
+};
+
+/*----------------------------------------------------------------------
+|   Equalizer_ComputeCoefficients
+|
+|   from the "Cookbook formulae for audio EQ biquad filter coefficients"
+|   by Robert Bristow-Johnson
++---------------------------------------------------------------------*/
+static void
+Equalizer_ComputeCoefficients(BLT_UInt32           sample_rate,
+                              const EqualizerBand* band,
+                              double*              k)
+{
+    double a     = pow(10.0, band->gain/40.0);
+    double w0    = 2.0*BLT_EQUALIZER_PI*band->frequency/(double)sample_rate;
+    double cs    = cos(w0);
+    double alpha = sin(w0)/(2.0*band->q);
+    double sa    = 2.0*sqrt(a)*alpha;
+    double b[3], d[3];
+
+    switch (band->type) {
+      case EQUALIZER_BAND_PEAK:
+        b[0] = 1.0+alpha*a;
+        b[1] = -2.0*cs;
+        b[2] = 1.0-alpha*a;
+        d[0] = 1.0+alpha/a;
+        d[1] = -2.0*cs;
+        d[2] = 1.0-alpha/a;
+        break;
+
+      case EQUALIZER_BAND_LOW_SHELF:
+        b[0] = a*((a+1.0)-(a-1.0)*cs+sa);
+        b[1] = 2.0*a*((a-1.0)-(a+1.0)*cs);
+        b[2] = a*((a+1.0)-(a-1.0)*cs-sa);
+        d[0] = (a+1.0)+(a-1.0)*cs+sa;
+        d[1] = -2.0*((a-1.0)+(a+1.0)*cs);
+        d[2] = (a+1.0)+(a-1.0)*cs-sa;
+        break;
+
+      case EQUALIZER_BAND_HIGH_SHELF:
+        b[0] = a*((a+1.0)+(a-1.0)*cs+sa);
+        b[1] = -2.0*a*((a-1.0)+(a+1.0)*cs);
+        b[2] = a*((a+1.0)+(a-1.0)*cs-sa);
+        d[0] = (a+1.0)-(a-1.0)*cs+sa;
+        d[1] = 2.0*((a-1.0)-(a+1.0)*cs);
+        d[2] = (a+1.0)-(a-1.0)*cs-sa;
+        break;
+
+      case EQUALIZER_BAND_LOW_PASS:
+        b[0] = (1.0-cs)/2.0;
+        b[1] = 1.0-cs;
+        b[2] = (1.0-cs)/2.0;
+        d[0] = 1.0+alpha;
+        d[1] = -2.0*cs;
+        d[2] = 1.0-alpha;
+        break;
+
+      case EQUALIZER_BAND_HIGH_PASS:
+        b[0] = (1.0+cs)/2.0;
+        b[1] = -(1.0+cs);
+        b[2] = (1.0+cs)/2.0;
+        d[0] = 1.0+alpha;
+        d[1] = -2.0*cs;
+        d[2] = 1.0-alpha;
+        break;
+
+      default:
+        /* pass through */
+        b[0] = d[0] = 1.0;
+        b[1] = b[2] = d[1] = d[2] = 0.0;
+        break;
+    }
+
+    k[0] = b[0]/d[0];
+    k[1] = b[1]/d[0];
+    k[2] = b[2]/d[0];
+    k[3] = d[1]/d[0];
+    k[4] = d[2]/d[0];
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_Create
++---------------------------------------------------------------------*/
+BLT_Result
+Equalizer_Create(BLT_UInt32    sample_rate,
+                 unsigned int  channel_count,
+                 unsigned int  band_count,
+                 Equalizer**   equalizer)
+{
+    Equalizer*    self;
+    EqualizerBand off;
+    unsigned int  b;
+
+    /* default */
+    *equalizer = NULL;
+
+    /* check parameters */
+    if (sample_rate < 1000 || channel_count == 0 || band_count == 0) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* allocate the object */
+    self = (Equalizer*)ATX_AllocateZeroMemory(sizeof(Equalizer));
+    if (self == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    self->sample_rate   = sample_rate;
+    self->channel_count = channel_count;
+    self->band_count    = band_count;
+    self->ramp_steps    = (unsigned int)(BLT_EQUALIZER_RAMP_DURATION*sample_rate/
+                                         BLT_EQUALIZER_RAMP_STEP)+1;
+    self->stages = (EqualizerStage*)ATX_AllocateZeroMemory(band_count*sizeof(EqualizerStage));
+    self->active = (unsigned int*)ATX_AllocateMemory(band_count*sizeof(unsigned int));
+    self->states = (double*)ATX_AllocateZeroMemory(2*band_count*channel_count*sizeof(double));
+    if (self->stages == NULL || self->active == NULL || self->states == NULL) {
+        Equalizer_Destroy(self);
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* all the bands start off */
+    off.type      = EQUALIZER_BAND_OFF;
+    off.frequency = 1000.0f;
+    off.gain      = 0.0f;
+    off.q         = BLT_EQUALIZER_DEFAULT_Q;
+    for (b=0; b<band_count; b++) {
+        Equalizer_SetBand(self, b, &off);
+    }
+
+    *equalizer = self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+Equalizer_Destroy(Equalizer* self)
+{
+    if (self == NULL) return BLT_SUCCESS;
+
+    if (self->stages) ATX_FreeMemory(self->stages);
+    if (self->active) ATX_FreeMemory(self->active);
+    if (self->states) ATX_FreeMemory(self->states);
+    ATX_FreeMemory(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_Matches
++---------------------------------------------------------------------*/
+BLT_Boolean
+Equalizer_Matches(Equalizer*   self,
+                  BLT_UInt32   sample_rate,
+                  unsigned int channel_count)
+{
+    return self->sample_rate   == sample_rate &&
+           self->channel_count == channel_count;
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_SetBand
++---------------------------------------------------------------------*/
+BLT_Result
+Equalizer_SetBand(Equalizer*           self,
+                  unsigned int         index,
+                  const EqualizerBand* band)
+{
+    EqualizerStage* stage;
+    EqualizerBand   settings = *band;
+    float           nyquist  = 0.49f*(float)self->sample_rate;
+    unsigned int    i;
+
+    if (index >= self->band_count) return BLT_ERROR_INVALID_PARAMETERS;
+    stage = &self->stages[index];
+
+    /* keep the parameters in range */
+    if (settings.frequency < 1.0f)                   settings.frequency = 1.0f;
+    if (settings.frequency > nyquist)                settings.frequency = nyquist;
+    if (settings.gain > BLT_EQUALIZER_MAX_GAIN)      settings.gain = BLT_EQUALIZER_MAX_GAIN;
+    if (settings.gain < -BLT_EQUALIZER_MAX_GAIN)     settings.gain = -BLT_EQUALIZER_MAX_GAIN;
+    if (!(settings.q > 0.0f))                        settings.q = BLT_EQUALIZER_DEFAULT_Q;
+    if (settings.q < BLT_EQUALIZER_MIN_Q)            settings.q = BLT_EQUALIZER_MIN_Q;
+
+    /* bands without any gain don't do anything */
+    if ((settings.type == EQUALIZER_BAND_PEAK       ||
+         settings.type == EQUALIZER_BAND_LOW_SHELF  ||
+         settings.type == EQUALIZER_BAND_HIGH_SHELF) && settings.gain == 0.0f) {
+        settings.type = EQUALIZER_BAND_OFF;
+    }
+
+    stage->type = settings.type;
+    Equalizer_ComputeCoefficients(self->sample_rate, &settings, stage->targets);
+
+    if (self->running) {
+        /* move to the new response progressively */
+        for (i=0; i<5; i++) {
+            stage->steps[i] = (stage->targets[i]-stage->coefficients[i])/self->ramp_steps;
+        }
+        stage->ramp = self->ramp_steps;
+    } else {
+        /* the filters are at rest, the change can't be heard */
+        ATX_CopyMemory(stage->coefficients, stage->targets, sizeof(stage->targets));
+        stage->ramp = 0;
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_IsActive
++---------------------------------------------------------------------*/
+BLT_Boolean
+Equalizer_IsActive(Equalizer* self)
+{
+    unsigned int b;
+    for (b=0; b<self->band_count; b++) {
+        if (self->stages[b].type != EQUALIZER_BAND_OFF || self->stages[b].ramp) {
+            return BLT_TRUE;
+        }
+    }
+    return BLT_FALSE;
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_ClearHistory
++---------------------------------------------------------------------*/
+void
+Equalizer_ClearHistory(Equalizer* self)
+{
+    unsigned int b;
+
+    ATX_SetMemory(self->states, 0, 2*self->band_count*self->channel_count*sizeof(double));
+    self->running = BLT_FALSE;
+
+    /* there is nothing to ramp from */
+    for (b=0; b<self->band_count; b++) {
+        EqualizerStage* stage = &self->stages[b];
+        ATX_CopyMemory(stage->coefficients, stage->targets, sizeof(stage->targets));
+        stage->ramp = 0;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_FlushState
+|
+|   keeps the filters out of denormals when the input goes silent
++---------------------------------------------------------------------*/
+static double
+Equalizer_FlushState(double state)
+{
+    return (state > -1e-20 && state < 1e-20) ? 0.0 : state;
+}
+
+/*----------------------------------------------------------------------
+|   Equalizer_FilterChannel
++---------------------------------------------------------------------*/
+static void
+Equalizer_FilterChannel(Equalizer*   self,
+                        float*       samples,
+                        BLT_Cardinal frame_count,
+                        unsigned int channel,
+                        unsigned int active_count)
+{
+    unsigned int n = self->channel_count;
+    double       block[BLT_EQUALIZER_BLOCK_SIZE];
+    BLT_Cardinal start;
+    BLT_Cardinal i;
+    unsigned int b;
+
+    samples += channel;
+    for (start=0; start<frame_count; start += BLT_EQUALIZER_BLOCK_SIZE) {
+        BLT_Cardinal count = frame_count-start < BLT_EQUALIZER_BLOCK_SIZE ?
+                             frame_count-start : BLT_EQUALIZER_BLOCK_SIZE;
+        float*       x     = samples+start*n;
+
+        for (i=0; i<count; i++) block[i] = x[i*n];
+        for (b=0; b<active_count; b++) {
+            const double* k  = self->stages[self->active[b]].coefficients;
+            double*       s  = self->states+2*self->active[b]*n+channel;
+            double        s0 = s[0], s1 = s[n];
+            for (i=0; i<count; i++) {
+                double in  = block[i];
+                double out = k[0]*in+s0;
+                s0 = k[1]*in-k[3]*out+s1;
+                s1 = k[2]*in-k[4]*out;
+                block[i] = out;
+            }
+            s[0] = Equalizer_FlushState(s0);
+            s[n] = Equalizer_FlushState(s1);
+        }
+        for (i=0; i<count; i++) x[i*n] = (float)block[i];
+    }
+}
+
+#if defined(BLT_EQUALIZER_HAVE_SSE2)
+/*----------------------------------------------------------------------
+|   Equalizer_FilterChannelPair
+|
+|   same as Equalizer_FilterChannel, for two adjacent channels at once,
+|   one in each lane
++---------------------------------------------------------------------*/
+static void
+Equalizer_FilterChannelPair(Equalizer*   self,
+                            float*       samples,
+                            BLT_Cardinal frame_count,
+                            unsigned int channel,
+                            unsigned int active_count)
+{
+    unsigned int n = self->channel_count;
+    __m128d      block[BLT_EQUALIZER_BLOCK_SIZE];
+    BLT_Cardinal start;
+    BLT_Cardinal i;
+    unsigned int b;
+
+    samples += channel;
+    for (start=0; start<frame_count; start += BLT_EQUALIZER_BLOCK_SIZE) {
+        BLT_Cardinal count = frame_count-start < BLT_EQUALIZER_BLOCK_SIZE ?
+                             frame_count-start : BLT_EQUALIZER_BLOCK_SIZE;
+        float*       x     = samples+start*n;
+
+        for (i=0; i<count; i++) {
+            block[i] = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(x+i*n))));
+        }
+        for (b=0; b<active_count; b++) {
+            const double* k  = self->stages[self->active[b]].coefficients;
+            double*       s  = self->states+2*self->active[b]*n+channel;
+            __m128d       k0 = _mm_set1_pd(k[0]), k1 = _mm_set1_pd(k[1]), k2 = _mm_set1_pd(k[2]);
+            __m128d       k3 = _mm_set1_pd(k[3]), k4 = _mm_set1_pd(k[4]);
+            __m128d       s0 = _mm_loadu_pd(s), s1 = _mm_loadu_pd(s+n);
+            for (i=0; i<count; i++) {
+                __m128d in  = block[i];
+                __m128d out = _mm_add_pd(_mm_mul_pd(k0, in), s0);
+                s0 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(k1, in), _mm_mul_pd(k3, out)), s1);
+                s1 = _mm_sub_pd(_mm_mul_pd(k2, in), _mm_mul_pd(k4, out));
+                block[i] = out;
+            }
+            _mm_storeu_pd(s,   s0);
+            _mm_storeu_pd(s+n, s1);
+            s[0]   = Equalizer_FlushState(s[0]);
+            s[1]   = Equalizer_FlushState(s[1]);
+            s[n]   = Equalizer_FlushState(s[n]);
+            s[n+1] = Equalizer_FlushState(s[n+1]);
+        }
+        for (i=0; i<count; i++) {
+            _mm_storel_epi64((__m128i*)(x+i*n), _mm_castps_si128(_mm_cvtpd_ps(block[i])));
+        }
+    }
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   Equalizer_Process
++---------------------------------------------------------------------*/
+void
+Equalizer_Process(Equalizer*   self,
+                  float*       samples,
+                  BLT_Cardinal frame_count)
+{
+    while (frame_count) {
+        BLT_Cardinal chunk        = frame_count;
+        unsigned int active_count = 0;
+        unsigned int b, c, i;
+
+        /* advance the ramps, and list the bands that do something */
+        for (b=0; b<self->band_count; b++) {
+            EqualizerStage* stage = &self->stages[b];
+            if (stage->ramp) {
+                if (--stage->ramp) {
+                    for (i=0; i<5; i++) stage->coefficients[i] += stage->steps[i];
+                } else {
+                    ATX_CopyMemory(stage->coefficients, stage->targets, sizeof(stage->targets));
+                }
+                chunk = BLT_EQUALIZER_RAMP_STEP;
+            } else if (stage->type == EQUALIZER_BAND_OFF) {
+                continue;
+            }
+            self->active[active_count++] = b;
+        }
+        if (chunk > frame_count) chunk = frame_count;
+
+        c = 0;
+        if (active_count) {
+#if defined(BLT_EQUALIZER_HAVE_SSE2)
+            for (; c+1 < self->channel_count; c += 2) {
+                Equalizer_FilterChannelPair(self, samples, chunk, c, active_count);
+            }
+#endif
+            for (; c < self->channel_count; c++) {
+                Equalizer_FilterChannel(self, samples, chunk, c, active_count);
+            }
+        }
+
+        /* bands that have faded out start from rest next time */
+        for (i=0; i<active_count; i++) {
+            EqualizerStage* stage = &self->stages[self->active[i]];
+            if (stage->type == EQUALIZER_BAND_OFF && stage->ramp == 0) {
+                ATX_SetMemory(self->states+2*self->active[i]*self->channel_count,
+                              0,
+                              2*self->channel_count*sizeof(double));
+            }
+        }
+
+        samples     += chunk*self->channel_count;
+        frame_count -= chunk;
+    }
+
+    self->running = Equalizer_IsActive(self);
+}
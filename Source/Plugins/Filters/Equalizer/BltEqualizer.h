@@ -0,0 +1,100 @@
+/*****************************************************************
+|
+|   Equalizer Filter Module - Equalizer
+|
+|   (c) 2002-2010 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_EQUALIZER_H_
+#define _BLT_EQUALIZER_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Parametric equalizer, working in place on interleaved native-endian
+ * float samples. Each band is a second order filter, computed in double
+ * precision, and all the bands are applied one after the other to each
+ * channel. When a band changes, its coefficients move to the new values
+ * over a few milliseconds, so that there are no clicks.
+ */
+typedef struct Equalizer Equalizer;
+
+typedef enum {
+    EQUALIZER_BAND_OFF,
+    EQUALIZER_BAND_PEAK,
+    EQUALIZER_BAND_LOW_SHELF,
+    EQUALIZER_BAND_HIGH_SHELF,
+    EQUALIZER_BAND_LOW_PASS,
+    EQUALIZER_BAND_HIGH_PASS
+} EqualizerBandType;
+
+typedef struct {
+    EqualizerBandType type;
+    float             frequency; /* center or corner frequency, in Hz        */
+    float             gain;      /* in dB, for the peak and shelf bands      */
+    float             q;         /* 0.7071 gives a Butterworth pass filter   */
+} EqualizerBand;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates an equalizer with band_count bands, all off.
+ */
+BLT_Result Equalizer_Create(BLT_UInt32    sample_rate,
+                            unsigned int  channel_count,
+                            unsigned int  band_count,
+                            Equalizer**   equalizer);
+BLT_Result Equalizer_Destroy(Equalizer* self);
+
+/**
+ * Returns true if the equalizer was created with these parameters.
+ */
+BLT_Boolean Equalizer_Matches(Equalizer*   self,
+                              BLT_UInt32   sample_rate,
+                              unsigned int channel_count);
+
+/**
+ * Changes a band. The frequency is kept under the Nyquist frequency.
+ * This changes the state used by Equalizer_Process, so it must be
+ * called from the same thread.
+ */
+BLT_Result Equalizer_SetBand(Equalizer*           self,
+                             unsigned int         index,
+                             const EqualizerBand* band);
+
+/**
+ * Returns false when all the bands are off, in which case
+ * Equalizer_Process doesn't change the samples.
+ */
+BLT_Boolean Equalizer_IsActive(Equalizer* self);
+
+/**
+ * Clears the filters, for when the next samples don't follow the
+ * previous ones.
+ */
+void Equalizer_ClearHistory(Equalizer* self);
+
+void Equalizer_Process(Equalizer*   self,
+                       float*       samples,
+                       BLT_Cardinal frame_count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_EQUALIZER_H_ */
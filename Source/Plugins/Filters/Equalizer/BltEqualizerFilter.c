@@ -0,0 +1,836 @@
+/*****************************************************************
+|
+|   Equalizer Filter Module
+|
+|   (c) 2002-2010 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltCore.h"
+#include "BltEqualizerFilter.h"
+#include "BltEqualizer.h"
+#include "BltMediaNode.h"
+#include "BltMedia.h"
+#include "BltPcm.h"
+#include "BltPacketProducer.h"
+#include "BltPacketConsumer.h"
+#include "BltStream.h"
+#include "BltThreads.h"
+
+/*----------------------------------------------------------------------
+|   logging
++---------------------------------------------------------------------*/
+ATX_SET_LOCAL_LOGGER("bluetune.plugins.filters.equalizer")
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+#define BLT_EQUALIZER_FILTER_MODULE_NAME "com.axiosys.filter.equalizer"
+
+#if !defined(BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS)
+#define BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS 10
+#endif
+#if BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS > 32
+#error "BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS must not be more than 32"
+#endif
+
+/*----------------------------------------------------------------------
+|    types
++---------------------------------------------------------------------*/
+typedef BLT_BaseModule EqualizerFilterModule;
+
+typedef struct {
+    /* interfaces */
+    ATX_IMPLEMENTS(BLT_MediaPort);
+    ATX_IMPLEMENTS(BLT_PacketConsumer);
+} EqualizerFilterInput;
+
+typedef struct {
+    /* interfaces */
+    ATX_IMPLEMENTS(BLT_MediaPort);
+    ATX_IMPLEMENTS(BLT_PacketProducer);
+
+    /* members */
+    BLT_MediaPacket* packet;
+} EqualizerFilterOutput;
+
+typedef struct {
+    /* base class */
+    ATX_EXTENDS(BLT_BaseMediaNode);
+
+    /* interfaces */
+    ATX_IMPLEMENTS(ATX_PropertyListener);
+
+    /* members */
+    EqualizerFilterInput       input;
+    EqualizerFilterOutput      output;
+    BLT_Mutex*                 bands_lock;   /* guards bands and bands_changed */
+    EqualizerBand              bands[BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS];
+    BLT_UInt32                 bands_changed; /* not yet given to the equalizer */
+    Equalizer*                 equalizer;
+    float*                     samples;      /* input converted to floats */
+    BLT_Size                   samples_size;
+    ATX_PropertyListenerHandle property_listener_handle;
+} EqualizerFilter;
+
+/*----------------------------------------------------------------------
+|   forward declarations
++---------------------------------------------------------------------*/
+ATX_DECLARE_INTERFACE_MAP(EqualizerFilterModule, BLT_Module)
+ATX_DECLARE_INTERFACE_MAP(EqualizerFilter, BLT_MediaNode)
+ATX_DECLARE_INTERFACE_MAP(EqualizerFilter, ATX_Referenceable)
+ATX_DECLARE_INTERFACE_MAP(EqualizerFilter, ATX_PropertyListener)
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_ParseBand
+|
+|    parses a "type,frequency,gain,q" band description, leaving the
+|    band off when it can't be parsed
++---------------------------------------------------------------------*/
+static void
+EqualizerFilter_ParseBand(const ATX_PropertyValue* value, EqualizerBand* band)
+{
+    static const struct {
+        const char*       name;
+        EqualizerBandType type;
+    } types[] = {
+        { "off",       EQUALIZER_BAND_OFF        },
+        { "peak",      EQUALIZER_BAND_PEAK       },
+        { "lowshelf",  EQUALIZER_BAND_LOW_SHELF  },
+        { "highshelf", EQUALIZER_BAND_HIGH_SHELF },
+        { "lowpass",   EQUALIZER_BAND_LOW_PASS   },
+        { "highpass",  EQUALIZER_BAND_HIGH_PASS  }
+    };
+    const char*  p;
+    char         field[32];
+    unsigned int f;
+    unsigned int i;
+
+    /* defaults */
+    band->type      = EQUALIZER_BAND_OFF;
+    band->frequency = 1000.0f;
+    band->gain      = 0.0f;
+    band->q         = 0.70710678f;
+
+    if (value == NULL                                ||
+        value->type != ATX_PROPERTY_VALUE_TYPE_STRING ||
+        value->data.string == NULL) {
+        return;
+    }
+
+    p = value->data.string;
+    for (f=0; f<4; f++) {
+        unsigned int length = 0;
+        float        number;
+
+        /* isolate the next field */
+        while (*p == ' ') p++;
+        while (*p && *p != ',') {
+            if (length+1 < sizeof(field)) field[length++] = *p;
+            p++;
+        }
+        while (length && field[length-1] == ' ') length--;
+        field[length] = '\0';
+
+        if (f == 0) {
+            for (i=0; i<sizeof(types)/sizeof(types[0]); i++) {
+                if (ATX_StringsEqual(field, types[i].name)) break;
+            }
+            if (i == sizeof(types)/sizeof(types[0])) {
+                ATX_LOG_WARNING_1("EqualizerFilter::ParseBand - unknown band type '%s'", field);
+                return;
+            }
+            band->type = types[i].type;
+        } else if (length && ATX_SUCCEEDED(ATX_ParseFloat(field, &number, ATX_TRUE))) {
+            switch (f) {
+                case 1: band->frequency = number; break;
+                case 2: band->gain      = number; break;
+                case 3: band->q         = number; break;
+            }
+        }
+
+        if (*p != ',') break;
+        p++;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_UpdateBand
+|
+|    called from the thread that sets the property, which isn't the one
+|    that processes the packets, so the band is only recorded here and
+|    given to the equalizer by the next call to EqualizerFilter_Process
++---------------------------------------------------------------------*/
+static void
+EqualizerFilter_UpdateBand(EqualizerFilter*         self,
+                           const char*              name,
+                           const ATX_PropertyValue* value)
+{
+    EqualizerBand band;
+    int           index = 0;
+
+    if (ATX_FAILED(ATX_ParseInteger(name+ATX_StringLength(BLT_EQUALIZER_FILTER_OPTION_BAND_PREFIX),
+                                    &index,
+                                    ATX_FALSE)) ||
+        index < 0 || index >= BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS) {
+        return;
+    }
+
+    EqualizerFilter_ParseBand(value, &band);
+    ATX_LOG_FINE_2("EqualizerFilter::UpdateBand - band %d, type %d",
+                   index, band.type);
+
+    BLT_Mutex_Lock(self->bands_lock);
+    self->bands[index] = band;
+    self->bands_changed |= 1U<<index;
+    BLT_Mutex_Unlock(self->bands_lock);
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_ApplyBands
+|
+|    gives the bands that changed, or all of them, to the equalizer
++---------------------------------------------------------------------*/
+static void
+EqualizerFilter_ApplyBands(EqualizerFilter* self, BLT_Boolean all)
+{
+    EqualizerBand bands[BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS];
+    BLT_UInt32    changed;
+    unsigned int  b;
+
+    BLT_Mutex_Lock(self->bands_lock);
+    changed = self->bands_changed;
+    self->bands_changed = 0;
+    if (changed || all) {
+        ATX_CopyMemory(bands, self->bands, sizeof(bands));
+    }
+    BLT_Mutex_Unlock(self->bands_lock);
+
+    for (b=0; b<BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS; b++) {
+        if (all || (changed & (1U<<b))) {
+            Equalizer_SetBand(self->equalizer, b, &bands[b]);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_Process
++---------------------------------------------------------------------*/
+static BLT_Result
+EqualizerFilter_Process(EqualizerFilter*        self,
+                        const BLT_PcmMediaType* media_type,
+                        BLT_MediaPacket*        packet,
+                        BLT_MediaPacket**       output)
+{
+    unsigned int sample_size = media_type->bits_per_sample/8;
+    BLT_Size     size        = BLT_MediaPacket_GetPayloadSize(packet);
+    BLT_Cardinal frames;
+    BLT_Boolean  is_float;
+    float*       samples;
+    BLT_Result   result;
+
+    /* default */
+    *output = NULL;
+
+    if (media_type->channel_count == 0 || sample_size == 0) {
+        return BLT_ERROR_INVALID_MEDIA_FORMAT;
+    }
+    frames = size/(media_type->channel_count*sample_size);
+    if (frames == 0) return BLT_SUCCESS;
+    is_float = media_type->sample_format   == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE &&
+               media_type->bits_per_sample == 32;
+
+    /* (re)create the equalizer when the format changes */
+    if (self->equalizer && !Equalizer_Matches(self->equalizer,
+                                              media_type->sample_rate,
+                                              media_type->channel_count)) {
+        ATX_LOG_FINE("EqualizerFilter::Process - format changed");
+        Equalizer_Destroy(self->equalizer);
+        self->equalizer = NULL;
+    }
+    if (self->equalizer == NULL) {
+        result = Equalizer_Create(media_type->sample_rate,
+                                  media_type->channel_count,
+                                  BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS,
+                                  &self->equalizer);
+        if (BLT_FAILED(result)) return result;
+        EqualizerFilter_ApplyBands(self, BLT_TRUE);
+    } else {
+        EqualizerFilter_ApplyBands(self, BLT_FALSE);
+    }
+
+    /* nothing to do when all the bands are off */
+    if (!Equalizer_IsActive(self->equalizer)) return BLT_SUCCESS;
+
+    /* get the samples as floats */
+    if (!is_float) {
+        BLT_PcmMediaType float_type;
+        BLT_Size         float_size = frames*media_type->channel_count*sizeof(float);
+        if (self->samples_size < float_size) {
+            if (self->samples) ATX_FreeMemory(self->samples);
+            self->samples_size = 0;
+            self->samples = (float*)ATX_AllocateMemory(float_size);
+            if (self->samples == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+            self->samples_size = float_size;
+        }
+        float_type                 = *media_type;
+        float_type.bits_per_sample = 32;
+        float_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+        result = BLT_Pcm_ConvertSamples(media_type,
+                                        BLT_MediaPacket_GetPayloadBuffer(packet),
+                                        &float_type,
+                                        self->samples,
+                                        frames*media_type->channel_count,
+                                        BLT_PCM_KERNEL_ANY);
+        if (BLT_FAILED(result)) return result;
+    }
+
+    /* process in place, unless someone else can see the packet */
+    if (BLT_MediaPacket_IsWritable(packet)) {
+        *output = packet;
+        BLT_MediaPacket_AddReference(packet);
+    } else {
+        result = BLT_Core_CreateMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
+                                            size,
+                                            (const BLT_MediaType*)media_type,
+                                            output);
+        if (BLT_FAILED(result)) return result;
+        BLT_MediaPacket_SetPayloadSize(*output, size);
+        BLT_MediaPacket_SetFlags(*output, BLT_MediaPacket_GetFlags(packet));
+        BLT_MediaPacket_SetTimeStamp(*output, BLT_MediaPacket_GetTimeStamp(packet));
+        BLT_MediaPacket_SetDuration(*output, BLT_MediaPacket_GetDuration(packet));
+        if (is_float) {
+            ATX_CopyMemory(BLT_MediaPacket_GetPayloadBuffer(*output),
+                           BLT_MediaPacket_GetPayloadBuffer(packet),
+                           size);
+        }
+    }
+
+    if (is_float) {
+        samples = (float*)BLT_MediaPacket_GetPayloadBuffer(*output);
+        Equalizer_Process(self->equalizer, samples, frames);
+    } else {
+        BLT_PcmMediaType float_type = *media_type;
+        float_type.bits_per_sample = 32;
+        float_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+        Equalizer_Process(self->equalizer, self->samples, frames);
+        BLT_Pcm_ConvertSamples(&float_type,
+                               self->samples,
+                               media_type,
+                               BLT_MediaPacket_GetPayloadBuffer(*output),
+                               frames*media_type->channel_count,
+                               BLT_PCM_KERNEL_ANY);
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilterInput_PutPacket
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilterInput_PutPacket(BLT_PacketConsumer* _self,
+                               BLT_MediaPacket*    packet)
+{
+    EqualizerFilter*  self = ATX_SELF_M(input, EqualizerFilter, BLT_PacketConsumer);
+    BLT_PcmMediaType* media_type;
+    BLT_MediaPacket*  output = NULL;
+    BLT_Result        result;
+
+    /* get the media type */
+    result = BLT_MediaPacket_GetMediaType(packet, (const BLT_MediaType**)(const void*)&media_type);
+    if (BLT_FAILED(result)) return result;
+
+    /* check the media type */
+    if (media_type->base.id != BLT_MEDIA_TYPE_ID_AUDIO_PCM) {
+        return BLT_ERROR_INVALID_MEDIA_TYPE;
+    }
+
+    /* the filters don't carry over to a new stream */
+    if (self->equalizer &&
+        (BLT_MediaPacket_GetFlags(packet) & (BLT_MEDIA_PACKET_FLAG_START_OF_STREAM |
+                                             BLT_MEDIA_PACKET_FLAG_STREAM_DISCONTINUITY))) {
+        Equalizer_ClearHistory(self->equalizer);
+    }
+
+    /* equalize, but let unsupported formats through */
+    result = EqualizerFilter_Process(self, media_type, packet, &output);
+    if (BLT_FAILED(result)) {
+        ATX_LOG_FINE_1("EqualizerFilter::PutPacket - cannot process (%d)", result);
+    }
+    if (output == NULL) {
+        output = packet;
+        BLT_MediaPacket_AddReference(packet);
+    }
+    self->output.packet = output;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   EqualizerFilterInput_QueryMediaType
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilterInput_QueryMediaType(BLT_MediaPort*         self,
+                                    BLT_Ordinal            index,
+                                    const BLT_MediaType**  media_type)
+{
+    BLT_COMPILER_UNUSED(self);
+    if (index == 0) {
+        *media_type = &BLT_GenericPcmMediaType;
+        return BLT_SUCCESS;
+    } else {
+        *media_type = NULL;
+        return BLT_FAILURE;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(EqualizerFilterInput)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilterInput, BLT_MediaPort)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilterInput, BLT_PacketConsumer)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|    BLT_PacketConsumer interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(EqualizerFilterInput, BLT_PacketConsumer)
+    EqualizerFilterInput_PutPacket
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPort interface
++---------------------------------------------------------------------*/
+BLT_MEDIA_PORT_IMPLEMENT_SIMPLE_TEMPLATE(EqualizerFilterInput,
+                                         "input",
+                                         PACKET,
+                                         IN)
+ATX_BEGIN_INTERFACE_MAP(EqualizerFilterInput, BLT_MediaPort)
+    EqualizerFilterInput_GetName,
+    EqualizerFilterInput_GetProtocol,
+    EqualizerFilterInput_GetDirection,
+    EqualizerFilterInput_QueryMediaType
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    EqualizerFilterOutput_GetPacket
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilterOutput_GetPacket(BLT_PacketProducer* _self,
+                                BLT_MediaPacket**   packet)
+{
+    EqualizerFilter* self = ATX_SELF_M(output, EqualizerFilter, BLT_PacketProducer);
+
+    if (self->output.packet) {
+        *packet = self->output.packet;
+        self->output.packet = NULL;
+        return BLT_SUCCESS;
+    } else {
+        *packet = NULL;
+        return BLT_ERROR_PORT_HAS_NO_DATA;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   EqualizerFilterOutput_QueryMediaType
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilterOutput_QueryMediaType(BLT_MediaPort*         self,
+                                     BLT_Ordinal            index,
+                                     const BLT_MediaType**  media_type)
+{
+    BLT_COMPILER_UNUSED(self);
+    if (index == 0) {
+        *media_type = &BLT_GenericPcmMediaType;
+        return BLT_SUCCESS;
+    } else {
+        *media_type = NULL;
+        return BLT_FAILURE;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(EqualizerFilterOutput)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilterOutput, BLT_MediaPort)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilterOutput, BLT_PacketProducer)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPort interface
++---------------------------------------------------------------------*/
+BLT_MEDIA_PORT_IMPLEMENT_SIMPLE_TEMPLATE(EqualizerFilterOutput,
+                                         "output",
+                                         PACKET,
+                                         OUT)
+ATX_BEGIN_INTERFACE_MAP(EqualizerFilterOutput, BLT_MediaPort)
+    EqualizerFilterOutput_GetName,
+    EqualizerFilterOutput_GetProtocol,
+    EqualizerFilterOutput_GetDirection,
+    EqualizerFilterOutput_QueryMediaType
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    BLT_PacketProducer interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(EqualizerFilterOutput, BLT_PacketProducer)
+    EqualizerFilterOutput_GetPacket
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_Create
++---------------------------------------------------------------------*/
+static BLT_Result
+EqualizerFilter_Create(BLT_Module*              module,
+                       BLT_Core*                core,
+                       BLT_ModuleParametersType parameters_type,
+                       BLT_AnyConst             parameters,
+                       BLT_MediaNode**          object)
+{
+    EqualizerFilter* self;
+    unsigned int     b;
+    BLT_Result       result;
+
+    ATX_LOG_FINE("EqualizerFilter::Create");
+
+    /* check parameters */
+    if (parameters == NULL ||
+        parameters_type != BLT_MODULE_PARAMETERS_TYPE_MEDIA_NODE_CONSTRUCTOR) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* allocate memory for the object */
+    self = ATX_AllocateZeroMemory(sizeof(EqualizerFilter));
+    if (self == NULL) {
+        *object = NULL;
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* construct the inherited object */
+    BLT_BaseMediaNode_Construct(&ATX_BASE(self, BLT_BaseMediaNode), module, core);
+
+    /* construct the object */
+    result = BLT_Mutex_Create(&self->bands_lock);
+    if (BLT_FAILED(result)) {
+        BLT_BaseMediaNode_Destruct(&ATX_BASE(self, BLT_BaseMediaNode));
+        ATX_FreeMemory((void*)self);
+        *object = NULL;
+        return result;
+    }
+    for (b=0; b<BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS; b++) {
+        EqualizerFilter_ParseBand(NULL, &self->bands[b]);
+    }
+
+    /* setup interfaces */
+    ATX_SET_INTERFACE_EX(self, EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode);
+    ATX_SET_INTERFACE_EX(self, EqualizerFilter, BLT_BaseMediaNode, ATX_Referenceable);
+    ATX_SET_INTERFACE(self, EqualizerFilter, ATX_PropertyListener);
+    ATX_SET_INTERFACE(&self->input,  EqualizerFilterInput,  BLT_MediaPort);
+    ATX_SET_INTERFACE(&self->input,  EqualizerFilterInput,  BLT_PacketConsumer);
+    ATX_SET_INTERFACE(&self->output, EqualizerFilterOutput, BLT_MediaPort);
+    ATX_SET_INTERFACE(&self->output, EqualizerFilterOutput, BLT_PacketProducer);
+    *object = &ATX_BASE_EX(self, BLT_BaseMediaNode, BLT_MediaNode);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_Destroy
++---------------------------------------------------------------------*/
+static BLT_Result
+EqualizerFilter_Destroy(EqualizerFilter* self)
+{
+    ATX_LOG_FINE("EqualizerFilter::Destroy");
+
+    /* release any input packet we may hold */
+    if (self->output.packet) {
+        BLT_MediaPacket_Release(self->output.packet);
+    }
+
+    /* free the equalizer and the buffer */
+    Equalizer_Destroy(self->equalizer);
+    if (self->samples) ATX_FreeMemory(self->samples);
+    BLT_Mutex_Destroy(self->bands_lock);
+
+    /* destruct the inherited object */
+    BLT_BaseMediaNode_Destruct(&ATX_BASE(self, BLT_BaseMediaNode));
+
+    /* free the object memory */
+    ATX_FreeMemory((void*)self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   EqualizerFilter_GetPortByName
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilter_GetPortByName(BLT_MediaNode*  _self,
+                              BLT_CString     name,
+                              BLT_MediaPort** port)
+{
+    EqualizerFilter* self = ATX_SELF_EX(EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    if (ATX_StringsEqual(name, "input")) {
+        *port = &ATX_BASE(&self->input, BLT_MediaPort);
+        return BLT_SUCCESS;
+    } else if (ATX_StringsEqual(name, "output")) {
+        *port = &ATX_BASE(&self->output, BLT_MediaPort);
+        return BLT_SUCCESS;
+    } else {
+        *port = NULL;
+        return BLT_ERROR_NO_SUCH_PORT;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_Activate
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilter_Activate(BLT_MediaNode* _self, BLT_Stream* stream)
+{
+    EqualizerFilter* self = ATX_SELF_EX(EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    /* keep a reference to the stream */
+    ATX_BASE(self, BLT_BaseMediaNode).context = stream;
+
+    /* listen to settings on the new stream */
+    if (stream) {
+        ATX_Properties* properties;
+        if (BLT_SUCCEEDED(BLT_Stream_GetProperties(stream, &properties))) {
+            unsigned int b;
+
+            /* the band properties have variable names, so listen to all */
+            ATX_Properties_AddListener(properties,
+                                       NULL,
+                                       &ATX_BASE(self, ATX_PropertyListener),
+                                       &self->property_listener_handle);
+
+            /* read the initial values */
+            for (b=0; b<BLT_CONFIG_EQUALIZER_FILTER_MAX_BANDS; b++) {
+                ATX_PropertyValue property;
+                char              name[64];
+                ATX_FormatStringN(name, sizeof(name), "%s%d",
+                                  BLT_EQUALIZER_FILTER_OPTION_BAND_PREFIX, b);
+                if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties, name, &property))) {
+                    EqualizerFilter_UpdateBand(self, name, &property);
+                }
+            }
+        }
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_Deactivate
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilter_Deactivate(BLT_MediaNode* _self)
+{
+    EqualizerFilter* self = ATX_SELF_EX(EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    /* remove our listener */
+    if (ATX_BASE(self, BLT_BaseMediaNode).context) {
+        ATX_Properties* properties;
+        if (BLT_SUCCEEDED(BLT_Stream_GetProperties(ATX_BASE(self, BLT_BaseMediaNode).context,
+                                                   &properties))) {
+            ATX_Properties_RemoveListener(properties,
+                                          self->property_listener_handle);
+        }
+    }
+
+    /* we're detached from the stream */
+    ATX_BASE(self, BLT_BaseMediaNode).context = NULL;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_Seek
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilter_Seek(BLT_MediaNode* _self,
+                     BLT_SeekMode*  mode,
+                     BLT_SeekPoint* point)
+{
+    EqualizerFilter* self = ATX_SELF_EX(EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    BLT_COMPILER_UNUSED(mode);
+    BLT_COMPILER_UNUSED(point);
+
+    if (self->output.packet) {
+        BLT_MediaPacket_Release(self->output.packet);
+        self->output.packet = NULL;
+    }
+
+    /* the samples after the seek point don't follow the previous ones */
+    if (self->equalizer) Equalizer_ClearHistory(self->equalizer);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(EqualizerFilter)
+    ATX_GET_INTERFACE_ACCEPT_EX(EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode)
+    ATX_GET_INTERFACE_ACCEPT_EX(EqualizerFilter, BLT_BaseMediaNode, ATX_Referenceable)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilter, ATX_PropertyListener)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|    BLT_MediaNode interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP_EX(EqualizerFilter, BLT_BaseMediaNode, BLT_MediaNode)
+    BLT_BaseMediaNode_GetInfo,
+    EqualizerFilter_GetPortByName,
+    EqualizerFilter_Activate,
+    EqualizerFilter_Deactivate,
+    BLT_BaseMediaNode_Start,
+    BLT_BaseMediaNode_Stop,
+    BLT_BaseMediaNode_Pause,
+    BLT_BaseMediaNode_Resume,
+    EqualizerFilter_Seek
+};
+
+/*----------------------------------------------------------------------
+|    EqualizerFilter_OnPropertyChanged
++---------------------------------------------------------------------*/
+BLT_VOID_METHOD
+EqualizerFilter_OnPropertyChanged(ATX_PropertyListener*    _self,
+                                  ATX_CString              name,
+                                  const ATX_PropertyValue* value)
+{
+    EqualizerFilter* self = ATX_SELF(EqualizerFilter, ATX_PropertyListener);
+
+    if (name == NULL) return;
+    if (ATX_StringsEqualN(name,
+                          BLT_EQUALIZER_FILTER_OPTION_BAND_PREFIX,
+                          ATX_StringLength(BLT_EQUALIZER_FILTER_OPTION_BAND_PREFIX))) {
+        EqualizerFilter_UpdateBand(self, name, value);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    ATX_PropertyListener interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(EqualizerFilter, ATX_PropertyListener)
+    EqualizerFilter_OnPropertyChanged,
+};
+
+/*----------------------------------------------------------------------
+|   ATX_Referenceable interface
++---------------------------------------------------------------------*/
+ATX_IMPLEMENT_REFERENCEABLE_INTERFACE_EX(EqualizerFilter,
+                                         BLT_BaseMediaNode,
+                                         reference_count)
+
+/*----------------------------------------------------------------------
+|   EqualizerFilterModule_Probe
++---------------------------------------------------------------------*/
+BLT_METHOD
+EqualizerFilterModule_Probe(BLT_Module*              self,
+                            BLT_Core*                core,
+                            BLT_ModuleParametersType parameters_type,
+                            BLT_AnyConst             parameters,
+                            BLT_Cardinal*            match)
+{
+    BLT_COMPILER_UNUSED(self);
+    BLT_COMPILER_UNUSED(core);
+
+    switch (parameters_type) {
+      case BLT_MODULE_PARAMETERS_TYPE_MEDIA_NODE_CONSTRUCTOR:
+        {
+            BLT_MediaNodeConstructor* constructor =
+                (BLT_MediaNodeConstructor*)parameters;
+
+            /* we need a name */
+            if (constructor->name == NULL ||
+                !ATX_StringsEqual(constructor->name, BLT_EQUALIZER_FILTER_MODULE_NAME)) {
+                return BLT_FAILURE;
+            }
+
+            /* the input and output protocols should be PACKET */
+            if ((constructor->spec.input.protocol  != BLT_MEDIA_PORT_PROTOCOL_ANY &&
+                 constructor->spec.input.protocol  != BLT_MEDIA_PORT_PROTOCOL_PACKET) ||
+                (constructor->spec.output.protocol != BLT_MEDIA_PORT_PROTOCOL_ANY &&
+                 constructor->spec.output.protocol != BLT_MEDIA_PORT_PROTOCOL_PACKET)) {
+                return BLT_FAILURE;
+            }
+
+            /* the input type should be unspecified, or audio/pcm */
+            if (!(constructor->spec.input.media_type->id == BLT_MEDIA_TYPE_ID_AUDIO_PCM) &&
+                !(constructor->spec.input.media_type->id == BLT_MEDIA_TYPE_ID_UNKNOWN)) {
+                return BLT_FAILURE;
+            }
+
+            /* the output type should be unspecified, or audio/pcm */
+            if (!(constructor->spec.output.media_type->id == BLT_MEDIA_TYPE_ID_AUDIO_PCM) &&
+                !(constructor->spec.output.media_type->id == BLT_MEDIA_TYPE_ID_UNKNOWN)) {
+                return BLT_FAILURE;
+            }
+
+            /* match level is always exact */
+            *match = BLT_MODULE_PROBE_MATCH_EXACT;
+
+            ATX_LOG_FINE_1("EqualizerFilterModule::Probe - Ok [%d]", *match);
+            return BLT_SUCCESS;
+        }
+        break;
+
+      default:
+        break;
+    }
+
+    return BLT_FAILURE;
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(EqualizerFilterModule)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilterModule, BLT_Module)
+    ATX_GET_INTERFACE_ACCEPT(EqualizerFilterModule, ATX_Referenceable)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|   node factory
++---------------------------------------------------------------------*/
+BLT_MODULE_IMPLEMENT_SIMPLE_MEDIA_NODE_FACTORY(EqualizerFilterModule, EqualizerFilter)
+
+/*----------------------------------------------------------------------
+|   BLT_Module interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(EqualizerFilterModule, BLT_Module)
+    BLT_BaseModule_GetInfo,
+    BLT_BaseModule_Attach,
+    EqualizerFilterModule_CreateInstance,
+    EqualizerFilterModule_Probe
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|   ATX_Referenceable interface
++---------------------------------------------------------------------*/
+#define EqualizerFilterModule_Destroy(x) \
+    BLT_BaseModule_Destroy((BLT_BaseModule*)(x))
+
+ATX_IMPLEMENT_REFERENCEABLE_INTERFACE(EqualizerFilterModule, reference_count)
+
+/*----------------------------------------------------------------------
+|   module object
++---------------------------------------------------------------------*/
+BLT_MODULE_IMPLEMENT_STANDARD_GET_MODULE(EqualizerFilterModule,
+                                         "Equalizer Filter",
+                                         BLT_EQUALIZER_FILTER_MODULE_NAME,
+                                         "1.0.0",
+                                         BLT_MODULE_AXIOMATIC_COPYRIGHT)
@@ -0,0 +1,52 @@
+/*****************************************************************
+|
+|   Equalizer Filter Module
+|
+|   (c) 2002-2010 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_EQUALIZER_FILTER_H_
+#define _BLT_EQUALIZER_FILTER_H_
+
+/**
+ * @ingroup plugin_modules
+ * @ingroup plugin_filter_modules
+ * @defgroup equalizer_filter_module Equalizer Filter Module
+ * Plugin module that create media nodes that equalize PCM audio data.
+ * These media nodes expect media packets with PCM audio as input,
+ * and produce media packets with PCM audio as output, in the same format.
+ * Each band is set with a string stream property named
+ * BLT_EQUALIZER_FILTER_OPTION_BAND_PREFIX followed by the index of the
+ * band (0, 1, ...), with a value of the form "type,frequency,gain,q",
+ * where type is one of peak, lowshelf, highshelf, lowpass, highpass or
+ * off, the frequency is in Hz and the gain in dB. The gain and q can be
+ * omitted. For example, "Plugins.EqualizerFilter.Band.0" set to
+ * "peak,1000,-3,1.4" cuts 3 dB around 1 kHz. Removing the property turns
+ * the band off. Changes are applied progressively, so that they can be
+ * made while playing.
+ *
+ * @{
+ */
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltTypes.h"
+#include "BltModule.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/** string stream properties, followed by the band index */
+#define BLT_EQUALIZER_FILTER_OPTION_BAND_PREFIX "Plugins.EqualizerFilter.Band."
+
+/*----------------------------------------------------------------------
+|   module
++---------------------------------------------------------------------*/
+BLT_Result BLT_EqualizerFilterModule_GetModuleObject(BLT_Module** module);
+
+/** @} */
+
+#endif /* _BLT_EQUALIZER_FILTER_H_ */
@@ -0,0 +1,374 @@
+/*****************************************************************
+|
+|   Fingerprint Filter Module - Analyzer
+|
+|   (c) 2002-2010 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltFingerprintAnalyzer.h"
+
+/*----------------------------------------------------------------------
+|   SIMD support
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_FINGERPRINT_ANALYZER_HAVE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLT_FINGERPRINT_ANALYZER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#define BLT_FINGERPRINT_ANALYZER_PI          3.14159265358979323846
+#define BLT_FINGERPRINT_ANALYZER_SAMPLE_RATE 5512.0
+
+/* the real frames are transformed as complex frames of half the size */
+#define BLT_FINGERPRINT_ANALYZER_FRAME_SIZE  2048
+#define BLT_FINGERPRINT_ANALYZER_FFT_SIZE    1024
+#define BLT_FINGERPRINT_ANALYZER_FFT_BITS    10
+#define BLT_FINGERPRINT_ANALYZER_HOP_SIZE    256
+
+#define BLT_FINGERPRINT_ANALYZER_BAND_COUNT  33
+#define BLT_FINGERPRINT_ANALYZER_MIN_FREQ    300.0
+#define BLT_FINGERPRINT_ANALYZER_MAX_FREQ    2000.0
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+struct FingerprintAnalyzer {
+    /* each sample at 5512 Hz is the average of the input over its */
+    /* duration, which also filters out most of what would alias   */
+    BLT_UInt32     sample_rate;
+    double         step;   /* output samples per input sample        */
+    double         phase;  /* how much of the output sample is done  */
+    float          sum;
+
+    float          frame[BLT_FINGERPRINT_ANALYZER_FRAME_SIZE];
+    unsigned int   frame_fill;
+
+    float          window[BLT_FINGERPRINT_ANALYZER_FRAME_SIZE];
+    float          fft_re[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+    float          fft_im[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+
+    /* the twiddles of the stage with butterflies of half size h are */
+    /* at [h-1, 2h-1), so that each stage reads them contiguously    */
+    float          twiddle_re[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+    float          twiddle_im[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+
+    /* e^(-i*pi*k/FFT_SIZE), to split the spectrum of the real frame */
+    float          split_re[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+    float          split_im[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+
+    unsigned short bit_reverse[BLT_FINGERPRINT_ANALYZER_FFT_SIZE];
+    unsigned int   band_edges[BLT_FINGERPRINT_ANALYZER_BAND_COUNT+1];
+    float          differences[BLT_FINGERPRINT_ANALYZER_BAND_COUNT-1];
+    BLT_Boolean    has_differences;
+
+    BLT_UInt32*    hashes;
+    BLT_Cardinal   hash_count;
+    BLT_Cardinal   max_hash_count;
+};
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_Create
++---------------------------------------------------------------------*/
+BLT_Result
+FingerprintAnalyzer_Create(unsigned int          max_duration,
+                           FingerprintAnalyzer** analyzer)
+{
+    FingerprintAnalyzer* self;
+    unsigned int         i;
+
+    /* default */
+    *analyzer = NULL;
+
+    /* check parameters */
+    if (max_duration == 0) return BLT_ERROR_INVALID_PARAMETERS;
+
+    /* allocate the object */
+    self = (FingerprintAnalyzer*)ATX_AllocateZeroMemory(sizeof(FingerprintAnalyzer));
+    if (self == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    self->max_hash_count = (BLT_Cardinal)(max_duration*BLT_FINGERPRINT_ANALYZER_SAMPLE_RATE/
+                                          BLT_FINGERPRINT_ANALYZER_HOP_SIZE);
+    self->hashes = (BLT_UInt32*)ATX_AllocateMemory(self->max_hash_count*sizeof(BLT_UInt32));
+    if (self->hashes == NULL) {
+        ATX_FreeMemory(self);
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* compute the tables */
+    for (i=0; i<BLT_FINGERPRINT_ANALYZER_FRAME_SIZE; i++) {
+        self->window[i] = (float)(0.5-0.5*cos(2.0*BLT_FINGERPRINT_ANALYZER_PI*i/
+                                              BLT_FINGERPRINT_ANALYZER_FRAME_SIZE));
+    }
+    for (i=1; i<BLT_FINGERPRINT_ANALYZER_FFT_SIZE; i *= 2) {
+        unsigned int j;
+        for (j=0; j<i; j++) {
+            self->twiddle_re[i-1+j] = (float) cos(BLT_FINGERPRINT_ANALYZER_PI*j/i);
+            self->twiddle_im[i-1+j] = (float)-sin(BLT_FINGERPRINT_ANALYZER_PI*j/i);
+        }
+    }
+    for (i=0; i<BLT_FINGERPRINT_ANALYZER_FFT_SIZE; i++) {
+        unsigned int reversed = 0;
+        unsigned int b;
+        for (b=0; b<BLT_FINGERPRINT_ANALYZER_FFT_BITS; b++) {
+            if (i & (1<<b)) reversed |= 1<<(BLT_FINGERPRINT_ANALYZER_FFT_BITS-1-b);
+        }
+        self->bit_reverse[i] = (unsigned short)reversed;
+        self->split_re[i] = (float) cos(BLT_FINGERPRINT_ANALYZER_PI*i/BLT_FINGERPRINT_ANALYZER_FFT_SIZE);
+        self->split_im[i] = (float)-sin(BLT_FINGERPRINT_ANALYZER_PI*i/BLT_FINGERPRINT_ANALYZER_FFT_SIZE);
+    }
+    for (i=0; i<=BLT_FINGERPRINT_ANALYZER_BAND_COUNT; i++) {
+        double frequency = BLT_FINGERPRINT_ANALYZER_MIN_FREQ*
+                           pow(BLT_FINGERPRINT_ANALYZER_MAX_FREQ/BLT_FINGERPRINT_ANALYZER_MIN_FREQ,
+                               (double)i/BLT_FINGERPRINT_ANALYZER_BAND_COUNT);
+        self->band_edges[i] = (unsigned int)floor(frequency*BLT_FINGERPRINT_ANALYZER_FRAME_SIZE/
+                                                  BLT_FINGERPRINT_ANALYZER_SAMPLE_RATE+0.5);
+    }
+
+    *analyzer = self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+FingerprintAnalyzer_Destroy(FingerprintAnalyzer* self)
+{
+    if (self == NULL) return BLT_SUCCESS;
+
+    ATX_FreeMemory(self->hashes);
+    ATX_FreeMemory(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_ClearHistory
++---------------------------------------------------------------------*/
+void
+FingerprintAnalyzer_ClearHistory(FingerprintAnalyzer* self)
+{
+    self->phase           = 0.0;
+    self->sum             = 0.0f;
+    self->frame_fill      = 0;
+    self->has_differences = BLT_FALSE;
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_Reset
++---------------------------------------------------------------------*/
+void
+FingerprintAnalyzer_Reset(FingerprintAnalyzer* self)
+{
+    FingerprintAnalyzer_ClearHistory(self);
+    self->hash_count = 0;
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_Fft
+|
+|   in-place radix-2 transform of fft_re/fft_im, which must already be
+|   in bit reversed order
++---------------------------------------------------------------------*/
+static void
+FingerprintAnalyzer_Fft(FingerprintAnalyzer* self)
+{
+    float*       re = self->fft_re;
+    float*       im = self->fft_im;
+    unsigned int half;
+
+    for (half=1; half<BLT_FINGERPRINT_ANALYZER_FFT_SIZE; half *= 2) {
+        const float* w_re = self->twiddle_re+half-1;
+        const float* w_im = self->twiddle_im+half-1;
+        unsigned int start;
+
+        for (start=0; start<BLT_FINGERPRINT_ANALYZER_FFT_SIZE; start += 2*half) {
+            float*       a_re = re+start;
+            float*       a_im = im+start;
+            float*       b_re = a_re+half;
+            float*       b_im = a_im+half;
+            unsigned int j = 0;
+
+            /* four butterflies at a time in the later stages */
+#if defined(BLT_FINGERPRINT_ANALYZER_HAVE_SSE2)
+            for (; j+4 <= half; j += 4) {
+                __m128 wr = _mm_loadu_ps(w_re+j);
+                __m128 wi = _mm_loadu_ps(w_im+j);
+                __m128 xr = _mm_loadu_ps(b_re+j);
+                __m128 xi = _mm_loadu_ps(b_im+j);
+                __m128 yr = _mm_loadu_ps(a_re+j);
+                __m128 yi = _mm_loadu_ps(a_im+j);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr));
+                _mm_storeu_ps(b_re+j, _mm_sub_ps(yr, tr));
+                _mm_storeu_ps(b_im+j, _mm_sub_ps(yi, ti));
+                _mm_storeu_ps(a_re+j, _mm_add_ps(yr, tr));
+                _mm_storeu_ps(a_im+j, _mm_add_ps(yi, ti));
+            }
+#elif defined(BLT_FINGERPRINT_ANALYZER_HAVE_NEON)
+            for (; j+4 <= half; j += 4) {
+                float32x4_t wr = vld1q_f32(w_re+j);
+                float32x4_t wi = vld1q_f32(w_im+j);
+                float32x4_t xr = vld1q_f32(b_re+j);
+                float32x4_t xi = vld1q_f32(b_im+j);
+                float32x4_t yr = vld1q_f32(a_re+j);
+                float32x4_t yi = vld1q_f32(a_im+j);
+                float32x4_t tr = vsubq_f32(vmulq_f32(wr, xr), vmulq_f32(wi, xi));
+                float32x4_t ti = vaddq_f32(vmulq_f32(wr, xi), vmulq_f32(wi, xr));
+                vst1q_f32(b_re+j, vsubq_f32(yr, tr));
+                vst1q_f32(b_im+j, vsubq_f32(yi, ti));
+                vst1q_f32(a_re+j, vaddq_f32(yr, tr));
+                vst1q_f32(a_im+j, vaddq_f32(yi, ti));
+            }
+#endif
+            for (; j<half; j++) {
+                float tr = w_re[j]*b_re[j]-w_im[j]*b_im[j];
+                float ti = w_re[j]*b_im[j]+w_im[j]*b_re[j];
+                b_re[j] = a_re[j]-tr;
+                b_im[j] = a_im[j]-ti;
+                a_re[j] = a_re[j]+tr;
+                a_im[j] = a_im[j]+ti;
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_AnalyzeFrame
++---------------------------------------------------------------------*/
+static void
+FingerprintAnalyzer_AnalyzeFrame(FingerprintAnalyzer* self)
+{
+    float        energies[BLT_FINGERPRINT_ANALYZER_BAND_COUNT];
+    BLT_UInt32   hash = 0;
+    unsigned int n = BLT_FINGERPRINT_ANALYZER_FFT_SIZE;
+    unsigned int i, band;
+
+    /* even samples in the real part, odd samples in the imaginary part */
+    for (i=0; i<n; i++) {
+        unsigned int k = self->bit_reverse[i];
+        self->fft_re[k] = self->frame[2*i  ]*self->window[2*i  ];
+        self->fft_im[k] = self->frame[2*i+1]*self->window[2*i+1];
+    }
+    FingerprintAnalyzer_Fft(self);
+
+    /* get the spectrum of the real frame from the complex one, but */
+    /* only for the bins that fall in a band                         */
+    for (band=0; band<BLT_FINGERPRINT_ANALYZER_BAND_COUNT; band++) {
+        float energy = 0.0f;
+        for (i=self->band_edges[band]; i<self->band_edges[band+1]; i++) {
+            float z_re  = self->fft_re[i];
+            float z_im  = self->fft_im[i];
+            float c_re  =  self->fft_re[n-i];
+            float c_im  = -self->fft_im[n-i];
+            float e_re  = 0.5f*(z_re+c_re);
+            float e_im  = 0.5f*(z_im+c_im);
+            float o_re  = 0.5f*(z_im-c_im);
+            float o_im  = 0.5f*(c_re-z_re);
+            float x_re  = e_re+self->split_re[i]*o_re-self->split_im[i]*o_im;
+            float x_im  = e_im+self->split_re[i]*o_im+self->split_im[i]*o_re;
+            energy += x_re*x_re+x_im*x_im;
+        }
+        energies[band] = energy;
+    }
+
+    /* one bit per pair of adjacent bands */
+    for (band=0; band<BLT_FINGERPRINT_ANALYZER_BAND_COUNT-1; band++) {
+        float difference = energies[band]-energies[band+1];
+        if (difference-self->differences[band] > 0.0f) hash |= 1U<<band;
+        self->differences[band] = difference;
+    }
+    if (self->has_differences) {
+        self->hashes[self->hash_count++] = hash;
+    }
+    self->has_differences = BLT_TRUE;
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_Process
++---------------------------------------------------------------------*/
+BLT_Result
+FingerprintAnalyzer_Process(FingerprintAnalyzer* self,
+                            const float*         samples,
+                            BLT_Cardinal         frame_count,
+                            unsigned int         channel_count,
+                            BLT_UInt32           sample_rate)
+{
+    float        scale = channel_count ? 1.0f/(float)channel_count : 0.0f;
+    BLT_Cardinal i;
+
+    /* check parameters */
+    if (channel_count == 0 || sample_rate < (BLT_UInt32)BLT_FINGERPRINT_ANALYZER_SAMPLE_RATE) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* the resampling restarts when the rate changes */
+    if (sample_rate != self->sample_rate) {
+        self->sample_rate = sample_rate;
+        self->step        = BLT_FINGERPRINT_ANALYZER_SAMPLE_RATE/(double)sample_rate;
+        self->phase       = 0.0;
+        self->sum         = 0.0f;
+    }
+
+    for (i=0; i<frame_count && self->hash_count < self->max_hash_count; i++) {
+        float mono;
+
+        /* mix down */
+        if (channel_count == 2) {
+            mono = 0.5f*(samples[0]+samples[1]);
+        } else {
+            unsigned int c;
+            mono = 0.0f;
+            for (c=0; c<channel_count; c++) mono += samples[c];
+            mono *= scale;
+        }
+        samples += channel_count;
+
+        /* resample */
+        if (self->phase+self->step < 1.0) {
+            self->sum   += mono*(float)self->step;
+            self->phase += self->step;
+            continue;
+        }
+        self->frame[self->frame_fill++] = self->sum+mono*(float)(1.0-self->phase);
+        self->phase = self->phase+self->step-1.0;
+        self->sum   = mono*(float)self->phase;
+
+        /* analyze every full frame, then slide by one hop */
+        if (self->frame_fill == BLT_FINGERPRINT_ANALYZER_FRAME_SIZE) {
+            unsigned int j;
+            FingerprintAnalyzer_AnalyzeFrame(self);
+            for (j=0; j<BLT_FINGERPRINT_ANALYZER_FRAME_SIZE-BLT_FINGERPRINT_ANALYZER_HOP_SIZE; j++) {
+                self->frame[j] = self->frame[j+BLT_FINGERPRINT_ANALYZER_HOP_SIZE];
+            }
+            self->frame_fill -= BLT_FINGERPRINT_ANALYZER_HOP_SIZE;
+        }
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   FingerprintAnalyzer_GetHashes
++---------------------------------------------------------------------*/
+const BLT_UInt32*
+FingerprintAnalyzer_GetHashes(FingerprintAnalyzer* self, BLT_Cardinal* hash_count)
+{
+    *hash_count = self->hash_count;
+    return self->hashes;
+}
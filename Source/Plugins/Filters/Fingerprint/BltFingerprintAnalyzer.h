@@ -0,0 +1,83 @@
+/*****************************************************************
+|
+|   Fingerprint Filter Module - Analyzer
+|
+|   (c) 2002-2010 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_FINGERPRINT_ANALYZER_H_
+#define _BLT_FINGERPRINT_ANALYZER_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * Computes an acoustic fingerprint from interleaved native-endian float
+ * samples. The audio is mixed down to mono and brought down to 5512 Hz,
+ * then cut into 2048-sample Hann-windowed frames every 256 samples
+ * (46 ms). The energy of each frame is measured in 33 bands spaced
+ * logarithmically between 300 and 2000 Hz, and each frame gives a 32-bit
+ * sub-fingerprint, where bit m is set when the energy difference between
+ * bands m and m+1 grew since the previous frame. The sub-fingerprints
+ * don't depend on the sample rate, the channel count or the level, so
+ * that two encodings of the same recording can be matched by counting
+ * the bits that differ.
+ */
+typedef struct FingerprintAnalyzer FingerprintAnalyzer;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates an analyzer that only looks at the first max_duration seconds
+ * of audio, so that the memory it uses is bounded.
+ */
+BLT_Result FingerprintAnalyzer_Create(unsigned int          max_duration,
+                                      FingerprintAnalyzer** analyzer);
+BLT_Result FingerprintAnalyzer_Destroy(FingerprintAnalyzer* self);
+
+/**
+ * Starts a new fingerprint.
+ */
+void FingerprintAnalyzer_Reset(FingerprintAnalyzer* self);
+
+/**
+ * Drops the samples of the frame in progress, for when the next samples
+ * don't follow the previous ones, but keeps the sub-fingerprints.
+ */
+void FingerprintAnalyzer_ClearHistory(FingerprintAnalyzer* self);
+
+/**
+ * Analyzes frame_count frames. Sample rates under 5512 Hz are not
+ * supported.
+ */
+BLT_Result FingerprintAnalyzer_Process(FingerprintAnalyzer* self,
+                                       const float*         samples,
+                                       BLT_Cardinal         frame_count,
+                                       unsigned int         channel_count,
+                                       BLT_UInt32           sample_rate);
+
+/**
+ * Returns the sub-fingerprints computed so far.
+ */
+const BLT_UInt32* FingerprintAnalyzer_GetHashes(FingerprintAnalyzer* self,
+                                                BLT_Cardinal*        hash_count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_FINGERPRINT_ANALYZER_H_ */
@@ -14,6 +14,7 @@
 #include "BltConfig.h"
 #include "BltCore.h"
 #include "BltFingerprintFilter.h"
+#include "BltFingerprintAnalyzer.h"
 #include "BltMediaNode.h"
 #include "BltMedia.h"
 #include "BltPcm.h"
@@ -29,8 +30,11 @@ ATX_SET_LOCAL_LOGGER("bluetune.plugins.filters.fingerprint")
 /*----------------------------------------------------------------------
 |    constants
 +---------------------------------------------------------------------*/
-#define BLT_FINGERPRINT_FILTER_MODE_DISABLED  0
-#define BLT_FINGERPRINT_FILTER_MODE_ENABLED   1
+/* only the beginning of the audio is analyzed, which is enough to */
+/* identify it, and keeps the fingerprint small                      */
+#if !defined(BLT_CONFIG_FINGERPRINT_FILTER_MAX_DURATION)
+#define BLT_CONFIG_FINGERPRINT_FILTER_MAX_DURATION 120 /* seconds */
+#endif
 
 /*----------------------------------------------------------------------
 |    types
@@ -64,7 +68,9 @@ typedef struct {
     FingerprintFilterOutput    output;
     ATX_UInt32                 mode;
     ATX_PropertyListenerHandle property_listener_handle;
-    ATX_UInt32                 fingerprint_value;
+    FingerprintAnalyzer*       analyzer;
+    float*                     samples;      /* input converted to floats */
+    BLT_Size                   samples_size;
 } FingerprintFilter;
 
 /*----------------------------------------------------------------------
@@ -75,6 +81,111 @@ ATX_DECLARE_INTERFACE_MAP(FingerprintFilter, BLT_MediaNode)
 ATX_DECLARE_INTERFACE_MAP(FingerprintFilter, ATX_Referenceable)
 ATX_DECLARE_INTERFACE_MAP(FingerprintFilter, ATX_PropertyListener)
 
+/*----------------------------------------------------------------------
+|    FingerprintFilter_Analyze
++---------------------------------------------------------------------*/
+static BLT_Result
+FingerprintFilter_Analyze(FingerprintFilter*      self,
+                          const BLT_PcmMediaType* media_type,
+                          BLT_MediaPacket*        packet)
+{
+    unsigned int sample_size = media_type->bits_per_sample/8;
+    BLT_Cardinal frames;
+    const float* samples;
+    BLT_Result   result;
+
+    if (media_type->channel_count == 0 || sample_size == 0) {
+        return BLT_ERROR_INVALID_MEDIA_FORMAT;
+    }
+    frames = BLT_MediaPacket_GetPayloadSize(packet)/(media_type->channel_count*sample_size);
+    if (frames == 0) return BLT_SUCCESS;
+
+    /* get the samples as floats */
+    if (media_type->sample_format   == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE &&
+        media_type->bits_per_sample == 32) {
+        samples = (const float*)BLT_MediaPacket_GetPayloadBuffer(packet);
+    } else {
+        BLT_PcmMediaType float_type;
+        BLT_Size         size = frames*media_type->channel_count*sizeof(float);
+        if (self->samples_size < size) {
+            if (self->samples) ATX_FreeMemory(self->samples);
+            self->samples_size = 0;
+            self->samples = (float*)ATX_AllocateMemory(size);
+            if (self->samples == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+            self->samples_size = size;
+        }
+        float_type                 = *media_type;
+        float_type.bits_per_sample = 32;
+        float_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+        result = BLT_Pcm_ConvertSamples(media_type,
+                                        BLT_MediaPacket_GetPayloadBuffer(packet),
+                                        &float_type,
+                                        self->samples,
+                                        frames*media_type->channel_count,
+                                        BLT_PCM_KERNEL_ANY);
+        if (BLT_FAILED(result)) return result;
+        samples = self->samples;
+    }
+
+    return FingerprintAnalyzer_Process(self->analyzer,
+                                       samples,
+                                       frames,
+                                       media_type->channel_count,
+                                       media_type->sample_rate);
+}
+
+/*----------------------------------------------------------------------
+|    FingerprintFilter_Publish
+|
+|    sets the fingerprint stream property, as the base64 encoding of the
+|    sub-fingerprints in little-endian byte order
++---------------------------------------------------------------------*/
+static void
+FingerprintFilter_Publish(FingerprintFilter* self)
+{
+    static const char  base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const BLT_UInt32*  hashes;
+    BLT_Cardinal       hash_count;
+    BLT_Cardinal       byte_count;
+    BLT_Cardinal       i;
+    char*              string;
+    char*              out;
+    ATX_Properties*    stream_properties = NULL;
+    ATX_PropertyValue  fingerprint_property;
+
+    hashes = FingerprintAnalyzer_GetHashes(self->analyzer, &hash_count);
+    if (hash_count == 0) return;
+    if (ATX_BASE(self, BLT_BaseMediaNode).context == NULL ||
+        BLT_FAILED(BLT_Stream_GetProperties(ATX_BASE(self, BLT_BaseMediaNode).context,
+                                            &stream_properties))) {
+        return;
+    }
+
+    byte_count = 4*hash_count;
+    string = (char*)ATX_AllocateMemory(4*((byte_count+2)/3)+1);
+    if (string == NULL) return;
+    out = string;
+    for (i=0; i<byte_count; i += 3) {
+        BLT_UInt32 bits = 0;
+        unsigned int j;
+        for (j=0; j<3; j++) {
+            bits <<= 8;
+            if (i+j < byte_count) bits |= (hashes[(i+j)/4]>>(8*((i+j)%4))) & 0xFF;
+        }
+        *out++ = base64[(bits>>18) & 0x3F];
+        *out++ = base64[(bits>>12) & 0x3F];
+        *out++ = i+1 < byte_count ? base64[(bits>>6) & 0x3F] : '=';
+        *out++ = i+2 < byte_count ? base64[ bits     & 0x3F] : '=';
+    }
+    *out = '\0';
+
+    ATX_LOG_FINE_1("publishing fingerprint - %d sub-fingerprints", hash_count);
+    fingerprint_property.type        = ATX_PROPERTY_VALUE_TYPE_STRING;
+    fingerprint_property.data.string = string;
+    ATX_Properties_SetProperty(stream_properties, BLT_FINGERPRINT_VALUE, &fingerprint_property);
+    ATX_FreeMemory(string);
+}
+
 /*----------------------------------------------------------------------
 |    FingerprintFilterInput_PutPacket
 +---------------------------------------------------------------------*/
@@ -96,48 +207,46 @@ FingerprintFilterInput_PutPacket(BLT_PacketConsumer* _self,
         return BLT_ERROR_INVALID_MEDIA_TYPE;
     }
 
-    /* keep the packet */
-    self->output.packet = packet;
-    BLT_MediaPacket_AddReference(packet);
-
     /* exit now if we're not enabled */
     if (self->mode == BLT_FINGERPRINT_FILTER_MODE_DISABLED) {
+        self->output.packet = packet;
+        BLT_MediaPacket_AddReference(packet);
         return BLT_SUCCESS;
     }
 
-    /* for now, we only support 16-bit */
-    if (media_type->bits_per_sample != 16) {
-        return BLT_SUCCESS;
+    /* create the analyzer the first time */
+    if (self->analyzer == NULL) {
+        result = FingerprintAnalyzer_Create(BLT_CONFIG_FINGERPRINT_FILTER_MAX_DURATION,
+                                            &self->analyzer);
+        if (BLT_FAILED(result)) return result;
     }
 
     /* process the PCM data */
-    /* TODO: implement actual fingerprint here */
     packet_flags = BLT_MediaPacket_GetFlags(packet);
-    ATX_LOG_FINE_1("processing packet - flags=%d", packet_flags);
     if (packet_flags & BLT_MEDIA_PACKET_FLAG_START_OF_STREAM) {
-        /* reset the fingerprint value */
-        self->fingerprint_value = 0;
+        FingerprintAnalyzer_Reset(self->analyzer);
+    } else if (packet_flags & BLT_MEDIA_PACKET_FLAG_STREAM_DISCONTINUITY) {
+        FingerprintAnalyzer_ClearHistory(self->analyzer);
     }
-    /* dummy example: fingerprint value = total number of PCM samples */
-    if (media_type->channel_count) {
-        ATX_UInt32 sample_count = BLT_MediaPacket_GetPayloadSize(packet)/(media_type->channel_count*media_type->bits_per_sample/8);
-        self->fingerprint_value += sample_count;
+    result = FingerprintFilter_Analyze(self, media_type, packet);
+    if (BLT_FAILED(result)) {
+        ATX_LOG_FINE_1("cannot analyze packet (%d)", result);
     }
     if (packet_flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM) {
         /* emit the fingerprint as a stream property */
-        /* as a dummy example, the fingerprint value is the string 'FP:XXXX' where XXXX is the PCM sample count */
-        /* measured during the fingerprint measuring phase */
-        ATX_Properties*   stream_properties = NULL;
-        ATX_PropertyValue fingerprint_property;
-        char              fingerprint_string[64];
-        ATX_FormatStringN(fingerprint_string, sizeof(fingerprint_string), "FP:%d", self->fingerprint_value);
-        BLT_Stream_GetProperties(ATX_BASE(self, BLT_BaseMediaNode).context, &stream_properties);
-        fingerprint_property.type        = ATX_PROPERTY_VALUE_TYPE_STRING;
-        fingerprint_property.data.string = fingerprint_string;
-        ATX_Properties_SetProperty(stream_properties, "dummy.fingerprint", &fingerprint_property);
-        self->fingerprint_value = 0;
+        FingerprintFilter_Publish(self);
+        FingerprintAnalyzer_Reset(self->analyzer);
     }
-    
+
+    /* when only analyzing, nothing goes further */
+    if (self->mode == BLT_FINGERPRINT_FILTER_MODE_ANALYZE) {
+        return BLT_SUCCESS;
+    }
+
+    /* keep the packet */
+    self->output.packet = packet;
+    BLT_MediaPacket_AddReference(packet);
+
     return BLT_SUCCESS;
 }
 
@@ -306,6 +415,10 @@ FingerprintFilter_Destroy(FingerprintFilter* self)
         BLT_MediaPacket_Release(self->output.packet);
     }
 
+    /* free the analyzer and the buffer */
+    FingerprintAnalyzer_Destroy(self->analyzer);
+    if (self->samples) ATX_FreeMemory(self->samples);
+
     /* destruct the inherited object */
     BLT_BaseMediaNode_Destruct(&ATX_BASE(self, BLT_BaseMediaNode));
 
@@ -416,6 +529,9 @@ FingerprintFilter_Seek(BLT_MediaNode* _self,
         self->output.packet = NULL;
     }
 
+    /* the samples after the seek point don't follow the previous ones */
+    if (self->analyzer) FingerprintAnalyzer_ClearHistory(self->analyzer);
+
     return BLT_SUCCESS;
 }
 
@@ -18,6 +18,14 @@
  * that passes through it.
  * These media nodes expect media packets with PCM audio as input, 
  * and produce media packets with PCM audio as output.
+ * The fingerprint is computed when the BLT_FINGERPRINT_FILTER_MODE core
+ * property is set to BLT_FINGERPRINT_FILTER_MODE_ENABLED, or to
+ * BLT_FINGERPRINT_FILTER_MODE_ANALYZE, in which case the packets are
+ * consumed instead of being passed on, so that a file can be analyzed as
+ * fast as it can be decoded. At the end of the stream, the fingerprint is
+ * published as the BLT_FINGERPRINT_VALUE stream property: the base64
+ * encoding of the 32-bit sub-fingerprints, in little-endian byte order,
+ * about 21.5 per second of audio (see BltFingerprintAnalyzer.h).
  *
  * @{ 
  */
@@ -33,6 +41,13 @@
 +---------------------------------------------------------------------*/
 #define BLT_FINGERPRINT_FILTER_MODE "plugins.filters.fingerprint.mode"
 
+#define BLT_FINGERPRINT_FILTER_MODE_DISABLED 0
+#define BLT_FINGERPRINT_FILTER_MODE_ENABLED  1
+#define BLT_FINGERPRINT_FILTER_MODE_ANALYZE  2
+
+/** string stream property */
+#define BLT_FINGERPRINT_VALUE "Fingerprint.Value"
+
 /*----------------------------------------------------------------------
 |   module
 +---------------------------------------------------------------------*/
@@ -34,25 +34,48 @@ ATX_SET_LOCAL_LOGGER("bluetune.plugins.filters.gain-control")
 +---------------------------------------------------------------------*/
 #define BLT_GAIN_CONTROL_FILTER_MODULE_NAME "com.axiosys.filter.gain-control"
 
-#define BLT_GAIN_CONTROL_FILTER_FACTOR_RANGE 1024
-#define BLT_GAIN_CONTROL_FILTER_MAX_FACTOR   16*1024
-
 #define BLT_GAIN_CONTROL_REPLAY_GAIN_TRACK_VALUE_SET 1
 #define BLT_GAIN_CONTROL_REPLAY_GAIN_ALBUM_VALUE_SET 2
 
 #define BLT_GAIN_CONTROL_REPLAY_GAIN_MIN (-2300)
 #define BLT_GAIN_CONTROL_REPLAY_GAIN_MAX (1700)
 
+/* number of samples processed at a time */
+#define BLT_GAIN_CONTROL_FILTER_BLOCK_SIZE 1024
+
+/* the limiter keeps the peaks under -0.1 dB, bringing the gain down */
+/* over up to 5 ms before a peak, and back up with a 50 ms constant  */
+#define BLT_GAIN_CONTROL_FILTER_LIMITER_CEILING 0.98855309f
+#define BLT_GAIN_CONTROL_FILTER_LIMITER_ATTACK  0.005
+#define BLT_GAIN_CONTROL_FILTER_LIMITER_RELEASE 0.050
+
+#if !defined(BLT_CONFIG_GAIN_CONTROL_FILTER_DEFAULT_LIMITER)
+#define BLT_CONFIG_GAIN_CONTROL_FILTER_DEFAULT_LIMITER BLT_TRUE
+#endif
+
+/*----------------------------------------------------------------------
+|   SIMD support
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_GAIN_CONTROL_FILTER_HAVE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLT_GAIN_CONTROL_FILTER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
 /*----------------------------------------------------------------------
 |    types
 +---------------------------------------------------------------------*/
 typedef BLT_BaseModule GainControlFilterModule;
 
-typedef enum {
-    BLT_GAIN_CONTROL_FILTER_MODE_INACTIVE,
-    BLT_GAIN_CONTROL_FILTER_MODE_AMPLIFY,
-    BLT_GAIN_CONTROL_FILTER_MODE_ATTENUATE
-} GainControlMode;
+/* multiplies 'count' samples by one gain each, saturating integers */
+typedef void (*GainControlFilterKernel)(const void*  in, 
+                                        void*        out, 
+                                        const float* gains, 
+                                        BLT_Cardinal count);
 
 typedef struct {
     /* interfaces */
@@ -69,6 +92,19 @@ typedef struct {
     BLT_MediaPacket* packet;
 } GainControlFilterOutput;
 
+typedef struct {
+    float*   samples;
+    BLT_Size size;
+} GainControlFilterBuffer;
+
+typedef struct {
+    BLT_Boolean enabled;
+    float       envelope;    /* gain reduction at the end of the last packet */
+    BLT_UInt32  sample_rate; /* rate for which the constants were computed   */
+    float       attack_step;
+    float       release;
+} GainControlFilterLimiter;
+
 typedef struct {
     /* base class */
     ATX_EXTENDS(BLT_BaseMediaNode);
@@ -77,10 +113,14 @@ typedef struct {
     ATX_IMPLEMENTS(ATX_PropertyListener);
 
     /* members */
-    GainControlFilterInput  input;
-    GainControlFilterOutput output;
-    GainControlMode         mode;
-    unsigned short          factor;
+    GainControlFilterInput   input;
+    GainControlFilterOutput  output;
+    float                    gain;         /* gain to apply                       */
+    float                    current_gain; /* gain at the end of the last packet  */
+    BLT_Boolean              ramp;         /* go from current_gain to gain        */
+    GainControlFilterLimiter limiter;
+    GainControlFilterBuffer  buffers[2];
+    float                    gains[BLT_GAIN_CONTROL_FILTER_BLOCK_SIZE];
     struct {
         BLT_Flags flags;
         int       track_gain;
@@ -88,6 +128,7 @@ typedef struct {
     } replay_gain_info;
     ATX_PropertyListenerHandle track_gain_listener_handle;
     ATX_PropertyListenerHandle album_gain_listener_handle;
+    ATX_PropertyListenerHandle limiter_listener_handle;
 } GainControlFilter;
 
 /*----------------------------------------------------------------------
@@ -98,6 +139,348 @@ ATX_DECLARE_INTERFACE_MAP(GainControlFilter, BLT_MediaNode)
 ATX_DECLARE_INTERFACE_MAP(GainControlFilter, ATX_Referenceable)
 ATX_DECLARE_INTERFACE_MAP(GainControlFilter, ATX_PropertyListener)
 
+/*----------------------------------------------------------------------
+|    GainControlFilter_ReadS24
++---------------------------------------------------------------------*/
+static BLT_Int32
+GainControlFilter_ReadS24(const unsigned char* x)
+{
+#if BLT_CONFIG_CPU_BYTE_ORDER == BLT_CPU_LITTLE_ENDIAN
+    return ((BLT_Int32)(((BLT_UInt32)x[0]<<8) | ((BLT_UInt32)x[1]<<16) | ((BLT_UInt32)x[2]<<24)))>>8;
+#else
+    return ((BLT_Int32)(((BLT_UInt32)x[2]<<8) | ((BLT_UInt32)x[1]<<16) | ((BLT_UInt32)x[0]<<24)))>>8;
+#endif
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_WriteS24
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_WriteS24(unsigned char* x, BLT_Int32 sample)
+{
+#if BLT_CONFIG_CPU_BYTE_ORDER == BLT_CPU_LITTLE_ENDIAN
+    x[0] = (unsigned char)(sample);
+    x[1] = (unsigned char)(sample>>8);
+    x[2] = (unsigned char)(sample>>16);
+#else
+    x[0] = (unsigned char)(sample>>16);
+    x[1] = (unsigned char)(sample>>8);
+    x[2] = (unsigned char)(sample);
+#endif
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_ApplyS16
+|
+|    all the code paths clamp, then round halfway values away from zero,
+|    so that they produce the same samples
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_ApplyS16(const void* in, void* out, const float* gains, BLT_Cardinal count)
+{
+    const short* src = (const short*)in;
+    short*       dst = (short*)out;
+
+#if defined(BLT_GAIN_CONTROL_FILTER_HAVE_SSE2)
+    const __m128 lo   = _mm_set1_ps(-32768.0f);
+    const __m128 hi   = _mm_set1_ps(32767.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (; count >= 8; count -= 8, src += 8, dst += 8, gains += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)src);
+        __m128  a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+        __m128  b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+        a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(a, _mm_loadu_ps(gains)),   lo), hi);
+        b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(b, _mm_loadu_ps(gains+4)), lo), hi);
+        a = _mm_add_ps(a, _mm_or_ps(_mm_and_ps(a, sign), half));
+        b = _mm_add_ps(b, _mm_or_ps(_mm_and_ps(b, sign), half));
+        _mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+    }
+#elif defined(BLT_GAIN_CONTROL_FILTER_HAVE_NEON)
+    const float32x4_t lo   = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi   = vdupq_n_f32(32767.0f);
+    const uint32x4_t  half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+    const uint32x4_t  sign = vdupq_n_u32(0x80000000);
+    for (; count >= 8; count -= 8, src += 8, dst += 8, gains += 8) {
+        int16x8_t   x = vld1q_s16(src);
+        float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+        float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+        a = vminq_f32(vmaxq_f32(vmulq_f32(a, vld1q_f32(gains)),   lo), hi);
+        b = vminq_f32(vmaxq_f32(vmulq_f32(b, vld1q_f32(gains+4)), lo), hi);
+        a = vaddq_f32(a, vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(a), sign), half)));
+        b = vaddq_f32(b, vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(b), sign), half)));
+        vst1q_s16(dst, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+    }
+#endif
+
+    for (; count; count--) {
+        float v = (float)*src++ * *gains++;
+        if (v < -32768.0f) v = -32768.0f;
+        if (v >  32767.0f) v =  32767.0f;
+        *dst++ = (short)(v < 0.0f ? v-0.5f : v+0.5f);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_ApplyS24
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_ApplyS24(const void* in, void* out, const float* gains, BLT_Cardinal count)
+{
+    const unsigned char* src = (const unsigned char*)in;
+    unsigned char*       dst = (unsigned char*)out;
+
+    for (; count; count--, src += 3, dst += 3) {
+        float v = (float)GainControlFilter_ReadS24(src) * *gains++;
+        if (v < -8388608.0f) v = -8388608.0f;
+        if (v >  8388607.0f) v =  8388607.0f;
+        GainControlFilter_WriteS24(dst, (BLT_Int32)(v < 0.0f ? v-0.5f : v+0.5f));
+    }
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_ApplyS32
+|
+|    done with doubles, floats don't have enough precision for 32 bits
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_ApplyS32(const void* in, void* out, const float* gains, BLT_Cardinal count)
+{
+    const BLT_Int32* src = (const BLT_Int32*)in;
+    BLT_Int32*       dst = (BLT_Int32*)out;
+
+    for (; count; count--) {
+        double v = (double)*src++ * (double)*gains++;
+        if (v < -2147483648.0) v = -2147483648.0;
+        if (v >  2147483647.0) v =  2147483647.0;
+        *dst++ = (BLT_Int32)(v < 0.0 ? v-0.5 : v+0.5);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_ApplyFloat
+|
+|    float samples are scaled without clipping, to keep the headroom
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_ApplyFloat(const void* in, void* out, const float* gains, BLT_Cardinal count)
+{
+    const float* src = (const float*)in;
+    float*       dst = (float*)out;
+
+#if defined(BLT_GAIN_CONTROL_FILTER_HAVE_SSE2)
+    for (; count >= 4; count -= 4, src += 4, dst += 4, gains += 4) {
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_loadu_ps(src), _mm_loadu_ps(gains)));
+    }
+#elif defined(BLT_GAIN_CONTROL_FILTER_HAVE_NEON)
+    for (; count >= 4; count -= 4, src += 4, dst += 4, gains += 4) {
+        vst1q_f32(dst, vmulq_f32(vld1q_f32(src), vld1q_f32(gains)));
+    }
+#endif
+
+    for (; count; count--) {
+        *dst++ = *src++ * *gains++;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_GetKernel
++---------------------------------------------------------------------*/
+static GainControlFilterKernel
+GainControlFilter_GetKernel(const BLT_PcmMediaType* media_type)
+{
+    if (media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE) {
+        switch (media_type->bits_per_sample) {
+            case 16: return GainControlFilter_ApplyS16;
+            case 24: return GainControlFilter_ApplyS24;
+            case 32: return GainControlFilter_ApplyS32;
+        }
+    } else if (media_type->sample_format   == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE &&
+               media_type->bits_per_sample == 32) {
+        return GainControlFilter_ApplyFloat;
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_GetPeaks
+|
+|    computes the largest magnitude of each frame, relative to full scale
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_GetPeaks(const BLT_PcmMediaType* media_type,
+                           const void*             samples,
+                           BLT_Cardinal            frame_count,
+                           float*                  peaks)
+{
+    unsigned int channel_count = media_type->channel_count;
+    BLT_Cardinal i;
+    unsigned int c;
+
+    for (i=0; i<frame_count; i++) {
+        float peak = 0.0f;
+        for (c=0; c<channel_count; c++) {
+            float v;
+            if (media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE) {
+                v = ((const float*)samples)[i*channel_count+c];
+            } else if (media_type->bits_per_sample == 16) {
+                v = (float)((const short*)samples)[i*channel_count+c]*(1.0f/32768.0f);
+            } else if (media_type->bits_per_sample == 24) {
+                v = (float)GainControlFilter_ReadS24((const unsigned char*)samples+3*(i*channel_count+c))*(1.0f/8388608.0f);
+            } else {
+                v = (float)((const BLT_Int32*)samples)[i*channel_count+c]*(1.0f/2147483648.0f);
+            }
+            if (v < 0.0f) v = -v;
+            if (v > peak) peak = v;
+        }
+        peaks[i] = peak;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_GetBuffer
++---------------------------------------------------------------------*/
+static float*
+GainControlFilter_GetBuffer(GainControlFilter* self, unsigned int index, BLT_Cardinal count)
+{
+    GainControlFilterBuffer* buffer = &self->buffers[index];
+    BLT_Size                 size   = count*sizeof(float);
+
+    if (size > buffer->size) {
+        if (buffer->samples) ATX_FreeMemory(buffer->samples);
+        buffer->samples = (float*)ATX_AllocateMemory(size);
+        buffer->size    = buffer->samples ? size : 0;
+    }
+
+    return buffer->samples;
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_Limit
+|
+|    reduces the gain of each frame so that the peaks stay under the
+|    ceiling. The whole packet is available, so the gain starts going
+|    down before the peaks within the packet without adding any delay.
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_Limit(GainControlFilter*      self,
+                        const BLT_PcmMediaType* media_type,
+                        const void*             samples,
+                        BLT_Cardinal            frame_count,
+                        float*                  frame_gains,
+                        float*                  limits)
+{
+    GainControlFilterLimiter* limiter   = &self->limiter;
+    float                     envelope  = limiter->envelope;
+    float                     reduction = 1.0f;
+    BLT_Cardinal              i;
+
+    /* recompute the time constants when the sample rate changes */
+    if (limiter->sample_rate != media_type->sample_rate || limiter->attack_step == 0.0f) {
+        double rate = media_type->sample_rate ? (double)media_type->sample_rate : 44100.0;
+        limiter->sample_rate = media_type->sample_rate;
+        limiter->attack_step = (float)(1.0/(BLT_GAIN_CONTROL_FILTER_LIMITER_ATTACK*rate));
+        limiter->release     = (float)exp(-1.0/(BLT_GAIN_CONTROL_FILTER_LIMITER_RELEASE*rate));
+    }
+
+    /* the gain reduction that each frame needs */
+    GainControlFilter_GetPeaks(media_type, samples, frame_count, limits);
+    for (i=0; i<frame_count; i++) {
+        float peak = limits[i]*frame_gains[i];
+        limits[i] = peak > BLT_GAIN_CONTROL_FILTER_LIMITER_CEILING ?
+                    BLT_GAIN_CONTROL_FILTER_LIMITER_CEILING/peak : 
+                    1.0f;
+    }
+
+    /* going backwards, ramp the reduction down ahead of each peak */
+    for (i=frame_count; i--;) {
+        reduction += limiter->attack_step;
+        if (reduction > limits[i]) reduction = limits[i];
+        limits[i] = reduction;
+    }
+
+    /* going forward, let the gain recover slowly after the peaks */
+    for (i=0; i<frame_count; i++) {
+        envelope = 1.0f-(1.0f-envelope)*limiter->release;
+        if (envelope > limits[i]) envelope = limits[i];
+        frame_gains[i] *= envelope;
+    }
+    limiter->envelope = envelope;
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_ProcessSamples
++---------------------------------------------------------------------*/
+static BLT_Result
+GainControlFilter_ProcessSamples(GainControlFilter*      self,
+                                 const BLT_PcmMediaType* media_type,
+                                 GainControlFilterKernel kernel,
+                                 const void*             in,
+                                 void*                   out,
+                                 BLT_Size                size)
+{
+    unsigned int channel_count = media_type->channel_count;
+    unsigned int sample_size   = media_type->bits_per_sample/8;
+    BLT_Cardinal frame_count   = size/(channel_count*sample_size);
+    float        start         = self->ramp ? self->current_gain : self->gain;
+    float        end           = self->gain;
+    BLT_Boolean  limit         = self->limiter.enabled && (start > 1.0f || end > 1.0f);
+    BLT_Cardinal i;
+
+    /* the next packet continues from here */
+    self->current_gain = end;
+    self->ramp         = BLT_TRUE;
+    if (!limit) self->limiter.envelope = 1.0f;
+    if (frame_count == 0) return BLT_SUCCESS;
+
+    if (start == end && !limit) {
+        /* the same gain for all the samples */
+        BLT_Cardinal sample_count = frame_count*channel_count;
+        BLT_Cardinal block_size   = sample_count < BLT_GAIN_CONTROL_FILTER_BLOCK_SIZE ?
+                                    sample_count : BLT_GAIN_CONTROL_FILTER_BLOCK_SIZE;
+        for (i=0; i<block_size; i++) {
+            self->gains[i] = end;
+        }
+        while (sample_count) {
+            BLT_Cardinal chunk = sample_count < block_size ? sample_count : block_size;
+            kernel(in, out, self->gains, chunk);
+            in  = (const unsigned char*)in+chunk*sample_size;
+            out = (unsigned char*)out+chunk*sample_size;
+            sample_count -= chunk;
+        }
+    } else {
+        /* a gain per frame, interpolated when the gain changes */
+        BLT_Cardinal block_frames = BLT_GAIN_CONTROL_FILTER_BLOCK_SIZE/channel_count;
+        float*       frame_gains  = GainControlFilter_GetBuffer(self, 0, frame_count);
+        if (frame_gains == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+        for (i=0; i<frame_count; i++) {
+            frame_gains[i] = start+(end-start)*(float)(i+1)/(float)frame_count;
+        }
+        if (limit) {
+            float* limits = GainControlFilter_GetBuffer(self, 1, frame_count);
+            if (limits == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+            GainControlFilter_Limit(self, media_type, in, frame_count, frame_gains, limits);
+        }
+        for (i=0; i<frame_count; i+=block_frames) {
+            BLT_Cardinal chunk = frame_count-i < block_frames ? frame_count-i : block_frames;
+            BLT_Cardinal f;
+            unsigned int c;
+            float*       gains = self->gains;
+            for (f=0; f<chunk; f++) {
+                for (c=0; c<channel_count; c++) {
+                    *gains++ = frame_gains[i+f];
+                }
+            }
+            kernel(in, out, self->gains, chunk*channel_count);
+            in  = (const unsigned char*)in+chunk*channel_count*sample_size;
+            out = (unsigned char*)out+chunk*channel_count*sample_size;
+        }
+    }
+
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |    GainControlFilterInput_PutPacket
 +---------------------------------------------------------------------*/
@@ -105,11 +488,12 @@ BLT_METHOD
 GainControlFilterInput_PutPacket(BLT_PacketConsumer* _self,
                                  BLT_MediaPacket*    packet)
 {
-    GainControlFilter* self = ATX_SELF_M(input, GainControlFilter, BLT_PacketConsumer);
-    BLT_PcmMediaType*  media_type;
-    BLT_Cardinal       sample_count;
-    short*             pcm;
-    BLT_Result         result;
+    GainControlFilter*      self = ATX_SELF_M(input, GainControlFilter, BLT_PacketConsumer);
+    BLT_PcmMediaType*       media_type;
+    GainControlFilterKernel kernel;
+    BLT_MediaPacket*        copy;
+    BLT_Size                size;
+    BLT_Result              result;
 
     /* get the media type */
     result = BLT_MediaPacket_GetMediaType(packet, (const BLT_MediaType**)(const void*)&media_type);
@@ -120,37 +504,58 @@ GainControlFilterInput_PutPacket(BLT_PacketConsumer* _self,
         return BLT_ERROR_INVALID_MEDIA_TYPE;
     }
 
-    /* keep the packet */
-    self->output.packet = packet;
-    BLT_MediaPacket_AddReference(packet);
+    /* a new stream doesn't continue from the previous gain */
+    if (BLT_MediaPacket_GetFlags(packet) & (BLT_MEDIA_PACKET_FLAG_START_OF_STREAM |
+                                            BLT_MEDIA_PACKET_FLAG_STREAM_DISCONTINUITY)) {
+        self->ramp             = BLT_FALSE;
+        self->limiter.envelope = 1.0f;
+    }
 
-    /* exit now if we're inactive */
-    if (self->mode == BLT_GAIN_CONTROL_FILTER_MODE_INACTIVE ||
-        self->factor == 0) {
+    /* pass the packet through unchanged at unity gain, or if we */
+    /* don't support the format                                   */
+    kernel = GainControlFilter_GetKernel(media_type);
+    if ((self->gain == 1.0f && (!self->ramp || self->current_gain == 1.0f)) ||
+        kernel == NULL                                                      ||
+        media_type->channel_count == 0                                      ||
+        media_type->channel_count > BLT_GAIN_CONTROL_FILTER_BLOCK_SIZE) {
+        self->current_gain = self->gain;
+        self->output.packet = packet;
+        BLT_MediaPacket_AddReference(packet);
         return BLT_SUCCESS;
     }
 
-    /* for now, we only support 16-bit */
-    if (media_type->bits_per_sample != 16) {
+    /* process in place, unless someone else can see the packet */
+    size = BLT_MediaPacket_GetPayloadSize(packet);
+    if (BLT_MediaPacket_IsWritable(packet)) {
+        void* samples = BLT_MediaPacket_GetPayloadBuffer(packet);
+        result = GainControlFilter_ProcessSamples(self, media_type, kernel, samples, samples, size);
+        if (BLT_FAILED(result)) return result;
+        self->output.packet = packet;
+        BLT_MediaPacket_AddReference(packet);
         return BLT_SUCCESS;
     }
 
-    /* adjust the gain */
-    pcm = (short*)BLT_MediaPacket_GetPayloadBuffer(packet);
-    sample_count = BLT_MediaPacket_GetPayloadSize(packet)/2;
-    if (self->mode == BLT_GAIN_CONTROL_FILTER_MODE_AMPLIFY) {
-        register unsigned short factor = self->factor;
-        while (sample_count--) {
-            *pcm = (*pcm * factor) / BLT_GAIN_CONTROL_FILTER_FACTOR_RANGE;
-            pcm++;
-        }
-    } else {
-        register unsigned short factor = self->factor;
-        while (sample_count--) {
-            *pcm = (*pcm * BLT_GAIN_CONTROL_FILTER_FACTOR_RANGE)/factor;
-            pcm++;
-        }
+    /* process into a new packet with the same timing */
+    result = BLT_Core_CreateMediaPacket(ATX_BASE(self, BLT_BaseMediaNode).core,
+                                        size,
+                                        (const BLT_MediaType*)media_type,
+                                        &copy);
+    if (BLT_FAILED(result)) return result;
+    BLT_MediaPacket_SetPayloadSize(copy, size);
+    BLT_MediaPacket_SetFlags(copy, BLT_MediaPacket_GetFlags(packet));
+    BLT_MediaPacket_SetTimeStamp(copy, BLT_MediaPacket_GetTimeStamp(packet));
+    BLT_MediaPacket_SetDuration(copy, BLT_MediaPacket_GetDuration(packet));
+    result = GainControlFilter_ProcessSamples(self, 
+                                              media_type, 
+                                              kernel, 
+                                              BLT_MediaPacket_GetPayloadBuffer(packet), 
+                                              BLT_MediaPacket_GetPayloadBuffer(copy), 
+                                              size);
+    if (BLT_FAILED(result)) {
+        BLT_MediaPacket_Release(copy);
+        return result;
     }
+    self->output.packet = copy;
 
     return BLT_SUCCESS;
 }
@@ -298,6 +703,12 @@ GainControlFilter_Create(BLT_Module*              module,
     /* construct the inherited object */
     BLT_BaseMediaNode_Construct(&ATX_BASE(self, BLT_BaseMediaNode), module, core);
 
+    /* construct the object */
+    self->gain             = 1.0f;
+    self->current_gain     = 1.0f;
+    self->limiter.enabled  = BLT_CONFIG_GAIN_CONTROL_FILTER_DEFAULT_LIMITER;
+    self->limiter.envelope = 1.0f;
+
     /* setup interfaces */
     ATX_SET_INTERFACE_EX(self, GainControlFilter, BLT_BaseMediaNode, BLT_MediaNode);
     ATX_SET_INTERFACE_EX(self, GainControlFilter, BLT_BaseMediaNode, ATX_Referenceable);
@@ -324,6 +735,10 @@ GainControlFilter_Destroy(GainControlFilter* self)
         BLT_MediaPacket_Release(self->output.packet);
     }
 
+    /* free the buffers */
+    if (self->buffers[0].samples) ATX_FreeMemory(self->buffers[0].samples);
+    if (self->buffers[1].samples) ATX_FreeMemory(self->buffers[1].samples);
+
     /* destruct the inherited object */
     BLT_BaseMediaNode_Destruct(&ATX_BASE(self, BLT_BaseMediaNode));
 
@@ -356,23 +771,16 @@ GainControlFilter_GetPortByName(BLT_MediaNode*  _self,
 }
 
 /*----------------------------------------------------------------------
-|    GainControlFilter_DbToFactor
+|    GainControlFilter_DbToGain
 |
 |    The input parameter is the gain expressed in 100th of decibels
 +---------------------------------------------------------------------*/
-static unsigned short
-GainControlFilter_DbToFactor(int gain)
+static float
+GainControlFilter_DbToGain(int gain)
 {
-    double f = 
-        (double)BLT_GAIN_CONTROL_FILTER_FACTOR_RANGE *
-        pow(10.0, ((double)gain)/2000);
-    unsigned int factor = (unsigned int)f; 
-    if (f >= BLT_GAIN_CONTROL_FILTER_FACTOR_RANGE && 
-        f <= BLT_GAIN_CONTROL_FILTER_MAX_FACTOR) {
-        return (unsigned short)factor;    
-    } else {
-        return BLT_GAIN_CONTROL_FILTER_FACTOR_RANGE;
-    }
+    if (gain < BLT_GAIN_CONTROL_REPLAY_GAIN_MIN) gain = BLT_GAIN_CONTROL_REPLAY_GAIN_MIN;
+    if (gain > BLT_GAIN_CONTROL_REPLAY_GAIN_MAX) gain = BLT_GAIN_CONTROL_REPLAY_GAIN_MAX;
+    return (float)pow(10.0, ((double)gain)/2000);
 }
 
 /*----------------------------------------------------------------------
@@ -390,26 +798,32 @@ GainControlFilter_UpdateReplayGain(GainControlFilter* self)
         gain_value = 0;
     }
     
-    /* if the gain is 0, deactivate the filter */
+    /* if the gain is 0, the filter is inactive */
     if (gain_value == 0) {
-        /* disable the filter */
-        if (self->factor != 0) {
+        if (self->gain != 1.0f) {
             ATX_LOG_FINE("GainControlFilter::UpdateReplayGain - filter now inactive");
         }
-        self->factor = 0;
-        self->mode = BLT_GAIN_CONTROL_FILTER_MODE_INACTIVE;
+        self->gain = 1.0f;
         return;
     }
 
-    /* convert the gain value into a mode and a factor */
-    if (gain_value > 0) {
-        self->mode = BLT_GAIN_CONTROL_FILTER_MODE_AMPLIFY;
-        self->factor = GainControlFilter_DbToFactor(gain_value);
-        ATX_LOG_FINE_1("GainControlFilter::UpdateReplayGain - filter amplification = %d", self->factor);
-    } else {
-        self->mode = BLT_GAIN_CONTROL_FILTER_MODE_ATTENUATE;
-        self->factor = GainControlFilter_DbToFactor(-gain_value);
-        ATX_LOG_FINE_1("GainControlFilter::UpdateReplayGain - filter attenuation = %d", self->factor);
+    /* the change is ramped over the next packet */
+    self->gain = GainControlFilter_DbToGain(gain_value);
+    ATX_LOG_FINE_1("GainControlFilter::UpdateReplayGain - gain = %d/100 dB", gain_value);
+}
+
+/*----------------------------------------------------------------------
+|    GainControlFilter_UpdateLimiter
++---------------------------------------------------------------------*/
+static void
+GainControlFilter_UpdateLimiter(GainControlFilter* self, const ATX_PropertyValue* value)
+{
+    if (value == NULL) {
+        self->limiter.enabled = BLT_CONFIG_GAIN_CONTROL_FILTER_DEFAULT_LIMITER;
+    } else if (value->type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN) {
+        self->limiter.enabled = value->data.boolean;
+    } else if (value->type == ATX_PROPERTY_VALUE_TYPE_INTEGER) {
+        self->limiter.enabled = value->data.integer ? BLT_TRUE : BLT_FALSE;
     }
 }
 
@@ -472,6 +886,10 @@ GainControlFilter_Activate(BLT_MediaNode* _self, BLT_Stream* stream)
                                        BLT_REPLAY_GAIN_ALBUM_GAIN_VALUE,
                                        &ATX_BASE(self, ATX_PropertyListener),
                                        &self->album_gain_listener_handle);
+            ATX_Properties_AddListener(properties, 
+                                       BLT_GAIN_CONTROL_FILTER_OPTION_LIMITER,
+                                       &ATX_BASE(self, ATX_PropertyListener),
+                                       &self->limiter_listener_handle);
 
             /* read the initial values of the replay gain info */
             self->replay_gain_info.flags = 0;
@@ -487,11 +905,17 @@ GainControlFilter_Activate(BLT_MediaNode* _self, BLT_Stream* stream)
             }
             if (ATX_SUCCEEDED(ATX_Properties_GetProperty(
                     properties,
-                    BLT_REPLAY_GAIN_TRACK_GAIN_VALUE,
+                    BLT_REPLAY_GAIN_ALBUM_GAIN_VALUE,
                     &property)) &&
                 property.type == ATX_PROPERTY_VALUE_TYPE_INTEGER) {
                 GainControlFilter_UpdateReplayGainAlbumValue(self, &property.data);
             }
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(
+                    properties,
+                    BLT_GAIN_CONTROL_FILTER_OPTION_LIMITER,
+                    &property))) {
+                GainControlFilter_UpdateLimiter(self, &property);
+            }
         }
     }
 
@@ -520,6 +944,8 @@ GainControlFilter_Deactivate(BLT_MediaNode* _self)
                                           self->track_gain_listener_handle);
             ATX_Properties_RemoveListener(properties, 
                                           self->album_gain_listener_handle);
+            ATX_Properties_RemoveListener(properties, 
+                                          self->limiter_listener_handle);
         }
     }
 
@@ -547,6 +973,10 @@ GainControlFilter_Seek(BLT_MediaNode* _self,
         self->output.packet = NULL;
     }
 
+    /* the samples after the seek point don't follow the previous ones */
+    self->ramp             = BLT_FALSE;
+    self->limiter.envelope = 1.0f;
+
     return BLT_SUCCESS;
 }
 
@@ -584,7 +1014,9 @@ GainControlFilter_OnPropertyChanged(ATX_PropertyListener*    _self,
 {
     GainControlFilter* self = ATX_SELF(GainControlFilter, ATX_PropertyListener);
 
-    if (name && 
+    if (name && ATX_StringsEqual(name, BLT_GAIN_CONTROL_FILTER_OPTION_LIMITER)) {
+        GainControlFilter_UpdateLimiter(self, value);
+    } else if (name && 
         (value == NULL || value->type == ATX_PROPERTY_VALUE_TYPE_INTEGER)) {
         if (ATX_StringsEqual(name, BLT_REPLAY_GAIN_TRACK_GAIN_VALUE)) {
             GainControlFilter_UpdateReplayGainTrackValue(self, value?&value->data:NULL);
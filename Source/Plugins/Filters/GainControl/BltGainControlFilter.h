@@ -21,6 +21,9 @@
  * They amplify or attenuate the PCM audio by a variable gain factor. 
  * These media nodes listen for ReplayGain values set by other nodes in 
  * the chain when they are found in certain media format or meta-data.
+ * Changes of gain are ramped over one packet, and when the gain is positive,
+ * a peak limiter keeps the samples from clipping, unless it is disabled 
+ * with the BLT_GAIN_CONTROL_FILTER_OPTION_LIMITER stream property.
  *
  * @{ 
  */
@@ -36,6 +39,9 @@
 +---------------------------------------------------------------------*/
 #define BLT_GAIN_CONTROL_FILTER_OPTION_DO_REPLAY_GAIN "Plugins.GainControlFilter.DoReplayGain"
 
+/** boolean stream property */
+#define BLT_GAIN_CONTROL_FILTER_OPTION_LIMITER        "Plugins.GainControlFilter.Limiter"
+
 /*----------------------------------------------------------------------
 |   module
 +---------------------------------------------------------------------*/
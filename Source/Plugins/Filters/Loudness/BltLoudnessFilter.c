@@ -0,0 +1,825 @@
+/*****************************************************************
+|
+|   Loudness Filter Module
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltCore.h"
+#include "BltLoudnessFilter.h"
+#include "BltLoudnessMeter.h"
+#include "BltReplayGain.h"
+#include "BltMediaNode.h"
+#include "BltMedia.h"
+#include "BltPcm.h"
+#include "BltPacketProducer.h"
+#include "BltPacketConsumer.h"
+#include "BltStream.h"
+
+/*----------------------------------------------------------------------
+|   logging
++---------------------------------------------------------------------*/
+ATX_SET_LOCAL_LOGGER("bluetune.plugins.filters.loudness")
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+#define BLT_LOUDNESS_FILTER_MODULE_NAME "com.axiosys.filter.loudness"
+
+/* ReplayGain 2.0 reference level, in LUFS */
+#define BLT_LOUDNESS_FILTER_REFERENCE_LOUDNESS (-18.0)
+
+/* the measurements are published every second, and the gain only once */
+/* there are 3 seconds of audio, then when it moves by 0.1 dB or more   */
+#define BLT_LOUDNESS_FILTER_UPDATE_INTERVAL   1
+#define BLT_LOUDNESS_FILTER_GAIN_MIN_DURATION 3
+#define BLT_LOUDNESS_FILTER_GAIN_MIN_CHANGE   10
+
+#if !defined(BLT_CONFIG_LOUDNESS_FILTER_DEFAULT_APPLY_GAIN)
+#define BLT_CONFIG_LOUDNESS_FILTER_DEFAULT_APPLY_GAIN BLT_TRUE
+#endif
+
+/*----------------------------------------------------------------------
+|    types
++---------------------------------------------------------------------*/
+typedef BLT_BaseModule LoudnessFilterModule;
+
+typedef struct {
+    /* interfaces */
+    ATX_IMPLEMENTS(BLT_MediaPort);
+    ATX_IMPLEMENTS(BLT_PacketConsumer);
+} LoudnessFilterInput;
+
+typedef struct {
+    /* interfaces */
+    ATX_IMPLEMENTS(BLT_MediaPort);
+    ATX_IMPLEMENTS(BLT_PacketProducer);
+
+    /* members */
+    BLT_MediaPacket* packet;
+} LoudnessFilterOutput;
+
+typedef struct {
+    /* base class */
+    ATX_EXTENDS(BLT_BaseMediaNode);
+
+    /* interfaces */
+    ATX_IMPLEMENTS(ATX_PropertyListener);
+
+    /* members */
+    LoudnessFilterInput  input;
+    LoudnessFilterOutput output;
+    LoudnessMeter*       meter;
+    float*               samples;      /* input converted to floats       */
+    BLT_Size             samples_size;
+    BLT_Boolean          scan_only;
+    BLT_Boolean          apply_gain;
+    BLT_Cardinal         frame_count;  /* frames measured in this stream  */
+    BLT_Cardinal         next_update;  /* frame_count at the next update  */
+    struct {
+        BLT_Boolean published;
+        ATX_Int32   value;             /* in 100th of decibels            */
+    } gain;
+    ATX_PropertyListenerHandle scan_only_listener_handle;
+    ATX_PropertyListenerHandle apply_gain_listener_handle;
+} LoudnessFilter;
+
+/*----------------------------------------------------------------------
+|   forward declarations
++---------------------------------------------------------------------*/
+ATX_DECLARE_INTERFACE_MAP(LoudnessFilterModule, BLT_Module)
+ATX_DECLARE_INTERFACE_MAP(LoudnessFilter, BLT_MediaNode)
+ATX_DECLARE_INTERFACE_MAP(LoudnessFilter, ATX_Referenceable)
+ATX_DECLARE_INTERFACE_MAP(LoudnessFilter, ATX_PropertyListener)
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_GetBooleanOption
++---------------------------------------------------------------------*/
+static BLT_Boolean
+LoudnessFilter_GetBooleanOption(const ATX_PropertyValue* value, BLT_Boolean default_value)
+{
+    if (value == NULL) {
+        return default_value;
+    } else if (value->type == ATX_PROPERTY_VALUE_TYPE_BOOLEAN) {
+        return value->data.boolean ? BLT_TRUE : BLT_FALSE;
+    } else if (value->type == ATX_PROPERTY_VALUE_TYPE_INTEGER) {
+        return value->data.integer ? BLT_TRUE : BLT_FALSE;
+    }
+    return default_value;
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_SetFloatProperty
++---------------------------------------------------------------------*/
+static void
+LoudnessFilter_SetFloatProperty(ATX_Properties* properties, const char* name, double value)
+{
+    ATX_PropertyValue property_value;
+    property_value.type    = ATX_PROPERTY_VALUE_TYPE_FLOAT;
+    property_value.data.fp = (float)value;
+    ATX_Properties_SetProperty(properties, name, &property_value);
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_UpdateGain
+|
+|    publishes the measured gain as the track gain, unless the track
+|    gain was set by someone else
++---------------------------------------------------------------------*/
+static void
+LoudnessFilter_UpdateGain(LoudnessFilter* self, ATX_Properties* properties, double loudness)
+{
+    BLT_Stream*       stream = ATX_BASE(self, BLT_BaseMediaNode).context;
+    ATX_PropertyValue property;
+    float             gain   = (float)(BLT_LOUDNESS_FILTER_REFERENCE_LOUDNESS-loudness);
+    ATX_Int32         value  = (ATX_Int32)(gain*100.0f);
+
+    if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties,
+                                                 BLT_REPLAY_GAIN_TRACK_GAIN_VALUE,
+                                                 &property)) &&
+        property.type == ATX_PROPERTY_VALUE_TYPE_INTEGER) {
+        if (!self->gain.published || property.data.integer != self->gain.value) {
+            return;
+        }
+        if (value-self->gain.value < BLT_LOUDNESS_FILTER_GAIN_MIN_CHANGE &&
+            self->gain.value-value < BLT_LOUDNESS_FILTER_GAIN_MIN_CHANGE) {
+            return;
+        }
+    }
+
+    ATX_LOG_FINE_1("LoudnessFilter::UpdateGain - gain = %d/100 dB", value);
+    self->gain.published = BLT_TRUE;
+    self->gain.value     = value;
+    BLT_ReplayGain_SetStreamProperties(stream,
+                                       gain,
+                                       BLT_REPLAY_GAIN_SET_MODE_UPDATE,
+                                       0.0f,
+                                       BLT_REPLAY_GAIN_SET_MODE_IGNORE);
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_RemoveGain
+|
+|    removes the track gain we published, if it is still there
++---------------------------------------------------------------------*/
+static void
+LoudnessFilter_RemoveGain(LoudnessFilter* self)
+{
+    BLT_Stream*     stream = ATX_BASE(self, BLT_BaseMediaNode).context;
+    ATX_Properties* properties;
+
+    if (!self->gain.published) return;
+    self->gain.published = BLT_FALSE;
+    if (stream == NULL) return;
+
+    if (BLT_SUCCEEDED(BLT_Stream_GetProperties(stream, &properties))) {
+        ATX_PropertyValue property;
+        if (ATX_SUCCEEDED(ATX_Properties_GetProperty(properties,
+                                                     BLT_REPLAY_GAIN_TRACK_GAIN_VALUE,
+                                                     &property)) &&
+            property.type == ATX_PROPERTY_VALUE_TYPE_INTEGER &&
+            property.data.integer == self->gain.value) {
+            BLT_ReplayGain_SetStreamProperties(stream,
+                                               0.0f,
+                                               BLT_REPLAY_GAIN_SET_MODE_REMOVE,
+                                               0.0f,
+                                               BLT_REPLAY_GAIN_SET_MODE_IGNORE);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Publish
++---------------------------------------------------------------------*/
+static void
+LoudnessFilter_Publish(LoudnessFilter* self)
+{
+    BLT_Stream*     stream = ATX_BASE(self, BLT_BaseMediaNode).context;
+    ATX_Properties* properties;
+    double          value;
+
+    if (stream == NULL || self->meter == NULL) return;
+    if (BLT_FAILED(BLT_Stream_GetProperties(stream, &properties))) return;
+
+    if (LoudnessMeter_GetIntegratedLoudness(self->meter, &value)) {
+        LoudnessFilter_SetFloatProperty(properties, BLT_LOUDNESS_INTEGRATED_VALUE, value);
+        if (self->apply_gain &&
+            self->frame_count >= BLT_LOUDNESS_FILTER_GAIN_MIN_DURATION*
+                                 LoudnessMeter_GetSampleRate(self->meter)) {
+            LoudnessFilter_UpdateGain(self, properties, value);
+        }
+    }
+    if (LoudnessMeter_GetLoudnessRange(self->meter, &value)) {
+        LoudnessFilter_SetFloatProperty(properties, BLT_LOUDNESS_RANGE_VALUE, value);
+    }
+    value = LoudnessMeter_GetTruePeak(self->meter);
+    if (value > 0.0) {
+        LoudnessFilter_SetFloatProperty(properties, BLT_LOUDNESS_TRUE_PEAK_VALUE, 20.0*log10(value));
+    }
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Measure
++---------------------------------------------------------------------*/
+static BLT_Result
+LoudnessFilter_Measure(LoudnessFilter*         self,
+                       const BLT_PcmMediaType* media_type,
+                       BLT_MediaPacket*        packet)
+{
+    unsigned int sample_size = media_type->bits_per_sample/8;
+    BLT_Cardinal frames;
+    const float* samples;
+    BLT_Result   result;
+
+    if (media_type->channel_count == 0 || sample_size == 0) {
+        return BLT_ERROR_INVALID_MEDIA_FORMAT;
+    }
+    frames = BLT_MediaPacket_GetPayloadSize(packet)/(media_type->channel_count*sample_size);
+    if (frames == 0) return BLT_SUCCESS;
+
+    /* (re)create the meter when the format changes */
+    if (self->meter && !LoudnessMeter_Matches(self->meter,
+                                              media_type->sample_rate,
+                                              media_type->channel_count,
+                                              media_type->channel_mask)) {
+        ATX_LOG_FINE("LoudnessFilter::Measure - format changed");
+        LoudnessMeter_Destroy(self->meter);
+        self->meter       = NULL;
+        self->frame_count = 0;
+        self->next_update = 0;
+    }
+    if (self->meter == NULL) {
+        result = LoudnessMeter_Create(media_type->sample_rate,
+                                      media_type->channel_count,
+                                      media_type->channel_mask,
+                                      &self->meter);
+        if (BLT_FAILED(result)) return result;
+    }
+    if (self->next_update == 0) {
+        self->next_update = BLT_LOUDNESS_FILTER_UPDATE_INTERVAL*media_type->sample_rate;
+    }
+
+    /* get the samples as floats */
+    if (media_type->sample_format   == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE &&
+        media_type->bits_per_sample == 32) {
+        samples = (const float*)BLT_MediaPacket_GetPayloadBuffer(packet);
+    } else {
+        BLT_PcmMediaType float_type;
+        BLT_Size         size = frames*media_type->channel_count*sizeof(float);
+        if (self->samples_size < size) {
+            if (self->samples) ATX_FreeMemory(self->samples);
+            self->samples_size = 0;
+            self->samples = (float*)ATX_AllocateMemory(size);
+            if (self->samples == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+            self->samples_size = size;
+        }
+        float_type                 = *media_type;
+        float_type.bits_per_sample = 32;
+        float_type.sample_format   = BLT_PCM_SAMPLE_FORMAT_FLOAT_NE;
+        result = BLT_Pcm_ConvertSamples(media_type,
+                                        BLT_MediaPacket_GetPayloadBuffer(packet),
+                                        &float_type,
+                                        self->samples,
+                                        frames*media_type->channel_count,
+                                        BLT_PCM_KERNEL_ANY);
+        if (BLT_FAILED(result)) return result;
+        samples = self->samples;
+    }
+
+    LoudnessMeter_Process(self->meter, samples, frames);
+
+    /* publish the measurements every now and then */
+    self->frame_count += frames;
+    if (self->frame_count >= self->next_update) {
+        LoudnessFilter_Publish(self);
+        self->next_update = self->frame_count +
+                            BLT_LOUDNESS_FILTER_UPDATE_INTERVAL*media_type->sample_rate;
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilterInput_PutPacket
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilterInput_PutPacket(BLT_PacketConsumer* _self,
+                              BLT_MediaPacket*    packet)
+{
+    LoudnessFilter*   self = ATX_SELF_M(input, LoudnessFilter, BLT_PacketConsumer);
+    BLT_PcmMediaType* media_type;
+    BLT_Flags         flags = BLT_MediaPacket_GetFlags(packet);
+    BLT_Result        result;
+
+    /* get the media type */
+    result = BLT_MediaPacket_GetMediaType(packet, (const BLT_MediaType**)(const void*)&media_type);
+    if (BLT_FAILED(result)) return result;
+
+    /* check the media type */
+    if (media_type->base.id != BLT_MEDIA_TYPE_ID_AUDIO_PCM) {
+        return BLT_ERROR_INVALID_MEDIA_TYPE;
+    }
+
+    /* a new stream starts a new measurement */
+    if (flags & BLT_MEDIA_PACKET_FLAG_START_OF_STREAM) {
+        LoudnessFilter_RemoveGain(self);
+        if (self->meter) LoudnessMeter_Reset(self->meter);
+        self->frame_count = 0;
+        self->next_update = 0;
+    } else if (flags & BLT_MEDIA_PACKET_FLAG_STREAM_DISCONTINUITY) {
+        if (self->meter) LoudnessMeter_ClearHistory(self->meter);
+    }
+
+    /* measure, but let unsupported formats through */
+    result = LoudnessFilter_Measure(self, media_type, packet);
+    if (BLT_FAILED(result)) {
+        ATX_LOG_FINE_1("LoudnessFilter::PutPacket - cannot measure (%d)", result);
+    }
+    if (flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM) {
+        LoudnessFilter_Publish(self);
+    }
+
+    /* when scanning, nothing goes further */
+    if (self->scan_only) return BLT_SUCCESS;
+
+    self->output.packet = packet;
+    BLT_MediaPacket_AddReference(packet);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessFilterInput_QueryMediaType
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilterInput_QueryMediaType(BLT_MediaPort*         self,
+                                   BLT_Ordinal            index,
+                                   const BLT_MediaType**  media_type)
+{
+    BLT_COMPILER_UNUSED(self);
+    if (index == 0) {
+        *media_type = &BLT_GenericPcmMediaType;
+        return BLT_SUCCESS;
+    } else {
+        *media_type = NULL;
+        return BLT_FAILURE;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(LoudnessFilterInput)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilterInput, BLT_MediaPort)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilterInput, BLT_PacketConsumer)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|    BLT_PacketConsumer interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(LoudnessFilterInput, BLT_PacketConsumer)
+    LoudnessFilterInput_PutPacket
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPort interface
++---------------------------------------------------------------------*/
+BLT_MEDIA_PORT_IMPLEMENT_SIMPLE_TEMPLATE(LoudnessFilterInput,
+                                         "input",
+                                         PACKET,
+                                         IN)
+ATX_BEGIN_INTERFACE_MAP(LoudnessFilterInput, BLT_MediaPort)
+    LoudnessFilterInput_GetName,
+    LoudnessFilterInput_GetProtocol,
+    LoudnessFilterInput_GetDirection,
+    LoudnessFilterInput_QueryMediaType
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    LoudnessFilterOutput_GetPacket
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilterOutput_GetPacket(BLT_PacketProducer* _self,
+                               BLT_MediaPacket**   packet)
+{
+    LoudnessFilter* self = ATX_SELF_M(output, LoudnessFilter, BLT_PacketProducer);
+
+    if (self->output.packet) {
+        *packet = self->output.packet;
+        self->output.packet = NULL;
+        return BLT_SUCCESS;
+    } else {
+        *packet = NULL;
+        return BLT_ERROR_PORT_HAS_NO_DATA;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessFilterOutput_QueryMediaType
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilterOutput_QueryMediaType(BLT_MediaPort*         self,
+                                    BLT_Ordinal            index,
+                                    const BLT_MediaType**  media_type)
+{
+    BLT_COMPILER_UNUSED(self);
+    if (index == 0) {
+        *media_type = &BLT_GenericPcmMediaType;
+        return BLT_SUCCESS;
+    } else {
+        *media_type = NULL;
+        return BLT_FAILURE;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(LoudnessFilterOutput)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilterOutput, BLT_MediaPort)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilterOutput, BLT_PacketProducer)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|    BLT_MediaPort interface
++---------------------------------------------------------------------*/
+BLT_MEDIA_PORT_IMPLEMENT_SIMPLE_TEMPLATE(LoudnessFilterOutput,
+                                         "output",
+                                         PACKET,
+                                         OUT)
+ATX_BEGIN_INTERFACE_MAP(LoudnessFilterOutput, BLT_MediaPort)
+    LoudnessFilterOutput_GetName,
+    LoudnessFilterOutput_GetProtocol,
+    LoudnessFilterOutput_GetDirection,
+    LoudnessFilterOutput_QueryMediaType
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    BLT_PacketProducer interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(LoudnessFilterOutput, BLT_PacketProducer)
+    LoudnessFilterOutput_GetPacket
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Create
++---------------------------------------------------------------------*/
+static BLT_Result
+LoudnessFilter_Create(BLT_Module*              module,
+                      BLT_Core*                core,
+                      BLT_ModuleParametersType parameters_type,
+                      BLT_AnyConst             parameters,
+                      BLT_MediaNode**          object)
+{
+    LoudnessFilter* self;
+
+    ATX_LOG_FINE("LoudnessFilter::Create");
+
+    /* check parameters */
+    if (parameters == NULL ||
+        parameters_type != BLT_MODULE_PARAMETERS_TYPE_MEDIA_NODE_CONSTRUCTOR) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* allocate memory for the object */
+    self = ATX_AllocateZeroMemory(sizeof(LoudnessFilter));
+    if (self == NULL) {
+        *object = NULL;
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* construct the inherited object */
+    BLT_BaseMediaNode_Construct(&ATX_BASE(self, BLT_BaseMediaNode), module, core);
+
+    /* construct the object */
+    self->scan_only  = BLT_FALSE;
+    self->apply_gain = BLT_CONFIG_LOUDNESS_FILTER_DEFAULT_APPLY_GAIN;
+
+    /* setup interfaces */
+    ATX_SET_INTERFACE_EX(self, LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode);
+    ATX_SET_INTERFACE_EX(self, LoudnessFilter, BLT_BaseMediaNode, ATX_Referenceable);
+    ATX_SET_INTERFACE(self, LoudnessFilter, ATX_PropertyListener);
+    ATX_SET_INTERFACE(&self->input,  LoudnessFilterInput,  BLT_MediaPort);
+    ATX_SET_INTERFACE(&self->input,  LoudnessFilterInput,  BLT_PacketConsumer);
+    ATX_SET_INTERFACE(&self->output, LoudnessFilterOutput, BLT_MediaPort);
+    ATX_SET_INTERFACE(&self->output, LoudnessFilterOutput, BLT_PacketProducer);
+    *object = &ATX_BASE_EX(self, BLT_BaseMediaNode, BLT_MediaNode);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Destroy
++---------------------------------------------------------------------*/
+static BLT_Result
+LoudnessFilter_Destroy(LoudnessFilter* self)
+{
+    ATX_LOG_FINE("LoudnessFilter::Destroy");
+
+    /* release any input packet we may hold */
+    if (self->output.packet) {
+        BLT_MediaPacket_Release(self->output.packet);
+    }
+
+    /* free the meter and the buffer */
+    LoudnessMeter_Destroy(self->meter);
+    if (self->samples) ATX_FreeMemory(self->samples);
+
+    /* destruct the inherited object */
+    BLT_BaseMediaNode_Destruct(&ATX_BASE(self, BLT_BaseMediaNode));
+
+    /* free the object memory */
+    ATX_FreeMemory((void*)self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessFilter_GetPortByName
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilter_GetPortByName(BLT_MediaNode*  _self,
+                             BLT_CString     name,
+                             BLT_MediaPort** port)
+{
+    LoudnessFilter* self = ATX_SELF_EX(LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    if (ATX_StringsEqual(name, "input")) {
+        *port = &ATX_BASE(&self->input, BLT_MediaPort);
+        return BLT_SUCCESS;
+    } else if (ATX_StringsEqual(name, "output")) {
+        *port = &ATX_BASE(&self->output, BLT_MediaPort);
+        return BLT_SUCCESS;
+    } else {
+        *port = NULL;
+        return BLT_ERROR_NO_SUCH_PORT;
+    }
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Activate
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilter_Activate(BLT_MediaNode* _self, BLT_Stream* stream)
+{
+    LoudnessFilter* self = ATX_SELF_EX(LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    /* keep a reference to the stream */
+    ATX_BASE(self, BLT_BaseMediaNode).context = stream;
+
+    /* listen to settings on the new stream */
+    if (stream) {
+        ATX_Properties* properties;
+        if (BLT_SUCCEEDED(BLT_Stream_GetProperties(stream, &properties))) {
+            ATX_PropertyValue property;
+            ATX_Properties_AddListener(properties,
+                                       BLT_LOUDNESS_FILTER_OPTION_SCAN_ONLY,
+                                       &ATX_BASE(self, ATX_PropertyListener),
+                                       &self->scan_only_listener_handle);
+            ATX_Properties_AddListener(properties,
+                                       BLT_LOUDNESS_FILTER_OPTION_APPLY_GAIN,
+                                       &ATX_BASE(self, ATX_PropertyListener),
+                                       &self->apply_gain_listener_handle);
+
+            /* read the initial values */
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(
+                    properties,
+                    BLT_LOUDNESS_FILTER_OPTION_SCAN_ONLY,
+                    &property))) {
+                self->scan_only = LoudnessFilter_GetBooleanOption(&property, BLT_FALSE);
+            }
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(
+                    properties,
+                    BLT_LOUDNESS_FILTER_OPTION_APPLY_GAIN,
+                    &property))) {
+                self->apply_gain = LoudnessFilter_GetBooleanOption(
+                    &property,
+                    BLT_CONFIG_LOUDNESS_FILTER_DEFAULT_APPLY_GAIN);
+            }
+        }
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Deactivate
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilter_Deactivate(BLT_MediaNode* _self)
+{
+    LoudnessFilter* self = ATX_SELF_EX(LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    /* don't leave our gain behind */
+    LoudnessFilter_RemoveGain(self);
+
+    /* remove our listeners */
+    if (ATX_BASE(self, BLT_BaseMediaNode).context) {
+        ATX_Properties* properties;
+        if (BLT_SUCCEEDED(BLT_Stream_GetProperties(ATX_BASE(self, BLT_BaseMediaNode).context,
+                                                   &properties))) {
+            ATX_Properties_RemoveListener(properties,
+                                          self->scan_only_listener_handle);
+            ATX_Properties_RemoveListener(properties,
+                                          self->apply_gain_listener_handle);
+        }
+    }
+
+    /* we're detached from the stream */
+    ATX_BASE(self, BLT_BaseMediaNode).context = NULL;
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_Seek
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilter_Seek(BLT_MediaNode* _self,
+                    BLT_SeekMode*  mode,
+                    BLT_SeekPoint* point)
+{
+    LoudnessFilter* self = ATX_SELF_EX(LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode);
+
+    BLT_COMPILER_UNUSED(mode);
+    BLT_COMPILER_UNUSED(point);
+
+    if (self->output.packet) {
+        BLT_MediaPacket_Release(self->output.packet);
+        self->output.packet = NULL;
+    }
+
+    /* the samples after the seek point don't follow the previous ones, */
+    /* but what was measured before still counts                        */
+    if (self->meter) LoudnessMeter_ClearHistory(self->meter);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(LoudnessFilter)
+    ATX_GET_INTERFACE_ACCEPT_EX(LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode)
+    ATX_GET_INTERFACE_ACCEPT_EX(LoudnessFilter, BLT_BaseMediaNode, ATX_Referenceable)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilter, ATX_PropertyListener)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|    BLT_MediaNode interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP_EX(LoudnessFilter, BLT_BaseMediaNode, BLT_MediaNode)
+    BLT_BaseMediaNode_GetInfo,
+    LoudnessFilter_GetPortByName,
+    LoudnessFilter_Activate,
+    LoudnessFilter_Deactivate,
+    BLT_BaseMediaNode_Start,
+    BLT_BaseMediaNode_Stop,
+    BLT_BaseMediaNode_Pause,
+    BLT_BaseMediaNode_Resume,
+    LoudnessFilter_Seek
+};
+
+/*----------------------------------------------------------------------
+|    LoudnessFilter_OnPropertyChanged
++---------------------------------------------------------------------*/
+BLT_VOID_METHOD
+LoudnessFilter_OnPropertyChanged(ATX_PropertyListener*    _self,
+                                 ATX_CString              name,
+                                 const ATX_PropertyValue* value)
+{
+    LoudnessFilter* self = ATX_SELF(LoudnessFilter, ATX_PropertyListener);
+
+    if (name == NULL) return;
+    if (ATX_StringsEqual(name, BLT_LOUDNESS_FILTER_OPTION_SCAN_ONLY)) {
+        self->scan_only = LoudnessFilter_GetBooleanOption(value, BLT_FALSE);
+    } else if (ATX_StringsEqual(name, BLT_LOUDNESS_FILTER_OPTION_APPLY_GAIN)) {
+        self->apply_gain = LoudnessFilter_GetBooleanOption(
+            value,
+            BLT_CONFIG_LOUDNESS_FILTER_DEFAULT_APPLY_GAIN);
+        if (!self->apply_gain) LoudnessFilter_RemoveGain(self);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    ATX_PropertyListener interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(LoudnessFilter, ATX_PropertyListener)
+    LoudnessFilter_OnPropertyChanged,
+};
+
+/*----------------------------------------------------------------------
+|   ATX_Referenceable interface
++---------------------------------------------------------------------*/
+ATX_IMPLEMENT_REFERENCEABLE_INTERFACE_EX(LoudnessFilter,
+                                         BLT_BaseMediaNode,
+                                         reference_count)
+
+/*----------------------------------------------------------------------
+|   LoudnessFilterModule_Probe
++---------------------------------------------------------------------*/
+BLT_METHOD
+LoudnessFilterModule_Probe(BLT_Module*              self,
+                           BLT_Core*                core,
+                           BLT_ModuleParametersType parameters_type,
+                           BLT_AnyConst             parameters,
+                           BLT_Cardinal*            match)
+{
+    BLT_COMPILER_UNUSED(self);
+    BLT_COMPILER_UNUSED(core);
+
+    switch (parameters_type) {
+      case BLT_MODULE_PARAMETERS_TYPE_MEDIA_NODE_CONSTRUCTOR:
+        {
+            BLT_MediaNodeConstructor* constructor =
+                (BLT_MediaNodeConstructor*)parameters;
+
+            /* we need a name */
+            if (constructor->name == NULL ||
+                !ATX_StringsEqual(constructor->name, BLT_LOUDNESS_FILTER_MODULE_NAME)) {
+                return BLT_FAILURE;
+            }
+
+            /* the input and output protocols should be PACKET */
+            if ((constructor->spec.input.protocol  != BLT_MEDIA_PORT_PROTOCOL_ANY &&
+                 constructor->spec.input.protocol  != BLT_MEDIA_PORT_PROTOCOL_PACKET) ||
+                (constructor->spec.output.protocol != BLT_MEDIA_PORT_PROTOCOL_ANY &&
+                 constructor->spec.output.protocol != BLT_MEDIA_PORT_PROTOCOL_PACKET)) {
+                return BLT_FAILURE;
+            }
+
+            /* the input type should be unspecified, or audio/pcm */
+            if (!(constructor->spec.input.media_type->id == BLT_MEDIA_TYPE_ID_AUDIO_PCM) &&
+                !(constructor->spec.input.media_type->id == BLT_MEDIA_TYPE_ID_UNKNOWN)) {
+                return BLT_FAILURE;
+            }
+
+            /* the output type should be unspecified, or audio/pcm */
+            if (!(constructor->spec.output.media_type->id == BLT_MEDIA_TYPE_ID_AUDIO_PCM) &&
+                !(constructor->spec.output.media_type->id == BLT_MEDIA_TYPE_ID_UNKNOWN)) {
+                return BLT_FAILURE;
+            }
+
+            /* match level is always exact */
+            *match = BLT_MODULE_PROBE_MATCH_EXACT;
+
+            ATX_LOG_FINE_1("LoudnessFilterModule::Probe - Ok [%d]", *match);
+            return BLT_SUCCESS;
+        }
+        break;
+
+      default:
+        break;
+    }
+
+    return BLT_FAILURE;
+}
+
+/*----------------------------------------------------------------------
+|   GetInterface implementation
++---------------------------------------------------------------------*/
+ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(LoudnessFilterModule)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilterModule, BLT_Module)
+    ATX_GET_INTERFACE_ACCEPT(LoudnessFilterModule, ATX_Referenceable)
+ATX_END_GET_INTERFACE_IMPLEMENTATION
+
+/*----------------------------------------------------------------------
+|   node factory
++---------------------------------------------------------------------*/
+BLT_MODULE_IMPLEMENT_SIMPLE_MEDIA_NODE_FACTORY(LoudnessFilterModule, LoudnessFilter)
+
+/*----------------------------------------------------------------------
+|   BLT_Module interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(LoudnessFilterModule, BLT_Module)
+    BLT_BaseModule_GetInfo,
+    BLT_BaseModule_Attach,
+    LoudnessFilterModule_CreateInstance,
+    LoudnessFilterModule_Probe
+ATX_END_INTERFACE_MAP
+
+/*----------------------------------------------------------------------
+|   ATX_Referenceable interface
++---------------------------------------------------------------------*/
+#define LoudnessFilterModule_Destroy(x) \
+    BLT_BaseModule_Destroy((BLT_BaseModule*)(x))
+
+ATX_IMPLEMENT_REFERENCEABLE_INTERFACE(LoudnessFilterModule, reference_count)
+
+/*----------------------------------------------------------------------
+|   module object
++---------------------------------------------------------------------*/
+BLT_MODULE_IMPLEMENT_STANDARD_GET_MODULE(LoudnessFilterModule,
+                                         "Loudness Filter",
+                                         BLT_LOUDNESS_FILTER_MODULE_NAME,
+                                         "1.0.0",
+                                         BLT_MODULE_AXIOMATIC_COPYRIGHT)
@@ -0,0 +1,65 @@
+/*****************************************************************
+|
+|   Loudness Filter Module
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_LOUDNESS_FILTER_H_
+#define _BLT_LOUDNESS_FILTER_H_
+
+/**
+ * @ingroup plugin_modules
+ * @ingroup plugin_filter_modules
+ * @defgroup loudness_filter_module Loudness Filter Module
+ * Plugin module that create media nodes that measure the loudness of
+ * PCM audio data, as specified by EBU R128.
+ * These media nodes expect media packets with PCM audio as input,
+ * and produce the same media packets as output.
+ * The integrated loudness, loudness range and true peak measured so far
+ * are published as stream properties about once per second, and when
+ * the stream ends. Unless the stream already has a ReplayGain track gain
+ * (from tags), the gain that brings the track to the ReplayGain 2.0
+ * reference level is published as one, so that a gain control filter
+ * further down the chain applies it.
+ * With the BLT_LOUDNESS_FILTER_OPTION_SCAN_ONLY stream property set, the
+ * packets are consumed instead of being passed on, so that a file can be
+ * measured as fast as it can be decoded.
+ *
+ * @{
+ */
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltTypes.h"
+#include "BltModule.h"
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/** float stream property, in LUFS */
+#define BLT_LOUDNESS_INTEGRATED_VALUE "Loudness.Integrated"
+
+/** float stream property, in LU */
+#define BLT_LOUDNESS_RANGE_VALUE      "Loudness.Range"
+
+/** float stream property, in dBTP */
+#define BLT_LOUDNESS_TRUE_PEAK_VALUE  "Loudness.TruePeak"
+
+/** boolean stream property */
+#define BLT_LOUDNESS_FILTER_OPTION_SCAN_ONLY  "Plugins.LoudnessFilter.ScanOnly"
+
+/** boolean stream property */
+#define BLT_LOUDNESS_FILTER_OPTION_APPLY_GAIN "Plugins.LoudnessFilter.ApplyGain"
+
+/*----------------------------------------------------------------------
+|   module
++---------------------------------------------------------------------*/
+BLT_Result BLT_LoudnessFilterModule_GetModuleObject(BLT_Module** module);
+
+/** @} */
+
+#endif /* _BLT_LOUDNESS_FILTER_H_ */
@@ -0,0 +1,699 @@
+/*****************************************************************
+|
+|   Loudness Filter Module - Loudness Meter
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltConfig.h"
+#include "BltPcm.h"
+#include "BltLoudnessMeter.h"
+
+/*----------------------------------------------------------------------
+|   SIMD support
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_LOUDNESS_METER_HAVE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLT_LOUDNESS_METER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+#define BLT_LOUDNESS_METER_PI 3.14159265358979323846
+
+/* blocks are made of 100 ms sub-blocks */
+#define BLT_LOUDNESS_METER_MOMENTARY_SUB_BLOCKS  4  /* 400 ms */
+#define BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS 30 /* 3 s    */
+
+/* gates, relative to the mean loudness of the blocks above -70 LUFS */
+#define BLT_LOUDNESS_METER_ABSOLUTE_GATE   (-70.0)
+#define BLT_LOUDNESS_METER_INTEGRATED_GATE (-10.0)
+#define BLT_LOUDNESS_METER_RANGE_GATE      (-20.0)
+
+/* histograms of block loudness, from -70 to +10 LUFS */
+#define BLT_LOUDNESS_METER_HISTOGRAM_STEP 0.1
+#define BLT_LOUDNESS_METER_HISTOGRAM_SIZE 800
+
+/* true peak interpolation filter */
+#define BLT_LOUDNESS_METER_TRUE_PEAK_PHASES 4
+#define BLT_LOUDNESS_METER_TRUE_PEAK_TAPS   12
+
+#define BLT_LOUDNESS_METER_SURROUND_WEIGHT  1.41
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+typedef struct {
+    BLT_UInt32 counts[BLT_LOUDNESS_METER_HISTOGRAM_SIZE];
+    double     energies[BLT_LOUDNESS_METER_HISTOGRAM_SIZE];
+} LoudnessHistogram;
+
+struct LoudnessMeter {
+    BLT_UInt32   sample_rate;
+    unsigned int channel_count;
+    BLT_UInt32   channel_mask;
+    double*      weights;
+
+    /* K-weighting: a high shelf then a high pass, each b0 b1 b2 a1 a2 */
+    double       coefficients[2][5];
+
+    /* states[k*channel_count+c] is the state k of channel c */
+    double*      states;
+
+    /* 100 ms sub-blocks */
+    BLT_Cardinal sub_block_size;
+    BLT_Cardinal sub_block_position;
+    double       sub_block_energy;
+    double       sub_blocks[BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS];
+    unsigned int sub_block_count;
+    unsigned int sub_block_index;
+
+    /* true peak: filter[k*PHASES+p] is tap k of phase p, and each */
+    /* channel has its last TAPS samples, stored twice so that the  */
+    /* window is always contiguous                                  */
+    float        true_peak_filter[BLT_LOUDNESS_METER_TRUE_PEAK_TAPS*
+                                  BLT_LOUDNESS_METER_TRUE_PEAK_PHASES];
+    float*       true_peak_history;
+    unsigned int true_peak_position;
+    float        true_peak;
+
+    LoudnessHistogram momentary;
+    LoudnessHistogram short_term;
+};
+
+/*----------------------------------------------------------------------
+|   LoudnessHistogram_Add
++---------------------------------------------------------------------*/
+static void
+LoudnessHistogram_Add(LoudnessHistogram* self, double energy)
+{
+    double loudness;
+    int    bin;
+
+    if (energy <= 0.0) return;
+    loudness = -0.691+10.0*log10(energy);
+    if (loudness < BLT_LOUDNESS_METER_ABSOLUTE_GATE) return;
+
+    bin = (int)((loudness-BLT_LOUDNESS_METER_ABSOLUTE_GATE)/BLT_LOUDNESS_METER_HISTOGRAM_STEP);
+    if (bin >= BLT_LOUDNESS_METER_HISTOGRAM_SIZE) bin = BLT_LOUDNESS_METER_HISTOGRAM_SIZE-1;
+    self->counts[bin]++;
+    self->energies[bin] += energy;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessHistogram_GetGateBin
+|
+|   finds the first bin above a gate relative to the mean loudness
++---------------------------------------------------------------------*/
+static BLT_Boolean
+LoudnessHistogram_GetGateBin(const LoudnessHistogram* self, double gate, unsigned int* gate_bin)
+{
+    double       energy = 0.0;
+    double       count  = 0.0;
+    double       threshold;
+    unsigned int i;
+
+    for (i=0; i<BLT_LOUDNESS_METER_HISTOGRAM_SIZE; i++) {
+        energy += self->energies[i];
+        count  += (double)self->counts[i];
+    }
+    if (count == 0.0) return BLT_FALSE;
+
+    /* bins are kept when their center is above the threshold */
+    threshold = -0.691+10.0*log10(energy/count)+gate;
+    threshold = ceil((threshold-BLT_LOUDNESS_METER_ABSOLUTE_GATE)/BLT_LOUDNESS_METER_HISTOGRAM_STEP-0.5);
+    if (threshold < 0.0) threshold = 0.0;
+    if (threshold > (double)BLT_LOUDNESS_METER_HISTOGRAM_SIZE) {
+        threshold = (double)BLT_LOUDNESS_METER_HISTOGRAM_SIZE;
+    }
+    *gate_bin = (unsigned int)threshold;
+
+    return BLT_TRUE;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_GetChannelWeight
++---------------------------------------------------------------------*/
+static double
+LoudnessMeter_GetChannelWeight(BLT_UInt32 speaker)
+{
+    switch (speaker) {
+        case BLT_PCM_SPEAKER_LOW_FREQUENCY:
+            return 0.0;
+
+        case BLT_PCM_SPEAKER_BACK_LEFT:
+        case BLT_PCM_SPEAKER_BACK_RIGHT:
+        case BLT_PCM_SPEAKER_SIDE_LEFT:
+        case BLT_PCM_SPEAKER_SIDE_RIGHT:
+            return BLT_LOUDNESS_METER_SURROUND_WEIGHT;
+
+        default:
+            return 1.0;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_ComputeFilters
+|
+|   the BS.1770 filters are specified at 48 kHz, so they are derived
+|   from their analog prototypes for other rates
++---------------------------------------------------------------------*/
+static void
+LoudnessMeter_ComputeFilters(LoudnessMeter* self)
+{
+    double rate = (double)self->sample_rate;
+    double k, q, vh, vb, a0;
+    int    p, t;
+
+    /* high shelf, +4 dB above 1.5 kHz */
+    k  = tan(BLT_LOUDNESS_METER_PI*1681.974450955533/rate);
+    q  = 0.7071752369554196;
+    vh = pow(10.0, 3.999843853973347/20.0);
+    vb = pow(vh, 0.4996667741545416);
+    a0 = 1.0+k/q+k*k;
+    self->coefficients[0][0] = (vh+vb*k/q+k*k)/a0;
+    self->coefficients[0][1] = 2.0*(k*k-vh)/a0;
+    self->coefficients[0][2] = (vh-vb*k/q+k*k)/a0;
+    self->coefficients[0][3] = 2.0*(k*k-1.0)/a0;
+    self->coefficients[0][4] = (1.0-k/q+k*k)/a0;
+
+    /* high pass at 38 Hz */
+    k  = tan(BLT_LOUDNESS_METER_PI*38.13547087602444/rate);
+    q  = 0.5003270373238773;
+    a0 = 1.0+k/q+k*k;
+    self->coefficients[1][0] = 1.0;
+    self->coefficients[1][1] = -2.0;
+    self->coefficients[1][2] = 1.0;
+    self->coefficients[1][3] = 2.0*(k*k-1.0)/a0;
+    self->coefficients[1][4] = (1.0-k/q+k*k)/a0;
+
+    /* true peak: Hann-windowed sinc, interpolating between the middle */
+    /* samples of the window, with a unity gain at DC for each phase   */
+    for (p=0; p<BLT_LOUDNESS_METER_TRUE_PEAK_PHASES; p++) {
+        double taps[BLT_LOUDNESS_METER_TRUE_PEAK_TAPS];
+        double sum = 0.0;
+        for (t=0; t<BLT_LOUDNESS_METER_TRUE_PEAK_TAPS; t++) {
+            double x = (double)(BLT_LOUDNESS_METER_TRUE_PEAK_TAPS/2-1-t)+
+                       (double)p/(double)BLT_LOUDNESS_METER_TRUE_PEAK_PHASES;
+            double w = 0.5+0.5*cos(BLT_LOUDNESS_METER_PI*x/(BLT_LOUDNESS_METER_TRUE_PEAK_TAPS/2+0.5));
+            taps[t] = (x == 0.0 ? 1.0 : sin(BLT_LOUDNESS_METER_PI*x)/(BLT_LOUDNESS_METER_PI*x))*w;
+            sum += taps[t];
+        }
+        for (t=0; t<BLT_LOUDNESS_METER_TRUE_PEAK_TAPS; t++) {
+            self->true_peak_filter[t*BLT_LOUDNESS_METER_TRUE_PEAK_PHASES+p] = (float)(taps[t]/sum);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_Create
++---------------------------------------------------------------------*/
+BLT_Result
+LoudnessMeter_Create(BLT_UInt32      sample_rate,
+                     unsigned int    channel_count,
+                     BLT_UInt32      channel_mask,
+                     LoudnessMeter** meter)
+{
+    LoudnessMeter* self;
+    BLT_UInt32     mask = channel_mask;
+    unsigned int   c;
+
+    /* default */
+    *meter = NULL;
+
+    /* check parameters */
+    if (sample_rate < 1000 || channel_count == 0) {
+        return BLT_ERROR_INVALID_PARAMETERS;
+    }
+
+    /* allocate the object */
+    self = (LoudnessMeter*)ATX_AllocateZeroMemory(sizeof(LoudnessMeter));
+    if (self == NULL) return BLT_ERROR_OUT_OF_MEMORY;
+    self->sample_rate    = sample_rate;
+    self->channel_count  = channel_count;
+    self->channel_mask   = channel_mask;
+    self->sub_block_size = (sample_rate+5)/10;
+    self->weights = (double*)ATX_AllocateMemory(channel_count*sizeof(double));
+    self->states  = (double*)ATX_AllocateZeroMemory(4*channel_count*sizeof(double));
+    self->true_peak_history = (float*)ATX_AllocateZeroMemory(channel_count*
+                                                             2*BLT_LOUDNESS_METER_TRUE_PEAK_TAPS*
+                                                             sizeof(float));
+    if (self->weights == NULL || self->states == NULL || self->true_peak_history == NULL) {
+        LoudnessMeter_Destroy(self);
+        return BLT_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* weigh the channels according to their position */
+    if (mask == 0) {
+        if (channel_count == 6) mask = BLT_CHANNEL_MASK_5POINT1;
+        if (channel_count == 8) mask = BLT_CHANNEL_MASK_7POINT1;
+    }
+    for (c=0; c<channel_count; c++) {
+        if (mask) {
+            BLT_UInt32 speaker = mask & (~mask+1);
+            mask &= ~speaker;
+            self->weights[c] = LoudnessMeter_GetChannelWeight(speaker);
+        } else {
+            self->weights[c] = 1.0;
+        }
+    }
+
+    LoudnessMeter_ComputeFilters(self);
+
+    *meter = self;
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_Destroy
++---------------------------------------------------------------------*/
+BLT_Result
+LoudnessMeter_Destroy(LoudnessMeter* self)
+{
+    if (self == NULL) return BLT_SUCCESS;
+
+    if (self->weights)           ATX_FreeMemory(self->weights);
+    if (self->states)            ATX_FreeMemory(self->states);
+    if (self->true_peak_history) ATX_FreeMemory(self->true_peak_history);
+    ATX_FreeMemory(self);
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_Matches
++---------------------------------------------------------------------*/
+BLT_Boolean
+LoudnessMeter_Matches(LoudnessMeter* self,
+                      BLT_UInt32     sample_rate,
+                      unsigned int   channel_count,
+                      BLT_UInt32     channel_mask)
+{
+    return self->sample_rate   == sample_rate   &&
+           self->channel_count == channel_count &&
+           self->channel_mask  == channel_mask;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_GetSampleRate
++---------------------------------------------------------------------*/
+BLT_UInt32
+LoudnessMeter_GetSampleRate(LoudnessMeter* self)
+{
+    return self->sample_rate;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_ClearHistory
++---------------------------------------------------------------------*/
+void
+LoudnessMeter_ClearHistory(LoudnessMeter* self)
+{
+    ATX_SetMemory(self->states, 0, 4*self->channel_count*sizeof(double));
+    ATX_SetMemory(self->true_peak_history, 0, self->channel_count*
+                                              2*BLT_LOUDNESS_METER_TRUE_PEAK_TAPS*
+                                              sizeof(float));
+    self->true_peak_position = 0;
+    self->sub_block_position = 0;
+    self->sub_block_energy   = 0.0;
+    self->sub_block_count    = 0;
+    self->sub_block_index    = 0;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_Reset
++---------------------------------------------------------------------*/
+void
+LoudnessMeter_Reset(LoudnessMeter* self)
+{
+    LoudnessMeter_ClearHistory(self);
+    ATX_SetMemory(&self->momentary,  0, sizeof(self->momentary));
+    ATX_SetMemory(&self->short_term, 0, sizeof(self->short_term));
+    self->true_peak = 0.0f;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_FlushState
+|
+|   keeps the filters out of denormals when the input goes silent
++---------------------------------------------------------------------*/
+static double
+LoudnessMeter_FlushState(double state)
+{
+    return (state > -1e-20 && state < 1e-20) ? 0.0 : state;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_FilterChannel
+|
+|   K-weights one channel and returns the sum of its squares
++---------------------------------------------------------------------*/
+static double
+LoudnessMeter_FilterChannel(LoudnessMeter* self,
+                            const float*   samples,
+                            BLT_Cardinal   frame_count,
+                            unsigned int   channel)
+{
+    const double* p  = self->coefficients[0];
+    const double* r  = self->coefficients[1];
+    unsigned int  n  = self->channel_count;
+    double*       s  = self->states+channel;
+    double        s0 = s[0], s1 = s[n], s2 = s[2*n], s3 = s[3*n];
+    double        sum = 0.0;
+    BLT_Cardinal  i;
+
+    samples += channel;
+    for (i=0; i<frame_count; i++, samples += n) {
+        double x = *samples;
+        double y = p[0]*x+s0;
+        double z;
+        s0 = p[1]*x-p[3]*y+s1;
+        s1 = p[2]*x-p[4]*y;
+        z  = r[0]*y+s2;
+        s2 = r[1]*y-r[3]*z+s3;
+        s3 = r[2]*y-r[4]*z;
+        sum += z*z;
+    }
+    s[0]   = LoudnessMeter_FlushState(s0);
+    s[n]   = LoudnessMeter_FlushState(s1);
+    s[2*n] = LoudnessMeter_FlushState(s2);
+    s[3*n] = LoudnessMeter_FlushState(s3);
+
+    return sum;
+}
+
+#if defined(BLT_LOUDNESS_METER_HAVE_SSE2)
+/*----------------------------------------------------------------------
+|   LoudnessMeter_FilterChannelPair
+|
+|   same as LoudnessMeter_FilterChannel, for two adjacent channels at
+|   once, one in each lane
++---------------------------------------------------------------------*/
+static double
+LoudnessMeter_FilterChannelPair(LoudnessMeter* self,
+                                const float*   samples,
+                                BLT_Cardinal   frame_count,
+                                unsigned int   channel)
+{
+    const double* p   = self->coefficients[0];
+    const double* r   = self->coefficients[1];
+    unsigned int  n   = self->channel_count;
+    double*       s   = self->states+channel;
+    __m128d       p0  = _mm_set1_pd(p[0]), p1 = _mm_set1_pd(p[1]), p2 = _mm_set1_pd(p[2]);
+    __m128d       p3  = _mm_set1_pd(p[3]), p4 = _mm_set1_pd(p[4]);
+    __m128d       r0  = _mm_set1_pd(r[0]), r1 = _mm_set1_pd(r[1]), r2 = _mm_set1_pd(r[2]);
+    __m128d       r3  = _mm_set1_pd(r[3]), r4 = _mm_set1_pd(r[4]);
+    __m128d       s0  = _mm_loadu_pd(s),     s1 = _mm_loadu_pd(s+n);
+    __m128d       s2  = _mm_loadu_pd(s+2*n), s3 = _mm_loadu_pd(s+3*n);
+    __m128d       sum = _mm_setzero_pd();
+    double        sums[2];
+    BLT_Cardinal  i;
+
+    samples += channel;
+    for (i=0; i<frame_count; i++, samples += n) {
+        __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)samples)));
+        __m128d y = _mm_add_pd(_mm_mul_pd(p0, x), s0);
+        __m128d z;
+        s0  = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(p1, x), _mm_mul_pd(p3, y)), s1);
+        s1  = _mm_sub_pd(_mm_mul_pd(p2, x), _mm_mul_pd(p4, y));
+        z   = _mm_add_pd(_mm_mul_pd(r0, y), s2);
+        s2  = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(r1, y), _mm_mul_pd(r3, z)), s3);
+        s3  = _mm_sub_pd(_mm_mul_pd(r2, y), _mm_mul_pd(r4, z));
+        sum = _mm_add_pd(sum, _mm_mul_pd(z, z));
+    }
+    _mm_storeu_pd(s,     s0);
+    _mm_storeu_pd(s+n,   s1);
+    _mm_storeu_pd(s+2*n, s2);
+    _mm_storeu_pd(s+3*n, s3);
+    for (i=0; i<4*n; i+=n) {
+        s[i]   = LoudnessMeter_FlushState(s[i]);
+        s[i+1] = LoudnessMeter_FlushState(s[i+1]);
+    }
+
+    _mm_storeu_pd(sums, sum);
+    return sums[0]*self->weights[channel]+sums[1]*self->weights[channel+1];
+}
+#endif
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_Filter
+|
+|   returns the weighted sum of the squares of the K-weighted samples
++---------------------------------------------------------------------*/
+static double
+LoudnessMeter_Filter(LoudnessMeter* self, const float* samples, BLT_Cardinal frame_count)
+{
+    double       sum = 0.0;
+    unsigned int c   = 0;
+
+#if defined(BLT_LOUDNESS_METER_HAVE_SSE2)
+    for (; c+1 < self->channel_count; c += 2) {
+        sum += LoudnessMeter_FilterChannelPair(self, samples, frame_count, c);
+    }
+#endif
+    for (; c < self->channel_count; c++) {
+        sum += LoudnessMeter_FilterChannel(self, samples, frame_count, c)*self->weights[c];
+    }
+
+    return sum;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_MeasureTruePeak
++---------------------------------------------------------------------*/
+static void
+LoudnessMeter_MeasureTruePeak(LoudnessMeter* self, const float* samples, BLT_Cardinal frame_count)
+{
+    unsigned int n        = self->channel_count;
+    unsigned int position = self->true_peak_position;
+    unsigned int c;
+
+    for (c=0; c<n; c++) {
+        float*       history = self->true_peak_history+c*2*BLT_LOUDNESS_METER_TRUE_PEAK_TAPS;
+        const float* in      = samples+c;
+        BLT_Cardinal i;
+#if defined(BLT_LOUDNESS_METER_HAVE_SSE2)
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128       peak     = _mm_set1_ps(self->true_peak);
+        float        peaks[4];
+#elif defined(BLT_LOUDNESS_METER_HAVE_NEON)
+        float32x4_t  peak     = vdupq_n_f32(self->true_peak);
+        float        peaks[4];
+#else
+        float        peak     = self->true_peak;
+#endif
+        position = self->true_peak_position;
+        for (i=0; i<frame_count; i++, in += n) {
+            const float* window;
+            unsigned int t;
+
+            /* the window is the TAPS samples after 'position' */
+            if (++position == BLT_LOUDNESS_METER_TRUE_PEAK_TAPS) position = 0;
+            history[position] = history[position+BLT_LOUDNESS_METER_TRUE_PEAK_TAPS] = *in;
+            window = history+position+1;
+
+            /* compute all the phases at once */
+#if defined(BLT_LOUDNESS_METER_HAVE_SSE2)
+            {
+                __m128 acc = _mm_setzero_ps();
+                for (t=0; t<BLT_LOUDNESS_METER_TRUE_PEAK_TAPS; t++) {
+                    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(window[t]),
+                                                     _mm_loadu_ps(&self->true_peak_filter[4*t])));
+                }
+                peak = _mm_max_ps(peak, _mm_and_ps(acc, abs_mask));
+            }
+#elif defined(BLT_LOUDNESS_METER_HAVE_NEON)
+            {
+                float32x4_t acc = vdupq_n_f32(0.0f);
+                for (t=0; t<BLT_LOUDNESS_METER_TRUE_PEAK_TAPS; t++) {
+                    acc = vmlaq_n_f32(acc, vld1q_f32(&self->true_peak_filter[4*t]), window[t]);
+                }
+                peak = vmaxq_f32(peak, vabsq_f32(acc));
+            }
+#else
+            {
+                float acc[BLT_LOUDNESS_METER_TRUE_PEAK_PHASES] = {0.0f, 0.0f, 0.0f, 0.0f};
+                unsigned int p;
+                for (t=0; t<BLT_LOUDNESS_METER_TRUE_PEAK_TAPS; t++) {
+                    for (p=0; p<BLT_LOUDNESS_METER_TRUE_PEAK_PHASES; p++) {
+                        acc[p] += window[t]*self->true_peak_filter[t*BLT_LOUDNESS_METER_TRUE_PEAK_PHASES+p];
+                    }
+                }
+                for (p=0; p<BLT_LOUDNESS_METER_TRUE_PEAK_PHASES; p++) {
+                    float v = acc[p] < 0.0f ? -acc[p] : acc[p];
+                    if (v > peak) peak = v;
+                }
+            }
+#endif
+        }
+
+#if defined(BLT_LOUDNESS_METER_HAVE_SSE2)
+        _mm_storeu_ps(peaks, peak);
+#elif defined(BLT_LOUDNESS_METER_HAVE_NEON)
+        vst1q_f32(peaks, peak);
+#endif
+#if defined(BLT_LOUDNESS_METER_HAVE_SSE2) || defined(BLT_LOUDNESS_METER_HAVE_NEON)
+        if (peaks[0] > self->true_peak) self->true_peak = peaks[0];
+        if (peaks[1] > self->true_peak) self->true_peak = peaks[1];
+        if (peaks[2] > self->true_peak) self->true_peak = peaks[2];
+        if (peaks[3] > self->true_peak) self->true_peak = peaks[3];
+#else
+        self->true_peak = peak;
+#endif
+    }
+    self->true_peak_position = position;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_CompleteSubBlock
++---------------------------------------------------------------------*/
+static void
+LoudnessMeter_CompleteSubBlock(LoudnessMeter* self)
+{
+    unsigned int i;
+
+    /* keep the mean square of the sub-block */
+    self->sub_blocks[self->sub_block_index] = self->sub_block_energy/(double)self->sub_block_size;
+    if (++self->sub_block_index == BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS) {
+        self->sub_block_index = 0;
+    }
+    if (self->sub_block_count < BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS) {
+        self->sub_block_count++;
+    }
+    self->sub_block_energy   = 0.0;
+    self->sub_block_position = 0;
+
+    /* momentary block, every 100 ms */
+    if (self->sub_block_count >= BLT_LOUDNESS_METER_MOMENTARY_SUB_BLOCKS) {
+        double energy = 0.0;
+        for (i=1; i<=BLT_LOUDNESS_METER_MOMENTARY_SUB_BLOCKS; i++) {
+            energy += self->sub_blocks[(self->sub_block_index+BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS-i)%
+                                       BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS];
+        }
+        LoudnessHistogram_Add(&self->momentary, energy/BLT_LOUDNESS_METER_MOMENTARY_SUB_BLOCKS);
+    }
+
+    /* short-term block, every 100 ms */
+    if (self->sub_block_count >= BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS) {
+        double energy = 0.0;
+        for (i=0; i<BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS; i++) {
+            energy += self->sub_blocks[i];
+        }
+        LoudnessHistogram_Add(&self->short_term, energy/BLT_LOUDNESS_METER_SHORT_TERM_SUB_BLOCKS);
+    }
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_Process
++---------------------------------------------------------------------*/
+void
+LoudnessMeter_Process(LoudnessMeter* self,
+                      const float*   samples,
+                      BLT_Cardinal   frame_count)
+{
+    LoudnessMeter_MeasureTruePeak(self, samples, frame_count);
+
+    while (frame_count) {
+        BLT_Cardinal chunk = self->sub_block_size-self->sub_block_position;
+        if (chunk > frame_count) chunk = frame_count;
+
+        self->sub_block_energy   += LoudnessMeter_Filter(self, samples, chunk);
+        self->sub_block_position += chunk;
+        if (self->sub_block_position == self->sub_block_size) {
+            LoudnessMeter_CompleteSubBlock(self);
+        }
+
+        samples     += chunk*self->channel_count;
+        frame_count -= chunk;
+    }
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_GetIntegratedLoudness
++---------------------------------------------------------------------*/
+BLT_Boolean
+LoudnessMeter_GetIntegratedLoudness(LoudnessMeter* self, double* lufs)
+{
+    unsigned int gate_bin;
+    double       energy = 0.0;
+    double       count  = 0.0;
+    unsigned int i;
+
+    if (!LoudnessHistogram_GetGateBin(&self->momentary,
+                                      BLT_LOUDNESS_METER_INTEGRATED_GATE,
+                                      &gate_bin)) {
+        return BLT_FALSE;
+    }
+    for (i=gate_bin; i<BLT_LOUDNESS_METER_HISTOGRAM_SIZE; i++) {
+        energy += self->momentary.energies[i];
+        count  += (double)self->momentary.counts[i];
+    }
+    if (count == 0.0) return BLT_FALSE;
+
+    *lufs = -0.691+10.0*log10(energy/count);
+    return BLT_TRUE;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_GetLoudnessRange
+|
+|   the distance between the 10th and 95th percentiles of the gated
+|   short-term loudness
++---------------------------------------------------------------------*/
+BLT_Boolean
+LoudnessMeter_GetLoudnessRange(LoudnessMeter* self, double* lu)
+{
+    const LoudnessHistogram* histogram = &self->short_term;
+    unsigned int             gate_bin;
+    double                   count = 0.0;
+    double                   low_rank, high_rank;
+    double                   total = 0.0;
+    unsigned int             low = 0;
+    unsigned int             i;
+
+    if (!LoudnessHistogram_GetGateBin(histogram,
+                                      BLT_LOUDNESS_METER_RANGE_GATE,
+                                      &gate_bin)) {
+        return BLT_FALSE;
+    }
+    for (i=gate_bin; i<BLT_LOUDNESS_METER_HISTOGRAM_SIZE; i++) {
+        count += (double)histogram->counts[i];
+    }
+    if (count == 0.0) return BLT_FALSE;
+
+    low_rank  = ceil(0.10*count);
+    high_rank = ceil(0.95*count);
+    for (i=gate_bin; i<BLT_LOUDNESS_METER_HISTOGRAM_SIZE; i++) {
+        double previous = total;
+        total += (double)histogram->counts[i];
+        if (previous < low_rank && total >= low_rank) low = i;
+        if (total >= high_rank) break;
+    }
+    if (i == BLT_LOUDNESS_METER_HISTOGRAM_SIZE) i--;
+
+    *lu = (double)(i-low)*BLT_LOUDNESS_METER_HISTOGRAM_STEP;
+    return BLT_TRUE;
+}
+
+/*----------------------------------------------------------------------
+|   LoudnessMeter_GetTruePeak
++---------------------------------------------------------------------*/
+double
+LoudnessMeter_GetTruePeak(LoudnessMeter* self)
+{
+    return (double)self->true_peak;
+}
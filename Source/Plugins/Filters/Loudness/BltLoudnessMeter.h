@@ -0,0 +1,97 @@
+/*****************************************************************
+|
+|   Loudness Filter Module - Loudness Meter
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+ ****************************************************************/
+
+#ifndef _BLT_LOUDNESS_METER_H_
+#define _BLT_LOUDNESS_METER_H_
+
+/*----------------------------------------------------------------------
+|   includes
++---------------------------------------------------------------------*/
+#include "BltConfig.h"
+#include "BltTypes.h"
+#include "BltErrors.h"
+
+/*----------------------------------------------------------------------
+|   types
++---------------------------------------------------------------------*/
+/**
+ * ITU-R BS.1770 / EBU R128 loudness meter, working on interleaved
+ * native-endian float samples. The samples are K-weighted, then gated
+ * in 400 ms blocks for the integrated loudness and in 3 s blocks for the
+ * loudness range (EBU Tech 3342). The true peak is measured on a 4x
+ * oversampled signal. The blocks are kept in histograms with 0.1 LU
+ * bins, so the memory used doesn't depend on the duration.
+ */
+typedef struct LoudnessMeter LoudnessMeter;
+
+/*----------------------------------------------------------------------
+|   prototypes
++---------------------------------------------------------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates a meter. A channel mask of 0 means the usual layout for the
+ * channel count. The LFE channel is ignored and the surround channels
+ * are weighted +1.5 dB, as in BS.1770.
+ */
+BLT_Result LoudnessMeter_Create(BLT_UInt32      sample_rate,
+                                unsigned int    channel_count,
+                                BLT_UInt32      channel_mask,
+                                LoudnessMeter** meter);
+BLT_Result LoudnessMeter_Destroy(LoudnessMeter* self);
+
+/**
+ * Returns true if the meter was created with these parameters.
+ */
+BLT_Boolean LoudnessMeter_Matches(LoudnessMeter* self,
+                                  BLT_UInt32     sample_rate,
+                                  unsigned int   channel_count,
+                                  BLT_UInt32     channel_mask);
+
+BLT_UInt32 LoudnessMeter_GetSampleRate(LoudnessMeter* self);
+
+/**
+ * Forgets everything that was measured.
+ */
+void LoudnessMeter_Reset(LoudnessMeter* self);
+
+/**
+ * Clears the filters and the partial blocks, for when the next samples
+ * don't follow the previous ones, but keeps the measurements.
+ */
+void LoudnessMeter_ClearHistory(LoudnessMeter* self);
+
+void LoudnessMeter_Process(LoudnessMeter* self,
+                           const float*   samples,
+                           BLT_Cardinal   frame_count);
+
+/**
+ * Gets the gated integrated loudness in LUFS. Returns false when there
+ * isn't any block above the absolute gate yet.
+ */
+BLT_Boolean LoudnessMeter_GetIntegratedLoudness(LoudnessMeter* self, double* lufs);
+
+/**
+ * Gets the loudness range in LU. Returns false when there isn't any
+ * short-term block above the absolute gate yet.
+ */
+BLT_Boolean LoudnessMeter_GetLoudnessRange(LoudnessMeter* self, double* lu);
+
+/**
+ * Returns the true peak, as a linear value where 1.0 is full scale.
+ */
+double LoudnessMeter_GetTruePeak(LoudnessMeter* self);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* _BLT_LOUDNESS_METER_H_ */
@@ -10,6 +10,8 @@
 /*----------------------------------------------------------------------
 |   includes
 +---------------------------------------------------------------------*/
+#include <math.h>
+
 #include "Atomix.h"
 #include "BltConfig.h"
 #include "BltCore.h"
@@ -26,6 +28,19 @@
 +---------------------------------------------------------------------*/
 ATX_SET_LOCAL_LOGGER("bluetune.plugins.general.silence-remover")
 
+/*----------------------------------------------------------------------
+|   SIMD support
++---------------------------------------------------------------------*/
+#if !defined(BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLT_SILENCE_REMOVER_HAVE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLT_SILENCE_REMOVER_HAVE_NEON
+#include <arm_neon.h>
+#endif
+#endif /* BLT_CONFIG_PCM_KERNELS_DISABLE_SIMD */
+
 /*----------------------------------------------------------------------
 |    types
 +---------------------------------------------------------------------*/
@@ -37,7 +52,9 @@ typedef struct {
     ATX_IMPLEMENTS(BLT_PacketConsumer);
 
     /* members */
-    BLT_MediaPacket* pending;
+    ATX_List* pending;      /* packets that end with silence, held until   */
+                            /* we know how long the silence is             */
+    BLT_Size  pending_tail; /* bytes of silence at the end of the first one */
 } SilenceRemoverInput;
 
 typedef struct {
@@ -54,20 +71,42 @@ typedef enum {
     SILENCE_REMOVER_STATE_IN_STREAM
 } SilenceRemoverState;
 
+typedef struct {
+    float     level;   /* float samples are silent under this magnitude */
+    BLT_Int32 level16; /* same, for 16-bit integers                      */
+    BLT_Int32 level32; /* same, for 32-bit integers                      */
+} SilenceRemoverThreshold;
+
 typedef struct {
     /* base class */
     ATX_EXTENDS(BLT_BaseMediaNode);
 
+    /* interfaces */
+    ATX_IMPLEMENTS(ATX_PropertyListener);
+
     /* members */
-    SilenceRemoverState  state;
-    SilenceRemoverInput  input;
-    SilenceRemoverOutput output;
+    SilenceRemoverState     state;
+    SilenceRemoverInput     input;
+    SilenceRemoverOutput    output;
+    SilenceRemoverThreshold threshold;
+    BLT_UInt32              min_duration; /* in milliseconds                  */
+    BLT_Cardinal            silence;      /* frames of silence held so far    */
+    BLT_Boolean             cutting;      /* the current silence is removed   */
+    ATX_PropertyListenerHandle threshold_listener_handle;
+    ATX_PropertyListenerHandle min_duration_listener_handle;
 } SilenceRemover;
 
 /*----------------------------------------------------------------------
 |    constants
 +---------------------------------------------------------------------*/
-#define BLT_SILENCE_REMOVER_THRESHOLD 64
+/* -54.2 dB keeps 16-bit samples under 64 silent */
+#if !defined(BLT_CONFIG_SILENCE_REMOVER_DEFAULT_THRESHOLD)
+#define BLT_CONFIG_SILENCE_REMOVER_DEFAULT_THRESHOLD (-54.2f) /* dBFS */
+#endif
+
+#if !defined(BLT_CONFIG_SILENCE_REMOVER_DEFAULT_MIN_DURATION)
+#define BLT_CONFIG_SILENCE_REMOVER_DEFAULT_MIN_DURATION 100 /* ms */
+#endif
 
 /*----------------------------------------------------------------------
 |   forward declarations
@@ -75,25 +114,261 @@ typedef struct {
 ATX_DECLARE_INTERFACE_MAP(SilenceRemoverModule, BLT_Module)
 ATX_DECLARE_INTERFACE_MAP(SilenceRemover, BLT_MediaNode)
 ATX_DECLARE_INTERFACE_MAP(SilenceRemover, ATX_Referenceable)
+ATX_DECLARE_INTERFACE_MAP(SilenceRemover, ATX_PropertyListener)
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_SetThreshold
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_SetThreshold(SilenceRemover* self, float db)
+{
+    double level = pow(10.0, db/20.0);
+
+    if (level > 1.0) level = 1.0;
+    self->threshold.level   = (float)level;
+    self->threshold.level16 = (BLT_Int32)ceil(level*32767.0);
+    self->threshold.level32 = (BLT_Int32)ceil(level*2147483647.0);
+    ATX_LOG_FINE_1("SilenceRemover::SetThreshold - level16 = %d", self->threshold.level16);
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_ScanS16
+|
+|    counts the silent samples at the start and at the end of a buffer
+|    (when they are all silent, the head is the whole buffer and the
+|    tail is 0)
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_ScanS16(const BLT_Int16* samples,
+                       BLT_Cardinal     count,
+                       BLT_Int32        level,
+                       BLT_Cardinal*    head,
+                       BLT_Cardinal*    tail)
+{
+    BLT_Cardinal first = 0;
+    BLT_Cardinal last  = count;
+#if defined(BLT_SILENCE_REMOVER_HAVE_SSE2)
+    __m128i lo = _mm_set1_epi16((short)-level);
+    __m128i hi = _mm_set1_epi16((short)level);
+#define BLT_SILENCE_REMOVER_SILENT_S16(_p)                               \
+    (_mm_movemask_epi8(_mm_and_si128(                                   \
+        _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i*)(_p)), lo),     \
+        _mm_cmplt_epi16(_mm_loadu_si128((const __m128i*)(_p)), hi))) == 0xFFFF)
+#elif defined(BLT_SILENCE_REMOVER_HAVE_NEON)
+    int16x8_t lo = vdupq_n_s16((short)-level);
+    int16x8_t hi = vdupq_n_s16((short)level);
+#define BLT_SILENCE_REMOVER_SILENT_S16(_p)                                       \
+    (vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(vandq_u16(                     \
+        vcgtq_s16(vld1q_s16(_p), lo), vcltq_s16(vld1q_s16(_p), hi)))), 0) ==    \
+     (BLT_UInt64)-1)
+#endif
+
+#if defined(BLT_SILENCE_REMOVER_SILENT_S16)
+    while (first+8 <= count && BLT_SILENCE_REMOVER_SILENT_S16(samples+first)) first += 8;
+#endif
+    while (first < count && samples[first] > -level && samples[first] < level) first++;
+    if (first < count) {
+#if defined(BLT_SILENCE_REMOVER_SILENT_S16)
+        while (last >= first+8 && BLT_SILENCE_REMOVER_SILENT_S16(samples+last-8)) last -= 8;
+#endif
+        while (samples[last-1] > -level && samples[last-1] < level) last--;
+    }
+#undef BLT_SILENCE_REMOVER_SILENT_S16
+
+    *head = first;
+    *tail = count-last;
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_ScanS32
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_ScanS32(const BLT_Int32* samples,
+                       BLT_Cardinal     count,
+                       BLT_Int32        level,
+                       BLT_Cardinal*    head,
+                       BLT_Cardinal*    tail)
+{
+    BLT_Cardinal first = 0;
+    BLT_Cardinal last  = count;
+#if defined(BLT_SILENCE_REMOVER_HAVE_SSE2)
+    __m128i lo = _mm_set1_epi32(-level);
+    __m128i hi = _mm_set1_epi32(level);
+#define BLT_SILENCE_REMOVER_SILENT_S32(_p)                               \
+    (_mm_movemask_epi8(_mm_and_si128(                                   \
+        _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(_p)), lo),     \
+        _mm_cmplt_epi32(_mm_loadu_si128((const __m128i*)(_p)), hi))) == 0xFFFF)
+#elif defined(BLT_SILENCE_REMOVER_HAVE_NEON)
+    int32x4_t lo = vdupq_n_s32(-level);
+    int32x4_t hi = vdupq_n_s32(level);
+#define BLT_SILENCE_REMOVER_SILENT_S32(_p)                                       \
+    (vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(vandq_u32(                    \
+        vcgtq_s32(vld1q_s32(_p), lo), vcltq_s32(vld1q_s32(_p), hi)))), 0) ==    \
+     (BLT_UInt64)-1)
+#endif
+
+#if defined(BLT_SILENCE_REMOVER_SILENT_S32)
+    while (first+4 <= count && BLT_SILENCE_REMOVER_SILENT_S32(samples+first)) first += 4;
+#endif
+    while (first < count && samples[first] > -level && samples[first] < level) first++;
+    if (first < count) {
+#if defined(BLT_SILENCE_REMOVER_SILENT_S32)
+        while (last >= first+4 && BLT_SILENCE_REMOVER_SILENT_S32(samples+last-4)) last -= 4;
+#endif
+        while (samples[last-1] > -level && samples[last-1] < level) last--;
+    }
+#undef BLT_SILENCE_REMOVER_SILENT_S32
+
+    *head = first;
+    *tail = count-last;
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_ScanFloat
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_ScanFloat(const float*  samples,
+                         BLT_Cardinal  count,
+                         float         level,
+                         BLT_Cardinal* head,
+                         BLT_Cardinal* tail)
+{
+    BLT_Cardinal first = 0;
+    BLT_Cardinal last  = count;
+#if defined(BLT_SILENCE_REMOVER_HAVE_SSE2)
+    __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 hi        = _mm_set1_ps(level);
+#define BLT_SILENCE_REMOVER_SILENT_FLOAT(_p) \
+    (_mm_movemask_ps(_mm_cmplt_ps(_mm_and_ps(_mm_loadu_ps(_p), magnitude), hi)) == 0xF)
+#elif defined(BLT_SILENCE_REMOVER_HAVE_NEON)
+    float32x4_t hi = vdupq_n_f32(level);
+#define BLT_SILENCE_REMOVER_SILENT_FLOAT(_p)                                     \
+    (vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(                              \
+        vcltq_f32(vabsq_f32(vld1q_f32(_p)), hi))), 0) == (BLT_UInt64)-1)
+#endif
+
+#if defined(BLT_SILENCE_REMOVER_SILENT_FLOAT)
+    while (first+4 <= count && BLT_SILENCE_REMOVER_SILENT_FLOAT(samples+first)) first += 4;
+#endif
+    while (first < count && samples[first] > -level && samples[first] < level) first++;
+    if (first < count) {
+#if defined(BLT_SILENCE_REMOVER_SILENT_FLOAT)
+        while (last >= first+4 && BLT_SILENCE_REMOVER_SILENT_FLOAT(samples+last-4)) last -= 4;
+#endif
+        while (samples[last-1] > -level && samples[last-1] < level) last--;
+    }
+#undef BLT_SILENCE_REMOVER_SILENT_FLOAT
+
+    *head = first;
+    *tail = count-last;
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_ReadSample
+|
+|    reads a sample of any format, relative to full scale
++---------------------------------------------------------------------*/
+static float
+SilenceRemover_ReadSample(const unsigned char*    sample,
+                          const BLT_PcmMediaType* media_type)
+{
+    unsigned int width = media_type->bits_per_sample/8;
+    BLT_UInt32   bits  = 0;
+    unsigned int i;
+
+    /* assemble the bytes, most significant first */
+    switch (media_type->sample_format) {
+        case BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE:
+        case BLT_PCM_SAMPLE_FORMAT_UNSIGNED_INT_BE:
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_BE:
+            for (i=0; i<width; i++) bits = (bits<<8) | sample[i];
+            break;
+
+        default:
+            for (i=width; i--;) bits = (bits<<8) | sample[i];
+            break;
+    }
+
+    switch (media_type->sample_format) {
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_BE:
+        case BLT_PCM_SAMPLE_FORMAT_FLOAT_LE:
+            {
+                union { BLT_UInt32 i; float f; } value;
+                value.i = bits;
+                return value.f;
+            }
+
+        case BLT_PCM_SAMPLE_FORMAT_UNSIGNED_INT_BE:
+        case BLT_PCM_SAMPLE_FORMAT_UNSIGNED_INT_LE:
+            bits = (bits<<(32-8*width))^0x80000000;
+            break;
+
+        default:
+            bits <<= 32-8*width;
+            break;
+    }
+
+    return (float)(BLT_Int32)bits/2147483648.0f;
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_ScanAny
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_ScanAny(const unsigned char*    samples,
+                       BLT_Cardinal            count,
+                       const BLT_PcmMediaType* media_type,
+                       float                   level,
+                       BLT_Cardinal*           head,
+                       BLT_Cardinal*           tail)
+{
+    unsigned int width = media_type->bits_per_sample/8;
+    BLT_Cardinal first = 0;
+    BLT_Cardinal last  = count;
+    float        value;
+
+    for (; first < count; first++) {
+        value = SilenceRemover_ReadSample(samples+first*width, media_type);
+        if (!(value > -level && value < level)) break;
+    }
+    if (first < count) {
+        for (;; last--) {
+            value = SilenceRemover_ReadSample(samples+(last-1)*width, media_type);
+            if (!(value > -level && value < level)) break;
+        }
+    }
+
+    *head = first;
+    *tail = count-last;
+}
 
 /*----------------------------------------------------------------------
-|    ScanPacket
+|    SilenceRemover_ScanPacket
+|
+|    finds the number of bytes of silence at the start and at the end of
+|    a packet (when the packet is all silence, zero_head is the payload
+|    size and zero_tail is 0). frame_size is 0 when the format isn't one
+|    we can scan, in which case there is no silence.
 +---------------------------------------------------------------------*/
 static BLT_Result
-ScanPacket(BLT_MediaPacket* packet, 
-           BLT_Cardinal*    zero_head, 
-           BLT_Cardinal*    zero_tail)
+SilenceRemover_ScanPacket(SilenceRemover*  self,
+                          BLT_MediaPacket* packet,
+                          BLT_Size*        zero_head,
+                          BLT_Size*        zero_tail,
+                          BLT_Size*        frame_size)
 {
     BLT_PcmMediaType* media_type;
-    short*            pcm;
+    const void*       pcm;
+    unsigned int      width;
+    BLT_Cardinal      frame_count;
     BLT_Cardinal      sample_count;
-    BLT_Ordinal       sample;
-    BLT_Cardinal      zero_head_count = 0;
-    BLT_Cardinal      non_zero_run = 0;
+    BLT_Cardinal      head = 0;
+    BLT_Cardinal      tail = 0;
 
     /* default values */
-    *zero_head = 0;
-    *zero_tail = 0;
+    *zero_head  = 0;
+    *zero_tail  = 0;
+    *frame_size = 0;
 
     /* get the media type */
     BLT_MediaPacket_GetMediaType(packet, (const BLT_MediaType**)(const void*)&media_type);
@@ -102,85 +377,108 @@ ScanPacket(BLT_MediaPacket* packet,
         return BLT_ERROR_INVALID_MEDIA_TYPE;
     }
 
-    /* for now, we only support 16-bit, stereo, PCM */
-    if (media_type->bits_per_sample != 16 || media_type->channel_count != 2) {
+    /* any number of channels, with 8, 16, 24 or 32 bits per sample */
+    width = media_type->bits_per_sample/8;
+    if (media_type->channel_count == 0 ||
+        width == 0 || width > 4        ||
+        media_type->bits_per_sample != 8*width) {
         return BLT_SUCCESS;
     }
+    if ((media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_BE ||
+         media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_LE) &&
+        width != 4) {
+        return BLT_SUCCESS;
+    }
+    *frame_size = media_type->channel_count*width;
 
-    /* check for zero samples */
-    sample_count = BLT_MediaPacket_GetPayloadSize(packet)/4;
-    if (sample_count == 0) return BLT_SUCCESS;
+    /* check for silent samples */
+    frame_count = BLT_MediaPacket_GetPayloadSize(packet)/(*frame_size);
+    if (frame_count == 0) return BLT_SUCCESS;
+    sample_count = frame_count*media_type->channel_count;
     pcm = BLT_MediaPacket_GetPayloadBuffer(packet);
-    for (sample = 0; sample < sample_count; sample++, pcm+=2) { 
-        if (pcm[0] > -BLT_SILENCE_REMOVER_THRESHOLD && 
-            pcm[0] <  BLT_SILENCE_REMOVER_THRESHOLD && 
-            pcm[1] > -BLT_SILENCE_REMOVER_THRESHOLD && 
-            pcm[1] <  BLT_SILENCE_REMOVER_THRESHOLD) {
-            if (sample == zero_head_count) {
-                zero_head_count++;
-            }
-        } else {
-            non_zero_run = sample+1;
-        }
+    if (media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE && width == 2) {
+        SilenceRemover_ScanS16((const BLT_Int16*)pcm, sample_count,
+                               self->threshold.level16, &head, &tail);
+    } else if (media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_NE && width == 4) {
+        SilenceRemover_ScanS32((const BLT_Int32*)pcm, sample_count,
+                               self->threshold.level32, &head, &tail);
+    } else if (media_type->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_NE) {
+        SilenceRemover_ScanFloat((const float*)pcm, sample_count,
+                                 self->threshold.level, &head, &tail);
+    } else {
+        SilenceRemover_ScanAny((const unsigned char*)pcm, sample_count, media_type,
+                               self->threshold.level, &head, &tail);
     }
-    *zero_head = zero_head_count*4;
-    if (non_zero_run > 0) {
-        *zero_tail = (sample_count-non_zero_run)*4;
+
+    /* a frame is silent only if all its samples are */
+    if (head == sample_count) {
+        *zero_head = BLT_MediaPacket_GetPayloadSize(packet);
+    } else {
+        *zero_head = (head/media_type->channel_count)*(*frame_size);
+        *zero_tail = (tail/media_type->channel_count)*(*frame_size);
     }
 
-    return BLT_SUCCESS;     
+    return BLT_SUCCESS;
 }
 
 /*----------------------------------------------------------------------
-|    SilenceRemover_TrimPending
+|    SilenceRemover_GetMinFrames
+|
+|    Returns the number of frames of silence that can be removed
++---------------------------------------------------------------------*/
+static BLT_Cardinal
+SilenceRemover_GetMinFrames(SilenceRemover* self, BLT_MediaPacket* packet)
+{
+    BLT_PcmMediaType* media_type;
+
+    BLT_MediaPacket_GetMediaType(packet, (const BLT_MediaType**)(const void*)&media_type);
+    return (BLT_Cardinal)(((ATX_UInt64)self->min_duration*media_type->sample_rate)/1000);
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_TrimPacket
+|
+|    removes bytes at the start and at the end of a packet, without copying
 +---------------------------------------------------------------------*/
 static void
-SilenceRemover_TrimPending(SilenceRemover* self)
+SilenceRemover_TrimPacket(BLT_MediaPacket* packet, BLT_Size head, BLT_Size tail)
 {
-    BLT_MediaPacket* packet = self->input.pending;
-    short*           pcm;
-    BLT_Cardinal     sample_count;
-    BLT_Cardinal     skip = 0;
-    int              sample;
-
-    /* quick check */
-    if (!packet) return;
-
-    ATX_LOG_FINER("SilenceRemover: trimming pending packet");
-
-    /* remove silence at the end of the packet */
-    pcm = (short*)BLT_MediaPacket_GetPayloadBuffer(packet);
-    sample_count = BLT_MediaPacket_GetPayloadSize(packet)/4;
-    pcm += sample_count*2;
-    for (sample = sample_count-1; sample >= 0; sample--, pcm-=2) {
-        if (pcm[0] > -BLT_SILENCE_REMOVER_THRESHOLD && 
-            pcm[0] <  BLT_SILENCE_REMOVER_THRESHOLD && 
-            pcm[1] > -BLT_SILENCE_REMOVER_THRESHOLD && 
-            pcm[1] <  BLT_SILENCE_REMOVER_THRESHOLD) {
-            skip++;
-        }
-    }
-    BLT_MediaPacket_SetPayloadSize(packet, (sample_count-skip)*4);
+    BLT_MediaPacket_SetPayloadWindow(packet,
+                                     BLT_MediaPacket_GetPayloadOffset(packet)+head,
+                                     BLT_MediaPacket_GetPayloadSize(packet)-head-tail);
 }
 
 /*----------------------------------------------------------------------
-|    SilenceRemover_AcceptPending
+|    SilenceRemover_AcceptPacket
 +---------------------------------------------------------------------*/
 static void
-SilenceRemover_AcceptPending(SilenceRemover* self)
+SilenceRemover_AcceptPacket(SilenceRemover* self, BLT_MediaPacket* packet)
 {
-    BLT_MediaPacket* packet = self->input.pending;
-    BLT_Result       result;
+    BLT_Result result;
+    ATX_LOG_FINER("SilenceRemover: accepting packet");
 
-    if (packet != NULL) {
-        result = ATX_List_AddData(self->output.packets, packet);
-        if (ATX_FAILED(result)) {
-            BLT_MediaPacket_Release(packet);
-        }
-        self->input.pending = NULL;
-        ATX_LOG_FINER("SilenceRemover: accepting pending packet");
+    /* add the packet to the output list */
+    result = ATX_List_AddData(self->output.packets, packet);
+    if (ATX_SUCCEEDED(result)) {
+        BLT_MediaPacket_AddReference(packet);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_DropPacket
+|
+|    drops a silent packet, or empties it if it has flags
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_DropPacket(SilenceRemover* self, BLT_MediaPacket* packet)
+{
+    if (BLT_MediaPacket_GetFlags(packet)) {
+        /* packet has flags, don't discard it, just empty it */
+        ATX_LOG_FINER("SilenceRemover: emptying packet");
+        BLT_MediaPacket_SetPayloadSize(packet, 0);
+        SilenceRemover_AcceptPacket(self, packet);
     } else {
-        ATX_LOG_FINER("SilenceRemover: no pending packet");
+        ATX_LOG_FINER("SilenceRemover: dropping packet");
     }
 }
 
@@ -188,39 +486,93 @@ SilenceRemover_AcceptPending(SilenceRemover* self)
 |    SilenceRemover_HoldPacket
 +---------------------------------------------------------------------*/
 static void
-SilenceRemover_HoldPacket(SilenceRemover* self, BLT_MediaPacket* packet)
+SilenceRemover_HoldPacket(SilenceRemover* self,
+                          BLT_MediaPacket* packet,
+                          BLT_Size         zero_tail)
 {
+    BLT_Result result;
     ATX_LOG_FINER("SilenceRemover: holding packet");
 
-    /* accept the previously pending packet if any */
-    SilenceRemover_AcceptPending(self);
+    /* the first packet held is the one that may have sound */
+    if (ATX_List_GetItemCount(self->input.pending) == 0) {
+        self->input.pending_tail = zero_tail;
+    }
+    result = ATX_List_AddData(self->input.pending, packet);
+    if (ATX_SUCCEEDED(result)) {
+        BLT_MediaPacket_AddReference(packet);
+    }
+}
 
-    /* hold the packet as a pending input */
-    self->input.pending = packet;
-    BLT_MediaPacket_AddReference(packet);
+/*----------------------------------------------------------------------
+|    SilenceRemover_AcceptPending
+|
+|    lets the pending packets through, when the silence was too short
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_AcceptPending(SilenceRemover* self)
+{
+    ATX_ListItem* item;
+
+    while ((item = ATX_List_GetFirstItem(self->input.pending))) {
+        BLT_MediaPacket* packet = ATX_ListItem_GetData(item);
+        ATX_List_RemoveItem(self->input.pending, item);
+        SilenceRemover_AcceptPacket(self, packet);
+        BLT_MediaPacket_Release(packet);
+    }
+    self->input.pending_tail = 0;
 }
 
 /*----------------------------------------------------------------------
-|    SilenceRemover_AcceptPacket
+|    SilenceRemover_TrimPending
+|
+|    removes the silence held in the pending packets
 +---------------------------------------------------------------------*/
 static void
-SilenceRemover_AcceptPacket(SilenceRemover* self, BLT_MediaPacket* packet)
+SilenceRemover_TrimPending(SilenceRemover* self)
 {
-    BLT_Result result;
-    ATX_LOG_FINER("SilenceRemover: accepting packet");
+    ATX_ListItem* item;
+    BLT_Boolean   first = BLT_TRUE;
 
-    /* first, use any pending packet */
-    SilenceRemover_AcceptPending(self);
+    ATX_LOG_FINER("SilenceRemover: trimming pending packets");
 
-    /* add the packet to the output list */
-    result = ATX_List_AddData(self->output.packets, packet);
-    if (ATX_SUCCEEDED(result)) {
-        BLT_MediaPacket_AddReference(packet);
+    while ((item = ATX_List_GetFirstItem(self->input.pending))) {
+        BLT_MediaPacket* packet = ATX_ListItem_GetData(item);
+        ATX_List_RemoveItem(self->input.pending, item);
+        if (first && BLT_MediaPacket_GetPayloadSize(packet) > self->input.pending_tail) {
+            /* remove the silence at the end of the packet */
+            SilenceRemover_TrimPacket(packet, 0, self->input.pending_tail);
+            SilenceRemover_AcceptPacket(self, packet);
+        } else {
+            SilenceRemover_DropPacket(self, packet);
+        }
+        BLT_MediaPacket_Release(packet);
+        first = BLT_FALSE;
     }
+    self->input.pending_tail = 0;
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_ReleasePending
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_ReleasePending(SilenceRemover* self)
+{
+    ATX_ListItem* item;
+
+    while ((item = ATX_List_GetFirstItem(self->input.pending))) {
+        BLT_MediaPacket_Release((BLT_MediaPacket*)ATX_ListItem_GetData(item));
+        ATX_List_RemoveItem(self->input.pending, item);
+    }
+    self->input.pending_tail = 0;
 }
 
 /*----------------------------------------------------------------------
 |    SilenceRemoverInput_PutPacket
+|
+|    Silence at the start and at the end of a stream is always removed.
+|    Inside a stream, only runs of silence at least as long as the
+|    minimum duration are, so packets that end with silence are held
+|    until we know how long it lasts.
 +---------------------------------------------------------------------*/
 BLT_METHOD
 SilenceRemoverInput_PutPacket(BLT_PacketConsumer* _self,
@@ -228,83 +580,115 @@ SilenceRemoverInput_PutPacket(BLT_PacketConsumer* _self,
 {
     SilenceRemover* self = ATX_SELF_M(input, SilenceRemover, BLT_PacketConsumer);
     BLT_Flags       packet_flags;
-    BLT_Cardinal    zero_head = 0;
-    BLT_Cardinal    zero_tail = 0;
-    BLT_Offset      payload_offset;
     BLT_Size        payload_size;
+    BLT_Size        zero_head = 0;
+    BLT_Size        zero_tail = 0;
+    BLT_Size        frame_size = 0;
+    BLT_Cardinal    head_frames = 0;
+    BLT_Cardinal    tail_frames = 0;
+    BLT_Cardinal    min_frames;
     ATX_Result      result;
 
     ATX_LOG_FINER("SilenceRemoverInput::PutPacket");
 
     /* get the packet info */
-    packet_flags   = BLT_MediaPacket_GetFlags(packet);
-    payload_offset = BLT_MediaPacket_GetPayloadOffset(packet);
-    payload_size   = BLT_MediaPacket_GetPayloadSize(packet);
+    packet_flags = BLT_MediaPacket_GetFlags(packet);
+    payload_size = BLT_MediaPacket_GetPayloadSize(packet);
 
-    /* scan the packet for zeros */
+    /* scan the packet for silence */
     if (payload_size != 0) {
-        result = ScanPacket(packet, &zero_head, &zero_tail);    
+        result = SilenceRemover_ScanPacket(self, packet, &zero_head, &zero_tail, &frame_size);
         if (BLT_FAILED(result)) return result;
         if (zero_head || zero_tail) {
             ATX_LOG_FINER_2("SilenceRemoverInput::PutPacket zero_head=%d, zero_tail=%d",
                             (int)zero_head, (int)zero_tail);
         }
+        if (frame_size) {
+            head_frames = zero_head/frame_size;
+            tail_frames = zero_tail/frame_size;
+        }
+    }
+    min_frames = SilenceRemover_GetMinFrames(self, packet);
+
+    /* a new stream starts, what we held belongs to the previous one */
+    if (packet_flags & BLT_MEDIA_PACKET_FLAG_START_OF_STREAM &&
+        self->state == SILENCE_REMOVER_STATE_IN_STREAM) {
+        SilenceRemover_AcceptPending(self);
+        self->state = SILENCE_REMOVER_STATE_START_OF_STREAM;
     }
 
     /* decide how to process the packet */
     if (self->state == SILENCE_REMOVER_STATE_START_OF_STREAM) {
         if (zero_head == payload_size) {
             /* packet is all silence */
-            if (packet_flags != 0) {
-                /* packet has flags, don't discard it, just empty it */
-                ATX_LOG_FINER("SilenceRemover: emptying packet");
-                BLT_MediaPacket_SetPayloadSize(packet, 0);
-                SilenceRemover_AcceptPacket(self, packet);
-            } else {
-                ATX_LOG_FINER("SilenceRemover: dropping packet");
-            }
-        } else {
-            /* remove silence at the start of the packet */
-            BLT_MediaPacket_SetPayloadOffset(packet, payload_offset+zero_head);
-            SilenceRemover_AcceptPacket(self, packet);
+            SilenceRemover_DropPacket(self, packet);
+            return BLT_SUCCESS;
+        }
+
+        /* remove silence at the start of the packet */
+        SilenceRemover_TrimPacket(packet, zero_head, 0);
+        payload_size -= zero_head;
+        zero_head   = 0;
+        head_frames = 0;
+
+        ATX_LOG_FINER("SilenceRemover: new state = IN_STREAM");
+        self->state   = SILENCE_REMOVER_STATE_IN_STREAM;
+        self->silence = 0;
+        self->cutting = BLT_FALSE;
+    }
 
-            /* we're now in the stream unless this is also the end */
-            if (!(packet_flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM)) {
-                ATX_LOG_FINER("SilenceRemover: new state = IN_STREAM");
-                self->state =  SILENCE_REMOVER_STATE_IN_STREAM;
+    /* in stream */
+    if (zero_head == payload_size) {
+        /* packet is all silence */
+        ATX_LOG_FINER("SilenceRemover: packet is all silence");
+        if (self->cutting || (payload_size == 0 && packet_flags == 0)) {
+            SilenceRemover_DropPacket(self, packet);
+        } else {
+            SilenceRemover_HoldPacket(self, packet, payload_size);
+            self->silence += head_frames;
+            if (self->silence >= min_frames) {
+                SilenceRemover_TrimPending(self);
+                self->cutting = BLT_TRUE;
             }
         }
     } else {
-        /* in stream */
-        if (zero_head == payload_size) {
-            /* packet is all silence */
-            ATX_LOG_FINER("SilenceRemover: packet is all silence");
-            if (packet_flags) {
-                /* packet has flags, don't discard it, just empty it */
+        /* the silence before the packet ends here */
+        if (self->cutting) {
+            SilenceRemover_TrimPacket(packet, zero_head, 0);
+        } else if (ATX_List_GetItemCount(self->input.pending)) {
+            if (self->silence+head_frames >= min_frames) {
                 SilenceRemover_TrimPending(self);
-                BLT_MediaPacket_SetPayloadSize(packet, 0);
-                SilenceRemover_AcceptPacket(self, packet);
+                SilenceRemover_TrimPacket(packet, zero_head, 0);
             } else {
-                ATX_LOG_FINER("SilenceRemover: dropping packet");
+                SilenceRemover_AcceptPending(self);
             }
-        } else {
-            /* accept the pending packet */
-            SilenceRemover_AcceptPending(self);
-            if (zero_tail) {
-                /* packet has some silence at the end */
-                ATX_LOG_FINER("SilenceRemover: packet has silence at end");
-                SilenceRemover_HoldPacket(self, packet);
-            } else {
-                /* packet has no silence at the end */
-                ATX_LOG_FINER("SilenceRemover: packet has no silence at end");
+        }
+        self->silence = 0;
+        self->cutting = BLT_FALSE;
+
+        if (zero_tail) {
+            /* packet has some silence at the end */
+            ATX_LOG_FINER("SilenceRemover: packet has silence at end");
+            if (tail_frames >= min_frames) {
+                SilenceRemover_TrimPacket(packet, 0, zero_tail);
                 SilenceRemover_AcceptPacket(self, packet);
+                self->cutting = BLT_TRUE;
+            } else {
+                SilenceRemover_HoldPacket(self, packet, zero_tail);
+                self->silence = tail_frames;
             }
+        } else {
+            /* packet has no silence at the end */
+            ATX_LOG_FINER("SilenceRemover: packet has no silence at end");
+            SilenceRemover_AcceptPacket(self, packet);
         }
-        if (packet_flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM ||
-            packet_flags & BLT_MEDIA_PACKET_FLAG_START_OF_STREAM) {
-            ATX_LOG_FINER("SilenceRemover: new state = START_OF_STREAM");
-            self->state = SILENCE_REMOVER_STATE_START_OF_STREAM;
-        }
+    }
+
+    if (packet_flags & BLT_MEDIA_PACKET_FLAG_END_OF_STREAM) {
+        /* the silence at the end of the stream is always removed */
+        SilenceRemover_TrimPending(self);
+        ATX_LOG_FINER("SilenceRemover: new state = START_OF_STREAM");
+        self->state = SILENCE_REMOVER_STATE_START_OF_STREAM;
     }
 
     return BLT_SUCCESS;
@@ -433,8 +817,9 @@ SilenceRemover_SetupPorts(SilenceRemover* self)
 {
     ATX_Result result;
 
-    /* no pending packet yet */
-    self->input.pending = NULL;
+    /* create a list of pending packets */
+    result = ATX_List_Create(&self->input.pending);
+    if (ATX_FAILED(result)) return result;
 
     /* create a list of output packets */
     result = ATX_List_Create(&self->output.packets);
@@ -475,7 +860,9 @@ SilenceRemover_Create(BLT_Module*              module,
     BLT_BaseMediaNode_Construct(&ATX_BASE(self, BLT_BaseMediaNode), module, core);
 
     /* construct the object */
-    self->state = SILENCE_REMOVER_STATE_START_OF_STREAM;
+    self->state        = SILENCE_REMOVER_STATE_START_OF_STREAM;
+    self->min_duration = BLT_CONFIG_SILENCE_REMOVER_DEFAULT_MIN_DURATION;
+    SilenceRemover_SetThreshold(self, BLT_CONFIG_SILENCE_REMOVER_DEFAULT_THRESHOLD);
 
     /* setup the input and output ports */
     result = SilenceRemover_SetupPorts(self);
@@ -489,6 +876,7 @@ SilenceRemover_Create(BLT_Module*              module,
     /* setup interfaces */
     ATX_SET_INTERFACE_EX(self, SilenceRemover, BLT_BaseMediaNode, BLT_MediaNode);
     ATX_SET_INTERFACE_EX(self, SilenceRemover, BLT_BaseMediaNode, ATX_Referenceable);
+    ATX_SET_INTERFACE(self, SilenceRemover, ATX_PropertyListener);
     ATX_SET_INTERFACE(&self->input,  SilenceRemoverInput,  BLT_MediaPort);
     ATX_SET_INTERFACE(&self->input,  SilenceRemoverInput,  BLT_PacketConsumer);
     ATX_SET_INTERFACE(&self->output, SilenceRemoverOutput, BLT_MediaPort);
@@ -510,7 +898,8 @@ SilenceRemover_Destroy(SilenceRemover* self)
 
     /* release any input packet we may hold */
     if (self->input.pending) {
-        BLT_MediaPacket_Release(self->input.pending);
+        SilenceRemover_ReleasePending(self);
+        ATX_List_Destroy(self->input.pending);
     }
 
     /* release any output packet we may hold */
@@ -555,6 +944,105 @@ SilenceRemover_GetPortByName(BLT_MediaNode*  _self,
     }
 }
 
+/*----------------------------------------------------------------------
+|    SilenceRemover_UpdateOption
++---------------------------------------------------------------------*/
+static void
+SilenceRemover_UpdateOption(SilenceRemover*          self,
+                            ATX_CString              name,
+                            const ATX_PropertyValue* value)
+{
+    if (ATX_StringsEqual(name, BLT_SILENCE_REMOVER_OPTION_THRESHOLD)) {
+        float threshold = BLT_CONFIG_SILENCE_REMOVER_DEFAULT_THRESHOLD;
+        if (value && value->type == ATX_PROPERTY_VALUE_TYPE_FLOAT) {
+            threshold = value->data.fp;
+        } else if (value && value->type == ATX_PROPERTY_VALUE_TYPE_INTEGER) {
+            threshold = (float)value->data.integer;
+        }
+        SilenceRemover_SetThreshold(self, threshold);
+    } else if (ATX_StringsEqual(name, BLT_SILENCE_REMOVER_OPTION_MIN_DURATION)) {
+        if (value && value->type == ATX_PROPERTY_VALUE_TYPE_INTEGER && value->data.integer >= 0) {
+            self->min_duration = value->data.integer;
+        } else {
+            self->min_duration = BLT_CONFIG_SILENCE_REMOVER_DEFAULT_MIN_DURATION;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_Activate
++---------------------------------------------------------------------*/
+BLT_METHOD
+SilenceRemover_Activate(BLT_MediaNode* _self, BLT_Stream* stream)
+{
+    SilenceRemover* self = ATX_SELF_EX(SilenceRemover, BLT_BaseMediaNode, BLT_MediaNode);
+
+    /* keep a reference to the stream */
+    ATX_BASE(self, BLT_BaseMediaNode).context = stream;
+
+    /* listen to settings on the new stream */
+    if (stream) {
+        ATX_Properties* properties;
+        if (BLT_SUCCEEDED(BLT_Stream_GetProperties(stream, &properties))) {
+            ATX_PropertyValue property;
+            ATX_Properties_AddListener(properties,
+                                       BLT_SILENCE_REMOVER_OPTION_THRESHOLD,
+                                       &ATX_BASE(self, ATX_PropertyListener),
+                                       &self->threshold_listener_handle);
+            ATX_Properties_AddListener(properties,
+                                       BLT_SILENCE_REMOVER_OPTION_MIN_DURATION,
+                                       &ATX_BASE(self, ATX_PropertyListener),
+                                       &self->min_duration_listener_handle);
+
+            /* read the initial values */
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(
+                    properties,
+                    BLT_SILENCE_REMOVER_OPTION_THRESHOLD,
+                    &property))) {
+                SilenceRemover_UpdateOption(self,
+                                            BLT_SILENCE_REMOVER_OPTION_THRESHOLD,
+                                            &property);
+            }
+            if (ATX_SUCCEEDED(ATX_Properties_GetProperty(
+                    properties,
+                    BLT_SILENCE_REMOVER_OPTION_MIN_DURATION,
+                    &property))) {
+                SilenceRemover_UpdateOption(self,
+                                            BLT_SILENCE_REMOVER_OPTION_MIN_DURATION,
+                                            &property);
+            }
+        }
+    }
+
+    return BLT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+|    SilenceRemover_Deactivate
++---------------------------------------------------------------------*/
+BLT_METHOD
+SilenceRemover_Deactivate(BLT_MediaNode* _self)
+{
+    SilenceRemover* self = ATX_SELF_EX(SilenceRemover, BLT_BaseMediaNode, BLT_MediaNode);
+
+    /* remove our listeners */
+    if (ATX_BASE(self, BLT_BaseMediaNode).context) {
+        ATX_Properties* properties;
+        if (BLT_SUCCEEDED(BLT_Stream_GetProperties(ATX_BASE(self, BLT_BaseMediaNode).context,
+                                                   &properties))) {
+            ATX_Properties_RemoveListener(properties,
+                                          self->threshold_listener_handle);
+            ATX_Properties_RemoveListener(properties,
+                                          self->min_duration_listener_handle);
+        }
+    }
+
+    /* we're detached from the stream */
+    ATX_BASE(self, BLT_BaseMediaNode).context = NULL;
+
+    return BLT_SUCCESS;
+}
+
 /*----------------------------------------------------------------------
 |    SilenceRemover_Seek
 +---------------------------------------------------------------------*/
@@ -567,11 +1055,10 @@ SilenceRemover_Seek(BLT_MediaNode* instance,
     BLT_COMPILER_UNUSED(mode);
     BLT_COMPILER_UNUSED(point);
     
-    /* flush the pending packet */
-    if (self->input.pending) {
-        BLT_MediaPacket_Release(self->input.pending);
-    } 
-    self->input.pending = NULL;
+    /* flush the pending packets */
+    SilenceRemover_ReleasePending(self);
+    self->silence = 0;
+    self->cutting = BLT_FALSE;
 
     return BLT_SUCCESS;
 }
@@ -582,6 +1069,7 @@ SilenceRemover_Seek(BLT_MediaNode* instance,
 ATX_BEGIN_GET_INTERFACE_IMPLEMENTATION(SilenceRemover)
     ATX_GET_INTERFACE_ACCEPT_EX(SilenceRemover, BLT_BaseMediaNode, BLT_MediaNode)
     ATX_GET_INTERFACE_ACCEPT_EX(SilenceRemover, BLT_BaseMediaNode, ATX_Referenceable)
+    ATX_GET_INTERFACE_ACCEPT(SilenceRemover, ATX_PropertyListener)
 ATX_END_GET_INTERFACE_IMPLEMENTATION
 
 /*----------------------------------------------------------------------
@@ -590,8 +1078,8 @@ ATX_END_GET_INTERFACE_IMPLEMENTATION
 ATX_BEGIN_INTERFACE_MAP_EX(SilenceRemover, BLT_BaseMediaNode, BLT_MediaNode)
     BLT_BaseMediaNode_GetInfo,
     SilenceRemover_GetPortByName,
-    BLT_BaseMediaNode_Activate,
-    BLT_BaseMediaNode_Deactivate,
+    SilenceRemover_Activate,
+    SilenceRemover_Deactivate,
     BLT_BaseMediaNode_Start,
     BLT_BaseMediaNode_Stop,
     BLT_BaseMediaNode_Pause,
@@ -599,6 +1087,27 @@ ATX_BEGIN_INTERFACE_MAP_EX(SilenceRemover, BLT_BaseMediaNode, BLT_MediaNode)
     SilenceRemover_Seek
 };
 
+/*----------------------------------------------------------------------
+|    SilenceRemover_OnPropertyChanged
++---------------------------------------------------------------------*/
+BLT_VOID_METHOD
+SilenceRemover_OnPropertyChanged(ATX_PropertyListener*    _self,
+                                 ATX_CString              name,
+                                 const ATX_PropertyValue* value)
+{
+    SilenceRemover* self = ATX_SELF(SilenceRemover, ATX_PropertyListener);
+
+    if (name == NULL) return;
+    SilenceRemover_UpdateOption(self, name, value);
+}
+
+/*----------------------------------------------------------------------
+|    ATX_PropertyListener interface
++---------------------------------------------------------------------*/
+ATX_BEGIN_INTERFACE_MAP(SilenceRemover, ATX_PropertyListener)
+    SilenceRemover_OnPropertyChanged,
+};
+
 /*----------------------------------------------------------------------
 |   ATX_Referenceable interface
 +---------------------------------------------------------------------*/
@@ -16,6 +16,22 @@
 #include "BltTypes.h"
 #include "BltModule.h"
 
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+/**
+ * Stream property: samples under this level, in dB relative to full
+ * scale, are silent (float or integer).
+ */
+#define BLT_SILENCE_REMOVER_OPTION_THRESHOLD    "Plugins.SilenceRemover.Threshold"
+
+/**
+ * Stream property: silence inside a stream is only removed when it lasts
+ * at least this long, in milliseconds (integer). Silence at the start and
+ * at the end of a stream is always removed.
+ */
+#define BLT_SILENCE_REMOVER_OPTION_MIN_DURATION "Plugins.SilenceRemover.MinDuration"
+
 /*----------------------------------------------------------------------
 |   module
 +---------------------------------------------------------------------*/
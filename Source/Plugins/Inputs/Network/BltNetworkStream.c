@@ -14,6 +14,9 @@
 #include "BltNetworkStream.h"
 #include "BltNetworkInputSource.h"
 #include "BltErrors.h"
+#include "BltEvent.h"
+#include "BltEventListener.h"
+#include "BltMediaNode.h"
 
 /*----------------------------------------------------------------------
 |   types
@@ -576,14 +579,43 @@ BLT_NetworkStream_GetAvailable(ATX_InputStream* _self, ATX_LargeSize* available)
     return ATX_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|   BLT_NetworkStream_SignalReady
+|
+|   tells the stream we are attached to that its input node has data
++---------------------------------------------------------------------*/
+static void
+BLT_NetworkStream_SignalReady(BLT_NetworkStream* self)
+{
+    BLT_EventListener* listener;
+    BLT_NodeReadyEvent event;
+
+    if (self->context == NULL) return;
+    listener = ATX_CAST(self->context, BLT_EventListener);
+    if (listener == NULL) return;
+
+    /* we are only attached while the node reading from us is the input */
+    event.node = NULL;
+    BLT_Stream_GetInputNode(self->context, &event.node);
+    if (event.node == NULL) return;
+    BLT_EventListener_OnEvent(listener, 
+                              (ATX_Object*)event.node, 
+                              BLT_EVENT_TYPE_NODE_READY, 
+                              (const BLT_Event*)(const void*)&event);
+    ATX_RELEASE_OBJECT(event.node);
+}
+
 /*----------------------------------------------------------------------
 |   BLT_NetworkStream_FillBuffer_
+|
+|   called from a thread other than the one reading from the stream
 +---------------------------------------------------------------------*/
 BLT_METHOD
 BLT_NetworkStream_FillBuffer_(BLT_BufferedNetworkStream* _self)
 {
     BLT_NetworkStream* self = ATX_SELF(BLT_NetworkStream, BLT_BufferedNetworkStream);
     ATX_LargeSize      source_available = 0;
+    ATX_Size           buffered = ATX_RingBuffer_GetAvailable(self->buffer);
     
     BLT_NetworkStream_CheckReconnection(self);
     if (ATX_SUCCEEDED(ATX_InputStream_GetAvailable(self->source, &source_available))) {
@@ -591,6 +623,12 @@ BLT_NetworkStream_FillBuffer_(BLT_BufferedNetworkStream* _self)
             BLT_NetworkStream_FillBuffer(self);
         }
     }
+
+    /* the reader may be waiting for this data */
+    if (ATX_RingBuffer_GetAvailable(self->buffer) > buffered) {
+        BLT_NetworkStream_SignalReady(self);
+    }
+    
     return ATX_SUCCESS;
 }
 
@@ -440,16 +440,23 @@ OsxAudioQueueOutput_BufferCallback(void*               _self,
                                    AudioQueueBufferRef buffer)
 {
     OsxAudioQueueOutput* self = (OsxAudioQueueOutput*)_self;
+    BLT_Boolean          was_full;
     BLT_COMPILER_UNUSED(queue);
     
     /* mark the buffer as free */
     pthread_mutex_lock(&self->lock);
+    was_full = (self->buffers[self->buffer_index].data == buffer);
     buffer->mUserData = NULL;
     buffer->mAudioDataByteSize = 0;
     pthread_cond_signal(&self->buffer_released_cond);
     pthread_mutex_unlock(&self->lock);
     
     ATX_LOG_FINER_1("callback for buffer %p", buffer);
+
+    /* GetStatus reported a full queue while this buffer was busy */
+    if (was_full) {
+        BLT_BaseMediaNode_SignalReady(&ATX_BASE(self, BLT_BaseMediaNode));
+    }
 }
 
 /*----------------------------------------------------------------------
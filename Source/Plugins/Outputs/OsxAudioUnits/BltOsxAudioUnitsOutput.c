@@ -114,6 +114,8 @@ OsxAudioUnitsOutput_RenderCallback(void*						inRefCon,
     unsigned int         requested;
     unsigned char*       out;
     ATX_Boolean          timestamp_measured = ATX_FALSE;
+    ATX_Boolean          was_full;
+    ATX_Boolean          space_freed;
     
     BLT_COMPILER_UNUSED(ioActionFlags);
     BLT_COMPILER_UNUSED(inTimeStamp);
@@ -142,6 +144,7 @@ OsxAudioUnitsOutput_RenderCallback(void*						inRefCon,
 
     /* lock the packet queue */
     pthread_mutex_lock(&self->lock);
+    was_full = (ATX_List_GetItemCount(self->packet_queue) >= self->max_packets_in_queue);
     
     /* return now if we're paused */
     //if (self->paused) goto end;
@@ -225,7 +228,14 @@ end:
         ATX_SetMemory(out, 0, requested);
     }
     
+    space_freed = was_full && 
+                  ATX_List_GetItemCount(self->packet_queue) < self->max_packets_in_queue;
     pthread_mutex_unlock(&self->lock);
+    
+    /* GetStatus reported a full queue, tell the stream it can write again */
+    if (space_freed) {
+        BLT_BaseMediaNode_SignalReady(&ATX_BASE(self, BLT_BaseMediaNode));
+    }
         
     return 0;
 }
@@ -842,6 +842,13 @@ AdtsParserModule_Attach(BLT_Module* _self, BLT_Core* core)
         &self->mp4es_type_id);
     if (BLT_FAILED(result)) return result;
     
+    /* only probe us for audio/aac input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_PACKET,
+                                         self->adts_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("ADTS Parser Module::Attach (" BLT_MP4_AUDIO_ES_MIME_TYPE " type = %d)", self->mp4es_type_id);
     ATX_LOG_FINE_1("ADTS Parser Module::Attach (audio/aac type = %d)", self->adts_type_id);
 
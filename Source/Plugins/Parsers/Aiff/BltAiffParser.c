@@ -747,6 +747,13 @@ AiffParserModule_Attach(BLT_Module* _self, BLT_Core* core)
         self->aiff_type_id);
     if (BLT_FAILED(result)) return result;
 
+    /* only probe us for audio/aiff input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_STREAM_PULL,
+                                         self->aiff_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("AiffParserModule::Attach (audio/aiff type = %d)",
                    self->aiff_type_id);
 
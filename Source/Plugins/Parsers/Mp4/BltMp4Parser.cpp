@@ -1006,6 +1006,9 @@ Mp4ParserOutput_GetPacket(BLT_PacketProducer* _self,
             if (BLT_FAILED(result)) return result;
         }
         
+        // copy the sample into a pooled packet. Samples are small, so this
+        // is cheaper than handing over the sample buffer, which would need
+        // an unpooled packet and a new sample buffer for every sample
         AP4_Size packet_size = sample_buffer->GetDataSize();
         result = BLT_Core_CreateMediaPacket(ATX_BASE(self->parser, BLT_BaseMediaNode).core,
                                             packet_size,
@@ -669,6 +669,13 @@ WaveParserModule_Attach(BLT_Module* _self, BLT_Core* core)
         &self->wav_type_id);
     if (BLT_FAILED(result)) return result;
     
+    /* only probe us for audio/wav input */
+    result = BLT_Core_DeclareModuleInput(core, 
+                                         _self, 
+                                         BLT_MEDIA_PORT_PROTOCOL_STREAM_PULL,
+                                         self->wav_type_id);
+    if (BLT_FAILED(result)) return result;
+
     ATX_LOG_FINE_1("Wave Parser Module::Attach (audio/wav type = %d)", self->wav_type_id);
 
     return BLT_SUCCESS;
@@ -0,0 +1,108 @@
+/*****************************************************************
+|
+|   BlueTune - PCM Test Support
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+****************************************************************/
+
+#ifndef _PCM_TEST_H_
+#define _PCM_TEST_H_
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "Atomix.h"
+#include "BltPcm.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* written after the expected end of an output buffer, to catch overruns */
+#define PCM_TEST_GUARD_SAMPLE 12345.0f
+
+/*----------------------------------------------------------------------
+|    CHECK
++---------------------------------------------------------------------*/
+#define CHECK(x)                                        \
+do {                                                    \
+    if (!(x)) {                                         \
+        fprintf(stderr, "FAILED line %d\n", __LINE__);  \
+        abort();                                        \
+    }                                                   \
+} while(0)
+
+/*----------------------------------------------------------------------
+|    globals
++---------------------------------------------------------------------*/
+/* the variants that the tests compare with the portable code */
+static const struct {
+    const char* name;
+    BLT_Flags   flag;
+} PcmTest_Kernels[] = {
+    {"sse2", BLT_PCM_KERNEL_SSE2},
+    {"avx2", BLT_PCM_KERNEL_AVX2},
+    {"neon", BLT_PCM_KERNEL_NEON}
+};
+
+#define PCM_TEST_KERNEL_COUNT (sizeof(PcmTest_Kernels)/sizeof(PcmTest_Kernels[0]))
+
+/*----------------------------------------------------------------------
+|    PcmTest_MakeSamples
+|
+|    random samples between -amplitude and amplitude
++---------------------------------------------------------------------*/
+static void
+PcmTest_MakeSamples(float* samples, BLT_Cardinal count, float amplitude)
+{
+    BLT_Cardinal i;
+    for (i=0; i<count; i++) {
+        samples[i] = amplitude*(2.0f*((float)rand()/(float)RAND_MAX)-1.0f);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    PcmTest_CompareSamples
+|
+|    fails, naming the test case and the first bad sample, if the
+|    samples differ by more than 'tolerance' (0 means the same values)
++---------------------------------------------------------------------*/
+static void
+PcmTest_CompareSamples(const char*  test_case,
+                       const float* expected,
+                       const float* actual,
+                       BLT_Cardinal count,
+                       float        tolerance)
+{
+    BLT_Cardinal i;
+    for (i=0; i<count; i++) {
+        if (fabs(actual[i]-expected[i]) > tolerance) {
+            fprintf(stderr, "%s: sample %d is %g instead of %g\n",
+                    test_case, (int)i, actual[i], expected[i]);
+            CHECK(0);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    PcmTest_PrintKernels
++---------------------------------------------------------------------*/
+static void
+PcmTest_PrintKernels(void)
+{
+    BLT_Flags    available = BLT_Pcm_GetAvailableKernels();
+    unsigned int i;
+
+    printf("available kernels: portable");
+    for (i=0; i<PCM_TEST_KERNEL_COUNT; i++) {
+        if (available & PcmTest_Kernels[i].flag) printf(" %s", PcmTest_Kernels[i].name);
+    }
+    printf("\n");
+}
+
+#endif /* _PCM_TEST_H_ */
@@ -0,0 +1,202 @@
+/*****************************************************************
+|
+|   BlueTune - Media Packet Test
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+****************************************************************/
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Atomix.h"
+#include "BltMedia.h"
+#include "BltPcm.h"
+#include "BltMediaPacket.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+#define BUFFER_SIZE 1031
+
+/*----------------------------------------------------------------------
+|    CHECK
++---------------------------------------------------------------------*/
+#define CHECK(x)                                        \
+do {                                                    \
+    if (!(x)) {                                         \
+        fprintf(stderr, "FAILED line %d\n", __LINE__);  \
+        abort();                                        \
+    }                                                   \
+} while(0)
+
+/*----------------------------------------------------------------------
+|    types
++---------------------------------------------------------------------*/
+/* owner of an external buffer, counts the calls to its release callback */
+typedef struct {
+    unsigned char buffer[BUFFER_SIZE];
+    unsigned int  release_count;
+} Owner;
+
+/*----------------------------------------------------------------------
+|    Owner_Init
++---------------------------------------------------------------------*/
+static void
+Owner_Init(Owner* owner)
+{
+    unsigned int i;
+    for (i=0; i<BUFFER_SIZE; i++) {
+        owner->buffer[i] = (unsigned char)i;
+    }
+    owner->release_count = 0;
+}
+
+/*----------------------------------------------------------------------
+|    Owner_ReleaseBuffer
++---------------------------------------------------------------------*/
+static void
+Owner_ReleaseBuffer(BLT_Any buffer, BLT_Any instance)
+{
+    Owner* owner = (Owner*)instance;
+    CHECK(buffer == owner->buffer);
+    ++owner->release_count;
+}
+
+/*----------------------------------------------------------------------
+|    TestExternalBuffer
++---------------------------------------------------------------------*/
+static void
+TestExternalBuffer(void)
+{
+    Owner            owner;
+    BLT_MediaPacket* packet;
+    unsigned char*   payload;
+    unsigned int     i;
+
+    /* the packet uses the buffer as is */
+    Owner_Init(&owner);
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_CreateWithExternalBuffer(owner.buffer,
+                                                                 BUFFER_SIZE,
+                                                                 NULL,
+                                                                 Owner_ReleaseBuffer,
+                                                                 &owner,
+                                                                 &packet)));
+    CHECK(BLT_MediaPacket_GetPayloadBuffer(packet) == owner.buffer);
+    CHECK(BLT_MediaPacket_GetPayloadSize(packet) == BUFFER_SIZE);
+
+    /* the buffer still belongs to its owner */
+    CHECK(!BLT_MediaPacket_IsWritable(packet));
+
+    /* it is given back with the last reference */
+    BLT_MediaPacket_AddReference(packet);
+    BLT_MediaPacket_Release(packet);
+    CHECK(owner.release_count == 0);
+    BLT_MediaPacket_Release(packet);
+    CHECK(owner.release_count == 1);
+
+    /* growing the payload copies it and gives the buffer back right away */
+    Owner_Init(&owner);
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_CreateWithExternalBuffer(owner.buffer,
+                                                                 BUFFER_SIZE,
+                                                                 NULL,
+                                                                 Owner_ReleaseBuffer,
+                                                                 &owner,
+                                                                 &packet)));
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_SetPayloadSize(packet, 2*BUFFER_SIZE)));
+    CHECK(owner.release_count == 1);
+    payload = (unsigned char*)BLT_MediaPacket_GetPayloadBuffer(packet);
+    CHECK(payload != owner.buffer);
+    for (i=0; i<BUFFER_SIZE; i++) {
+        CHECK(payload[i] == (unsigned char)i);
+    }
+    CHECK(BLT_MediaPacket_IsWritable(packet));
+    BLT_MediaPacket_Release(packet);
+    CHECK(owner.release_count == 1);
+}
+
+/*----------------------------------------------------------------------
+|    TestView
++---------------------------------------------------------------------*/
+static void
+TestView(void)
+{
+    Owner                owner;
+    BLT_PcmMediaType     pcm_type;
+    const BLT_MediaType* type;
+    BLT_MediaPacket*     packet;
+    BLT_MediaPacket*     view;
+    BLT_MediaPacket*     other_view;
+    unsigned char*       payload;
+    unsigned int         i;
+
+    Owner_Init(&owner);
+    BLT_PcmMediaType_Init(&pcm_type);
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_CreateWithExternalBuffer(owner.buffer,
+                                                                 BUFFER_SIZE,
+                                                                 &pcm_type.base,
+                                                                 Owner_ReleaseBuffer,
+                                                                 &owner,
+                                                                 &packet)));
+
+    /* the offset of a view is relative to the payload */
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_SetPayloadOffset(packet, 10)));
+    CHECK(BLT_MediaPacket_CreateView(packet, 0, BUFFER_SIZE, NULL, &view) == BLT_ERROR_INVALID_PARAMETERS);
+    CHECK(view == NULL);
+    CHECK(BLT_MediaPacket_CreateView(packet, -1, 1, NULL, &view) == BLT_ERROR_INVALID_PARAMETERS);
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_CreateView(packet, 100, 200, NULL, &view)));
+    CHECK(BLT_MediaPacket_GetPayloadBuffer(view) == owner.buffer+110);
+    CHECK(BLT_MediaPacket_GetPayloadSize(view) == 200);
+
+    /* with the type of the packet, unless another one is given */
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_GetMediaType(view, &type)));
+    CHECK(BLT_MediaType_Equals(type, &pcm_type.base));
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_CreateView(packet, 0, 10, &BLT_MediaType_None, &other_view)));
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_GetMediaType(other_view, &type)));
+    CHECK(type->id == BLT_MEDIA_TYPE_ID_NONE);
+    BLT_MediaPacket_Release(other_view);
+
+    /* neither of them can be modified while the buffer is shared */
+    CHECK(!BLT_MediaPacket_IsWritable(view));
+    CHECK(!BLT_MediaPacket_IsWritable(packet));
+
+    /* the view keeps the buffer alive after the packet is released */
+    BLT_MediaPacket_Release(packet);
+    CHECK(owner.release_count == 0);
+    payload = (unsigned char*)BLT_MediaPacket_GetPayloadBuffer(view);
+    for (i=0; i<200; i++) {
+        CHECK(payload[i] == (unsigned char)(110+i));
+    }
+
+    /* growing the view copies it, and lets go of the packet */
+    CHECK(BLT_SUCCEEDED(BLT_MediaPacket_SetPayloadSize(view, 300)));
+    CHECK(owner.release_count == 1);
+    payload = (unsigned char*)BLT_MediaPacket_GetPayloadBuffer(view);
+    for (i=0; i<200; i++) {
+        CHECK(payload[i] == (unsigned char)(110+i));
+    }
+    CHECK(BLT_MediaPacket_IsWritable(view));
+    BLT_MediaPacket_Release(view);
+    CHECK(owner.release_count == 1);
+}
+
+/*----------------------------------------------------------------------
+|    main
++---------------------------------------------------------------------*/
+int
+main(int argc, char** argv)
+{
+    BLT_COMPILER_UNUSED(argc);
+    BLT_COMPILER_UNUSED(argv);
+
+    TestExternalBuffer();
+    TestView();
+
+    printf("PASSED\n");
+    return 0;
+}
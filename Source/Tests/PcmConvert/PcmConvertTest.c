@@ -0,0 +1,208 @@
+/*****************************************************************
+|
+|   BlueTune - PCM Conversion Test
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+****************************************************************/
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Atomix.h"
+#include "BltPcm.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* not a multiple of any vector size, so that the tails are tested too */
+#define SAMPLE_COUNT 1031
+
+/*----------------------------------------------------------------------
+|    CHECK
++---------------------------------------------------------------------*/
+#define CHECK(x)                                        \
+do {                                                    \
+    if (!(x)) {                                         \
+        fprintf(stderr, "FAILED line %d\n", __LINE__);  \
+        abort();                                        \
+    }                                                   \
+} while(0)
+
+/*----------------------------------------------------------------------
+|    types
++---------------------------------------------------------------------*/
+typedef struct {
+    const char*   name;
+    unsigned char sample_format;
+    unsigned char bits_per_sample;
+} Format;
+
+/*----------------------------------------------------------------------
+|    globals
++---------------------------------------------------------------------*/
+static const Format Formats[] = {
+    {"s16le", BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE, 16},
+    {"s16be", BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE, 16},
+    {"s24le", BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE, 24},
+    {"s24be", BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE, 24},
+    {"s32le", BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_LE, 32},
+    {"s32be", BLT_PCM_SAMPLE_FORMAT_SIGNED_INT_BE, 32},
+    {"f32le", BLT_PCM_SAMPLE_FORMAT_FLOAT_LE,      32},
+    {"f32be", BLT_PCM_SAMPLE_FORMAT_FLOAT_BE,      32}
+};
+
+static const struct {
+    const char* name;
+    BLT_Flags   flag;
+} Kernels[] = {
+    {"portable", BLT_PCM_KERNEL_PORTABLE},
+    {"sse2",     BLT_PCM_KERNEL_SSE2},
+    {"avx2",     BLT_PCM_KERNEL_AVX2},
+    {"neon",     BLT_PCM_KERNEL_NEON}
+};
+
+/*----------------------------------------------------------------------
+|    MakeInput
++---------------------------------------------------------------------*/
+static void
+MakeInput(const Format* format, unsigned char* buffer)
+{
+    unsigned int width = format->bits_per_sample/8;
+    unsigned int i;
+
+    if (format->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_LE ||
+        format->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_BE) {
+        /* full scale values, out of range values, then random values */
+        static const float specials[] = {
+            0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 1.5f, -1.5f,
+            1e-20f, -1e-20f, 1e20f, -1e20f, 0.99999994f, -0.99999994f
+        };
+        for (i=0; i<SAMPLE_COUNT; i++) {
+            float          f;
+            unsigned char* x = (unsigned char*)&f;
+            if (i < sizeof(specials)/sizeof(specials[0])) {
+                f = specials[i];
+            } else {
+                f = 2.2f*((float)rand()/(float)RAND_MAX)-1.1f;
+            }
+            if ((format->sample_format == BLT_PCM_SAMPLE_FORMAT_FLOAT_LE) !=
+                (BLT_CONFIG_CPU_BYTE_ORDER == BLT_CPU_LITTLE_ENDIAN)) {
+                buffer[4*i  ] = x[3];
+                buffer[4*i+1] = x[2];
+                buffer[4*i+2] = x[1];
+                buffer[4*i+3] = x[0];
+            } else {
+                memcpy(buffer+4*i, x, 4);
+            }
+        }
+    } else {
+        /* random bytes, with the extreme values first */
+        for (i=0; i<SAMPLE_COUNT*width; i++) {
+            buffer[i] = (unsigned char)rand();
+        }
+        memset(buffer, 0x7F, width);
+        memset(buffer+width, 0x80, width);
+        memset(buffer+2*width, 0xFF, width);
+        memset(buffer+3*width, 0x00, width);
+    }
+}
+
+/*----------------------------------------------------------------------
+|    TestConversion
++---------------------------------------------------------------------*/
+static void
+TestConversion(const Format* in_format, const Format* out_format, BLT_Flags available)
+{
+    unsigned char    in[SAMPLE_COUNT*4];
+    unsigned char    expected[SAMPLE_COUNT*4];
+    unsigned char    actual[SAMPLE_COUNT*4+1]; /* with a guard byte */
+    BLT_PcmMediaType in_type;
+    BLT_PcmMediaType out_type;
+    BLT_Size         out_size = SAMPLE_COUNT*(out_format->bits_per_sample/8);
+    unsigned int     i;
+
+    BLT_PcmMediaType_Init(&in_type);
+    in_type.sample_format   = in_format->sample_format;
+    in_type.bits_per_sample = in_format->bits_per_sample;
+    BLT_PcmMediaType_Init(&out_type);
+    out_type.sample_format   = out_format->sample_format;
+    out_type.bits_per_sample = out_format->bits_per_sample;
+
+    MakeInput(in_format, in);
+
+    /* reference output from the generic loop */
+    CHECK(BLT_SUCCEEDED(BLT_Pcm_ConvertSamples(&in_type, in, &out_type, expected, SAMPLE_COUNT, 0)));
+
+    /* each kernel must produce the same bits, starting at any offset */
+    for (i=0; i<sizeof(Kernels)/sizeof(Kernels[0]); i++) {
+        unsigned int offset;
+        if ((available & Kernels[i].flag) == 0) continue;
+        for (offset=0; offset<3; offset++) {
+            unsigned int in_offset  = offset*(in_format->bits_per_sample/8);
+            unsigned int out_offset = offset*(out_format->bits_per_sample/8);
+            memset(actual, 0xAA, sizeof(actual));
+            CHECK(BLT_SUCCEEDED(BLT_Pcm_ConvertSamples(&in_type,
+                                                       in+in_offset,
+                                                       &out_type,
+                                                       actual,
+                                                       SAMPLE_COUNT-offset,
+                                                       Kernels[i].flag)));
+            if (memcmp(actual, expected+out_offset, out_size-out_offset)) {
+                fprintf(stderr, "%s -> %s: %s kernel differs\n",
+                        in_format->name, out_format->name, Kernels[i].name);
+                CHECK(0);
+            }
+            CHECK(actual[out_size-out_offset] == 0xAA);
+        }
+    }
+
+    /* in place, when the samples don't get wider */
+    if (out_format->bits_per_sample <= in_format->bits_per_sample) {
+        unsigned int in_size = SAMPLE_COUNT*(in_format->bits_per_sample/8);
+        for (i=0; i<sizeof(Kernels)/sizeof(Kernels[0])+1; i++) {
+            BLT_Flags flags = i < sizeof(Kernels)/sizeof(Kernels[0]) ? Kernels[i].flag : 0;
+            if (flags && (available & flags) == 0) continue;
+            memcpy(actual, in, in_size);
+            CHECK(BLT_SUCCEEDED(BLT_Pcm_ConvertSamples(&in_type, actual, &out_type, actual, SAMPLE_COUNT, flags)));
+            if (memcmp(actual, expected, out_size)) {
+                fprintf(stderr, "%s -> %s: %s kernel differs in place\n",
+                        in_format->name, out_format->name, flags ? Kernels[i].name : "generic");
+                CHECK(0);
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    main
++---------------------------------------------------------------------*/
+int
+main(int argc, char** argv)
+{
+    BLT_Flags    available = BLT_Pcm_GetAvailableKernels();
+    unsigned int i, j;
+
+    BLT_COMPILER_UNUSED(argc);
+    BLT_COMPILER_UNUSED(argv);
+
+    printf("available kernels:");
+    for (i=0; i<sizeof(Kernels)/sizeof(Kernels[0]); i++) {
+        if (available & Kernels[i].flag) printf(" %s", Kernels[i].name);
+    }
+    printf("\n");
+
+    for (i=0; i<sizeof(Formats)/sizeof(Formats[0]); i++) {
+        for (j=0; j<sizeof(Formats)/sizeof(Formats[0]); j++) {
+            TestConversion(&Formats[i], &Formats[j], available);
+        }
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*****************************************************************
+|
+|   BlueTune - Dither Test
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+****************************************************************/
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#include <string.h>
+
+#include "PcmTest.h"
+#include "BltPcmAdapter.h"
+#include "BltPcmDither.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* not a multiple of any vector or noise block size */
+#define FRAME_COUNT 1031
+
+#define MAX_CHANNEL_COUNT 6
+
+/*----------------------------------------------------------------------
+|    globals
++---------------------------------------------------------------------*/
+static const unsigned int Modes[] = {
+    BLT_PCM_ADAPTER_DITHER_TPDF,
+    BLT_PCM_ADAPTER_DITHER_SHAPED
+};
+
+static const unsigned int Resolutions[] = {8, 16, 20, 24};
+
+/* packet sizes, in frames, that the input is cut into */
+static const BLT_Cardinal Chunks[] = {1, 63, 256, 1031};
+
+/*----------------------------------------------------------------------
+|    TestDither
++---------------------------------------------------------------------*/
+static void
+TestDither(unsigned int channel_count,
+           unsigned int bits_per_sample,
+           unsigned int mode)
+{
+    BLT_Flags    available = BLT_Pcm_GetAvailableKernels();
+    float        input[FRAME_COUNT*MAX_CHANNEL_COUNT];
+    float        expected[FRAME_COUNT*MAX_CHANNEL_COUNT];
+    float        actual[FRAME_COUNT*MAX_CHANNEL_COUNT+1]; /* with a guard sample */
+    unsigned int sample_count = FRAME_COUNT*channel_count;
+    float        scale = (float)(1L<<(bits_per_sample-1));
+    unsigned int i, j, k;
+
+    /* random samples, a bit beyond full scale so that clipping is tested */
+    PcmTest_MakeSamples(input, sample_count, 1.1f);
+
+    for (i=0; i<sizeof(Chunks)/sizeof(Chunks[0]); i++) {
+        PcmDither* portable;
+
+        /* the noise is generated for each call, so the reference is */
+        /* computed with the same packets                            */
+        CHECK(BLT_SUCCEEDED(PcmDither_Create(channel_count, bits_per_sample, mode,
+                                             BLT_PCM_KERNEL_PORTABLE, &portable)));
+        for (j=0; j<FRAME_COUNT; j+=Chunks[i]) {
+            BLT_Cardinal count = FRAME_COUNT-j < Chunks[i] ? FRAME_COUNT-j : Chunks[i];
+            PcmDither_Process(portable, input+j*channel_count, expected+j*channel_count, count);
+        }
+        PcmDither_Destroy(portable);
+
+        /* on the target grid */
+        for (j=0; j<sample_count; j++) {
+            float q = expected[j]*scale;
+            CHECK(q == (float)floor(q) && q >= -scale && q <= scale-1.0f);
+        }
+
+        /* the noise generators produce the same values, so the vector */
+        /* code, working in place, must produce the same output        */
+        for (k=0; k<PCM_TEST_KERNEL_COUNT; k++) {
+            PcmDither* dither;
+            char       test_case[128];
+            if ((available & PcmTest_Kernels[k].flag) == 0) continue;
+            CHECK(BLT_SUCCEEDED(PcmDither_Create(channel_count, bits_per_sample, mode,
+                                                 PcmTest_Kernels[k].flag, &dither)));
+            memcpy(actual, input, sample_count*sizeof(float));
+            actual[sample_count] = PCM_TEST_GUARD_SAMPLE;
+            for (j=0; j<FRAME_COUNT; j+=Chunks[i]) {
+                BLT_Cardinal count = FRAME_COUNT-j < Chunks[i] ? FRAME_COUNT-j : Chunks[i];
+                PcmDither_Process(dither, actual+j*channel_count, actual+j*channel_count, count);
+            }
+            CHECK(actual[sample_count] == PCM_TEST_GUARD_SAMPLE);
+            sprintf(test_case, "%d channels, %d bits, mode %d, %d frame packets, %s",
+                    channel_count, bits_per_sample, mode, (int)Chunks[i], PcmTest_Kernels[k].name);
+            PcmTest_CompareSamples(test_case, expected, actual, sample_count, 0.0f);
+            PcmDither_Destroy(dither);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    main
++---------------------------------------------------------------------*/
+int
+main(int argc, char** argv)
+{
+    unsigned int i, j, c;
+
+    BLT_COMPILER_UNUSED(argc);
+    BLT_COMPILER_UNUSED(argv);
+
+    PcmTest_PrintKernels();
+
+    for (i=0; i<sizeof(Modes)/sizeof(Modes[0]); i++) {
+        for (j=0; j<sizeof(Resolutions)/sizeof(Resolutions[0]); j++) {
+            for (c=1; c<=MAX_CHANNEL_COUNT; c++) {
+                TestDither(c, Resolutions[j], Modes[i]);
+            }
+        }
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*****************************************************************
+|
+|   BlueTune - Channel Mixer Test
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+****************************************************************/
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#include <string.h>
+
+#include "PcmTest.h"
+#include "BltPcmMixer.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* not a multiple of any vector size, so that the tails are tested too */
+#define FRAME_COUNT 1031
+
+/* both variants sum the channels in the same order, but the compiler */
+/* may fuse the multiplies and adds of one of them                     */
+#define TOLERANCE 1e-6f
+
+#define MAX_INPUT_CHANNEL_COUNT  8
+#define MAX_OUTPUT_CHANNEL_COUNT 3
+
+/*----------------------------------------------------------------------
+|    MakeMatrix
++---------------------------------------------------------------------*/
+static void
+MakeMatrix(unsigned int input_channel_count,
+           unsigned int output_channel_count,
+           char*        matrix)
+{
+    unsigned int i, o;
+
+    matrix[0] = '\0';
+    for (o=0; o<output_channel_count; o++) {
+        for (i=0; i<input_channel_count; i++) {
+            sprintf(matrix+strlen(matrix), "%s%.6f",
+                    i ? "," : (o ? ";" : ""),
+                    2.0*((double)rand()/(double)RAND_MAX)-1.0);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------
+|    TestMixer
++---------------------------------------------------------------------*/
+static void
+TestMixer(unsigned int input_channel_count,
+          unsigned int output_channel_count,
+          const char*  matrix)
+{
+    BLT_Flags    available = BLT_Pcm_GetAvailableKernels();
+    unsigned int ic = input_channel_count;
+    unsigned int oc = output_channel_count;
+    PcmMixer*    portable;
+    float        input[FRAME_COUNT*MAX_INPUT_CHANNEL_COUNT];
+    float        expected[FRAME_COUNT*MAX_OUTPUT_CHANNEL_COUNT];
+    float        actual[FRAME_COUNT*MAX_OUTPUT_CHANNEL_COUNT+1]; /* with a guard sample */
+    unsigned int offset;
+    unsigned int k;
+
+    CHECK(BLT_SUCCEEDED(PcmMixer_Create(ic, 0, oc, 0, matrix, BLT_PCM_KERNEL_PORTABLE, &portable)));
+    CHECK(PcmMixer_HasCustomMatrix(portable) == (matrix != NULL));
+
+    /* random samples at up to full scale */
+    PcmTest_MakeSamples(input, FRAME_COUNT*ic, 1.0f);
+
+    /* reference output */
+    PcmMixer_Process(portable, input, expected, FRAME_COUNT);
+
+    /* the vector code must agree with it, starting at any frame */
+    for (k=0; k<PCM_TEST_KERNEL_COUNT; k++) {
+        PcmMixer* mixer;
+        if ((available & PcmTest_Kernels[k].flag) == 0) continue;
+        CHECK(BLT_SUCCEEDED(PcmMixer_Create(ic, 0, oc, 0, matrix, PcmTest_Kernels[k].flag, &mixer)));
+        for (offset=0; offset<3; offset++) {
+            unsigned int count = (FRAME_COUNT-offset)*oc;
+            char         test_case[128];
+            sprintf(test_case, "%d -> %d channels, %s matrix, offset %d, %s",
+                    ic, oc, matrix ? "custom" : "standard", offset, PcmTest_Kernels[k].name);
+            actual[count] = PCM_TEST_GUARD_SAMPLE;
+            PcmMixer_Process(mixer, input+offset*ic, actual, FRAME_COUNT-offset);
+            PcmTest_CompareSamples(test_case, expected+offset*oc, actual, count, TOLERANCE);
+            CHECK(actual[count] == PCM_TEST_GUARD_SAMPLE);
+        }
+        PcmMixer_Destroy(mixer);
+    }
+
+    PcmMixer_Destroy(portable);
+}
+
+/*----------------------------------------------------------------------
+|    main
++---------------------------------------------------------------------*/
+int
+main(int argc, char** argv)
+{
+    char         matrix[MAX_INPUT_CHANNEL_COUNT*MAX_OUTPUT_CHANNEL_COUNT*16];
+    unsigned int i, o;
+
+    BLT_COMPILER_UNUSED(argc);
+    BLT_COMPILER_UNUSED(argv);
+
+    PcmTest_PrintKernels();
+
+    /* 1 and 2 output channels have vector loops, 3 doesn't */
+    for (i=1; i<=MAX_INPUT_CHANNEL_COUNT; i++) {
+        for (o=1; o<=MAX_OUTPUT_CHANNEL_COUNT; o++) {
+            TestMixer(i, o, NULL);
+            MakeMatrix(i, o, matrix);
+            TestMixer(i, o, matrix);
+        }
+    }
+
+    printf("PASSED\n");
+    return 0;
+}
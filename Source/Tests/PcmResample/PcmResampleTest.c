@@ -0,0 +1,171 @@
+/*****************************************************************
+|
+|   BlueTune - Sample Rate Converter Test
+|
+|   (c) 2002-2009 Gilles Boccon-Gibod
+|   Author: Gilles Boccon-Gibod (bok@bok.net)
+|
+****************************************************************/
+
+/*----------------------------------------------------------------------
+|    includes
++---------------------------------------------------------------------*/
+#include "PcmTest.h"
+#include "BltPcmAdapter.h"
+#include "BltPcmResampler.h"
+
+/*----------------------------------------------------------------------
+|    constants
++---------------------------------------------------------------------*/
+/* not a multiple of any vector size, so that the tails are tested too */
+#define FRAME_COUNT 1031
+
+/* the vector code sums the taps in a different order, so the results */
+/* can differ by a few rounding errors                                */
+#define TOLERANCE 1e-5f
+
+#define MAX_CHANNEL_COUNT 6
+
+/*----------------------------------------------------------------------
+|    globals
++---------------------------------------------------------------------*/
+static const struct {
+    BLT_UInt32 input_rate;
+    BLT_UInt32 output_rate;
+} Rates[] = {
+    {44100, 48000},  /* one filter per phase */
+    {48000, 44100},
+    {44100, 22050},  /* downsampling, longer filters */
+    {96000, 44100},
+    {8000,  44100},
+    {44100, 44101}   /* too many phases, interpolated filters */
+};
+
+static const unsigned int Qualities[] = {
+    BLT_PCM_ADAPTER_RESAMPLER_QUALITY_LOW,
+    BLT_PCM_ADAPTER_RESAMPLER_QUALITY_MEDIUM,
+    BLT_PCM_ADAPTER_RESAMPLER_QUALITY_HIGH,
+    BLT_PCM_ADAPTER_RESAMPLER_QUALITY_BEST
+};
+
+/* packet sizes, in frames, that the input is cut into */
+static const BLT_Cardinal Chunks[] = {1, 7, 64, 333, 1031};
+
+/*----------------------------------------------------------------------
+|    Resample
++---------------------------------------------------------------------*/
+static BLT_Cardinal
+Resample(PcmResampler* resampler,
+         const float*  input,
+         unsigned int  channel_count,
+         BLT_Cardinal  chunk,
+         float*        output)
+{
+    BLT_Cardinal consumed = 0;
+    BLT_Cardinal produced = 0;
+    BLT_Cardinal frames;
+
+    while (consumed < FRAME_COUNT) {
+        BLT_Cardinal count = FRAME_COUNT-consumed < chunk ? FRAME_COUNT-consumed : chunk;
+        CHECK(BLT_SUCCEEDED(PcmResampler_Process(resampler,
+                                                 input+consumed*channel_count,
+                                                 count,
+                                                 output+produced*channel_count,
+                                                 &frames)));
+        consumed += count;
+        produced += frames;
+    }
+    CHECK(BLT_SUCCEEDED(PcmResampler_Flush(resampler, output+produced*channel_count, &frames)));
+
+    return produced+frames;
+}
+
+/*----------------------------------------------------------------------
+|    TestResampler
++---------------------------------------------------------------------*/
+static void
+TestResampler(BLT_UInt32   input_rate,
+              BLT_UInt32   output_rate,
+              unsigned int channel_count,
+              unsigned int quality)
+{
+    BLT_Flags     available = BLT_Pcm_GetAvailableKernels();
+    PcmResampler* portable;
+    float*        input;
+    float*        expected;
+    float*        actual;
+    BLT_Cardinal  max_frames;
+    BLT_Cardinal  expected_frames;
+    unsigned int  i, k;
+
+    CHECK(BLT_SUCCEEDED(PcmResampler_Create(input_rate, output_rate, channel_count, quality,
+                                            BLT_PCM_KERNEL_PORTABLE, &portable)));
+    max_frames = PcmResampler_GetMaxOutputFrames(portable, FRAME_COUNT);
+
+    /* random samples at up to full scale */
+    input    = (float*)malloc(FRAME_COUNT*channel_count*sizeof(float));
+    expected = (float*)malloc(max_frames*channel_count*sizeof(float));
+    actual   = (float*)malloc((max_frames*channel_count+1)*sizeof(float)); /* with a guard sample */
+    CHECK(input && expected && actual);
+    PcmTest_MakeSamples(input, FRAME_COUNT*channel_count, 1.0f);
+
+    /* reference output, all in one packet */
+    expected_frames = Resample(portable, input, channel_count, FRAME_COUNT, expected);
+    CHECK(expected_frames <= max_frames);
+
+    /* the vector code, with any packet size, must agree with it */
+    for (k=0; k<PCM_TEST_KERNEL_COUNT; k++) {
+        PcmResampler* resampler;
+        if ((available & PcmTest_Kernels[k].flag) == 0) continue;
+        CHECK(BLT_SUCCEEDED(PcmResampler_Create(input_rate, output_rate, channel_count, quality,
+                                                PcmTest_Kernels[k].flag, &resampler)));
+        CHECK(PcmResampler_GetMaxOutputFrames(resampler, FRAME_COUNT) == max_frames);
+        for (i=0; i<sizeof(Chunks)/sizeof(Chunks[0]); i++) {
+            char         test_case[128];
+            BLT_Cardinal frames;
+            sprintf(test_case, "%d -> %d, %d channels, quality %d, %d frame packets, %s",
+                    (int)input_rate, (int)output_rate, channel_count, quality,
+                    (int)Chunks[i], PcmTest_Kernels[k].name);
+            actual[max_frames*channel_count] = PCM_TEST_GUARD_SAMPLE;
+            frames = Resample(resampler, input, channel_count, Chunks[i], actual);
+            if (frames != expected_frames) {
+                fprintf(stderr, "%s: %d frames instead of %d\n",
+                        test_case, (int)frames, (int)expected_frames);
+                CHECK(0);
+            }
+            PcmTest_CompareSamples(test_case, expected, actual, frames*channel_count, TOLERANCE);
+            CHECK(actual[max_frames*channel_count] == PCM_TEST_GUARD_SAMPLE);
+        }
+        PcmResampler_Destroy(resampler);
+    }
+
+    free(input);
+    free(expected);
+    free(actual);
+    PcmResampler_Destroy(portable);
+}
+
+/*----------------------------------------------------------------------
+|    main
++---------------------------------------------------------------------*/
+int
+main(int argc, char** argv)
+{
+    unsigned int i, j, c;
+
+    BLT_COMPILER_UNUSED(argc);
+    BLT_COMPILER_UNUSED(argv);
+
+    PcmTest_PrintKernels();
+
+    for (i=0; i<sizeof(Rates)/sizeof(Rates[0]); i++) {
+        for (j=0; j<sizeof(Qualities)/sizeof(Qualities[0]); j++) {
+            for (c=1; c<=MAX_CHANNEL_COUNT; c++) {
+                TestResampler(Rates[i].input_rate, Rates[i].output_rate, c, Qualities[j]);
+            }
+        }
+    }
+
+    printf("PASSED\n");
+    return 0;
+}